@@ -0,0 +1,124 @@
+/**
+ * @file Boot.h
+ * @brief Header file for the Boot module.
+ *
+ * This file contains the function definitions for the Boot module. The Boot module
+ * replaces the C runtime auto-initialization with a word-wide copy of .data and a
+ * word-wide zero fill of .bss that runs from the _system_pre_init hook.
+ *
+ * Variables that do not need to be initialized at reset (trace logs, frame buffers)
+ * can be placed in the following sections, which are defined in msp432p401r.cmd:
+ *  - .noinit:      Never initialized. The contents are undefined after a power-on reset
+ *                  and are left untouched after a warm reset.
+ *  - .persistent:  Never initialized and always located at the start of SRAM bank 0.
+ *                  Intended for small state that must survive warm resets. The contents
+ *                  must be validated (for example, with a magic value) before use.
+ *
+ * Example:
+ *      #pragma DATA_SECTION(Frame_Buffer, ".noinit")
+ *      uint8_t Frame_Buffer[4096];
+ *
+ * The cycle counts reported by this module are read from the DWT cycle counter (CYCCNT),
+ * which is enabled at the start of _system_pre_init.
+ *
+ */
+
+#ifndef INC_BOOT_H_
+#define INC_BOOT_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief The _system_pre_init function is called by the C runtime before main.
+ *
+ * This function enables the DWT cycle counter, copies the .data section from flash to SRAM
+ * and zero fills the .bss section using 32-bit transfers. It returns 0 so that the C runtime
+ * skips its own auto-initialization routine. The .noinit and .persistent sections are not touched.
+ *
+ * @param None
+ *
+ * @return Always returns 0.
+ */
+int _system_pre_init(void);
+
+/**
+ * @brief The Boot_Record_Main_Entry function records the cycle count at which main was entered.
+ *
+ * This function should be called as the first statement in main.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Boot_Record_Main_Entry();
+
+/**
+ * @brief The Boot_Get_Main_Entry_Cycles function returns the number of CPU cycles from
+ * _system_pre_init to the entry of main.
+ *
+ * @param None
+ *
+ * @return The number of CPU cycles spent before main was entered.
+ */
+uint32_t Boot_Get_Main_Entry_Cycles();
+
+/**
+ * @brief The Boot_Get_Init_Cycles function returns the number of CPU cycles spent
+ * copying .data and zero filling .bss.
+ *
+ * @param None
+ *
+ * @return The number of CPU cycles spent initializing SRAM.
+ */
+uint32_t Boot_Get_Init_Cycles();
+
+/**
+ * @brief The Boot_Get_Init_Bytes function returns the number of bytes of .data and .bss
+ * that were initialized at boot.
+ *
+ * @param None
+ *
+ * @return The number of bytes initialized at boot.
+ */
+uint32_t Boot_Get_Init_Bytes();
+
+/**
+ * @brief The Boot_Get_Skipped_Bytes function returns the number of bytes in the .noinit and
+ * .persistent sections, which are not initialized at boot.
+ *
+ * @param None
+ *
+ * @return The number of bytes that are skipped at boot.
+ */
+uint32_t Boot_Get_Skipped_Bytes();
+
+/**
+ * @brief The Boot_Get_Saved_Cycles function estimates the number of CPU cycles saved at boot
+ * by not initializing the .noinit and .persistent sections.
+ *
+ * The estimate is the measured cost per byte of the .data and .bss initialization
+ * multiplied by the number of skipped bytes.
+ *
+ * @param None
+ *
+ * @return The estimated number of CPU cycles saved at boot.
+ */
+uint32_t Boot_Get_Saved_Cycles();
+
+/**
+ * @brief The Boot_Is_Warm_Start function indicates whether the contents of the .persistent
+ * section were preserved from the previous session.
+ *
+ * A marker in the .persistent section is checked and then set during _system_pre_init. The marker
+ * is only valid if SRAM was retained through the reset (for example, a watchdog or pin reset).
+ *
+ * @param None
+ *
+ * @return Indicates the type of start.
+ *  - 0: Cold start (power-on reset or SRAM contents lost)
+ *  - 1: Warm start (SRAM contents retained)
+ */
+uint8_t Boot_Is_Warm_Start();
+
+#endif /* INC_BOOT_H_ */
@@ -0,0 +1,40 @@
+/**
+ * @file CRC16.h
+ * @brief Header file for the CRC16 module.
+ *
+ * This file contains the function definitions for the CRC16 module.
+ * The checksum is the CRC-16/CCITT-FALSE variant:
+ *  - Polynomial: 0x1021
+ *  - Initial value: 0xFFFF
+ *  - No input or output reflection
+ *  - No final XOR
+ *
+ * This module does not access any peripheral registers.
+ *
+ */
+
+#ifndef INC_CRC16_H_
+#define INC_CRC16_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Initial value of the CRC-16/CCITT-FALSE checksum
+ */
+#define CRC16_INIT  0xFFFF
+
+/**
+ * @brief The CRC16_Update function updates a CRC-16/CCITT-FALSE checksum with a block of data.
+ *
+ * This function processes the data four bits at a time using a 16-entry lookup table.
+ * To compute the checksum of a single block, pass CRC16_INIT as the crc parameter.
+ *
+ * @param crc The current value of the checksum.
+ * @param data Pointer to the data to be processed.
+ * @param length Number of bytes to be processed.
+ *
+ * @return The updated value of the checksum.
+ */
+uint16_t CRC16_Update(uint16_t crc, const uint8_t *data, uint32_t length);
+
+#endif /* INC_CRC16_H_ */
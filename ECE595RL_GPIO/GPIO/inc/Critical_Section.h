@@ -0,0 +1,90 @@
+/**
+ * @file Critical_Section.h
+ * @brief Header file for the Critical_Section module.
+ *
+ * This file contains the function definitions for the Critical_Section module.
+ *
+ * A critical section masks only the interrupts whose priority is lower than or equal to a given
+ * priority level by raising the BASEPRI register. Interrupts with a higher priority (a numerically
+ * lower priority level) remain enabled, so time-critical handlers are not delayed by code that
+ * only shares data with lower-priority handlers.
+ *
+ * The MSP432P401R implements 3 priority bits, so the priority levels range from 0 (highest) to 7 (lowest).
+ * Priority level 0 cannot be masked with BASEPRI and is reserved for handlers that do not share
+ * data with other code (see ISR_Latency.h and IRQ_Priority.h).
+ *
+ * Critical sections can be nested. An inner critical section never lowers the masking level of an
+ * outer critical section, and Critical_Section_Exit restores the level that was active before the
+ * matching Critical_Section_Enter.
+ *
+ * The masking level is raised with a single MSR BASEPRI_MAX instruction, which only writes BASEPRI if the
+ * new value masks more interrupts than the current one. PRIMASK is never set, so a critical section does
+ * not delay the interrupts above its level, not even for the few instructions of Critical_Section_Enter.
+ * The TI compiler cannot pass a C variable to an inline assembly statement, so the instruction is in the
+ * assembly function Critical_Section_Raise (see Critical_Section.c), which costs a call and a return.
+ *
+ * Example:
+ *  uint32_t state = Critical_Section_Enter(CRITICAL_SECTION_GPIO);
+ *  P1->OUT = (P1->OUT & 0xFE) | led_value;
+ *  Critical_Section_Exit(state);
+ *
+ * For more information regarding BASEPRI, refer to the Cortex-M4 Devices Generic User Guide.
+ *
+ */
+
+#ifndef INC_CRITICAL_SECTION_H_
+#define INC_CRITICAL_SECTION_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "IRQ_Priority.h"
+
+/**
+ * @brief Priority level of the interrupts that access the GPIO output registers
+ *
+ * The event handlers of the priority plan (see IRQ_Priority.h) are the highest-priority handlers that write the
+ * LEDs, so critical sections that protect a read-modify-write of a Px->OUT register mask the levels from
+ * IRQ_PRIORITY_LEVEL_EVENTS to 7. The PC sampler (IRQ_PRIORITY_LEVEL_SAMPLER) is not masked.
+ */
+#define CRITICAL_SECTION_GPIO   IRQ_PRIORITY_LEVEL_EVENTS
+
+/**
+ * @brief The Critical_Section_Raise function reads BASEPRI and then raises it with MSR BASEPRI_MAX.
+ *
+ * BASEPRI is only written if basepri is nonzero and BASEPRI is either 0 or greater than basepri. An interrupt
+ * between the read and the write restores BASEPRI before it returns, so the value read is still current.
+ *
+ * @param basepri The BASEPRI value (the priority level shifted into the implemented priority bits).
+ *
+ * @return The value of BASEPRI before the call.
+ */
+uint32_t Critical_Section_Raise(uint32_t basepri);
+
+/**
+ * @brief The Critical_Section_Enter function masks the interrupts with a priority level greater than or equal to priority.
+ *
+ * If the current BASEPRI value already masks these interrupts, it is not changed. PRIMASK is not used,
+ * so this function is safe to call from any handler.
+ *
+ * @param priority The priority level (1 to 7) of the highest-priority interrupt to be masked.
+ *
+ * @return The previous value of BASEPRI, which must be passed to Critical_Section_Exit.
+ */
+static inline uint32_t Critical_Section_Enter(uint32_t priority)
+{
+    return Critical_Section_Raise(priority << (8 - __NVIC_PRIO_BITS));
+}
+
+/**
+ * @brief The Critical_Section_Exit function restores the masking level saved by Critical_Section_Enter.
+ *
+ * @param previous The value returned by the matching Critical_Section_Enter call.
+ *
+ * @return None
+ */
+static inline void Critical_Section_Exit(uint32_t previous)
+{
+    _set_interrupt_priority(previous);
+}
+
+#endif /* INC_CRITICAL_SECTION_H_ */
@@ -0,0 +1,152 @@
+/**
+ * @file DMA.h
+ * @brief Header file for the DMA driver.
+ *
+ * This file contains the function definitions for the DMA driver.
+ *
+ * The DMA driver owns the control table of the MSP432P401R DMA controller and starts transfers from memory to a
+ * peripheral data register, one byte per request of the peripheral trigger. A transfer runs without the CPU; the
+ * controller disables the channel when the last byte has been written, so DMA_Is_Busy only reads the channel
+ * enable bit and no interrupt is needed.
+ *
+ * Ping-pong transfers:
+ *  - A channel has a primary and an alternate structure. When a structure set with ping_pong completes, the
+ *    controller continues with the other structure without a gap, and raises the completion interrupt of the
+ *    channel (see DMA_Enable_Interrupt), whose handler sets the completed structure again with the next block.
+ *  - A structure set without ping_pong ends the transfer: the channel is disabled when it completes. The channel
+ *    is also disabled if the other structure completes before the handler has set the structure again.
+ *
+ * Each channel is connected to one of eight trigger sources by DMA_Channel->CH_SRCCFG. The channels used by the
+ * program are listed below, so that two modules do not use the same channel:
+ *  - DMA_CHANNEL_UART_TX (0), source 1: EUSCI_A0 transmit, used by Diff_Log
+ *  - DMA_CHANNEL_WS2812 (6), source 1: EUSCI_A3 transmit, used by WS2812, with the DMA_INT1 interrupt
+ *
+ * For more information regarding the DMA controller and the trigger sources of each channel, refer to the DMA
+ * section of the MSP432Pxx Microcontrollers Technical Reference Manual and the MSP432P401R datasheet.
+ *
+ */
+
+#ifndef INC_DMA_H_
+#define INC_DMA_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Number of DMA channels of the MSP432P401R
+ */
+#define DMA_NUM_CHANNELS            8
+
+/**
+ * @brief Largest number of bytes of a basic-mode transfer
+ */
+#define DMA_MAX_TRANSFER            1024
+
+/**
+ * @brief Channels and trigger sources used by the program
+ */
+#define DMA_CHANNEL_UART_TX         0
+#define DMA_SOURCE_UART_TX          1       // EUSCI_A0 TXIFG
+#define DMA_CHANNEL_WS2812          6
+#define DMA_SOURCE_WS2812           1       // EUSCI_A3 TXIFG
+
+/**
+ * @brief The DMA_Init function sets the base address of the control table and enables the DMA controller.
+ *
+ * Every channel is disabled. This function must be called before any other DMA function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void DMA_Init();
+
+/**
+ * @brief The DMA_Start_To_Peripheral function starts a basic-mode transfer from a buffer to a peripheral register.
+ *
+ * Each request of the trigger source copies one byte from the next location of the buffer to the register,
+ * which is not incremented. The buffer must not change until the transfer has completed.
+ *
+ * @note The channel must not be busy (see DMA_Is_Busy).
+ *
+ * @param channel The DMA channel (0 to DMA_NUM_CHANNELS - 1).
+ * @param source The trigger source of the channel (1 to 7).
+ * @param buffer Pointer to the bytes to transfer.
+ * @param destination Pointer to the peripheral register.
+ * @param count The number of bytes to transfer (1 to DMA_MAX_TRANSFER).
+ *
+ * @return None
+ */
+void DMA_Start_To_Peripheral(uint8_t channel, uint8_t source, const uint8_t *buffer, volatile void *destination,
+                             uint32_t count);
+
+/**
+ * @brief The DMA_Set_To_Peripheral function sets the primary or alternate structure of a channel for a transfer
+ * from a buffer to a peripheral register, without enabling the channel.
+ *
+ * While the channel is enabled, only the structure that has completed may be set (see the ping-pong transfers).
+ *
+ * @param channel The DMA channel (0 to DMA_NUM_CHANNELS - 1).
+ * @param alternate 0 for the primary structure, 1 for the alternate structure.
+ * @param buffer Pointer to the bytes to transfer.
+ * @param destination Pointer to the peripheral register.
+ * @param count The number of bytes to transfer (1 to DMA_MAX_TRANSFER).
+ * @param ping_pong 1 if the transfer continues with the other structure, 0 if it ends with this structure.
+ *
+ * @return None
+ */
+void DMA_Set_To_Peripheral(uint8_t channel, uint8_t alternate, const uint8_t *buffer, volatile void *destination,
+                           uint32_t count, uint8_t ping_pong);
+
+/**
+ * @brief The DMA_Enable function connects a channel to its trigger source and enables it, starting with the
+ * primary structure.
+ *
+ * @param channel The DMA channel.
+ * @param source The trigger source of the channel (1 to 7).
+ *
+ * @return None
+ */
+void DMA_Enable(uint8_t channel, uint8_t source);
+
+/**
+ * @brief The DMA_Enable_Interrupt function raises the DMA_INT1 interrupt when a structure of a channel completes.
+ *
+ * Only one channel can use DMA_INT1. The priority and the NVIC enable of DMA_INT1 are set by the caller.
+ *
+ * @param channel The DMA channel.
+ *
+ * @return None
+ */
+void DMA_Enable_Interrupt(uint8_t channel);
+
+/**
+ * @brief The DMA_Clear_Interrupt function clears the completion flag of a channel.
+ *
+ * This function must be called by the DMA_INT1 interrupt handler.
+ *
+ * @param channel The DMA channel.
+ *
+ * @return None
+ */
+void DMA_Clear_Interrupt(uint8_t channel);
+
+/**
+ * @brief The DMA_Is_Busy function indicates whether a transfer of a channel has not completed.
+ *
+ * @param channel The DMA channel.
+ *
+ * @return 1 if the channel is enabled, 0 if its last transfer has completed.
+ */
+uint8_t DMA_Is_Busy(uint8_t channel);
+
+/**
+ * @brief The DMA_Stop function disables a channel. The bytes that have not been transferred are discarded.
+ *
+ * @param channel The DMA channel.
+ *
+ * @return None
+ */
+void DMA_Stop(uint8_t channel);
+
+#endif /* INC_DMA_H_ */
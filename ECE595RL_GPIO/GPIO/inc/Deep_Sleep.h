@@ -0,0 +1,119 @@
+/**
+ * @file Deep_Sleep.h
+ * @brief Header file for the Deep_Sleep driver.
+ *
+ * This file contains the function definitions for the Deep_Sleep driver.
+ *
+ * The Deep_Sleep driver enters LPM3.5 or LPM4.5 after a period of inactivity. An input is
+ * considered inactive if the status of the user buttons and the PMOD SWT switches does not change.
+ * While the device is in LPM3.5 or LPM4.5, the outputs of the LEDs are held by the I/O lock (LOCKLPM5).
+ *
+ * The device wakes up when one of the user buttons (P1.1 or P1.4) is pressed. Waking up from LPM3.5
+ * or LPM4.5 causes a reset. Deep_Sleep_Resume must be called at the beginning of main, after Pin_Power_Init,
+ * to restore the LED outputs and release the I/O lock.
+ *  - LPM3.5: SRAM bank 0 is retained, so the LED state is restored from the .persistent section.
+ *  - LPM4.5: SRAM is not retained, so the LED state is restored from INFO flash (see Flash_Log.h).
+ *
+ * @note The PMOD SWT switches (P10.0 - P10.3) cannot wake up the device since Port 10 does not
+ * have interrupt capability.
+ *
+ * For more information regarding LPM3.5 and LPM4.5, refer to the Power Control Manager (PCM) section
+ * of the MSP432Pxx Microcontrollers Technical Reference Manual.
+ *
+ */
+
+#ifndef INC_DEEP_SLEEP_H_
+#define INC_DEEP_SLEEP_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "Flash_Log.h"
+
+/**
+ * @brief Low-power mode entered by Deep_Sleep_Enter: LPM3.5
+ */
+#define DEEP_SLEEP_LPM35            35
+
+/**
+ * @brief Low-power mode entered by Deep_Sleep_Enter: LPM4.5
+ */
+#define DEEP_SLEEP_LPM45            45
+
+/**
+ * @brief Default inactivity timeout in milliseconds (1 hour)
+ */
+#define DEEP_SLEEP_DEFAULT_TIMEOUT  3600000
+
+/**
+ * @brief The Deep_Sleep_Resume function restores the LED state after waking up from LPM3.5 or LPM4.5.
+ *
+ * If the device has woken up from LPM3.5 or LPM4.5, this function initializes the LED, button and switch pins,
+ * writes the saved LED outputs and then releases the I/O lock. Since the outputs are written before the I/O lock
+ * is released, the LEDs do not change state during wake-up.
+ *
+ * On wake-up, Flash_Log_Init is called once by this function (after the I/O lock is released if the state was
+ * restored from SRAM), so main must not call it again. The restored state is passed to LED_Controller_Resume by
+ * main, so that the pattern run continues where it stopped.
+ *
+ * This function must be called at the beginning of main, before any pin other than the unused pins is configured.
+ * Pin_Power_Init may run first: it only parks the unused pins, whose new settings take effect when the I/O lock
+ * (LOCKLPM5) is released by this function.
+ *
+ * @param state Pointer to the structure where the restored LED state will be stored.
+ *
+ * @return Indicates the reason for the reset.
+ *  - 0: The device did not wake up from LPM3.5 or LPM4.5 and state is not modified
+ *  - 1: The device woke up from LPM3.5 or LPM4.5 and the pins have been initialized
+ */
+uint8_t Deep_Sleep_Resume(Flash_Log_State *state);
+
+/**
+ * @brief The Deep_Sleep_Set_Policy function configures the inactivity policy.
+ *
+ * @param timeout_ms Time in milliseconds without an input change before entering deep sleep. Set to 0 to disable.
+ * @param mode The low-power mode to be entered (DEEP_SLEEP_LPM35 or DEEP_SLEEP_LPM45).
+ *
+ * @return None
+ */
+void Deep_Sleep_Set_Policy(uint32_t timeout_ms, uint8_t mode);
+
+/**
+ * @brief The Deep_Sleep_Update function tracks the input activity and enters deep sleep after the timeout.
+ *
+ * This function should be called periodically, for example after each pattern run. If the inputs have not changed
+ * for the configured timeout, Deep_Sleep_Enter is called with the current LED state.
+ *
+ * @param state Pointer to the current LED state, including the button and switch status.
+ *
+ * @return None
+ */
+void Deep_Sleep_Update(const Flash_Log_State *state);
+
+/**
+ * @brief The Deep_Sleep_Enter function enters LPM3.5 or LPM4.5.
+ *
+ * This function saves the LED state, configures the user buttons (P1.1 and P1.4) as wake-up sources
+ * and enters the configured low-power mode. The clock is switched to 3 MHz at core voltage level 0 before entry.
+ *
+ * If the transition fails, the 48 MHz clock and the reactor interrupts (see Reactor_Suspend) are restored
+ * and the function returns.
+ *
+ * @param state Pointer to the LED state to be restored after wake-up.
+ *
+ * @return None
+ */
+void Deep_Sleep_Enter(const Flash_Log_State *state);
+
+/**
+ * @brief The Deep_Sleep_Get_Wake_Latency_Cycles function returns the number of CPU cycles from
+ * the reset vector to the release of the I/O lock after waking up from LPM3.5 or LPM4.5.
+ *
+ * The time needed by the hardware to exit LPM3.5 or LPM4.5 before the reset vector is executed is not included.
+ *
+ * @param None
+ *
+ * @return The wake-up latency in CPU cycles or 0 if the device did not wake up from LPM3.5 or LPM4.5.
+ */
+uint32_t Deep_Sleep_Get_Wake_Latency_Cycles();
+
+#endif /* INC_DEEP_SLEEP_H_ */
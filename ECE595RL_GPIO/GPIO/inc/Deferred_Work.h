@@ -0,0 +1,171 @@
+/**
+ * @file Deferred_Work.h
+ * @brief Header file for the Deferred_Work module.
+ *
+ * This file contains the function definitions for the Deferred_Work module.
+ *
+ * The Deferred_Work module splits interrupt handling into a top half and a bottom half. The top half is the
+ * interrupt handler itself: it only does what cannot wait (clearing the flags, reading the data registers) and
+ * posts a work item with Deferred_Work_Post. The bottom half is the work item, a function that runs later in the
+ * PendSV handler (see Kernel.c), which calls Deferred_Work_Run before it switches threads. PendSV has the lowest
+ * priority level (7), so the work items run after all pending interrupt handlers have completed and before the
+ * thread-mode code resumes, and they can be preempted by any interrupt.
+ *
+ * The work items run in the order in which they were posted, one at a time. A work item must not block, and
+ * it must not call Deferred_Work_Post for itself in a loop, since the thread-mode code only resumes once the queue
+ * is empty.
+ *
+ * The queue is lock-free: Deferred_Work_Post claims a slot with an exclusive load/store (LDREX/STREX) and writes
+ * the function last. The PendSV handler stops at the first slot whose function has not been written yet, and the
+ * interrupted Deferred_Work_Post pends PendSV again when it has written it.
+ *
+ * The execution time of each top half is measured with the DWT cycle counter, from the first statement of the
+ * interrupt handler (the 12-cycle exception entry is not included) to the call of Deferred_Work_Top_Half_End,
+ * and compared with a budget. A top half that exceeds the budget is counted, and a FLIGHT_RECORDER_ISR_OVERRUN
+ * record is logged by a work item, so that the logging itself does not lengthen the top half. The measurement
+ * costs about 10 cycles per interrupt.
+ *
+ * The following UART commands are registered (see UART_Command.h):
+ *  - 'w': Transmit the deferred work statistics (Deferred_Work_Dump)
+ *  - 'W': Clear the statistics (Deferred_Work_Reset)
+ *
+ */
+
+#ifndef INC_DEFERRED_WORK_H_
+#define INC_DEFERRED_WORK_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Number of work items in the queue (power of two). Work items posted to a full queue are dropped and counted.
+ */
+#define DEFERRED_WORK_QUEUE_SIZE            16
+
+/**
+ * @brief Default top-half budget in CPU cycles (10 us at 48 MHz)
+ */
+#define DEFERRED_WORK_DEFAULT_BUDGET        480
+
+/**
+ * @brief Interrupt handlers whose top half is measured
+ */
+typedef enum
+{
+    DEFERRED_WORK_ISR_TA1_N,        // Reactor timers (see Reactor.h)
+    DEFERRED_WORK_ISR_PORT1,        // Reactor user buttons
+    DEFERRED_WORK_ISR_EUSCIA0,      // Reactor UART receive
+    DEFERRED_WORK_ISR_DMA_INT1,     // WS2812 DMA completion (see WS2812.h)
+    DEFERRED_WORK_NUM_ISRS
+} Deferred_Work_ISR;
+
+/**
+ * @brief Work item function
+ */
+typedef void (*Deferred_Work_Function)(uint32_t argument);
+
+/**
+ * @brief Statistics of the top half of an interrupt handler
+ */
+typedef struct
+{
+    uint32_t count;                 // Number of measured executions
+    uint32_t max_cycles;            // Longest execution in CPU cycles
+    uint32_t overruns;              // Executions longer than the budget
+} Deferred_Work_Top_Half_Stats;
+
+/**
+ * @brief The Deferred_Work_Init function clears the queue and the statistics and sets the priority of PendSV.
+ *
+ * @param budget_cycles The top-half budget in CPU cycles, or 0 to disable the overrun detection.
+ *
+ * @return None
+ */
+void Deferred_Work_Init(uint32_t budget_cycles);
+
+/**
+ * @brief The Deferred_Work_Post function adds a work item to the queue and pends PendSV.
+ *
+ * This function can be called from any interrupt handler, from a work item and from thread mode.
+ *
+ * @param function The function to be called by the PendSV handler.
+ * @param argument The argument passed to the function.
+ *
+ * @return Indicates whether the work item has been queued.
+ *  - 0: The work item has been queued
+ *  - 1: The queue is full and the work item has been dropped
+ */
+uint8_t Deferred_Work_Post(Deferred_Work_Function function, uint32_t argument);
+
+/**
+ * @brief The Deferred_Work_Run function runs the work items of the queue until the queue is empty.
+ *
+ * This function is called by the PendSV handler and must not be called from anywhere else.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Deferred_Work_Run();
+
+/**
+ * @brief The Deferred_Work_Top_Half_Begin function starts the measurement of a top half.
+ *
+ * This function must be called at the start of the interrupt handler.
+ *
+ * @param None
+ *
+ * @return The cycle count, which must be passed to Deferred_Work_Top_Half_End.
+ */
+static inline uint32_t Deferred_Work_Top_Half_Begin()
+{
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief The Deferred_Work_Top_Half_End function ends the measurement of a top half and checks the budget.
+ *
+ * This function must be called at the end of the interrupt handler.
+ *
+ * @param isr The interrupt handler.
+ * @param start The value returned by Deferred_Work_Top_Half_Begin.
+ *
+ * @return None
+ */
+void Deferred_Work_Top_Half_End(Deferred_Work_ISR isr, uint32_t start);
+
+/**
+ * @brief The Deferred_Work_Get_Top_Half_Stats function returns the statistics of the top half of an interrupt handler.
+ *
+ * @param isr The interrupt handler.
+ * @param stats Pointer to the structure where the statistics will be stored.
+ *
+ * @return None
+ */
+void Deferred_Work_Get_Top_Half_Stats(Deferred_Work_ISR isr, Deferred_Work_Top_Half_Stats *stats);
+
+/**
+ * @brief The Deferred_Work_Reset function clears the statistics.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Deferred_Work_Reset();
+
+/**
+ * @brief The Deferred_Work_Dump function transmits the deferred work statistics via UART.
+ *
+ * The report contains the number of work items run, the dropped work items, the largest queue depth, the longest
+ * work item in CPU cycles, the top-half budget and, for each interrupt handler, the number of executions, the
+ * longest execution in CPU cycles and the number of overruns.
+ *
+ * @note The EUSCI_A0 UART module must be initialized before calling this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Deferred_Work_Dump();
+
+#endif /* INC_DEFERRED_WORK_H_ */
@@ -0,0 +1,189 @@
+/**
+ * @file Diff_Log.h
+ * @brief Header file for the Diff_Log module.
+ *
+ * This file contains the function definitions for the Diff_Log module.
+ *
+ * The Diff_Log module transmits a line via UART when the state of the LEDs or of the inputs changes, so that the
+ * behavior of the LED patterns can be followed on a terminal without a debugger. The GPIO functions record the
+ * values written by LED1_Output, LED2_Output, LED2_Toggle and PMOD_8LD_Output and the values read by
+ * Get_Buttons_Status and Get_PMOD_SWT_Status with DIFF_LOG_RECORD, which only compares the value with the
+ * previous one.
+ *
+ * Coalescing:
+ *  - The first change opens a window of window_ms milliseconds. The changes within the window are merged into
+ *    one line, which is built by Diff_Log_Update once the window has elapsed. The line contains the time in ms
+ *    since Diff_Log_Init, the signals that have changed with their new value in hexadecimal and, for a signal
+ *    that changed more than once, the number of changes, for example:
+ *        diff 12340 rgb=4 8ld=aa(x3)
+ *
+ * Bandwidth cap:
+ *  - The lines are limited to cap bytes per second by a token bucket that holds up to DIFF_LOG_BURST_BYTES.
+ *  - A line that would exceed the cap, or that does not fit into the transmit buffer, is dropped and counted.
+ *    Its changes stay pending and are merged into the next line, which is attempted one window later and ends
+ *    with the number of lines dropped before it ("drop=2"). The last line therefore always shows the current
+ *    state, whatever the rate of changes.
+ *
+ * Transmission:
+ *  - The lines are copied into a transmit buffer of DIFF_LOG_BUFFER_SIZE bytes, which the DMA controller writes
+ *    to the EUSCI_A0 transmit buffer (see DMA.h). Neither DIFF_LOG_RECORD nor Diff_Log_Update waits for the
+ *    UART, so logging does not delay the LED patterns: Diff_Log_Update only formats at most one line.
+ *  - The other modules transmit with the blocking EUSCI_A0_UART functions. To keep their output from being mixed
+ *    with a line, the UART commands must not be handled while Diff_Log_Is_Busy returns 1, and Diff_Log_Update
+ *    only starts a transfer when the transmit buffer of the UART is empty.
+ *
+ * The log is disabled by default. To enable it, define DIFF_LOG_ENABLE in the project build settings
+ * (Build > ARM Compiler > Predefined Symbols). When it is disabled, DIFF_LOG_RECORD expands to nothing and the
+ * Diff_Log functions are not defined.
+ *
+ * The following UART commands are registered (see UART_Command.h):
+ *  - 'd': Transmit the log statistics and drop counts (Diff_Log_Dump)
+ *  - 'D': Clear the statistics (Diff_Log_Reset)
+ *
+ */
+
+#ifndef INC_DIFF_LOG_H_
+#define INC_DIFF_LOG_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Default coalescing window in milliseconds
+ */
+#define DIFF_LOG_DEFAULT_WINDOW_MS      50
+
+/**
+ * @brief Default bandwidth cap in bytes per second (about 9% of the 11520 bytes per second of 115200 baud)
+ */
+#define DIFF_LOG_DEFAULT_CAP            1000
+
+/**
+ * @brief Largest number of bytes that can be transmitted at once after an idle period (token bucket size)
+ */
+#define DIFF_LOG_BURST_BYTES            256
+
+/**
+ * @brief Size of the transmit buffer in bytes (power of two)
+ */
+#define DIFF_LOG_BUFFER_SIZE            512
+
+/**
+ * @brief Signals of the log
+ */
+typedef enum
+{
+    DIFF_LOG_LED1,                  // Red LED (P1.0)
+    DIFF_LOG_LED2,                  // RGB LED (P2.0 - P2.2)
+    DIFF_LOG_PMOD_8LD,              // PMOD 8LD (P9)
+    DIFF_LOG_BUTTONS,               // User buttons (P1.1 and P1.4)
+    DIFF_LOG_SWITCHES,              // PMOD SWT (P10.0 - P10.3)
+    DIFF_LOG_NUM_SIGNALS
+} Diff_Log_Signal;
+
+/**
+ * @brief Log statistics
+ */
+typedef struct
+{
+    uint32_t lines;                 // Lines copied into the transmit buffer
+    uint32_t bytes;                 // Bytes of these lines
+    uint32_t changes;               // Changes of the signals in these lines
+    uint32_t coalesced;             // Changes that did not get a line of their own
+    uint32_t dropped_cap;           // Lines dropped by the bandwidth cap
+    uint32_t dropped_full;          // Lines dropped because the transmit buffer was full
+} Diff_Log_Stats;
+
+#ifdef DIFF_LOG_ENABLE
+
+#define DIFF_LOG_RECORD(signal, value)  Diff_Log_Record(signal, value)
+
+#else
+
+#define DIFF_LOG_RECORD(signal, value)
+
+#endif /* DIFF_LOG_ENABLE */
+
+/**
+ * @brief The Diff_Log_Init function starts the log.
+ *
+ * The current state of the signals is read from the GPIO functions and transmitted as the first line.
+ *
+ * @note The clock, the GPIO pins, the EUSCI_A0 UART module and the DMA controller (DMA_Init) must be initialized
+ * before calling this function.
+ *
+ * @param window_ms The coalescing window in milliseconds.
+ * @param cap The bandwidth cap in bytes per second (at least 1).
+ *
+ * @return None
+ */
+void Diff_Log_Init(uint32_t window_ms, uint32_t cap);
+
+/**
+ * @brief The Diff_Log_Record function records the value of a signal.
+ *
+ * Nothing is done unless the value differs from the previous value of the signal. It is safe to call from
+ * interrupt handlers with a priority level of CRITICAL_SECTION_GPIO or lower.
+ *
+ * @param signal The signal.
+ * @param value The value of the signal.
+ *
+ * @return None
+ */
+void Diff_Log_Record(Diff_Log_Signal signal, uint8_t value);
+
+/**
+ * @brief The Diff_Log_Update function builds the line of the pending changes once their window has elapsed, and
+ * starts the transmission of the buffered lines.
+ *
+ * This function must be called periodically, at least once per window. It does not wait for the UART.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Diff_Log_Update();
+
+/**
+ * @brief The Diff_Log_Is_Busy function indicates whether lines are waiting in the transmit buffer or being
+ * transmitted.
+ *
+ * @param None
+ *
+ * @return 1 if the UART must not be used by the blocking EUSCI_A0_UART functions, 0 otherwise.
+ */
+uint8_t Diff_Log_Is_Busy();
+
+/**
+ * @brief The Diff_Log_Get_Stats function returns the log statistics.
+ *
+ * @param stats Pointer to the structure where the statistics will be stored.
+ *
+ * @return None
+ */
+void Diff_Log_Get_Stats(Diff_Log_Stats *stats);
+
+/**
+ * @brief The Diff_Log_Reset function clears the log statistics.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Diff_Log_Reset();
+
+/**
+ * @brief The Diff_Log_Dump function transmits the log statistics via UART.
+ *
+ * The report contains the window, the cap, the number of lines, bytes and changes logged, the number of changes
+ * that were coalesced and the number of lines dropped by the cap and by a full transmit buffer.
+ *
+ * @note This function uses the blocking EUSCI_A0_UART functions (see Diff_Log_Is_Busy).
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Diff_Log_Dump();
+
+#endif /* INC_DIFF_LOG_H_ */
@@ -0,0 +1,134 @@
+/**
+ * @file Flash_Log.h
+ * @brief Header file for the Flash_Log driver.
+ *
+ * This file contains the function definitions for the Flash_Log driver.
+ *
+ * The Flash_Log driver stores the LED state (active pattern, input configuration and
+ * LED outputs) in the INFO flash memory so that it can be restored after a reset or
+ * a power cycle. The state is stored as an append-only log of 16-byte records in the
+ * two 4 KB sectors of INFO flash bank 1:
+ *  - Sector A: 0x00202000 - 0x00202FFF
+ *  - Sector B: 0x00203000 - 0x00203FFF
+ *
+ * New records are appended to the active sector. When the active sector is full, the other
+ * sector is erased and becomes the active sector. Each sector holds 256 records, so a sector
+ * is erased once every 256 saves and each sector is erased once every 512 saves.
+ *
+ * @note INFO flash bank 1 is the default location of the bootstrap loader (BSL).
+ * Using this driver erases the BSL. Programming and debugging through the XDS110
+ * debug probe on the LaunchPad is not affected. The linker command file leaves INFO bank 1 out of
+ * the memory map, so no section is placed in the sectors of the log.
+ *
+ * For more information regarding the Flash Controller (FLCTL), refer to the
+ * Flash Controller section of the MSP432Pxx Microcontrollers Technical Reference Manual.
+ *
+ */
+
+#ifndef INC_FLASH_LOG_H_
+#define INC_FLASH_LOG_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Start address of the first INFO flash sector used by the log
+ */
+#define FLASH_LOG_SECTOR_A      0x00202000
+
+/**
+ * @brief Start address of the second INFO flash sector used by the log
+ */
+#define FLASH_LOG_SECTOR_B      0x00203000
+
+/**
+ * @brief Size of each INFO flash sector in bytes
+ */
+#define FLASH_LOG_SECTOR_SIZE   0x1000
+
+/**
+ * @brief LED state that is stored in INFO flash
+ */
+typedef struct
+{
+    uint8_t pattern;            // Active LED pattern (see LED_Get_Active_Pattern)
+    uint8_t button_status;      // Button status that selected the pattern
+    uint8_t switch_status;      // Switch status that selected the pattern
+    uint8_t led1_value;         // Output of the built-in red LED
+    uint8_t rgb_led_value;      // Output of the RGB LED
+    uint8_t pmod_8ld_value;     // Output of the PMOD 8LD module
+} Flash_Log_State;
+
+/**
+ * @brief The Flash_Log_Init function finds the most recent valid record in INFO flash.
+ *
+ * This function scans both sectors for the valid record with the highest sequence number
+ * and for the next free location. Records with an invalid checksum (for example, a record
+ * that was interrupted by a power loss) are skipped. The number of CPU cycles spent
+ * is available from Flash_Log_Get_Restore_Cycles.
+ *
+ * @param None
+ *
+ * @return Indicates whether a valid record was found.
+ *  - 0: No valid record was found
+ *  - 1: A valid record was found
+ */
+uint8_t Flash_Log_Init();
+
+/**
+ * @brief The Flash_Log_Restore function copies the most recently saved state.
+ *
+ * @param state Pointer to the structure where the saved state will be stored.
+ *
+ * @return Indicates whether a saved state was available.
+ *  - 0: No saved state is available and state is not modified
+ *  - 1: The saved state has been copied to state
+ */
+uint8_t Flash_Log_Restore(Flash_Log_State *state);
+
+/**
+ * @brief The Flash_Log_Save function appends the state to the log in INFO flash.
+ *
+ * The record is not written if the state is identical to the most recently saved state.
+ * If the active sector is full, the other sector is erased before the record is written.
+ *
+ * @param state Pointer to the state to be saved.
+ *
+ * @return Indicates the result of the operation.
+ *  - 0: The state was written or did not need to be written
+ *  - 1: A flash program or erase error occurred
+ */
+uint8_t Flash_Log_Save(const Flash_Log_State *state);
+
+/**
+ * @brief The Flash_Log_Get_Restore_Cycles function returns the number of CPU cycles spent in Flash_Log_Init.
+ *
+ * @param None
+ *
+ * @return The number of CPU cycles spent scanning the log at boot.
+ */
+uint32_t Flash_Log_Get_Restore_Cycles();
+
+/**
+ * @brief The Flash_Log_Get_Erase_Count function returns the total number of sector erases performed by the log.
+ *
+ * The count is stored in every record, so it is preserved across resets.
+ *
+ * @param None
+ *
+ * @return The total number of sector erases.
+ */
+uint32_t Flash_Log_Get_Erase_Count();
+
+/**
+ * @brief The Flash_Log_Get_Save_Count function returns the number of records written since boot.
+ *
+ * Together with the uptime, this value gives the number of saves (and therefore erases) per day.
+ *
+ * @param None
+ *
+ * @return The number of records written since boot.
+ */
+uint32_t Flash_Log_Get_Save_Count();
+
+#endif /* INC_FLASH_LOG_H_ */
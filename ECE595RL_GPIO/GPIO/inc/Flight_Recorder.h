@@ -0,0 +1,186 @@
+/**
+ * @file Flight_Recorder.h
+ * @brief Header file for the Flight_Recorder module.
+ *
+ * This file contains the function definitions for the Flight_Recorder module.
+ *
+ * The flight recorder logs events (pattern changes, input events, clock transitions, UART errors,
+ * resets and faults) as 12-byte binary records in the .noinit section. Since the .noinit section is not
+ * initialized at boot, the records of the previous session are still available after a watchdog reset,
+ * a fault or a pin reset. They are lost after a power-on reset or a brown-out that drops SRAM.
+ *
+ * Two buffers are used. At boot, the buffer of the previous session is kept for reading and the other
+ * buffer is used to record the current session. Each buffer holds the most recent
+ * FLIGHT_RECORDER_SIZE records of its session.
+ *
+ * Flight_Recorder_Log is lock-free and can be called from any interrupt priority. A slot is reserved
+ * with an exclusive load/store (LDREX/STREX) on the write index and the record is written with three word stores.
+ * The slot is counted before the record is written, so the last store is the sequence number of the record,
+ * which publishes it. If a reset occurs between the reservation and that store, the slot still holds a record of
+ * an earlier lap of the buffer (or no record), whose sequence number does not match the slot; such a slot is
+ * skipped when the previous session is read. The number of CPU cycles of a call is measured by Flight_Recorder_Init
+ * (see Flight_Recorder_Get_Log_Cycles).
+ *
+ */
+
+#ifndef INC_FLIGHT_RECORDER_H_
+#define INC_FLIGHT_RECORDER_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Number of records in each buffer (must be a power of 2)
+ */
+#define FLIGHT_RECORDER_SIZE    256
+
+/**
+ * @brief Types of records logged by the flight recorder
+ */
+#define FLIGHT_RECORDER_BOOT                0x01    // arg8: reset source flags, arg16: HARDRESET_STAT
+#define FLIGHT_RECORDER_PATTERN_CHANGE      0x02    // arg8: new pattern, arg16: previous pattern
+#define FLIGHT_RECORDER_INPUT_EVENT         0x03    // arg8: button status, arg16: switch status
+#define FLIGHT_RECORDER_CLOCK_TRANSITION    0x04    // arg8: 0 = failed, 1 = success, arg16: frequency in effect in MHz
+#define FLIGHT_RECORDER_UART_ERROR          0x05    // arg8: EUSCI_A0 STATW, arg16: received character
+#define FLIGHT_RECORDER_DEEP_SLEEP_ENTER    0x06    // arg8: low-power mode (35 or 45)
+#define FLIGHT_RECORDER_DEEP_SLEEP_WAKE     0x07    // arg16: wake-up latency in CPU cycles (saturated)
+#define FLIGHT_RECORDER_FAULT               0x08    // arg8: UFSR (low byte), arg16: BFSR and MMFSR
+#define FLIGHT_RECORDER_ISR_OVERRUN         0x09    // arg8: interrupt handler (see Deferred_Work.h), arg16: top-half cycles (saturated)
+#define FLIGHT_RECORDER_TASK_OVERRUN        0x0A    // arg8: task (see Scheduler.h), arg16: response time in us (saturated)
+
+/**
+ * @brief Reset source flags stored in arg8 of a FLIGHT_RECORDER_BOOT record
+ */
+#define FLIGHT_RECORDER_RESET_SOFT          0x01
+#define FLIGHT_RECORDER_RESET_PSS           0x02
+#define FLIGHT_RECORDER_RESET_PCM           0x04
+#define FLIGHT_RECORDER_RESET_PIN           0x08
+#define FLIGHT_RECORDER_RESET_REBOOT        0x10
+#define FLIGHT_RECORDER_RESET_CS            0x20
+#define FLIGHT_RECORDER_RESET_COLD          0x80
+
+/**
+ * @brief Record stored by the flight recorder
+ */
+typedef struct
+{
+    uint32_t timestamp;     // DWT cycle counter value when the record was logged
+    uint32_t info;          // bits 0-7: type, bits 8-15: arg8, bits 16-31: arg16
+    uint32_t sequence;      // Number of records logged before this one in its session, plus one (0: not written)
+} Flight_Recorder_Record;
+
+/**
+ * @brief Control block of the flight recorder (stored in the .noinit section)
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t active;                            // Buffer used by the current session (0 or 1)
+    uint32_t check;                             // Complement of active
+    volatile uint32_t count[2];                 // Number of records logged in each buffer
+} Flight_Recorder_Control_Block;
+
+extern Flight_Recorder_Control_Block Flight_Recorder_Control;
+extern Flight_Recorder_Record Flight_Recorder_Buffer[2][FLIGHT_RECORDER_SIZE];
+extern Flight_Recorder_Record *Flight_Recorder_Active;
+extern volatile uint32_t *Flight_Recorder_Count;
+
+/**
+ * @brief The Flight_Recorder_Init function starts a new recording session.
+ *
+ * If the control block in the .noinit section is valid, the buffer of the previous session is kept
+ * for reading and the other buffer is cleared. Otherwise, both buffers are cleared. A FLIGHT_RECORDER_BOOT
+ * record with the reset source is then logged, with its cost in CPU cycles measured, and the reset status
+ * registers are cleared.
+ *
+ * This function must be called before Flight_Recorder_Log.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Flight_Recorder_Init();
+
+/**
+ * @brief The Flight_Recorder_Log function logs a record with the current cycle count.
+ *
+ * @param type The type of the record (FLIGHT_RECORDER_BOOT, FLIGHT_RECORDER_PATTERN_CHANGE, ...).
+ * @param arg8 An 8-bit argument whose meaning depends on the record type.
+ * @param arg16 A 16-bit argument whose meaning depends on the record type.
+ *
+ * @return None
+ */
+static inline void Flight_Recorder_Log(uint8_t type, uint8_t arg8, uint16_t arg16)
+{
+    uint32_t index;
+    volatile Flight_Recorder_Record *record;
+
+    // Reserve a slot; the store fails and is retried if an interrupt logged a record in between
+    do
+    {
+        index = __ldrex((void *)Flight_Recorder_Count);
+    } while (__strex(index + 1, (void *)Flight_Recorder_Count));
+
+    record = &Flight_Recorder_Active[index & (FLIGHT_RECORDER_SIZE - 1)];
+    record->timestamp = DWT->CYCCNT;
+    record->info = type | ((uint32_t)arg8 << 8) | ((uint32_t)arg16 << 16);
+
+    // Publish the record last (the stores are volatile, so they are not reordered)
+    record->sequence = index + 1;
+}
+
+/**
+ * @brief The Flight_Recorder_Get_Previous function returns the records of the previous session.
+ *
+ * The records are returned in the order in which they were logged. Slots that were counted but not written
+ * before the reset (see the sequence number of Flight_Recorder_Record) are skipped.
+ *
+ * @param records Pointer to the buffer where the records will be copied.
+ * @param max Maximum number of records to be copied.
+ *
+ * @return The number of records copied.
+ */
+uint32_t Flight_Recorder_Get_Previous(Flight_Recorder_Record *records, uint32_t max);
+
+/**
+ * @brief The Flight_Recorder_Dump_Previous function transmits the records of the previous session via UART.
+ *
+ * Each record is transmitted as one line with the following format:
+ *  <index> <timestamp (hex)> <type> <arg8 (hex)> <arg16 (hex)>
+ * Slots that were counted but not written are transmitted as "<index> unwritten". The report ends with the
+ * cost of Flight_Recorder_Log (see Flight_Recorder_Get_Log_Cycles).
+ *
+ * @note The EUSCI_A0 UART module must be initialized before calling this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Flight_Recorder_Dump_Previous();
+
+/**
+ * @brief The Flight_Recorder_Get_Log_Cycles function returns the cost of Flight_Recorder_Log.
+ *
+ * The cost is measured with the DWT cycle counter around the FLIGHT_RECORDER_BOOT record of Flight_Recorder_Init,
+ * including the two reads of the counter. The record is logged before the clock is changed, so the flash has no
+ * wait states and no interrupt is enabled.
+ *
+ * @param None
+ *
+ * @return The number of CPU cycles of the call.
+ */
+uint32_t Flight_Recorder_Get_Log_Cycles();
+
+/**
+ * @brief The Flight_Recorder_Fault_Handler function logs a FLIGHT_RECORDER_FAULT record and resets the device.
+ *
+ * This function is called by the HardFault handler. The MemManage, BusFault and UsageFault
+ * exceptions are not enabled, so these faults are escalated to a HardFault.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Flight_Recorder_Fault_Handler(void);
+
+#endif /* INC_FLIGHT_RECORDER_H_ */
@@ -93,8 +93,8 @@ uint8_t LED1_Status();
 /**
  * @brief The LED2_Init function initializes the RGB LED (P2.0 - P2.2).
  *
- * This function initializes the following RGB LED, configures the pins as GPIO pins with high drive strength,
- * and sets the direction of the pins as output. The RGB LED is off by default upon initialization.
+ * This function initializes the following RGB LED, configures the pins as GPIO pins with the drive strength
+ * selected for their load (see Pin_Power.h), and sets the direction of the pins as output. The RGB LED is off by default upon initialization.
  *  - RGBLED_RED      (P2.0)
  *  - RGBLED_GREEN    (P2.1)
  *  - RGBLED_BLUE     (P2.2)
@@ -201,7 +201,7 @@ uint8_t Get_Buttons_Status();
  * @brief The PMOD_8LD_Init function initializes the pins (P9.0 - P9.7) used by the Digilent PMOD 8LD module.
  *
  * This function initializes the pins, P9.0 through P9.7, which will be used to drive the eight
- * LEDs on the Digilent PMOD 8LD module. It configures the pins as GPIO output pins with high drive strength.
+ * LEDs on the Digilent PMOD 8LD module. It configures the pins as GPIO output pins with regular drive strength.
  *
  * The following connections must be made:
  *  - PMOD LED0   <-->  MSP432 LaunchPad Pin P9.0
@@ -237,6 +237,19 @@ void PMOD_8LD_Init();
  */
 uint8_t PMOD_8LD_Output(uint8_t led_value);
 
+/**
+ * @brief The PMOD_8LD_Status function indicates the status of the eight LEDs on the PMOD 8LD module
+ * located at pins P9.0 - P9.7.
+ *
+ * @param None
+ *
+ * @return uint8_t The value representing the status of the PMOD 8LD module. Each bit corresponds to one LED.
+ *         0: LED Off
+ *         1: LED On
+ *
+ */
+uint8_t PMOD_8LD_Status();
+
 /**
  * @brief The PMOD_SWT_Init function initializes the pins (P10.0 - P10.3) used by the Digilent PMOD SWT module.
  *
@@ -386,4 +399,61 @@ void LED_Pattern_5();
  */
 void LED_Controller(uint8_t button_status, uint8_t switch_status);
 
+/**
+ * @brief The LED_Controller_Step function runs the LED patterns of LED_Controller without blocking.
+ *
+ * Each call runs the code of LED_Controller up to its next delay and returns the length of that delay instead
+ * of waiting. The caller waits (for example with a timer, see Reactor.h) and then calls LED_Controller_Step again.
+ * The port writes and the switch reads are the same as those of LED_Controller, in the same order and separated
+ * by the same delays, so a loop of LED_Controller_Step and Clock_Delay1ms is equivalent to LED_Controller.
+ *
+ * When no pattern is running, LED_Controller_Step selects the pattern from button_status and switch_status like
+ * LED_Controller. While a pattern is running, the arguments are ignored and the running pattern reads the switches
+ * itself, like LED_Pattern_2 to LED_Pattern_5.
+ *
+ * @param button_status The status of the user buttons (see LED_Controller).
+ * @param switch_status The status of the switches on the PMOD SWT (see LED_Controller).
+ *
+ * @return The delay in milliseconds before the next call, or 0 when the pattern run is complete.
+ */
+uint32_t LED_Controller_Step(uint8_t button_status, uint8_t switch_status);
+
+/**
+ * @brief The LED_Controller_Resume function continues a pattern run from restored LED outputs.
+ *
+ * This function sets the active pattern and the position of LED_Controller_Step in the pattern from the outputs
+ * that the pattern had written before a reset (see Deep_Sleep_Resume and Flash_Log_Restore), so that the next call
+ * of LED_Controller_Step continues the run instead of starting it again. For example, the counter of LED_Pattern_2
+ * continues from the restored PMOD 8LD output. The outputs are not written.
+ *
+ * If the outputs do not match a delay of the pattern, no pattern is running and the next call of LED_Controller_Step
+ * starts a new run.
+ *
+ * @param pattern The restored active pattern (1 - 5).
+ * @param led1_value The restored output of the built-in red LED.
+ * @param rgb_led_value The restored output of the RGB LED.
+ * @param pmod_8ld_value The restored output of the PMOD 8LD module.
+ *
+ * @return The delay in milliseconds before the next call of LED_Controller_Step, or 0 if no pattern is running.
+ */
+uint32_t LED_Controller_Resume(uint8_t pattern, uint8_t led1_value, uint8_t rgb_led_value, uint8_t pmod_8ld_value);
+
+/**
+ * @brief The LED_Controller_Step_Is_Running function indicates whether LED_Controller_Step is in the middle of a pattern run.
+ *
+ * @param None
+ *
+ * @return 1 if the last call of LED_Controller_Step returned a delay, 0 otherwise.
+ */
+uint8_t LED_Controller_Step_Is_Running();
+
+/**
+ * @brief The LED_Get_Active_Pattern function returns the LED pattern most recently selected by LED_Controller.
+ *
+ * @param None
+ *
+ * @return The number of the active LED pattern (1 - 5).
+ */
+uint8_t LED_Get_Active_Pattern();
+
 #endif /* INC_GPIO_H_ */
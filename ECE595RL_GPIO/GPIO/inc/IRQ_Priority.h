@@ -0,0 +1,218 @@
+/**
+ * @file IRQ_Priority.h
+ * @brief Header file for the IRQ_Priority module.
+ *
+ * This file contains the function definitions for the IRQ_Priority module.
+ *
+ * The IRQ_Priority module holds the interrupt priority plan of the program: the priority grouping and the preempt
+ * priority and sub-priority of each interrupt source. The modules set the priority of their interrupts with
+ * IRQ_Priority_Apply instead of hard-coded values, so the relative order of the sources is decided in one table.
+ *
+ * Plan (level 0 is the highest priority):
+ *  - 0: ISR_Latency timer (TA2_0) and latency probe (TA0_0). Level 0 cannot be masked with BASEPRI.
+ *  - 1: PC_Sampler timer (TA3_0), above every critical section of the application.
+ *  - 2: Reactor timers (TA1_N), UART receive (EUSCIA0) and user buttons (PORT1), the kernel tick (SysTick) and
+ *       the WS2812 DMA completion (DMA_INT1). These handlers only post events, work items and release semaphores,
+ *       so they share one level and do not preempt each other. When several of them are pending, the NVIC takes
+ *       the lowest IRQ number first, so a timer expiry (IRQ 11) is taken before a received character (IRQ 16),
+ *       a DMA completion (IRQ 33) and a button edge (IRQ 35).
+ *  - 7: PendSV (context switch and deferred work), below every other handler.
+ *
+ * Grouping:
+ *  - The MSP432P401R implements 3 priority bits. IRQ_PRIORITY_PREEMPT_BITS of them are preempt priority bits and
+ *    the others are sub-priority bits. A sub-priority only orders pending interrupts of the same preempt level;
+ *    it never allows preemption.
+ *  - BASEPRI masks by preempt priority, so Critical_Section.h, REACTOR_PRIORITY and KERNEL_SYSCALL_PRIORITY
+ *    assume all 3 bits are preempt bits (the reset value). With fewer preempt bits, the levels in this file are
+ *    the preempt levels of the reduced range.
+ *
+ * Latency measurement:
+ *  - When IRQ_PRIORITY_MEASURE_ENABLE is defined in the project build settings (Build > ARM Compiler >
+ *    Predefined Symbols), the probe timer (Timer A0 from SMCLK) interrupts at level 0 at an arbitrary point of
+ *    the program, records DWT->CYCCNT and pends one of the measured sources with the NVIC software trigger
+ *    (STIR), in turn. The first statement of the handler of that source calls IRQ_Priority_Entry, which reads
+ *    DWT->CYCCNT again. The difference is the entry latency of the source under the current load: the higher-
+ *    priority handlers that run in between, the handler of the same or higher level that is active, and the
+ *    sections that mask the level with BASEPRI or PRIMASK.
+ *  - The measured latency includes the return from the probe handler and the exception entry of the source,
+ *    about 20 cycles, so the minimum of each source is the latency without interference.
+ *  - The trace pin (IRQ_PRIORITY_TRACE_PORT, IRQ_PRIORITY_TRACE_PIN) is set when the probe pends a source and
+ *    cleared at the entry of its handler, so the same latency can be checked with a logic analyzer.
+ *  - Only the handlers that tolerate an entry without their interrupt flag are measured (the reactor sources).
+ *    A source whose interrupt is disabled in the NVIC is skipped.
+ *
+ * The following UART commands are registered (see UART_Command.h):
+ *  - 'i': Transmit the priority plan and the latency statistics (IRQ_Priority_Dump)
+ *  - 'I': Clear the latency statistics (IRQ_Priority_Reset)
+ *
+ * For more information regarding the NVIC, refer to the Cortex-M4 Devices Generic User Guide.
+ *
+ */
+
+#ifndef INC_IRQ_PRIORITY_H_
+#define INC_IRQ_PRIORITY_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Number of preempt priority bits (0 to __NVIC_PRIO_BITS); the remaining bits are sub-priority bits
+ */
+#define IRQ_PRIORITY_PREEMPT_BITS       3
+
+/**
+ * @brief Preempt priority levels of the plan
+ */
+#define IRQ_PRIORITY_LEVEL_LATENCY      0
+#define IRQ_PRIORITY_LEVEL_SAMPLER      1
+#define IRQ_PRIORITY_LEVEL_EVENTS       2
+#define IRQ_PRIORITY_LEVEL_DEFERRED     7
+
+/**
+ * @brief Default period of the latency probe in SMCLK ticks (about 1 ms at 12 MHz). The period is prime so that
+ * the probe does not lock to the other periodic interrupts.
+ */
+#define IRQ_PRIORITY_PROBE_PERIOD       12011
+
+/**
+ * @brief Trace pin of the latency probe
+ */
+#define IRQ_PRIORITY_TRACE_PORT         P4
+#define IRQ_PRIORITY_TRACE_PIN          0
+
+/**
+ * @brief Interrupt sources of the plan
+ */
+typedef enum
+{
+    IRQ_PRIORITY_TA2_0,             // ISR_Latency timer
+    IRQ_PRIORITY_TA0_0,             // Latency probe
+    IRQ_PRIORITY_TA3_0,             // PC_Sampler timer
+    IRQ_PRIORITY_TA1_N,             // Reactor timers
+    IRQ_PRIORITY_EUSCIA0,           // Reactor UART receive
+    IRQ_PRIORITY_PORT1,             // Reactor user buttons
+    IRQ_PRIORITY_SYSTICK,           // Kernel tick
+    IRQ_PRIORITY_DMA_INT1,          // WS2812 DMA completion
+    IRQ_PRIORITY_PENDSV,            // Context switch and deferred work
+    IRQ_PRIORITY_NUM_SOURCES
+} IRQ_Priority_Source;
+
+/**
+ * @brief Entry latency statistics of a source
+ */
+typedef struct
+{
+    uint32_t count;                 // Number of measured entries
+    uint32_t min_cycles;            // Shortest latency in CPU cycles
+    uint32_t max_cycles;            // Longest latency in CPU cycles
+    uint64_t total_cycles;          // Sum of the latencies, for the average
+} IRQ_Priority_Latency_Stats;
+
+/**
+ * @brief The IRQ_Priority_Init function sets the priority grouping and clears the latency statistics.
+ *
+ * This function must be called before the other modules enable their interrupts.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void IRQ_Priority_Init();
+
+/**
+ * @brief The IRQ_Priority_Apply function sets the priority of an interrupt source according to the plan.
+ *
+ * @param source The interrupt source.
+ *
+ * @return None
+ */
+void IRQ_Priority_Apply(IRQ_Priority_Source source);
+
+/**
+ * @brief The IRQ_Priority_Probe_Start function starts the latency probe.
+ *
+ * Timer A0 is configured in up mode with SMCLK as the clock source, and the TA0_0 interrupt is enabled.
+ * The trace pin is configured as an output.
+ *
+ * @note The clock must be initialized before calling this function. Deep_Sleep_Enter stops the probe.
+ *
+ * @param period The number of SMCLK ticks between two probes (2 to 65536).
+ *
+ * @return None
+ */
+void IRQ_Priority_Probe_Start(uint32_t period);
+
+/**
+ * @brief The IRQ_Priority_Probe_Stop function stops Timer A0 and disables the TA0_0 interrupt.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void IRQ_Priority_Probe_Stop();
+
+/**
+ * @brief The IRQ_Priority_Record function completes the measurement of a probe.
+ *
+ * This function is called by IRQ_Priority_Entry and must not be called from anywhere else.
+ *
+ * @param source The interrupt source whose handler has been entered.
+ * @param entry_cycles The value of DWT->CYCCNT at the entry of the handler.
+ *
+ * @return None
+ */
+void IRQ_Priority_Record(IRQ_Priority_Source source, uint32_t entry_cycles);
+
+/**
+ * @brief The IRQ_Priority_Entry function marks the entry of an interrupt handler for the latency measurement.
+ *
+ * This function must be called at the start of the handler. It does nothing unless IRQ_PRIORITY_MEASURE_ENABLE
+ * is defined.
+ *
+ * @param source The interrupt source of the handler.
+ *
+ * @return None
+ */
+static inline void IRQ_Priority_Entry(IRQ_Priority_Source source)
+{
+#ifdef IRQ_PRIORITY_MEASURE_ENABLE
+    IRQ_Priority_Record(source, DWT->CYCCNT);
+#endif
+}
+
+/**
+ * @brief The IRQ_Priority_Get_Latency_Stats function returns the entry latency statistics of a source.
+ *
+ * @param source The interrupt source.
+ * @param stats Pointer to the structure where the statistics will be stored.
+ *
+ * @return None
+ */
+void IRQ_Priority_Get_Latency_Stats(IRQ_Priority_Source source, IRQ_Priority_Latency_Stats *stats);
+
+/**
+ * @brief The IRQ_Priority_Reset function clears the latency statistics.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void IRQ_Priority_Reset();
+
+/**
+ * @brief The IRQ_Priority_Dump function transmits the priority plan and the latency statistics via UART.
+ *
+ * The report contains the priority grouping, the number of probes that found the previous probe still pending
+ * and, for each source, its IRQ number, preempt priority and sub-priority as read back from the NVIC, whether it
+ * is enabled and, for the measured sources, the number of entries and the minimum, average and maximum latency
+ * in CPU cycles.
+ *
+ * @note The EUSCI_A0 UART module must be initialized before calling this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void IRQ_Priority_Dump();
+
+#endif /* INC_IRQ_PRIORITY_H_ */
@@ -0,0 +1,145 @@
+/**
+ * @file ISR_Latency.h
+ * @brief Header file for the ISR_Latency module.
+ *
+ * This file contains the function definitions for the ISR_Latency module.
+ *
+ * The ISR_Latency module measures the interrupt latency of the highest-priority interrupt (priority level 0).
+ * Timer A2 runs in up mode from SMCLK and requests the TA2_0 interrupt when the counter reaches TA2CCR0.
+ * The counter restarts from 0 at the same time, so the value of TA2R read at the start of the handler is
+ * the number of timer ticks between the interrupt request and the execution of the handler.
+ *
+ * Since priority level 0 cannot be masked with BASEPRI (see Critical_Section.h), the measured latency includes
+ * the exception entry, the completion of multi-cycle instructions, flash wait states and the PRIMASK windows
+ * of the application, but not the BASEPRI critical sections.
+ *
+ * The resolution of the measurement is one timer tick. With Clock_Init48MHz, SMCLK is 12 MHz and
+ * one tick corresponds to 4 CPU cycles.
+ *
+ * The measurement runs in windows of a given number of interrupts. Timer A2 is stopped at the end of each
+ * window, so the measurement does not wake up the CPU from the reactor (see Reactor.h) outside of a window and
+ * does not change the CPU utilisation and the sleep time reported by the reactor and LED_Energy. To find the
+ * worst-case latency under heavy use, start a window while the program is loaded (for example, with the WS2812
+ * strip and the diff log running and a burst of commands being received) and read the window when it has ended.
+ *
+ * The measurement is set up by main when ISR_LATENCY_ENABLE is defined in the project build settings.
+ * The following UART commands are registered (see UART_Command.h):
+ *  - 'a': Transmit the latency statistics of the last window (ISR_Latency_Dump)
+ *  - 'A': Start a window of ISR_LATENCY_DEFAULT_WINDOW interrupts (ISR_Latency_Start)
+ *
+ * For more information regarding Timer_A, refer to the Timer_A section of the
+ * MSP432Pxx Microcontrollers Technical Reference Manual.
+ *
+ */
+
+#ifndef INC_ISR_LATENCY_H_
+#define INC_ISR_LATENCY_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Default period between two interrupt requests in SMCLK ticks (100 us with the 12 MHz SMCLK)
+ */
+#define ISR_LATENCY_DEFAULT_PERIOD  1200
+
+/**
+ * @brief Default number of interrupts of a window (1 s with the default period)
+ */
+#define ISR_LATENCY_DEFAULT_WINDOW  10000
+
+/**
+ * @brief The ISR_Latency_Init function sets up the latency measurement without starting it.
+ *
+ * The period and the number of CPU cycles per timer tick are stored, the statistics are reset and the
+ * UART commands are registered. Timer A2 is stopped until ISR_Latency_Start is called.
+ *
+ * @note The clock must be initialized before calling this function. Deep_Sleep_Enter stops the measurement.
+ *
+ * @param period The number of SMCLK ticks between two interrupt requests (2 to 65536).
+ *
+ * @return None
+ */
+void ISR_Latency_Init(uint32_t period);
+
+/**
+ * @brief The ISR_Latency_Start function resets the statistics and starts a measurement window.
+ *
+ * Timer A2 is configured in up mode with SMCLK as the clock source, and the TA2_0 interrupt is enabled
+ * with priority level 0. The TA2_0 handler stops the timer after the given number of interrupts.
+ *
+ * @param count The number of interrupts of the window.
+ *
+ * @return None
+ */
+void ISR_Latency_Start(uint32_t count);
+
+/**
+ * @brief The ISR_Latency_Is_Running function indicates whether a measurement window has not ended.
+ *
+ * @param None
+ *
+ * @return 1 if Timer A2 is running, 0 otherwise.
+ */
+uint8_t ISR_Latency_Is_Running();
+
+/**
+ * @brief The ISR_Latency_Stop function stops Timer A2 and disables the TA2_0 interrupt, which ends the window.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void ISR_Latency_Stop();
+
+/**
+ * @brief The ISR_Latency_Reset function resets the latency statistics.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void ISR_Latency_Reset();
+
+/**
+ * @brief The ISR_Latency_Get_Max_Cycles function returns the worst-case latency measured since the last reset.
+ *
+ * @param None
+ *
+ * @return The maximum latency in CPU cycles.
+ */
+uint32_t ISR_Latency_Get_Max_Cycles();
+
+/**
+ * @brief The ISR_Latency_Get_Min_Cycles function returns the best-case latency measured since the last reset.
+ *
+ * @param None
+ *
+ * @return The minimum latency in CPU cycles or 0 if no interrupt has been measured.
+ */
+uint32_t ISR_Latency_Get_Min_Cycles();
+
+/**
+ * @brief The ISR_Latency_Get_Count function returns the number of interrupts measured since the last reset.
+ *
+ * @param None
+ *
+ * @return The number of measured interrupts.
+ */
+uint32_t ISR_Latency_Get_Count();
+
+/**
+ * @brief The ISR_Latency_Dump function transmits the latency statistics of the last window via UART.
+ *
+ * The report contains the number of measured interrupts, whether the window is still running, and the best-case
+ * and worst-case latency in CPU cycles and in nanoseconds.
+ *
+ * @note The EUSCI_A0 UART module must be initialized before calling this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void ISR_Latency_Dump();
+
+#endif /* INC_ISR_LATENCY_H_ */
@@ -0,0 +1,296 @@
+/**
+ * @file Kernel.h
+ * @brief Header file for the Kernel module.
+ *
+ * This file contains the function definitions for the Kernel module.
+ *
+ * The Kernel module is a small preemptive scheduler with fixed priorities. Each thread has a unique priority
+ * from 0 (highest) to KERNEL_IDLE_PRIORITY - 1, and the highest-priority thread that is ready always runs.
+ * A thread blocks on a semaphore, a queue or a delay, and is made ready again by another thread, an interrupt
+ * handler, a work item (see Deferred_Work.h) or the 1 ms SysTick tick. The idle thread has the lowest priority
+ * and runs the function passed to Kernel_Start (for example Reactor_Run, which sleeps when it has nothing to do).
+ *
+ * Threads:
+ *  - The thread control blocks and the stacks are static; there is no dynamic allocation. Declare the stack with
+ *    KERNEL_STACK, which aligns it on 8 bytes as required by the procedure call standard.
+ *  - Threads run in thread mode on the process stack (PSP). Interrupt handlers run on the main stack (MSP), which
+ *    Kernel_Start resets to the top of the .stack section, so a thread stack only holds the thread's own frames
+ *    and one exception frame.
+ *  - A thread that returns from its entry function is stopped, and its priority cannot be reused.
+ *
+ * Context switch:
+ *  - The scheduler pends PendSV, which has the lowest priority level (7), so the switch happens once all interrupt
+ *    handlers have completed. The PendSV handler first runs the deferred work items (Deferred_Work_Run) and then
+ *    saves R4-R11 of the current thread on its stack and restores those of the next thread.
+ *  - The FPU registers use lazy stacking (FPCCR.ASPEN and FPCCR.LSPEN are set after reset). S16-S31 are saved
+ *    only when the thread has used the FPU (bit 4 of EXC_RETURN is 0), and the hardware saves S0-S15 and FPSCR
+ *    only when the switch actually stores S16-S31, so threads that do not use the FPU switch at the integer cost.
+ *  - Estimated switch time at 48 MHz, from the Cortex-M4 instruction timings (not measured on the board, and the
+ *    flash wait states add to it): about 95 cycles (2 us) from the PendSV request to the first instruction of the
+ *    next thread when neither thread uses the FPU, and about 165 cycles (3.5 us) when both do.
+ *    Kernel_Dump reports the number of switches, so the switch overhead is switches * 95 cycles per second.
+ *
+ * RAM per thread:
+ *  - 28 bytes for the Kernel_Thread structure and 4 bytes for its entry in the priority table.
+ *  - The stack: the saved context takes 17 words (68 bytes) without the FPU and 51 words (204 bytes) with the FPU,
+ *    in addition to the deepest call chain of the thread. KERNEL_MIN_STACK_WORDS is the smallest stack accepted.
+ *    Kernel_Dump reports the stack usage of each thread (high-water mark of a fill pattern).
+ *
+ * Interrupt safety:
+ *  - The kernel data is protected by critical sections at priority level KERNEL_SYSCALL_PRIORITY (see
+ *    Critical_Section.h), so interrupt handlers with a higher priority (ISR_Latency, PC_Sampler) are never delayed
+ *    by the kernel, and must not call it.
+ *  - Kernel_Semaphore_Give and Kernel_Queue_Send can be called from interrupt handlers with a priority level from
+ *    KERNEL_SYSCALL_PRIORITY to 7 and from work items. The other functions are only called from threads.
+ *  - The blocking functions must not be called from the idle thread or inside a critical section.
+ *
+ * The kernel is disabled by default. To enable it, define KERNEL_ENABLE in the project build settings
+ * (Build > ARM Compiler > Predefined Symbols); main then runs the reactor in the idle thread.
+ *
+ * @note The Profiler table is not protected against concurrent updates, so the profiled functions should only be
+ * called from one thread while PROFILER_ENABLE is defined.
+ *
+ * The following UART command is registered (see UART_Command.h):
+ *  - 'k': Transmit the thread list (Kernel_Dump)
+ *
+ */
+
+#ifndef INC_KERNEL_H_
+#define INC_KERNEL_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "IRQ_Priority.h"
+
+/**
+ * @brief Number of priorities; the lowest one is reserved for the idle thread
+ */
+#define KERNEL_NUM_PRIORITIES       32
+#define KERNEL_IDLE_PRIORITY        (KERNEL_NUM_PRIORITIES - 1)
+
+/**
+ * @brief Highest interrupt priority level (see Critical_Section.h) of the handlers that call the kernel
+ */
+#define KERNEL_SYSCALL_PRIORITY     IRQ_PRIORITY_LEVEL_EVENTS
+
+/**
+ * @brief Frequency of the SysTick tick in Hz. Delays and timeouts are counted in ticks (milliseconds).
+ */
+#define KERNEL_TICK_HZ              1000
+
+/**
+ * @brief Timeout value that waits without a time limit
+ */
+#define KERNEL_WAIT_FOREVER         0xFFFFFFFF
+
+/**
+ * @brief Smallest thread stack in words (the saved context with the FPU plus a few call frames)
+ */
+#define KERNEL_MIN_STACK_WORDS      64
+
+/**
+ * @brief Stack of the idle thread in words (the size of the main stack, see msp432p401r.cmd)
+ */
+#define KERNEL_IDLE_STACK_WORDS     128
+
+/**
+ * @brief Declares a thread stack of the given number of 32-bit words, aligned on 8 bytes
+ */
+#define KERNEL_STACK(name, words)   static uint64_t name[((words) + 1) / 2]
+
+/**
+ * @brief Thread states
+ */
+#define KERNEL_STATE_READY          0
+#define KERNEL_STATE_BLOCKED        1
+#define KERNEL_STATE_STOPPED        2
+
+struct Kernel_Semaphore;
+
+/**
+ * @brief Thread control block
+ */
+typedef struct
+{
+    uint32_t *sp;                           // Saved stack pointer (must be the first member, see PendSV_Handler)
+    const char *name;
+    uint32_t *stack;                        // Lowest address of the stack
+    uint32_t stack_words;
+    uint32_t wake_tick;                     // Tick at which a delay or a timeout ends
+    struct Kernel_Semaphore *waiting;       // Semaphore the thread is waiting for, or 0
+    uint8_t priority;
+    uint8_t state;
+    uint8_t timed_out;                      // The last wait ended with a timeout
+} Kernel_Thread;
+
+/**
+ * @brief Counting semaphore
+ */
+typedef struct Kernel_Semaphore
+{
+    uint32_t count;
+    uint32_t max;
+    uint32_t waiters;                       // Bit p is set if the thread of priority p is waiting
+} Kernel_Semaphore;
+
+/**
+ * @brief Queue of 32-bit messages
+ */
+typedef struct
+{
+    Kernel_Semaphore items;                 // Counts the messages that have not been claimed by a receiver
+    uint32_t *buffer;
+    uint32_t size;
+    uint32_t count;                         // Messages in the buffer
+    uint32_t head;
+    uint32_t tail;
+} Kernel_Queue;
+
+/**
+ * @brief The Kernel_Init function clears the thread table.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Kernel_Init();
+
+/**
+ * @brief The Kernel_Thread_Create function creates a thread that is ready to run.
+ *
+ * Threads can be created before or after Kernel_Start. If the new thread has a higher priority than the
+ * calling thread, it runs immediately.
+ *
+ * @param thread Pointer to the thread control block (static).
+ * @param name The name shown by Kernel_Dump.
+ * @param entry The function run by the thread.
+ * @param argument The argument passed to entry.
+ * @param stack The stack, declared with KERNEL_STACK.
+ * @param stack_words The size of the stack in 32-bit words (at least KERNEL_MIN_STACK_WORDS).
+ * @param priority The priority (0 to KERNEL_IDLE_PRIORITY - 1), not used by another thread.
+ *
+ * @return Indicates whether the thread has been created.
+ *  - 0: The thread has been created
+ *  - 1: The priority is invalid or used, or the stack is too small
+ */
+uint8_t Kernel_Thread_Create(Kernel_Thread *thread, const char *name, void (*entry)(void *), void *argument,
+                             uint64_t *stack, uint32_t stack_words, uint8_t priority);
+
+/**
+ * @brief The Kernel_Start function starts the SysTick tick and the highest-priority thread.
+ *
+ * The calling code (main) is abandoned: its stack becomes the interrupt handler stack, and the idle thread
+ * runs the idle function.
+ *
+ * @param idle The function run by the idle thread. It must not return or block.
+ *
+ * @return This function does not return.
+ */
+void Kernel_Start(void (*idle)(void));
+
+/**
+ * @brief The Kernel_Delay function blocks the calling thread for a number of ticks.
+ *
+ * @param ticks The delay in ticks (milliseconds). The delay ends at the ticks-th tick interrupt, so it is
+ * between ticks - 1 and ticks milliseconds long.
+ *
+ * @return None
+ */
+void Kernel_Delay(uint32_t ticks);
+
+/**
+ * @brief The Kernel_Get_Ticks function returns the number of ticks since Kernel_Start.
+ *
+ * @param None
+ *
+ * @return The number of ticks.
+ */
+uint32_t Kernel_Get_Ticks();
+
+/**
+ * @brief The Kernel_Semaphore_Init function initializes a counting semaphore.
+ *
+ * @param semaphore Pointer to the semaphore.
+ * @param initial The initial count.
+ * @param max The largest count; further gives are ignored (1 for a binary semaphore).
+ *
+ * @return None
+ */
+void Kernel_Semaphore_Init(Kernel_Semaphore *semaphore, uint32_t initial, uint32_t max);
+
+/**
+ * @brief The Kernel_Semaphore_Take function decrements a semaphore, blocking while its count is 0.
+ *
+ * @param semaphore Pointer to the semaphore.
+ * @param timeout The longest wait in ticks, 0 to return immediately or KERNEL_WAIT_FOREVER.
+ *
+ * @return Indicates whether the semaphore has been taken.
+ *  - 0: The semaphore has been taken
+ *  - 1: The timeout has expired
+ */
+uint8_t Kernel_Semaphore_Take(Kernel_Semaphore *semaphore, uint32_t timeout);
+
+/**
+ * @brief The Kernel_Semaphore_Give function increments a semaphore or wakes up the highest-priority waiting thread.
+ *
+ * This function can be called from interrupt handlers (see the interrupt safety notes above).
+ *
+ * @param semaphore Pointer to the semaphore.
+ *
+ * @return None
+ */
+void Kernel_Semaphore_Give(Kernel_Semaphore *semaphore);
+
+/**
+ * @brief The Kernel_Queue_Init function initializes a message queue.
+ *
+ * @param queue Pointer to the queue.
+ * @param buffer The storage of the messages (static).
+ * @param size The number of messages of the buffer.
+ *
+ * @return None
+ */
+void Kernel_Queue_Init(Kernel_Queue *queue, uint32_t *buffer, uint32_t size);
+
+/**
+ * @brief The Kernel_Queue_Send function adds a message to a queue without blocking.
+ *
+ * This function can be called from interrupt handlers (see the interrupt safety notes above).
+ *
+ * @param queue Pointer to the queue.
+ * @param message The message.
+ *
+ * @return Indicates whether the message has been added.
+ *  - 0: The message has been added
+ *  - 1: The queue is full
+ */
+uint8_t Kernel_Queue_Send(Kernel_Queue *queue, uint32_t message);
+
+/**
+ * @brief The Kernel_Queue_Receive function removes the oldest message from a queue, blocking while it is empty.
+ *
+ * @param queue Pointer to the queue.
+ * @param message Pointer to the variable where the message will be stored.
+ * @param timeout The longest wait in ticks, 0 to return immediately or KERNEL_WAIT_FOREVER.
+ *
+ * @return Indicates whether a message has been received.
+ *  - 0: A message has been received
+ *  - 1: The timeout has expired
+ */
+uint8_t Kernel_Queue_Receive(Kernel_Queue *queue, uint32_t *message, uint32_t timeout);
+
+/**
+ * @brief The Kernel_Dump function transmits the thread list via UART.
+ *
+ * The report contains the number of ticks and context switches and, for each thread, its priority, state and
+ * stack usage in words.
+ *
+ * @note The EUSCI_A0 UART module must be initialized before calling this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Kernel_Dump();
+
+#endif /* INC_KERNEL_H_ */
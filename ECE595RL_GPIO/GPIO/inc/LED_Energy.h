@@ -0,0 +1,198 @@
+/**
+ * @file LED_Energy.h
+ * @brief Header file for the LED_Energy module.
+ *
+ * This file contains the function definitions for the LED_Energy module.
+ *
+ * The LED_Energy module estimates the charge drawn by the LEDs and the CPU. The GPIO output functions
+ * (LED1_Output, LED2_Output, LED2_Toggle and PMOD_8LD_Output) report every write to LED_Energy_Output,
+ * and the on-time of each LED pin is integrated with the DWT cycle counter. The CPU time is split into
+ * active time and sleep time (reported with LED_Energy_Sleep_Begin and LED_Energy_Sleep_End, see Reactor.h).
+ *
+ * The charge is the sum of the on-time of each pin multiplied by the current of the pin, plus the active
+ * and sleep time multiplied by the CPU currents. The charge is also accumulated per LED pattern:
+ * a pattern run starts when LED_Controller selects a pattern and ends when another pattern is selected.
+ *
+ * @note The default currents are nominal estimates, not measurements. For accurate figures, measure the
+ * current of each LED and of the CPU at the 3V3 jumper (JP8) of the LaunchPad and set them with
+ * LED_Energy_Set_Pin_Current and LED_Energy_Set_CPU_Current.
+ *
+ * The on-time is integrated over intervals of the DWT cycle counter, so LED_Energy_Update must be called
+ * at least once every 89 seconds (at 48 MHz). The stats task of main.c calls it every second.
+ *
+ */
+
+#ifndef INC_LED_ENERGY_H_
+#define INC_LED_ENERGY_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Number of LED pins: P1.0 (red LED), P2.0 - P2.2 (RGB LED) and P9.0 - P9.7 (PMOD 8LD)
+ */
+#define LED_ENERGY_NUM_PINS         12
+
+/**
+ * @brief Index of the first pin of each LED port
+ */
+#define LED_ENERGY_PIN_LED1         0
+#define LED_ENERGY_PIN_LED2         1
+#define LED_ENERGY_PIN_PMOD_8LD     4
+
+/**
+ * @brief Number of LED patterns (see LED_Controller)
+ */
+#define LED_ENERGY_NUM_PATTERNS     5
+
+/**
+ * @brief LED ports reported to LED_Energy_Output
+ */
+typedef enum
+{
+    LED_ENERGY_LED1,                // P1.0
+    LED_ENERGY_LED2,                // P2.0 - P2.2
+    LED_ENERGY_PMOD_8LD,            // P9.0 - P9.7
+    LED_ENERGY_NUM_PORTS
+} LED_Energy_Port;
+
+/**
+ * @brief Energy statistics of an LED pattern
+ */
+typedef struct
+{
+    uint32_t runs;                  // Number of runs of the pattern (including the current run)
+    uint64_t total_cycles;          // Duration of all runs in CPU cycles
+    uint64_t active_cycles;         // Part of total_cycles during which the CPU was not sleeping
+    uint64_t total_charge;          // Charge of all runs in uA * CPU cycles
+    uint64_t last_cycles;           // Duration of the last completed run in CPU cycles
+    uint64_t last_charge;           // Charge of the last completed run in uA * CPU cycles
+} LED_Energy_Pattern_Stats;
+
+/**
+ * @brief The LED_Energy_Init function clears the statistics and reads the current LED outputs.
+ *
+ * The following UART command is registered (see UART_Command.h):
+ *  - 'e': Transmit the energy report (LED_Energy_Dump)
+ *
+ * @param None
+ *
+ * @return None
+ */
+void LED_Energy_Init();
+
+/**
+ * @brief The LED_Energy_Set_Pin_Current function sets the current drawn by an LED pin when it is on.
+ *
+ * @param pin The index of the pin (LED_ENERGY_PIN_LED1, LED_ENERGY_PIN_LED2 + 0 to 2, LED_ENERGY_PIN_PMOD_8LD + 0 to 7).
+ * @param current_uA The current in microamperes.
+ *
+ * @return None
+ */
+void LED_Energy_Set_Pin_Current(uint8_t pin, uint32_t current_uA);
+
+/**
+ * @brief The LED_Energy_Set_CPU_Current function sets the current drawn by the device in active mode and in sleep mode.
+ *
+ * @param active_uA The current in active mode in microamperes.
+ * @param sleep_uA The current in sleep mode in microamperes.
+ *
+ * @return None
+ */
+void LED_Energy_Set_CPU_Current(uint32_t active_uA, uint32_t sleep_uA);
+
+/**
+ * @brief The LED_Energy_Output function reports a write to an LED port.
+ *
+ * This function is called by the GPIO output functions after the port has been written.
+ *
+ * @param port The LED port that has been written.
+ * @param value The new output value of the LED pins of the port (bit 0 is the first pin of the port).
+ *
+ * @return None
+ */
+void LED_Energy_Output(LED_Energy_Port port, uint8_t value);
+
+/**
+ * @brief The LED_Energy_Sleep_Begin function reports that the CPU is about to enter sleep mode.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void LED_Energy_Sleep_Begin();
+
+/**
+ * @brief The LED_Energy_Sleep_End function reports that the CPU has left sleep mode.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void LED_Energy_Sleep_End();
+
+/**
+ * @brief The LED_Energy_Set_Pattern function starts a run of an LED pattern.
+ *
+ * This function is called by LED_Controller when the active pattern changes.
+ *
+ * @param pattern The LED pattern (1 to LED_ENERGY_NUM_PATTERNS).
+ *
+ * @return None
+ */
+void LED_Energy_Set_Pattern(uint8_t pattern);
+
+/**
+ * @brief The LED_Energy_Update function integrates the on-time and the CPU time up to now.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void LED_Energy_Update();
+
+/**
+ * @brief The LED_Energy_Get_Pin_On_Cycles function returns the on-time of an LED pin.
+ *
+ * @param pin The index of the pin.
+ *
+ * @return The on-time in CPU cycles.
+ */
+uint64_t LED_Energy_Get_Pin_On_Cycles(uint8_t pin);
+
+/**
+ * @brief The LED_Energy_Get_Total_uAh function returns the estimated charge since LED_Energy_Init.
+ *
+ * @param None
+ *
+ * @return The charge in microampere-hours.
+ */
+uint32_t LED_Energy_Get_Total_uAh();
+
+/**
+ * @brief The LED_Energy_Get_Pattern_Stats function returns the energy statistics of an LED pattern.
+ *
+ * @param pattern The LED pattern (1 to LED_ENERGY_NUM_PATTERNS).
+ * @param stats Pointer to the structure where the statistics will be stored.
+ *
+ * @return None
+ */
+void LED_Energy_Get_Pattern_Stats(uint8_t pattern, LED_Energy_Pattern_Stats *stats);
+
+/**
+ * @brief The LED_Energy_Dump function transmits the energy report via UART.
+ *
+ * The report contains the total charge, the CPU active and sleep time, and for each pattern the number
+ * of runs, the charge of all runs, the CPU utilisation and average current over all runs, and the charge
+ * and duration of the last completed run. Charges are transmitted in microampere-hours, durations in
+ * milliseconds, the CPU utilisation in per mille and the average current in microamperes.
+ *
+ * @note The EUSCI_A0 UART module must be initialized before calling this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void LED_Energy_Dump();
+
+#endif /* INC_LED_ENERGY_H_ */
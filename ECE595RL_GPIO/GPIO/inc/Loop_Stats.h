@@ -0,0 +1,136 @@
+/**
+ * @file Loop_Stats.h
+ * @brief Header file for the Loop_Stats module.
+ *
+ * This file contains the function definitions for the Loop_Stats module.
+ *
+ * The Loop_Stats module measures the period of the main loop with the DWT cycle counter and
+ * the time spent in each phase of an iteration. The main loop calls Loop_Stats_Begin at the start
+ * of each iteration and Loop_Stats_Mark at the end of each phase:
+ *  while(1)
+ *  {
+ *      Loop_Stats_Begin();
+ *      ...read the inputs...
+ *      Loop_Stats_Mark(LOOP_STATS_INPUT);
+ *      ...
+ *  }
+ *
+ * The time between the last Loop_Stats_Mark and the next Loop_Stats_Begin is added to LOOP_STATS_OTHER.
+ *
+ * The periods are counted in a log-linear histogram: each power of two is divided into 8 buckets,
+ * so the percentiles are accurate to 12.5%. The minimum, maximum and mean are exact.
+ *
+ */
+
+#ifndef INC_LOOP_STATS_H_
+#define INC_LOOP_STATS_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Phases of an iteration of the main loop
+ */
+typedef enum
+{
+    LOOP_STATS_INPUT,               // Reading the buttons and switches
+    LOOP_STATS_CONTROLLER,          // LED_Controller, including the delays of the LED patterns
+    LOOP_STATS_DELAY,               // Delay at the end of the iteration
+    LOOP_STATS_OTHER,               // Saving the state, deep sleep policy, UART commands
+    LOOP_STATS_NUM_PHASES
+} Loop_Stats_Phase;
+
+/**
+ * @brief Summary of the loop period statistics
+ */
+typedef struct
+{
+    uint32_t count;                                 // Number of measured periods
+    uint32_t min_cycles;                            // Shortest period
+    uint32_t max_cycles;                            // Longest period
+    uint32_t mean_cycles;                           // Mean period
+    uint32_t p50_cycles;                            // Median period
+    uint32_t p90_cycles;                            // 90th percentile of the period
+    uint32_t p99_cycles;                            // 99th percentile of the period
+    uint32_t jitter_cycles;                         // Difference between the 99th percentile and the median
+    uint32_t budget_cycles;                         // Period budget (0 if not set)
+    uint32_t overruns;                              // Number of periods longer than the budget
+    uint16_t phase_permille[LOOP_STATS_NUM_PHASES]; // Share of the time spent in each phase (per mille)
+} Loop_Stats_Summary;
+
+/**
+ * @brief The Loop_Stats_Init function clears the statistics.
+ *
+ * The following UART commands are registered (see UART_Command.h):
+ *  - 'l': Transmit the summary (Loop_Stats_Dump)
+ *  - 'L': Clear the statistics (Loop_Stats_Reset)
+ *
+ * @param budget_cycles The period budget in CPU cycles. Set to 0 to disable the overrun count.
+ *
+ * @return None
+ */
+void Loop_Stats_Init(uint32_t budget_cycles);
+
+/**
+ * @brief The Loop_Stats_Reset function clears the statistics. The period budget is not changed.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Loop_Stats_Reset();
+
+/**
+ * @brief The Loop_Stats_Set_Budget function sets the period budget and clears the overrun count.
+ *
+ * @param budget_cycles The period budget in CPU cycles. Set to 0 to disable the overrun count.
+ *
+ * @return None
+ */
+void Loop_Stats_Set_Budget(uint32_t budget_cycles);
+
+/**
+ * @brief The Loop_Stats_Begin function marks the start of an iteration of the main loop.
+ *
+ * The period since the previous call is recorded, except after Loop_Stats_Init or Loop_Stats_Reset.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Loop_Stats_Begin();
+
+/**
+ * @brief The Loop_Stats_Mark function marks the end of a phase of the current iteration.
+ *
+ * The time since the previous Loop_Stats_Mark or Loop_Stats_Begin call is added to the phase.
+ *
+ * @param phase The phase that has just ended.
+ *
+ * @return None
+ */
+void Loop_Stats_Mark(Loop_Stats_Phase phase);
+
+/**
+ * @brief The Loop_Stats_Get_Summary function computes the summary of the statistics.
+ *
+ * @param summary Pointer to the structure where the summary will be stored.
+ *
+ * @return None
+ */
+void Loop_Stats_Get_Summary(Loop_Stats_Summary *summary);
+
+/**
+ * @brief The Loop_Stats_Dump function transmits the summary via UART.
+ *
+ * The periods are transmitted in microseconds and the phase shares in per mille.
+ *
+ * @note The EUSCI_A0 UART module must be initialized before calling this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Loop_Stats_Dump();
+
+#endif /* INC_LOOP_STATS_H_ */
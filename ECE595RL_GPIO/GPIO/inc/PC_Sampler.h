@@ -0,0 +1,107 @@
+/**
+ * @file PC_Sampler.h
+ * @brief Header file for the PC_Sampler module.
+ *
+ * This file contains the function definitions for the PC_Sampler module.
+ *
+ * The PC_Sampler module is a statistical profiler. Timer A3 periodically requests the TA3_0 interrupt,
+ * and the handler reads the program counter (PC) that was stacked on exception entry, which is the address
+ * of the instruction that was interrupted. The samples are counted in a histogram of fixed-size address ranges
+ * (buckets) covering the .text section. Samples outside of the .text section (for example, in ROM or SRAM)
+ * are counted separately.
+ *
+ * The bucket size is the smallest power of two for which PC_SAMPLER_NUM_BUCKETS buckets cover the .text section.
+ * The histogram is transmitted via UART by PC_Sampler_Dump, and the host script
+ * ECE595RL_GPIO/tools/pc_sample_resolve.py resolves the buckets to function names using the
+ * map file generated by the linker (GPIO.map).
+ *
+ * The PC sampler is started by main when PC_SAMPLER_ENABLE is defined in the project build settings.
+ *
+ * The TA3_0 interrupt has priority level 1 (IRQ_PRIORITY_LEVEL_SAMPLER), above the CRITICAL_SECTION_GPIO and
+ * kernel critical sections (see Critical_Section.h), so the samples inside these sections are taken on time.
+ *
+ * For more information regarding the exception stack frame, refer to the Cortex-M4 Devices Generic User Guide.
+ *
+ */
+
+#ifndef INC_PC_SAMPLER_H_
+#define INC_PC_SAMPLER_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Number of buckets in the histogram
+ */
+#define PC_SAMPLER_NUM_BUCKETS      512
+
+/**
+ * @brief Default sampling period in SMCLK ticks (about 1 kHz with the 12 MHz SMCLK)
+ *
+ * The period is not a multiple of 1 ms so that the samples do not lock to the delays of the main loop.
+ */
+#define PC_SAMPLER_DEFAULT_PERIOD   12007
+
+/**
+ * @brief The PC_Sampler_Init function clears the histogram and starts sampling.
+ *
+ * Timer A3 is configured in up mode with SMCLK as the clock source, and the TA3_0 interrupt
+ * is enabled with priority level 1. The following UART commands are registered (see UART_Command.h):
+ *  - 's': Transmit the histogram (PC_Sampler_Dump)
+ *  - 'c': Clear the histogram (PC_Sampler_Reset)
+ *
+ * @note The clock must be initialized before calling this function. Deep_Sleep_Enter stops the sampling.
+ *
+ * @param period The number of SMCLK ticks between two samples (2 to 65536).
+ *
+ * @return None
+ */
+void PC_Sampler_Init(uint32_t period);
+
+/**
+ * @brief The PC_Sampler_Stop function stops Timer A3 and disables the TA3_0 interrupt.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void PC_Sampler_Stop();
+
+/**
+ * @brief The PC_Sampler_Reset function clears the histogram.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void PC_Sampler_Reset();
+
+/**
+ * @brief The PC_Sampler_Get_Total function returns the number of samples taken since the last reset.
+ *
+ * @param None
+ *
+ * @return The number of samples.
+ */
+uint32_t PC_Sampler_Get_Total();
+
+/**
+ * @brief The PC_Sampler_Dump function transmits the histogram via UART.
+ *
+ * The histogram is transmitted with the following format (all values except shift are hexadecimal):
+ *  PC sampler: base=<start of .text> shift=<log2 of the bucket size> total=<samples> other=<samples outside .text>
+ *  <start address of the bucket> <samples>
+ *  ...
+ *  PC sampler: end
+ *
+ * Only the non-empty buckets are transmitted. Sampling is paused during the dump.
+ *
+ * @note The EUSCI_A0 UART module must be initialized before calling this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void PC_Sampler_Dump();
+
+#endif /* INC_PC_SAMPLER_H_ */
@@ -0,0 +1,179 @@
+/**
+ * @file Perf_Counter.h
+ * @brief Header file for the Perf_Counter module.
+ *
+ * This file contains the function definitions for the Perf_Counter module.
+ *
+ * The Perf_Counter module is a registry of named 32-bit event counters. The counters are declared in
+ * PERF_COUNTERS below and are stored in a single array placed in the .perf_counters section,
+ * so a snapshot of all counters is a single memcpy.
+ *
+ * Perf_Counter_Increment and Perf_Counter_Add update a counter with an exclusive load/store (LDREX/STREX),
+ * so they can be called from any interrupt priority without masking interrupts.
+ *
+ * Perf_Counter_Update computes the rate of each counter (events per second) at most once per second. It should
+ * be called once per iteration of the main loop. The rates are computed over the time between two updates,
+ * which must be shorter than the period of the DWT cycle counter (89 seconds at 48 MHz).
+ *
+ * To add a counter, add an entry to PERF_COUNTERS and call Perf_Counter_Increment(PERF_COUNTER_<id>)
+ * where the event occurs.
+ *
+ */
+
+#ifndef INC_PERF_COUNTER_H_
+#define INC_PERF_COUNTER_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief List of the counters
+ *
+ * Each entry defines an identifier (PERF_COUNTER_<id>) and the name printed by Perf_Counter_Dump.
+ */
+#define PERF_COUNTERS(X)                                            \
+    X(PORT_WRITES,              "port_writes")                      \
+    X(PORT_WRITES_ELIDED,       "port_writes_elided")               \
+    X(UART_BYTES_IN,            "uart_bytes_in")                    \
+    X(UART_BYTES_OUT,           "uart_bytes_out")                   \
+    X(UART_ERRORS,              "uart_errors")                      \
+    X(LOOP_OVERRUNS,            "loop_overruns")                    \
+    X(PATTERN_FRAMES,           "pattern_frames")                   \
+    X(INPUT_EVENTS,             "input_events")                     \
+    X(WAKE_UPS,                 "wake_ups")                         \
+    X(FLASH_SAVES,              "flash_saves")
+
+#define PERF_COUNTER_ID(id, name)   PERF_COUNTER_##id,
+
+/**
+ * @brief Identifiers of the counters
+ */
+typedef enum
+{
+    PERF_COUNTERS(PERF_COUNTER_ID)
+    PERF_COUNTER_NUM_COUNTERS
+} Perf_Counter_Id;
+
+#undef PERF_COUNTER_ID
+
+extern volatile uint32_t Perf_Counter_Values[PERF_COUNTER_NUM_COUNTERS];
+
+/**
+ * @brief The Perf_Counter_Add function adds a value to a counter.
+ *
+ * @param id The identifier of the counter.
+ * @param value The value to be added.
+ *
+ * @return None
+ */
+static inline void Perf_Counter_Add(Perf_Counter_Id id, uint32_t value)
+{
+    volatile uint32_t *counter = &Perf_Counter_Values[id];
+    uint32_t count;
+
+    // The store fails and is retried if an interrupt updated a counter in between
+    do
+    {
+        count = __ldrex((void *)counter);
+    } while (__strex(count + value, (void *)counter));
+}
+
+/**
+ * @brief The Perf_Counter_Increment function adds one to a counter.
+ *
+ * @param id The identifier of the counter.
+ *
+ * @return None
+ */
+static inline void Perf_Counter_Increment(Perf_Counter_Id id)
+{
+    Perf_Counter_Add(id, 1);
+}
+
+/**
+ * @brief The Perf_Counter_Get function returns the value of a counter.
+ *
+ * @param id The identifier of the counter.
+ *
+ * @return The value of the counter.
+ */
+static inline uint32_t Perf_Counter_Get(Perf_Counter_Id id)
+{
+    return Perf_Counter_Values[id];
+}
+
+/**
+ * @brief The Perf_Counter_Init function clears the counters and the rates.
+ *
+ * The following UART commands are registered (see UART_Command.h):
+ *  - 'n': Transmit the counters in text format (Perf_Counter_Dump)
+ *  - 'N': Transmit the counters in binary format (Perf_Counter_Dump_Binary)
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Perf_Counter_Init();
+
+/**
+ * @brief The Perf_Counter_Snapshot function copies the values of all counters.
+ *
+ * The counters are copied with a single memcpy, so the copy is not atomic across counters.
+ *
+ * @param values Pointer to an array of PERF_COUNTER_NUM_COUNTERS elements.
+ *
+ * @return None
+ */
+void Perf_Counter_Snapshot(uint32_t *values);
+
+/**
+ * @brief The Perf_Counter_Update function computes the rates if at least one second has elapsed since the last update.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Perf_Counter_Update();
+
+/**
+ * @brief The Perf_Counter_Get_Rate function returns the rate of a counter computed by Perf_Counter_Update.
+ *
+ * @param id The identifier of the counter.
+ *
+ * @return The rate of the counter in events per second.
+ */
+uint32_t Perf_Counter_Get_Rate(Perf_Counter_Id id);
+
+/**
+ * @brief The Perf_Counter_Dump function transmits the counters via UART in text format.
+ *
+ * Each counter is transmitted as one line with the following format:
+ *  <name> <value> <rate>/s
+ *
+ * @note The EUSCI_A0 UART module must be initialized before calling this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Perf_Counter_Dump();
+
+/**
+ * @brief The Perf_Counter_Dump_Binary function transmits the counters via UART in binary format.
+ *
+ * The frame has the following layout (multi-byte fields are little-endian):
+ *  - 2 bytes: Start of frame (0xA5, 0x5A)
+ *  - 1 byte: Number of counters (N)
+ *  - N * 4 bytes: Values of the counters, in the order of PERF_COUNTERS
+ *  - N * 4 bytes: Rates of the counters in events per second
+ *  - 2 bytes: CRC-16/CCITT-FALSE of the number of counters, the values and the rates (see CRC16.h)
+ *
+ * @note The EUSCI_A0 UART module must be initialized before calling this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Perf_Counter_Dump_Binary();
+
+#endif /* INC_PERF_COUNTER_H_ */
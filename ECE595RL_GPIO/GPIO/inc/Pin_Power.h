@@ -0,0 +1,72 @@
+/**
+ * @file Pin_Power.h
+ * @brief Header file for the Pin_Power driver.
+ *
+ * This file contains the function definitions for the Pin_Power driver.
+ *
+ * After reset, every pin of the MSP432P401R is a general-purpose input without a pull resistor. A floating input
+ * drifts to intermediate voltages, where both transistors of its input buffer conduct, so each unused pin can draw
+ * a leakage current in active mode and in LPM3, LPM4, LPM3.5 and LPM4.5. Pin_Power_Init gives every pin that is
+ * not used by the program a defined level:
+ *  - Output low: the pins that are not connected to anything that can drive them.
+ *  - Input with pull-down resistor: P10.4 and P10.5. Port 10 is the input port of the PMOD SWT, so its unused
+ *    pins stay inputs and cannot be shorted by a module that drives them.
+ *
+ * The following pins are not changed:
+ *  - P1.0 (red LED), P1.1 and P1.4 (user buttons), P1.2 and P1.3 (UART)
+ *  - P2.0 - P2.2 (RGB LED), P9.0 - P9.7 (PMOD 8LD), P10.0 - P10.3 (PMOD SWT)
+ *  - PJ.2 and PJ.3 (HFXT crystal), PJ.4 and PJ.5 (JTAG TDI and TDO/SWO)
+ * The LED and input pins are configured by their own Init functions (see GPIO.h). The IRQ_Priority trace pin
+ * (P4.0) is an output low until IRQ_Priority_Probe_Start is called.
+ *
+ * Drive strength:
+ *  - The drive strength of an output is selected from the current of its load with PIN_POWER_DRIVE. The high drive
+ *    strength only lowers the output resistance; it is only needed when the load draws more than the regular drive
+ *    can supply, and it makes the edges faster and noisier. Only P2.0 - P2.3 have the high drive strength.
+ *  - The loads below are nominal estimates (the same LED current as the defaults of LED_Energy), not measurements.
+ *
+ * @note The current saved by Pin_Power_Init should be measured on the LaunchPad by comparing the current at the
+ * 3V3 jumper (JP8) with Pin_Power_Init called and not called, in active mode and in LPM3.5. It has not been measured.
+ *
+ * For more information regarding the unused pins and the drive strength, refer to the Digital I/O section of the
+ * MSP432Pxx Microcontrollers Technical Reference Manual and the MSP432P401R datasheet.
+ *
+ */
+
+#ifndef INC_PIN_POWER_H_
+#define INC_PIN_POWER_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Largest load in microamperes for the regular drive strength
+ */
+#define PIN_POWER_REGULAR_DRIVE_MAX_UA  6000
+
+/**
+ * @brief Load of each output pin in microamperes
+ */
+#define PIN_POWER_LOAD_LED1_UA          3000    // Red LED, driven through its series resistor
+#define PIN_POWER_LOAD_LED2_UA          3000    // Each color of the RGB LED, driven through its series resistor
+#define PIN_POWER_LOAD_PMOD_8LD_UA      100     // Input of the transistor that drives each LED of the PMOD 8LD
+
+/**
+ * @brief Returns the PxDS bits of the pins in mask for a load in microamperes: set (high drive strength) only if
+ * the load is larger than the regular drive strength can supply
+ */
+#define PIN_POWER_DRIVE(load_uA, mask)  (((load_uA) > PIN_POWER_REGULAR_DRIVE_MAX_UA) ? (mask) : 0)
+
+/**
+ * @brief The Pin_Power_Init function configures the pins that are not used by the program.
+ *
+ * This function should be called at the start of main, before the pins are unlocked after a wake-up from
+ * LPM3.5 or LPM4.5 (see Deep_Sleep_Resume), so that the unused pins keep a defined level at all times.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Pin_Power_Init();
+
+#endif /* INC_PIN_POWER_H_ */
@@ -0,0 +1,124 @@
+/**
+ * @file Port_Trace.h
+ * @brief Header file for the Port_Trace module.
+ *
+ * This file contains the function definitions for the Port_Trace module.
+ *
+ * The Port_Trace module records every write to the LED output ports (P1, P2 and P9) with the DWT cycle
+ * counter, so that the timing of the LED patterns can be compared against golden waveforms with
+ * tools/trace_compare.py. The same module runs on the target and in the host simulation (see GPIO_Host).
+ *
+ * The records are stored in a FIFO of PORT_TRACE_SIZE entries. When the FIFO is full, new records are
+ * dropped and counted as lost, so that a trace always starts at Port_Trace_Init without gaps.
+ *
+ * The trace is disabled by default. To enable it, define PORT_TRACE_ENABLE in the project build settings
+ * (Build > ARM Compiler > Predefined Symbols). When it is disabled, PORT_TRACE_LOG expands to nothing
+ * and the Port_Trace functions are not defined.
+ *
+ */
+
+#ifndef INC_PORT_TRACE_H_
+#define INC_PORT_TRACE_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Number of records in the FIFO (8 bytes each)
+ */
+#ifndef PORT_TRACE_SIZE
+#define PORT_TRACE_SIZE     256
+#endif
+
+/**
+ * @brief Record of a port write
+ */
+typedef struct
+{
+    uint32_t timestamp;     // DWT->CYCCNT after the write
+    uint8_t port;           // Port number (1 to 10)
+    uint8_t value;          // Value of the OUT register after the write
+    uint16_t reserved;
+} Port_Trace_Entry;
+
+#ifdef PORT_TRACE_ENABLE
+
+#define PORT_TRACE_LOG(port, value)     Port_Trace_Log(port, value)
+
+#else
+
+#define PORT_TRACE_LOG(port, value)
+
+#endif /* PORT_TRACE_ENABLE */
+
+/**
+ * @brief The Port_Trace_Init function clears the trace.
+ *
+ * The following UART commands are registered (see UART_Command.h):
+ *  - 't': Transmit the trace and remove the transmitted records (Port_Trace_Dump)
+ *  - 'T': Clear the trace (Port_Trace_Reset)
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Port_Trace_Init();
+
+/**
+ * @brief The Port_Trace_Reset function removes every record and clears the number of lost records.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Port_Trace_Reset();
+
+/**
+ * @brief The Port_Trace_Log function records a port write.
+ *
+ * It is safe to call from interrupt handlers with a priority level of CRITICAL_SECTION_GPIO or lower.
+ *
+ * @param port The port number (1 to 10).
+ * @param value The value of the OUT register after the write.
+ *
+ * @return None
+ */
+void Port_Trace_Log(uint8_t port, uint8_t value);
+
+/**
+ * @brief The Port_Trace_Read function removes the oldest records from the trace.
+ *
+ * @param entries Pointer to the array that receives the records.
+ * @param max The maximum number of records to read.
+ *
+ * @return The number of records read.
+ */
+uint32_t Port_Trace_Read(Port_Trace_Entry *entries, uint32_t max);
+
+/**
+ * @brief The Port_Trace_Get_Lost function returns the number of records dropped because the FIFO was full.
+ *
+ * @param None
+ *
+ * @return The number of lost records since the last reset.
+ */
+uint32_t Port_Trace_Get_Lost();
+
+/**
+ * @brief The Port_Trace_Dump function transmits the trace via UART and removes the transmitted records.
+ *
+ * The trace is transmitted with the following format:
+ *  Port trace: freq=<CPU frequency in Hz> count=<number of records> lost=<number of lost records>
+ *  <timestamp hex> <port> <value hex>
+ *  ...
+ *  Port trace: end
+ *
+ * @note The EUSCI_A0 UART module must be initialized before calling this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Port_Trace_Dump();
+
+#endif /* INC_PORT_TRACE_H_ */
@@ -0,0 +1,191 @@
+/**
+ * @file Profiler.h
+ * @brief Header file for the Profiler module.
+ *
+ * This file contains the function definitions for the Profiler module.
+ *
+ * The profiler measures the number of CPU cycles spent in each driver entry point with the DWT cycle counter.
+ * For each profiled function, it records the number of calls and a log2 histogram of the cycles per call:
+ * bucket b counts the calls that took between 2^b and 2^(b+1) - 1 cycles (bucket 0 also counts calls of 0 cycles).
+ * The cycles include the time spent in the functions called by the profiled function.
+ *
+ * The profiler is disabled by default. To enable it, define PROFILER_ENABLE in the project build settings
+ * (Build > ARM Compiler > Predefined Symbols). When it is disabled, PROFILER_ENTER and PROFILER_EXIT expand
+ * to nothing, the profiled functions are compiled exactly as before and the Profiler functions are not defined.
+ *
+ * A profiled function calls PROFILER_ENTER once at the beginning and PROFILER_EXIT before each return:
+ *  void LED1_Output(uint8_t led_value)
+ *  {
+ *      PROFILER_ENTER();
+ *      ...
+ *      PROFILER_EXIT(LED1_OUTPUT);
+ *  }
+ *
+ * The overhead of a PROFILER_ENTER / PROFILER_EXIT pair is measured by Profiler_Init
+ * (see Profiler_Get_Overhead_Cycles).
+ *
+ * @note The table is not protected against concurrent updates, so the profiled functions
+ * should not be called from interrupt handlers while PROFILER_ENABLE is defined.
+ *
+ */
+
+#ifndef INC_PROFILER_H_
+#define INC_PROFILER_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Number of buckets in the log2 histogram of each profiled function
+ */
+#define PROFILER_NUM_BUCKETS    32
+
+/**
+ * @brief List of the profiled functions
+ *
+ * Each entry defines an identifier (PROFILER_<id>) and the name printed by Profiler_Dump.
+ */
+#define PROFILER_FUNCTIONS(X)                                   \
+    X(LED1_OUTPUT,              "LED1_Output")                  \
+    X(LED2_OUTPUT,              "LED2_Output")                  \
+    X(PMOD_8LD_OUTPUT,          "PMOD_8LD_Output")              \
+    X(GET_BUTTONS_STATUS,       "Get_Buttons_Status")           \
+    X(GET_PMOD_SWT_STATUS,      "Get_PMOD_SWT_Status")          \
+    X(LED_PATTERN_1,            "LED_Pattern_1")                \
+    X(LED_PATTERN_2,            "LED_Pattern_2")                \
+    X(LED_PATTERN_3,            "LED_Pattern_3")                \
+    X(LED_PATTERN_4,            "LED_Pattern_4")                \
+    X(LED_PATTERN_5,            "LED_Pattern_5")                \
+    X(CLOCK_DELAY1US,           "Clock_Delay1us")               \
+    X(CLOCK_DELAY1MS,           "Clock_Delay1ms")               \
+    X(UART_INIT,                "EUSCI_A0_UART_Init")           \
+    X(UART_INCHAR,              "EUSCI_A0_UART_InChar")         \
+    X(UART_OUTCHAR,             "EUSCI_A0_UART_OutChar")        \
+    X(UART_INSTRING,            "EUSCI_A0_UART_InString")       \
+    X(UART_OUTSTRING,           "EUSCI_A0_UART_OutString")      \
+    X(UART_INUDEC,              "EUSCI_A0_UART_InUDec")         \
+    X(UART_OUTUDEC,             "EUSCI_A0_UART_OutUDec")        \
+    X(UART_OUTSDEC,             "EUSCI_A0_UART_OutSDec")        \
+    X(UART_OUTUFIX,             "EUSCI_A0_UART_OutUFix")        \
+    X(UART_OUTUHEX,             "EUSCI_A0_UART_OutUHex")        \
+    X(UART_READ,                "EUSCI_A0_UART_Read")           \
+    X(UART_WRITE,               "EUSCI_A0_UART_Write")
+
+#define PROFILER_ID(id, name)   PROFILER_##id,
+
+/**
+ * @brief Identifiers of the profiled functions
+ */
+typedef enum
+{
+    PROFILER_FUNCTIONS(PROFILER_ID)
+    PROFILER_NUM_FUNCTIONS
+} Profiler_Function;
+
+#undef PROFILER_ID
+
+/**
+ * @brief Statistics recorded for each profiled function
+ */
+typedef struct
+{
+    uint32_t count;                                 // Number of calls
+    uint32_t histogram[PROFILER_NUM_BUCKETS];       // Number of calls per log2 bucket of cycles
+} Profiler_Entry;
+
+#ifdef PROFILER_ENABLE
+
+extern Profiler_Entry Profiler_Table[PROFILER_NUM_FUNCTIONS];
+
+/**
+ * @brief The Profiler_Record function adds a call of a profiled function to the table.
+ *
+ * The bucket is found with a count leading zeros (CLZ) instruction.
+ *
+ * @param id The identifier of the profiled function.
+ * @param cycles The number of cycles spent in the call.
+ *
+ * @return None
+ */
+static inline void Profiler_Record(Profiler_Function id, uint32_t cycles)
+{
+    Profiler_Entry *entry = &Profiler_Table[id];
+
+    entry->count++;
+    entry->histogram[31 - _norm(cycles | 1)]++;
+}
+
+#define PROFILER_ENTER()        uint32_t profiler_start_cycles = DWT->CYCCNT
+#define PROFILER_EXIT(id)       Profiler_Record(PROFILER_##id, DWT->CYCCNT - profiler_start_cycles)
+
+#else
+
+#define PROFILER_ENTER()
+#define PROFILER_EXIT(id)
+
+#endif /* PROFILER_ENABLE */
+
+/**
+ * @brief The Profiler_Init function clears the table and measures the overhead of the profiler.
+ *
+ * The following UART commands are registered (see UART_Command.h):
+ *  - 'p': Transmit the table (Profiler_Dump)
+ *  - 'r': Clear the table (Profiler_Reset)
+ *
+ * The DWT cycle counter is enabled by _system_pre_init (see Boot.h).
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Profiler_Init();
+
+/**
+ * @brief The Profiler_Reset function clears the table.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Profiler_Reset();
+
+/**
+ * @brief The Profiler_Get_Entry function returns the statistics of a profiled function.
+ *
+ * @param id The identifier of the profiled function.
+ *
+ * @return Pointer to the statistics of the profiled function.
+ */
+const Profiler_Entry *Profiler_Get_Entry(Profiler_Function id);
+
+/**
+ * @brief The Profiler_Get_Overhead_Cycles function returns the overhead of the profiler.
+ *
+ * The overhead is the worst case of 16 calls to an empty function that only contains
+ * PROFILER_ENTER and PROFILER_EXIT, including the cycles spent in Profiler_Record.
+ *
+ * @param None
+ *
+ * @return The number of cycles added to each call of a profiled function.
+ */
+uint32_t Profiler_Get_Overhead_Cycles();
+
+/**
+ * @brief The Profiler_Dump function transmits the table via UART.
+ *
+ * The first line contains the overhead of the profiler in cycles.
+ * Each profiled function that has been called at least once is transmitted as one line with the following format:
+ *  <name> <count> <bucket>:<calls> <bucket>:<calls> ...
+ *
+ * Only the non-empty buckets are transmitted. The calls made by Profiler_Dump to the EUSCI_A0_UART functions
+ * are also recorded, so the lines of these functions may include part of the dump.
+ *
+ * @note The EUSCI_A0 UART module must be initialized before calling this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Profiler_Dump();
+
+#endif /* INC_PROFILER_H_ */
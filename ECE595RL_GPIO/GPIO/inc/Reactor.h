@@ -0,0 +1,264 @@
+/**
+ * @file Reactor.h
+ * @brief Header file for the Reactor module.
+ *
+ * This file contains the function definitions for the Reactor module.
+ *
+ * The Reactor module runs the application as a set of event handlers. Interrupt handlers post events to a queue,
+ * and Reactor_Run calls the handler registered for each event, one at a time and in the order of the queue.
+ * A handler runs to completion and is never interrupted by another handler, only by interrupt handlers.
+ * When the queue is empty, the CPU sleeps with WFI until the next interrupt.
+ *
+ * Event sources:
+ *  - REACTOR_EVENT_TIMER: one-shot timers on Timer A1, clocked by ACLK (32768 Hz REFOCLK) in continuous mode.
+ *    Each timer uses one of the capture/compare registers TA1CCR1 to TA1CCR4, so no interrupt occurs between
+ *    two expiries. The resolution is one ACLK period (30.5 us) and the longest delay is REACTOR_TIMER_MAX_MS.
+ *  - REACTOR_EVENT_BUTTONS: both edges of the user buttons (P1.1 and P1.4), see Reactor_Enable_Buttons.
+ *    The PMOD SWT switches cannot post events since Port 10 does not have interrupt capability.
+ *  - REACTOR_EVENT_UART_RX: a character has been received by EUSCI_A0, see Reactor_Enable_UART_RX.
+ *  - REACTOR_EVENT_DMA_DONE: reserved for the drivers that use DMA, which post it from their DMA interrupt handler.
+ *
+ * The queue is lock-free: Reactor_Post claims a slot with an exclusive load/store (LDREX/STREX) on the head index,
+ * so it can be called from any interrupt priority without masking interrupts. The slot is written after it has been
+ * claimed. Reactor_Run never reads a claimed slot before it is written, since the producers are interrupt handlers,
+ * which complete before the thread-mode code resumes, or handlers called by Reactor_Run itself.
+ *
+ * Time keeping:
+ *  - The time is measured with Timer A1, which keeps running while the CPU sleeps.
+ *  - The DWT cycle counter stops while the CPU sleeps. After each WFI, Reactor_Run advances DWT->CYCCNT by the
+ *    sleep time measured with Timer A1, so the modules that measure time with the cycle counter (Loop_Stats,
+ *    Deep_Sleep, Perf_Counter, LED_Energy, Flight_Recorder) still measure the elapsed time. The correction is
+ *    rounded to ACLK periods, so a single sleep is accurate to one ACLK period (about 1465 cycles at 48 MHz),
+ *    but the rounding errors do not accumulate.
+ *  - Each sleep is reported to LED_Energy, which charges it at the sleep current.
+ *  - The CPU utilisation is the share of the time that the CPU did not spend in WFI. It includes the interrupt
+ *    handlers, in particular the periodic interrupts of PC_Sampler and of an ISR_Latency window, which also wake
+ *    up the CPU.
+ *
+ * The execution time of the interrupt handlers of the event sources is measured against the top-half budget
+ * of the Deferred_Work module (see Deferred_Work.h).
+ *
+ * The following UART command is registered (see UART_Command.h):
+ *  - 'u': Transmit the reactor statistics (Reactor_Dump)
+ *
+ * @note The clock must be initialized with Clock_Init48MHz before calling Reactor_Init.
+ *
+ */
+
+#ifndef INC_REACTOR_H_
+#define INC_REACTOR_H_
+
+#include <stdint.h>
+#include "msp.h"
+#include "IRQ_Priority.h"
+
+/**
+ * @brief Number of events in the queue (power of two). Events posted to a full queue are dropped and counted.
+ */
+#define REACTOR_QUEUE_SIZE          32
+
+/**
+ * @brief Number of timers (TA1CCR1 to TA1CCR4)
+ */
+#define REACTOR_NUM_TIMERS          4
+
+/**
+ * @brief Longest delay of a timer in milliseconds (65535 ACLK periods minus a margin)
+ */
+#define REACTOR_TIMER_MAX_MS        1990
+
+/**
+ * @brief Priority level of the interrupts of the event sources (see Critical_Section.h and IRQ_Priority.h)
+ */
+#define REACTOR_PRIORITY            IRQ_PRIORITY_LEVEL_EVENTS
+
+/**
+ * @brief Types of events
+ */
+typedef enum
+{
+    REACTOR_EVENT_TIMER,            // Argument: the timer that expired (0 to REACTOR_NUM_TIMERS - 1)
+    REACTOR_EVENT_BUTTONS,          // Argument: the status of the user buttons after the edge (P1->IN & 0x12)
+    REACTOR_EVENT_UART_RX,          // Argument: the received character
+    REACTOR_EVENT_DMA_DONE,         // Argument: the DMA channel
+    REACTOR_NUM_EVENTS
+} Reactor_Event_Type;
+
+/**
+ * @brief Event handler
+ */
+typedef void (*Reactor_Handler)(uint32_t argument);
+
+/**
+ * @brief Statistics of the reactor
+ */
+typedef struct
+{
+    uint32_t events[REACTOR_NUM_EVENTS];            // Number of events handled per type
+    uint32_t max_handler_cycles[REACTOR_NUM_EVENTS];// Longest handler execution per type in CPU cycles
+    uint32_t dropped;                               // Events posted to a full queue
+    uint32_t max_depth;                             // Largest number of events waiting in the queue
+    uint32_t sleeps;                                // Number of WFI executions
+    uint64_t total_ticks;                           // Time since Reactor_Init in ACLK periods
+    uint64_t sleep_ticks;                           // Time spent in WFI in ACLK periods
+} Reactor_Stats;
+
+/**
+ * @brief The Reactor_Init function clears the queue and the statistics and starts Timer A1.
+ *
+ * The handlers are cleared and the timers are stopped. The TA1_N interrupt is enabled with priority level
+ * REACTOR_PRIORITY.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Reactor_Init();
+
+/**
+ * @brief The Reactor_Register function sets the handler of an event type.
+ *
+ * Events without a handler are removed from the queue and ignored.
+ *
+ * @param type The event type.
+ * @param handler The function called with the argument of each event of this type, or 0.
+ *
+ * @return None
+ */
+void Reactor_Register(Reactor_Event_Type type, Reactor_Handler handler);
+
+/**
+ * @brief The Reactor_Post function adds an event to the queue.
+ *
+ * This function can be called from any interrupt handler and from the event handlers.
+ *
+ * @param type The event type.
+ * @param argument The argument passed to the handler (0 to 0xFFFFFF).
+ *
+ * @return Indicates whether the event has been queued.
+ *  - 0: The event has been queued
+ *  - 1: The queue is full and the event has been dropped
+ */
+uint8_t Reactor_Post(Reactor_Event_Type type, uint32_t argument);
+
+/**
+ * @brief The Reactor_Timer_Start function starts a timer that posts a REACTOR_EVENT_TIMER event after a delay.
+ *
+ * If the timer is already running, it is restarted. The event of an expiry that is still in the queue is
+ * not removed.
+ *
+ * @param timer The timer (0 to REACTOR_NUM_TIMERS - 1).
+ * @param ms The delay from now in milliseconds (1 to REACTOR_TIMER_MAX_MS).
+ *
+ * @return None
+ */
+void Reactor_Timer_Start(uint8_t timer, uint32_t ms);
+
+/**
+ * @brief The Reactor_Timer_Continue function starts a timer again, counting the delay from its previous expiry.
+ *
+ * Calling this function from the handler of the timer gives a periodic timer whose period does not drift with the
+ * latency of the handler. If the new expiry time has already passed, the event is posted immediately.
+ *
+ * @param timer The timer (0 to REACTOR_NUM_TIMERS - 1), started at least once with Reactor_Timer_Start.
+ * @param ms The delay from the previous expiry in milliseconds (1 to REACTOR_TIMER_MAX_MS).
+ *
+ * @return None
+ */
+void Reactor_Timer_Continue(uint8_t timer, uint32_t ms);
+
+/**
+ * @brief The Reactor_Timer_Stop function stops a timer.
+ *
+ * @param timer The timer (0 to REACTOR_NUM_TIMERS - 1).
+ *
+ * @return None
+ */
+void Reactor_Timer_Stop(uint8_t timer);
+
+/**
+ * @brief The Reactor_Suspend function disables the interrupts of the event sources, for example before entering LPM3.5.
+ *
+ * Timer A1 is stopped, so the time does not advance until Reactor_Resume is called.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Reactor_Suspend();
+
+/**
+ * @brief The Reactor_Resume function enables the interrupts of the event sources again after Reactor_Suspend.
+ *
+ * The edge interrupts of the user buttons are configured again if they were enabled with Reactor_Enable_Buttons,
+ * and Timer A1 continues counting.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Reactor_Resume();
+
+/**
+ * @brief The Reactor_Enable_Buttons function posts a REACTOR_EVENT_BUTTONS event on each edge of the user buttons.
+ *
+ * The PORT1 interrupt is enabled with priority level REACTOR_PRIORITY. The buttons bounce, so a press usually
+ * posts several events; the handler should read the buttons again after a debounce delay.
+ *
+ * @note Buttons_Init must be called before this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Reactor_Enable_Buttons();
+
+/**
+ * @brief The Reactor_Enable_UART_RX function posts a REACTOR_EVENT_UART_RX event when EUSCI_A0 receives a character.
+ *
+ * The EUSCI_A0 interrupt handler reads RXBUF, logs the receive errors like EUSCI_A0_UART_InChar and posts the
+ * character as the argument of the event (see UART_Command_Execute). RXBUF is read within one character time
+ * (87 us at 115200 baud) even while the event handlers are busy, so a burst of characters is not lost unless the
+ * queue is full. The receive interrupt stays enabled, so this function is called once.
+ *
+ * @note EUSCI_A0_UART_Init must be called before this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Reactor_Enable_UART_RX();
+
+/**
+ * @brief The Reactor_Run function handles the events of the queue and sleeps when the queue is empty.
+ *
+ * @param None
+ *
+ * @return This function does not return.
+ */
+void Reactor_Run();
+
+/**
+ * @brief The Reactor_Get_Stats function returns the statistics of the reactor.
+ *
+ * @param stats Pointer to the structure where the statistics will be stored.
+ *
+ * @return None
+ */
+void Reactor_Get_Stats(Reactor_Stats *stats);
+
+/**
+ * @brief The Reactor_Dump function transmits the statistics of the reactor via UART.
+ *
+ * The report contains the CPU utilisation in per mille, the number of sleeps, the dropped events, the largest queue
+ * depth and, for each event type, the number of events and the longest handler execution in CPU cycles.
+ *
+ * @note The EUSCI_A0 UART module must be initialized before calling this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Reactor_Dump();
+
+#endif /* INC_REACTOR_H_ */
@@ -0,0 +1,104 @@
+/**
+ * @file SRAM_Power.h
+ * @brief Header file for the SRAM_Power driver.
+ *
+ * This file contains the function definitions for the SRAM_Power driver.
+ *
+ * The 64 KB SRAM of the MSP432P401R is divided into eight 8 KB banks. Each bank can be
+ * disabled in active mode (SYSCTL SRAM_BANKEN) and can be excluded from retention in
+ * LPM3 and LPM4 (SYSCTL SRAM_BANKRET). Bank 0 is always enabled and always retained.
+ *
+ * The amount of SRAM in use is determined from the section boundaries generated by the linker
+ * (see msp432p401r.cmd). All SRAM sections are placed from the bottom of SRAM upwards, so the
+ * banks above the highest used address can be powered down.
+ *
+ * For more information regarding the SRAM bank registers, refer to the SYSCTL Registers section
+ * of the MSP432Pxx Microcontrollers Technical Reference Manual.
+ *
+ * @note The current saved per bank should be measured on the LaunchPad by comparing the
+ * current at the 3V3 jumper (JP8) with SRAM_Power_Init called and not called.
+ *
+ */
+
+#ifndef INC_SRAM_POWER_H_
+#define INC_SRAM_POWER_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Number of SRAM banks on the MSP432P401R
+ */
+#define SRAM_POWER_NUM_BANKS    8
+
+/**
+ * @brief Size of each SRAM bank in bytes
+ */
+#define SRAM_POWER_BANK_SIZE    0x2000
+
+/**
+ * @brief The SRAM_Power_Init function disables the SRAM banks that are not used by the program.
+ *
+ * This function determines the highest SRAM address in use from the linker-generated section
+ * boundaries and disables all banks above it. All enabled banks are retained in LPM3 and LPM4.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void SRAM_Power_Init();
+
+/**
+ * @brief The SRAM_Power_Set_LPM_Retention function selects which enabled SRAM banks are retained in LPM3 and LPM4.
+ *
+ * Banks that are not retained lose their contents when the device enters LPM3 or LPM4. Disabled banks are never retained.
+ * Bank 0 is always retained regardless of the value of bank_mask.
+ *
+ * @param bank_mask An 8-bit unsigned integer where each bit corresponds to an SRAM bank (bit 0 = bank 0).
+ *                  Set a bit to 1 to retain the corresponding bank.
+ *
+ * @return None
+ */
+void SRAM_Power_Set_LPM_Retention(uint8_t bank_mask);
+
+/**
+ * @brief The SRAM_Power_Get_Scratch_Banks function returns the banks that only contain the .noinit section.
+ *
+ * The contents of these banks are not required to be initialized, so retention can be
+ * released for them with SRAM_Power_Set_LPM_Retention if the buffers they contain do not need
+ * to survive LPM3 or LPM4.
+ *
+ * @param None
+ *
+ * @return A bit mask of the banks that are fully covered by the .noinit section.
+ */
+uint8_t SRAM_Power_Get_Scratch_Banks();
+
+/**
+ * @brief The SRAM_Power_Get_Used_Bytes function returns the number of bytes of SRAM in use.
+ *
+ * @param None
+ *
+ * @return The offset of the highest used SRAM address from the start of SRAM.
+ */
+uint32_t SRAM_Power_Get_Used_Bytes();
+
+/**
+ * @brief The SRAM_Power_Get_Enabled_Banks function returns the banks that are enabled in active mode.
+ *
+ * @param None
+ *
+ * @return A bit mask of the enabled SRAM banks (bit 0 = bank 0).
+ */
+uint8_t SRAM_Power_Get_Enabled_Banks();
+
+/**
+ * @brief The SRAM_Power_Get_Retained_Banks function returns the banks that are retained in LPM3 and LPM4.
+ *
+ * @param None
+ *
+ * @return A bit mask of the retained SRAM banks (bit 0 = bank 0).
+ */
+uint8_t SRAM_Power_Get_Retained_Banks();
+
+#endif /* INC_SRAM_POWER_H_ */
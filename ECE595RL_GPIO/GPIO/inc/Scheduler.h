@@ -0,0 +1,141 @@
+/**
+ * @file Scheduler.h
+ * @brief Header file for the Scheduler module.
+ *
+ * This file contains the function definitions for the Scheduler module.
+ *
+ * The Scheduler module runs a static table of periodic tasks from a single tick. Each task has a period and an
+ * offset in ticks: it is released at the ticks offset, offset + period, offset + 2 * period, and so on. The offsets
+ * spread the tasks with long periods over different ticks, so that they do not all run in the same tick.
+ *
+ * The scheduling is cooperative and rate-monotonic: at each tick, the released tasks run one after the other in
+ * the order of their periods (the shortest period first, and in the order of the table for equal periods), and
+ * each task runs to completion. A task is never preempted by another task, so the longest task delays the tasks
+ * released in the next tick; the tasks should return quickly and keep their state in static variables.
+ *
+ * The tick is a reactor timer (see Reactor.h) restarted with Reactor_Timer_Continue, so the tick period does not
+ * drift, and the CPU sleeps in Reactor_Run between the ticks. The scheduler handles the REACTOR_EVENT_TIMER events,
+ * so the other reactor timers cannot be used with it. The other event types can still be used.
+ *
+ * Timing statistics (DWT cycle counter):
+ *  - The execution time of each task: the number of runs, the average and the longest execution.
+ *  - The response time of each task: from the start of the tick to the end of the task, including the tasks that
+ *    ran before it in the same tick. The latency of the tick event itself (the wake-up and the other events in the
+ *    reactor queue) is not included.
+ *  - A deadline overrun is counted when a task completes after its next release, that is when its response time
+ *    is longer than its period. Each overrun is logged as a FLIGHT_RECORDER_TASK_OVERRUN record.
+ *  - A late tick is counted when the tasks of a tick take longer than the tick period, which delays the next tick.
+ *
+ * The following UART commands are registered (see UART_Command.h):
+ *  - 'x': Transmit the task statistics (Scheduler_Dump)
+ *  - 'X': Clear the statistics (Scheduler_Reset)
+ *
+ * @note The reactor must be initialized with Reactor_Init before calling Scheduler_Run.
+ *
+ */
+
+#ifndef INC_SCHEDULER_H_
+#define INC_SCHEDULER_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Maximum number of tasks in the table
+ */
+#define SCHEDULER_MAX_TASKS         8
+
+/**
+ * @brief Periodic task
+ */
+typedef struct
+{
+    const char *name;                   // Name shown by Scheduler_Dump
+    void (*function)(void);             // Function called at each release
+    uint16_t period;                    // Period in ticks (at least 1)
+    uint16_t offset;                    // First release in ticks (less than the period)
+} Scheduler_Task;
+
+/**
+ * @brief Statistics of a task
+ */
+typedef struct
+{
+    uint32_t runs;                      // Number of runs
+    uint32_t overruns;                  // Runs that completed after the next release of the task
+    uint32_t max_cycles;                // Longest execution in CPU cycles
+    uint32_t max_response_cycles;       // Longest time from the start of the tick to the end of the run
+    uint64_t total_cycles;              // Sum of the executions, for the average
+} Scheduler_Task_Stats;
+
+/**
+ * @brief The Scheduler_Init function sets the task table and the tick and clears the statistics.
+ *
+ * The table is not copied, so it must be static.
+ *
+ * @param tasks The task table.
+ * @param count The number of tasks (1 to SCHEDULER_MAX_TASKS).
+ * @param timer The reactor timer used for the tick (0 to REACTOR_NUM_TIMERS - 1).
+ * @param tick_ms The tick period in milliseconds (1 to REACTOR_TIMER_MAX_MS).
+ *
+ * @return Indicates whether the table has been accepted.
+ *  - 0: The table has been accepted
+ *  - 1: The number of tasks, a period or an offset is invalid
+ */
+uint8_t Scheduler_Init(const Scheduler_Task *tasks, uint8_t count, uint8_t timer, uint32_t tick_ms);
+
+/**
+ * @brief The Scheduler_Run function starts the tick and runs the reactor.
+ *
+ * The first tick (tick 0) occurs one tick period after the call.
+ *
+ * @param None
+ *
+ * @return This function does not return.
+ */
+void Scheduler_Run();
+
+/**
+ * @brief The Scheduler_Get_Ticks function returns the number of ticks handled since Scheduler_Run.
+ *
+ * @param None
+ *
+ * @return The number of ticks.
+ */
+uint32_t Scheduler_Get_Ticks();
+
+/**
+ * @brief The Scheduler_Get_Task_Stats function returns the statistics of a task.
+ *
+ * @param task The index of the task in the table.
+ * @param stats Pointer to the structure where the statistics will be stored.
+ *
+ * @return None
+ */
+void Scheduler_Get_Task_Stats(uint8_t task, Scheduler_Task_Stats *stats);
+
+/**
+ * @brief The Scheduler_Reset function clears the statistics of the tasks and the late tick count.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Scheduler_Reset();
+
+/**
+ * @brief The Scheduler_Dump function transmits the task statistics via UART.
+ *
+ * The report contains the tick period, the number of ticks and late ticks and, for each task in rate-monotonic
+ * order, its period and offset, the number of runs, the average and longest execution and the longest response
+ * in CPU cycles, the number of deadline overruns and its share of the CPU time (per mille).
+ *
+ * @note The EUSCI_A0 UART module must be initialized before calling this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Scheduler_Dump();
+
+#endif /* INC_SCHEDULER_H_ */
@@ -0,0 +1,65 @@
+/**
+ * @file UART_Command.h
+ * @brief Header file for the UART_Command module.
+ *
+ * This file contains the function definitions for the UART_Command module.
+ *
+ * The UART_Command module dispatches single-character commands received via UART to the
+ * handlers registered by other modules (for example, the Profiler and PC_Sampler modules).
+ * UART_Command_Poll does not wait for a character, so it can be called once per iteration of the main loop.
+ * When the characters are received by an interrupt handler, UART_Command_Execute dispatches them instead.
+ *
+ * @note The EUSCI_A0 UART module must be initialized before calling UART_Command_Poll.
+ *
+ */
+
+#ifndef INC_UART_COMMAND_H_
+#define INC_UART_COMMAND_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Maximum number of registered commands
+ */
+#define UART_COMMAND_MAX    32
+
+/**
+ * @brief The UART_Command_Register function registers the handler of a command.
+ *
+ * If the command is already registered, its handler is replaced.
+ *
+ * @param command The character that selects the handler.
+ * @param handler The function called when the command is received.
+ *
+ * @return Indicates whether the command has been registered.
+ *  - 0: The command has been registered
+ *  - 1: The command table is full
+ */
+uint8_t UART_Command_Register(char command, void (*handler)(void));
+
+/**
+ * @brief The UART_Command_Poll function calls the handler of a received command.
+ *
+ * If no character has been received, this function returns immediately.
+ * Characters without a registered handler are ignored.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void UART_Command_Poll();
+
+/**
+ * @brief The UART_Command_Execute function calls the handler of a command that has already been received.
+ *
+ * This function is used when the characters are read by an interrupt handler (see Reactor_Enable_UART_RX).
+ * Characters without a registered handler are ignored.
+ *
+ * @param command The received character.
+ *
+ * @return None
+ */
+void UART_Command_Execute(char command);
+
+#endif /* INC_UART_COMMAND_H_ */
@@ -0,0 +1,212 @@
+/**
+ * @file WS2812.h
+ * @brief Header file for the WS2812 driver.
+ *
+ * This file contains the function definitions for the WS2812 driver.
+ *
+ * The WS2812 driver controls a strip of WS2812B or SK6812 addressable RGB LEDs connected to P9.7 (pin 4 of the
+ * PMOD header of the PMOD 8LD). The data line of the strip is driven by the SIMO output of EUSCI_A3 in SPI
+ * master mode, which is fed by the DMA controller, so that the pixel data is transmitted without the CPU.
+ *
+ * Timing:
+ *  - Each data bit of a pixel is sent as four SPI bits at WS2812_SPI_HZ (SMCLK / 4 = 3 MHz): 1000 for a 0 and
+ *    1100 for a 1. A data bit lasts 1.333 us (1.25 us +/- 0.6 us), the high time of a 0 is 333 ns and the high
+ *    time of a 1 is 667 ns, which is within the limits of both the WS2812B (400 ns and 800 ns +/- 150 ns) and the
+ *    SK6812 (300 ns and 600 ns +/- 150 ns). Three SPI bits at 2.4 MHz would be shorter, but the 833 ns high time
+ *    of a 1 is outside the SK6812 limits.
+ *  - Each frame starts with WS2812_RESET_US of low level, so that the strip latches the previous frame before
+ *    the first pixel of the next one, even after an underrun.
+ *  - A frame of n pixels takes (WS2812_RESET_BYTES + 12 * n) bytes, that is 300 us + 32 us per pixel (see
+ *    WS2812_Get_Frame_us). The highest frame rate is 61 fps for 500 pixels and 60 fps for up to 511 pixels.
+ *
+ * Frames:
+ *  - The pixels are drawn with WS2812_Set_Pixel and keep their colors, so only the pixels that change need to be
+ *    drawn again. WS2812_Show encodes all the pixels at once into the back frame (12 SPI bytes per pixel, after
+ *    the low level), which is transmitted when the frame being transmitted ends. Until then, WS2812_Is_Ready
+ *    returns 0 and WS2812_Show drops the next frame, but the pixels can be drawn.
+ *  - The strip holds the last frame, so a frame is only transmitted when WS2812_Show is called.
+ *  - When a frame ends, a REACTOR_EVENT_DMA_DONE event is posted with DMA_CHANNEL_WS2812 as its argument.
+ *
+ * CPU load:
+ *  - The two encoded frames take 2 * WS2812_MAX_FRAME_BYTES bytes of SRAM (14.6 KB for 600 pixels), in addition
+ *    to 3 bytes per pixel for the colors. The DMA controller transmits a frame in ping-pong chunks of up to
+ *    DMA_MAX_TRANSFER bytes (see DMA.h), so a frame of 500 pixels raises the DMA_INT1 interrupt 6 times. The
+ *    handler only sets the structure that has completed to the next chunk, which is already encoded.
+ *  - A chunk is transmitted in 2.7 ms, so the handler has that long to set the next one. If it runs too late, the
+ *    strip sees a long low level in the middle of the frame; the frame is then counted as an underrun and
+ *    transmitted again from its start.
+ *  - The cycles of WS2812_Show and of the DMA_INT1 handler are measured, and WS2812_Update computes the achieved
+ *    frame rate and the CPU load of the driver over the last period. The load depends on how often the program
+ *    calls WS2812_Show; it should be read from the 'g' report.
+ *
+ * @note The WS2812B and SK6812 need a data high level of at least 0.7 times their supply voltage, so a strip
+ * powered from 5 V needs a level shifter (for example a 74AHCT125) between P9.7 and its data input.
+ *
+ * @note P9.7 is also the data line of LED 7 of the PMOD 8LD, which stays off while WS2812_Init is in effect.
+ * WS2812_Init must be called after PMOD_8LD_Init, which configures P9.7 as an I/O pin.
+ *
+ * @note The driver is only built when WS2812_ENABLE is defined in the project build settings, so that its
+ * buffers do not take SRAM otherwise.
+ *
+ * The following UART commands are registered (see UART_Command.h):
+ *  - 'g': Transmit the strip statistics and the frame rate against the strip length (WS2812_Dump)
+ *  - 'G': Clear the statistics (WS2812_Reset)
+ *
+ * For more information regarding the eUSCI in SPI mode, refer to the eUSCI - SPI Mode section of the
+ * MSP432Pxx Microcontrollers Technical Reference Manual, and the datasheets of the WS2812B and the SK6812.
+ *
+ */
+
+#ifndef INC_WS2812_H_
+#define INC_WS2812_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Largest number of pixels of the strip (3 bytes per pixel in each of the two buffers)
+ */
+#define WS2812_MAX_PIXELS           600
+
+/**
+ * @brief SPI bit rate in Hz: SMCLK (12 MHz) divided by 4
+ */
+#define WS2812_SPI_HZ               3000000
+
+/**
+ * @brief Low level at the start of each frame in microseconds (280 us for the WS2812B, 80 us for the SK6812)
+ */
+#define WS2812_RESET_US             300
+
+/**
+ * @brief Number of zero bytes of the low level at the start of each frame
+ */
+#define WS2812_RESET_BYTES          ((WS2812_RESET_US * (WS2812_SPI_HZ / 1000000) + 7) / 8)
+
+/**
+ * @brief Number of SPI bytes of a pixel (24 data bits of 4 SPI bits)
+ */
+#define WS2812_PIXEL_BYTES          12
+
+/**
+ * @brief Number of SPI bytes of a frame of the largest strip
+ */
+#define WS2812_MAX_FRAME_BYTES      (WS2812_RESET_BYTES + WS2812_MAX_PIXELS * WS2812_PIXEL_BYTES)
+
+/**
+ * @brief Strip statistics
+ */
+typedef struct
+{
+    uint32_t frames;                // Frames transmitted
+    uint32_t underruns;             // Frames transmitted again after an underrun
+    uint32_t dropped;               // Calls to WS2812_Show while a frame was already waiting
+    uint32_t fps;                   // Frames per second over the last period of WS2812_Update
+    uint32_t cpu_per_mille;         // Time of WS2812_Show and DMA_INT1 over the last period, in thousandths of the CPU
+    uint32_t max_encode_cycles;     // Longest encoding of a frame by WS2812_Show in CPU cycles
+} WS2812_Stats;
+
+/**
+ * @brief The WS2812_Init function configures EUSCI_A3, P9.7 and the DMA channel of the strip, and clears the pixels.
+ *
+ * @note The clock, the DMA controller (DMA_Init), the deferred work statistics (Deferred_Work_Init) and the
+ * reactor (Reactor_Init) must be initialized before calling this function.
+ *
+ * @param length The number of pixels of the strip (1 to WS2812_MAX_PIXELS).
+ *
+ * @return Indicates whether the strip has been configured.
+ *  - 0: The strip has been configured
+ *  - 1: The length is out of range
+ */
+uint8_t WS2812_Init(uint16_t length);
+
+/**
+ * @brief The WS2812_Set_Pixel function sets the color of a pixel, which is transmitted by the next WS2812_Show.
+ *
+ * Indexes outside of the strip are ignored.
+ *
+ * @param index The pixel, starting with the pixel closest to the data input (0 to length - 1).
+ * @param red The red intensity (0 to 255).
+ * @param green The green intensity (0 to 255).
+ * @param blue The blue intensity (0 to 255).
+ *
+ * @return None
+ */
+void WS2812_Set_Pixel(uint16_t index, uint8_t red, uint8_t green, uint8_t blue);
+
+/**
+ * @brief The WS2812_Show function encodes the pixels into the back frame and transmits it as the next frame.
+ *
+ * The frame starts immediately if the strip is idle, and otherwise when the frame being transmitted ends.
+ * The pixels are encoded by the caller, in about 10 CPU cycles per color byte.
+ *
+ * @param None
+ *
+ * @return Indicates whether the frame has been queued.
+ *  - 0: The frame has been queued
+ *  - 1: A frame is already waiting (WS2812_Is_Ready returned 0), so the frame has been dropped
+ */
+uint8_t WS2812_Show();
+
+/**
+ * @brief The WS2812_Is_Ready function indicates whether WS2812_Show can queue a frame.
+ *
+ * @param None
+ *
+ * @return 1 if no frame is waiting for the end of the current frame, 0 otherwise.
+ */
+uint8_t WS2812_Is_Ready();
+
+/**
+ * @brief The WS2812_Get_Frame_us function computes the transmission time of a frame.
+ *
+ * @param length The number of pixels.
+ *
+ * @return The duration of the low level and of the pixel data in microseconds.
+ */
+uint32_t WS2812_Get_Frame_us(uint16_t length);
+
+/**
+ * @brief The WS2812_Update function computes the achieved frame rate and the CPU load of the driver since its previous call.
+ *
+ * This function should be called periodically, about once per second, from thread mode.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void WS2812_Update();
+
+/**
+ * @brief The WS2812_Get_Stats function returns the strip statistics.
+ *
+ * @param stats Pointer to the structure where the statistics will be stored.
+ *
+ * @return None
+ */
+void WS2812_Get_Stats(WS2812_Stats *stats);
+
+/**
+ * @brief The WS2812_Reset function clears the strip statistics.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void WS2812_Reset();
+
+/**
+ * @brief The WS2812_Dump function transmits the strip statistics via UART.
+ *
+ * The report contains the length of the strip, its computed frame time and highest frame rate, the statistics
+ * of WS2812_Stats, and the computed highest frame rate for a range of strip lengths up to WS2812_MAX_PIXELS.
+ *
+ * @note The EUSCI_A0 UART module must be initialized before calling this function.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void WS2812_Dump();
+
+#endif /* INC_WS2812_H_ */
@@ -15,6 +15,22 @@
  *  - PMOD SWT: https://digilent.com/reference/pmod/pmodswt/reference-manual
  *  - PMOD 8LD: https://digilent.com/reference/pmod/pmod8ld/reference-manual
  *
+ * The program is a table of periodic tasks run by a cooperative scheduler (see Scheduler.h) from a 10 ms tick:
+ *  - input scan (10 ms): reads the user buttons and the PMOD SWT switches
+ *  - debounce (10 ms): accepts the inputs once they have been stable for two scans (20 ms)
+ *  - UART service (20 ms): handles the UART commands that had to wait for the diff log
+ *  - pattern (100 ms): runs the LED patterns with LED_Controller_Step; the delays of the patterns are counted in
+ *    periods of the task instead of busy waits
+ *  - stats (1 s): deep sleep policy, performance counters and energy estimate
+ *  - diff log (10 ms, with DIFF_LOG_ENABLE): transmits the changes of the LEDs and inputs (see Diff_Log.h)
+ *  - strip (10 ms, with WS2812_ENABLE): shows the PMOD 8LD pattern in the color of the RGB LED on an LED strip on
+ *    P9.7, repeated every 8 pixels. Only the pixels whose LED changed are drawn again, and a frame is only shown
+ *    when the LEDs have changed, so the strip costs no CPU time while the pattern waits (see WS2812.h).
+ * The UART commands are received by the EUSCI_A0 interrupt and handled as soon as the reactor posts them. An edge
+ * of the user buttons (PORT1 interrupt) restarts the debounce at the edge instead of at the next scan. The PMOD SWT
+ * switches (Port 10) have no interrupts, so they are only read by the scans.
+ * The CPU sleeps in the reactor (see Reactor.h) between the ticks.
+ *
  * @note The user buttons, located at P1.1 and P1.4, are configured with negative logic
  * as the default setting. When the buttons are pressed, they connect to GND. Refer to the
  * schematic found in the MSP432P401R LaunchPad User's Guide.
@@ -24,33 +40,379 @@
 
 #include <stdint.h>
 #include "msp.h"
+#include "inc/Boot.h"
 #include "inc/Clock.h"
+#include "inc/Deferred_Work.h"
+#include "inc/Deep_Sleep.h"
+#include "inc/Diff_Log.h"
+#include "inc/DMA.h"
 #include "inc/EUSCI_A0_UART.h"
+#include "inc/Flash_Log.h"
+#include "inc/LED_Energy.h"
+#include "inc/Flight_Recorder.h"
 #include "inc/GPIO.h"
+#include "inc/IRQ_Priority.h"
+#include "inc/ISR_Latency.h"
+#include "inc/Kernel.h"
+#include "inc/Loop_Stats.h"
+#include "inc/PC_Sampler.h"
+#include "inc/Perf_Counter.h"
+#include "inc/Pin_Power.h"
+#include "inc/Port_Trace.h"
+#include "inc/Profiler.h"
+#include "inc/Reactor.h"
+#include "inc/Scheduler.h"
+#include "inc/SRAM_Power.h"
+#include "inc/UART_Command.h"
+#include "inc/WS2812.h"
+
+// Scheduler tick, and reactor timer that drives it
+#define SCHEDULER_TICK_MS       10
+#define SCHEDULER_TIMER         0
+
+// Period of the pattern task (the delays of the LED patterns are multiples of it)
+#define PATTERN_PERIOD_MS       100
+
+// Number of identical consecutive input scans before a change of the inputs is accepted (20 ms)
+#define DEBOUNCE_SCANS          2
+
+// Number of received commands that can wait while the diff log transmits (a power of 2)
+#define UART_PENDING_SIZE       32
+
+// Number of pixels of the WS2812 strip, and intensity of its lit pixels
+#define STRIP_LENGTH            500
+#define STRIP_INTENSITY         32
+
+static Flash_Log_State LED_State = {1, 0x12, 0x00, 0x00, 0x00, 0x00};
+static uint8_t Scan_Buttons;
+static uint8_t Scan_Switches;
+static uint8_t Debounce_Count;
+static uint8_t Button_Status = 0x12;
+static uint8_t Switch_Status;
+static uint32_t Pattern_Wait_ms;
+static char UART_Pending[UART_PENDING_SIZE];
+static uint32_t UART_Pending_Head;
+static uint32_t UART_Pending_Tail;
+
+static void Input_Scan_Task()
+{
+    uint8_t buttons = Get_Buttons_Status();
+    uint8_t switches = Get_PMOD_SWT_Status();
+
+    if ((buttons != Scan_Buttons) || (switches != Scan_Switches))
+    {
+        Scan_Buttons = buttons;
+        Scan_Switches = switches;
+        Debounce_Count = 0;
+    }
+    else if (Debounce_Count < DEBOUNCE_SCANS)
+    {
+        Debounce_Count++;
+    }
+}
+
+static void Buttons_Changed(uint32_t buttons)
+{
+    // Start the debounce at the edge; the following scans accept the buttons once they stop bouncing
+    Scan_Buttons = buttons;
+    Debounce_Count = 0;
+}
+
+static void Debounce_Task()
+{
+    // The inputs are accepted once they have not changed for DEBOUNCE_SCANS scans
+    if (Debounce_Count >= DEBOUNCE_SCANS)
+    {
+        Button_Status = Scan_Buttons;
+        Switch_Status = Scan_Switches;
+    }
+}
+
+static void Pattern_Task()
+{
+    // Wait for the delay returned by the previous step of the running pattern
+    if (Pattern_Wait_ms > PATTERN_PERIOD_MS)
+    {
+        Pattern_Wait_ms -= PATTERN_PERIOD_MS;
+        return;
+    }
+    Pattern_Wait_ms = 0;
+
+    // The debounced inputs are read at the start of a pattern run; a running pattern reads the switches itself
+    if (!LED_Controller_Step_Is_Running())
+    {
+        Loop_Stats_Mark(LOOP_STATS_DELAY);
+        Loop_Stats_Begin();
+        Loop_Stats_Mark(LOOP_STATS_INPUT);
+    }
+
+    uint32_t delay = LED_Controller_Step(Button_Status, Switch_Status);
+    if (delay != 0)
+    {
+        Pattern_Wait_ms = delay;
+        return;
+    }
+    Loop_Stats_Mark(LOOP_STATS_CONTROLLER);
+
+    // Save the LED state only when the active pattern or its inputs change to limit flash wear
+    if ((LED_Get_Active_Pattern() != LED_State.pattern)
+        || (Button_Status != LED_State.button_status)
+        || (Switch_Status != LED_State.switch_status))
+    {
+        if ((Button_Status != LED_State.button_status) || (Switch_Status != LED_State.switch_status))
+        {
+            Flight_Recorder_Log(FLIGHT_RECORDER_INPUT_EVENT, Button_Status, Switch_Status);
+            Perf_Counter_Increment(PERF_COUNTER_INPUT_EVENTS);
+        }
+        LED_State.pattern = LED_Get_Active_Pattern();
+        LED_State.button_status = Button_Status;
+        LED_State.switch_status = Switch_Status;
+        LED_State.led1_value = LED1_Status();
+        LED_State.rgb_led_value = LED2_Status();
+        LED_State.pmod_8ld_value = PMOD_8LD_Status();
+        Flash_Log_Save(&LED_State);
+    }
+    Loop_Stats_Mark(LOOP_STATS_OTHER);
+}
+
+static void UART_Service_Task()
+{
+    while (UART_Pending_Tail != UART_Pending_Head)
+    {
+#ifdef DIFF_LOG_ENABLE
+        // The replies of the commands must not be mixed with a line of the diff log, so the commands wait
+        if (Diff_Log_Is_Busy())
+        {
+            return;
+        }
+#endif
+        UART_Command_Execute(UART_Pending[UART_Pending_Tail++ & (UART_PENDING_SIZE - 1)]);
+    }
+}
+
+static void UART_Received(uint32_t character)
+{
+    // The reactor handlers and the tasks run in the same thread, so the pending commands need no lock
+    if (UART_Pending_Head - UART_Pending_Tail < UART_PENDING_SIZE)
+    {
+        UART_Pending[UART_Pending_Head++ & (UART_PENDING_SIZE - 1)] = (char)character;
+    }
+    UART_Service_Task();
+}
+
+static void Stats_Task()
+{
+    // Enter LPM3.5 after one hour without an input change, saving the current outputs of the running pattern
+    LED_State.led1_value = LED1_Status();
+    LED_State.rgb_led_value = LED2_Status();
+    LED_State.pmod_8ld_value = PMOD_8LD_Status();
+    Deep_Sleep_Update(&LED_State);
+    Perf_Counter_Update();
+    LED_Energy_Update();
+#ifdef WS2812_ENABLE
+    WS2812_Update();
+#endif
+}
+
+#ifdef WS2812_ENABLE
+static uint8_t Strip_LEDs;
+static uint8_t Strip_Color = 0xFF;      // Not a color of the RGB LED, so that the first run draws every pixel
+
+static void Strip_Task()
+{
+    uint8_t leds = PMOD_8LD_Status();
+    uint8_t color = LED2_Status();
+    uint8_t changed = (color != Strip_Color) ? 0xFF : (leds ^ Strip_LEDs);
+
+    // Wait for the end of the queued frame before showing the next one, so that no change is dropped
+    if ((changed == 0) || !WS2812_Is_Ready())
+    {
+        return;
+    }
+
+    for (uint8_t led = 0; led < 8; led++)
+    {
+        if (!((changed >> led) & 0x01))
+        {
+            continue;
+        }
+
+        uint8_t level = ((leds >> led) & 0x01) ? STRIP_INTENSITY : 0;
+        for (uint16_t pixel = led; pixel < STRIP_LENGTH; pixel += 8)
+        {
+            WS2812_Set_Pixel(pixel, (color & RGB_LED_RED) ? level : 0, (color & RGB_LED_GREEN) ? level : 0,
+                             (color & RGB_LED_BLUE) ? level : 0);
+        }
+    }
+    Strip_LEDs = leds;
+    Strip_Color = color;
+    WS2812_Show();
+}
+#endif
+
+// Periods and offsets in ticks of 10 ms; the offsets keep the pattern and statistics tasks out of the same tick
+static const Scheduler_Task Tasks[] =
+{
+    {"input scan",  Input_Scan_Task,    1,      0},
+    {"debounce",    Debounce_Task,      1,      0},
+    {"uart",        UART_Service_Task,  2,      1},
+    {"pattern",     Pattern_Task,       PATTERN_PERIOD_MS / SCHEDULER_TICK_MS,  3},
+    {"stats",       Stats_Task,         100,    7},
+#ifdef DIFF_LOG_ENABLE
+    {"diff log",    Diff_Log_Update,    1,      0},
+#endif
+#ifdef WS2812_ENABLE
+    {"strip",       Strip_Task,         1,      0},
+#endif
+};
 
 int main(void)
 {
+    // Record the number of cycles spent before main (see Boot_Get_Main_Entry_Cycles)
+    Boot_Record_Main_Entry();
+
+    // Drive the unused pins low or pull them down so that they do not float (see Pin_Power.h)
+    Pin_Power_Init();
+
+    // If the device woke up from LPM3.5 or LPM4.5, restore the LED outputs and release the I/O lock
+    uint8_t woke_up = Deep_Sleep_Resume(&LED_State);
+
+    // Start a new flight recorder session; the previous session remains readable
+    Flight_Recorder_Init();
+
+    // Clear the performance counters (send 'n' via UART to print them and 'N' for the binary format)
+    Perf_Counter_Init();
+
+    if (woke_up)
+    {
+        Perf_Counter_Increment(PERF_COUNTER_WAKE_UPS);
+        uint32_t latency = Deep_Sleep_Get_Wake_Latency_Cycles();
+        Flight_Recorder_Log(FLIGHT_RECORDER_DEEP_SLEEP_WAKE, 0, (latency > 0xFFFF) ? 0xFFFF : latency);
+    }
+
     // Initialize the 48 MHz Clock
     Clock_Init48MHz();
 
-    // Initialize the built-in red LED and the RGB LEDs
-    LED1_Init();
-    LED2_Init();
+#ifdef PORT_TRACE_ENABLE
+    // Record the writes to the LED ports (send 't' via UART to print the trace and 'T' to clear it)
+    Port_Trace_Init();
+#endif
+
+    // Power down the SRAM banks that are not used by the program
+    SRAM_Power_Init();
+
+    // The pins have already been initialized and the flash log scanned by Deep_Sleep_Resume after a wake-up
+    uint8_t restored = woke_up;
+    if (!woke_up)
+    {
+        // Initialize the built-in red LED and the RGB LEDs
+        LED1_Init();
+        LED2_Init();
+
+        // Initialize the user buttons
+        Buttons_Init();
 
-    // Initialize the user buttons
-    Buttons_Init();
+        // Initialize the PMOD 8LD module
+        PMOD_8LD_Init();
 
-    // Initialize the PMOD 8LD module
-    PMOD_8LD_Init();
+        // Initialize the PMOD SWT module
+        PMOD_SWT_Init();
 
-    // Initialize the PMOD SWT module
-    PMOD_SWT_Init();
+        // Find the LED state saved in INFO flash and restore it before the first LED pattern is executed
+        restored = Flash_Log_Init() && Flash_Log_Restore(&LED_State);
+        if (restored)
+        {
+            LED1_Output(LED_State.led1_value);
+            LED2_Output(LED_State.rgb_led_value);
+            PMOD_8LD_Output(LED_State.pmod_8ld_value);
+        }
+    }
 
-    while(1)
+    // Continue the restored pattern run from its outputs instead of starting it again, with the inputs that selected it
+    if (restored)
     {
-        uint8_t button_status = Get_Buttons_Status();
-        uint8_t switch_status = Get_PMOD_SWT_Status();
-        LED_Controller(button_status, switch_status);
-        Clock_Delay1ms(100);
+        Button_Status = LED_State.button_status;
+        Switch_Status = LED_State.switch_status;
+        Pattern_Wait_ms = LED_Controller_Resume(LED_State.pattern, LED_State.led1_value, LED_State.rgb_led_value,
+                                                LED_State.pmod_8ld_value);
     }
+
+    // Set the priority grouping of the interrupt priority plan before any interrupt is enabled
+    // Send 'i' via UART to print the plan and the entry latencies and 'I' to clear the latencies
+    IRQ_Priority_Init();
+
+#ifdef ISR_LATENCY_ENABLE
+    // Measure the latency of the highest-priority interrupt every 100 us in windows of 1 s, so that the timer
+    // does not wake up the CPU outside of a window (send 'A' via UART to start a window and 'a' to print it)
+    ISR_Latency_Init(ISR_LATENCY_DEFAULT_PERIOD);
+#endif
+
+    // Initialize the UART for the debug commands (see UART_Command.h)
+    EUSCI_A0_UART_Init();
+
+    // Send 'f' via UART to print the flight recorder log of the previous session
+    UART_Command_Register('f', Flight_Recorder_Dump_Previous);
+
+    // Estimate the charge drawn by the LEDs and the CPU (send 'e' via UART to print the report)
+    LED_Energy_Init();
+    LED_Energy_Set_Pattern(LED_Get_Active_Pattern());
+
+    // Measure the period of the input reads against a budget of 110 ms (100 ms period plus one tick for a late pattern task)
+    // Send 'l' via UART to print the loop statistics and 'L' to clear them
+    Loop_Stats_Init((Clock_GetFreq() / 1000) * 110);
+
+    // Set up the DMA controller for the drivers that transmit with DMA
+    DMA_Init();
+
+#ifdef DIFF_LOG_ENABLE
+    // Transmit a line when the LEDs or the inputs change, merging the changes within 50 ms and using at most
+    // 1000 bytes per second of the UART (send 'd' via UART to print the drop counts and 'D' to clear them)
+    Diff_Log_Init(DIFF_LOG_DEFAULT_WINDOW_MS, DIFF_LOG_DEFAULT_CAP);
+#endif
+
+#ifdef PROFILER_ENABLE
+    // Send 'p' via UART to print the profiler table and 'r' to clear it
+    Profiler_Init();
+#endif
+
+#ifdef IRQ_PRIORITY_MEASURE_ENABLE
+    // Measure the entry latency of the reactor interrupt sources about every millisecond
+    IRQ_Priority_Probe_Start(IRQ_PRIORITY_PROBE_PERIOD);
+#endif
+
+#ifdef PC_SAMPLER_ENABLE
+    // Send 's' via UART to print the PC histogram and 'c' to clear it
+    PC_Sampler_Init(PC_SAMPLER_DEFAULT_PERIOD);
+#endif
+
+    // Run the bottom halves of the interrupt handlers in PendSV and measure the top halves against a budget of 10 us
+    // Send 'w' via UART to print the statistics and 'W' to clear them
+    Deferred_Work_Init(DEFERRED_WORK_DEFAULT_BUDGET);
+
+    // Run the tasks from a 10 ms tick of the reactor and sleep between the ticks
+    // Send 'u' via UART to print the reactor statistics and 'x' to print the task statistics ('X' clears them)
+    Reactor_Init();
+    Scheduler_Init(Tasks, sizeof(Tasks) / sizeof(Tasks[0]), SCHEDULER_TIMER, SCHEDULER_TICK_MS);
+
+    // Handle the UART commands from the receive interrupt and restart the debounce on the edges of the buttons
+    Reactor_Register(REACTOR_EVENT_UART_RX, UART_Received);
+    Reactor_Enable_UART_RX();
+    Reactor_Register(REACTOR_EVENT_BUTTONS, Buttons_Changed);
+    Reactor_Enable_Buttons();
+
+#ifdef WS2812_ENABLE
+    // Drive the LED strip on P9.7 instead of LED 7 of the PMOD 8LD; the strip task draws its first frame
+    // Send 'g' via UART to print the frame rate against the strip length and 'G' to clear the statistics
+    WS2812_Init(STRIP_LENGTH);
+#endif
+
+    Loop_Stats_Begin();
+
+#ifdef KERNEL_ENABLE
+    // Run the scheduler in the idle thread of the preemptive kernel, below the threads (send 'k' via UART to print them)
+    Kernel_Init();
+    Kernel_Start(Scheduler_Run);
+#else
+    Scheduler_Run();
+#endif
 }
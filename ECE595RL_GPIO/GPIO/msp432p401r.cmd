@@ -41,7 +41,10 @@
 MEMORY
 {
     MAIN       (RX) : origin = 0x00000000, length = 0x00040000
-    INFO       (RX) : origin = 0x00200000, length = 0x00004000
+    /* INFO bank 1 (0x00202000 - 0x00203FFF) is erased and written by the Flash_Log */
+    /* driver (src/Flash_Log.c), so it is left out of the memory map and the linker */
+    /* cannot place any section there.                                              */
+    INFO       (RX) : origin = 0x00200000, length = 0x00002000
 #ifdef  __TI_COMPILER_VERSION__
 #if     __TI_COMPILER_VERSION__ >= 15009000
     ALIAS
@@ -77,7 +80,7 @@ MEMORY
 SECTIONS
 {
     .intvecs:   > 0x00000000
-    .text   :   > MAIN
+    .text   :   > MAIN, RUN_START(__text_run_start), RUN_END(__text_run_end)
     .const  :   > MAIN
     .cinit  :   > MAIN
     .pinit  :   > MAIN
@@ -91,14 +94,41 @@ SECTIONS
     .flashMailbox : > 0x00200000
     /* TLV table for device identification and characterization              */
     .tlvTable     : > 0x00201000
-    /* BSL area for device bootstrap loader                                  */
-    .bslArea      : > 0x00202000
+    /* The BSL area (0x00202000) is not allocated: INFO bank 1 holds the      */
+    /* LED state of the Flash_Log driver, so the BSL is not available.        */
 
-    .vtable :   > 0x20000000
-    .data   :   > SRAM_DATA
-    .bss    :   > SRAM_DATA
-    .sysmem :   > SRAM_DATA
-    .stack  :   > SRAM_DATA (HIGH)
+    /* .persistent is kept at the start of SRAM bank 0 (directly after the */
+    /* RAM vector table, if one is used) so that its location does not     */
+    /* move when other sections grow.                                      */
+    GROUP : > 0x20000000
+    {
+        .vtable
+        .persistent : type = NOINIT, RUN_SIZE(__persistent_run_size),
+                      RUN_END(__persistent_run_end)
+    }
+
+    /* .data and .bss are initialized by _system_pre_init (src/Boot.c)    */
+    /* using word-wide transfers, so both sections are padded to 4 bytes. */
+    .data   :   load = MAIN, run = SRAM_DATA, palign(4),
+                LOAD_START(__data_load_start),
+                RUN_START(__data_run_start), RUN_SIZE(__data_run_size),
+                RUN_END(__data_run_end)
+    .bss    :   > SRAM_DATA, palign(4),
+                RUN_START(__bss_run_start), RUN_SIZE(__bss_run_size),
+                RUN_END(__bss_run_end)
+    .sysmem :   > SRAM_DATA, RUN_END(__sysmem_run_end)
+    /* .noinit is never initialized (large buffers, trace logs)           */
+    .noinit :   > SRAM_DATA, type = NOINIT, RUN_SIZE(__noinit_run_size),
+                RUN_START(__noinit_run_start), RUN_END(__noinit_run_end)
+    /* .perf_counters holds all performance counters (src/Perf_Counter.c) */
+    /* in one block, so a snapshot is a single copy. It is cleared by     */
+    /* Perf_Counter_Init.                                                 */
+    .perf_counters : > SRAM_DATA, type = NOINIT, RUN_START(__perf_counters_run_start),
+                     RUN_END(__perf_counters_run_end)
+    /* The stack is not placed at the top of SRAM so that all used memory */
+    /* stays in the lowest banks and the unused banks can be powered down */
+    /* by SRAM_Power_Init (src/SRAM_Power.c).                             */
+    .stack  :   > SRAM_DATA
 
 #ifdef  __TI_COMPILER_VERSION__
 #if     __TI_COMPILER_VERSION__ >= 15009000
@@ -0,0 +1,118 @@
+/**
+ * @file Boot.c
+ * @brief Source code for the Boot module.
+ *
+ * This file contains the function definitions for the Boot module.
+ *
+ * The section boundaries used in this file are defined in msp432p401r.cmd.
+ * The .data section is loaded in flash (MAIN) and copied to SRAM (SRAM_DATA) at boot.
+ *
+ */
+
+#include "../inc/Boot.h"
+
+// Value stored in the .persistent section to mark that SRAM has been initialized at least once
+#define BOOT_WARM_MAGIC     0x5741524D
+
+// Section boundaries generated by the linker (see msp432p401r.cmd)
+extern uint32_t __data_load_start;
+extern uint32_t __data_run_start;
+extern uint32_t __data_run_size;
+extern uint32_t __bss_run_start;
+extern uint32_t __bss_run_size;
+extern uint32_t __noinit_run_size;
+extern uint32_t __persistent_run_size;
+
+#pragma DATA_SECTION(Boot_Warm_Marker, ".persistent")
+uint32_t Boot_Warm_Marker;
+
+// Boot statistics (written after .bss has been zero filled)
+static uint32_t Boot_Init_Cycles;
+static uint32_t Boot_Init_Bytes;
+static uint32_t Boot_Main_Entry_Cycles;
+static uint8_t Boot_Warm_Start;
+
+int _system_pre_init(void)
+{
+    uint32_t *src;
+    uint32_t *dst;
+    uint32_t *end;
+    uint32_t start_cycles;
+    uint8_t warm_start;
+
+    // Enable the DWT cycle counter and start counting from zero
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    start_cycles = DWT->CYCCNT;
+
+    // Copy .data from flash to SRAM one word at a time
+    // The section size is padded to a multiple of 4 bytes in the linker command file
+    src = &__data_load_start;
+    dst = &__data_run_start;
+    end = (uint32_t *)((uint32_t)&__data_run_start + (uint32_t)&__data_run_size);
+    while (dst < end)
+    {
+        *dst++ = *src++;
+    }
+
+    // Zero fill .bss one word at a time
+    dst = &__bss_run_start;
+    end = (uint32_t *)((uint32_t)&__bss_run_start + (uint32_t)&__bss_run_size);
+    while (dst < end)
+    {
+        *dst++ = 0;
+    }
+
+    // The .persistent section is left untouched, so the marker survives warm resets
+    warm_start = (Boot_Warm_Marker == BOOT_WARM_MAGIC);
+    Boot_Warm_Marker = BOOT_WARM_MAGIC;
+
+    // .bss is now valid, so the statistics can be stored
+    Boot_Init_Cycles = DWT->CYCCNT - start_cycles;
+    Boot_Init_Bytes = (uint32_t)&__data_run_size + (uint32_t)&__bss_run_size;
+    Boot_Warm_Start = warm_start;
+
+    // Return 0 to skip the C runtime auto-initialization
+    return 0;
+}
+
+void Boot_Record_Main_Entry()
+{
+    Boot_Main_Entry_Cycles = DWT->CYCCNT;
+}
+
+uint32_t Boot_Get_Main_Entry_Cycles()
+{
+    return Boot_Main_Entry_Cycles;
+}
+
+uint32_t Boot_Get_Init_Cycles()
+{
+    return Boot_Init_Cycles;
+}
+
+uint32_t Boot_Get_Init_Bytes()
+{
+    return Boot_Init_Bytes;
+}
+
+uint32_t Boot_Get_Skipped_Bytes()
+{
+    return (uint32_t)&__noinit_run_size + (uint32_t)&__persistent_run_size;
+}
+
+uint32_t Boot_Get_Saved_Cycles()
+{
+    if (Boot_Init_Bytes == 0)
+    {
+        return 0;
+    }
+    return (uint32_t)(((uint64_t)Boot_Init_Cycles * Boot_Get_Skipped_Bytes()) / Boot_Init_Bytes);
+}
+
+uint8_t Boot_Is_Warm_Start()
+{
+    return Boot_Warm_Start;
+}
@@ -0,0 +1,29 @@
+/**
+ * @file CRC16.c
+ * @brief Source code for the CRC16 module.
+ *
+ * This file contains the function definitions for the CRC16 module.
+ *
+ */
+
+#include "../inc/CRC16.h"
+
+// CRC-16/CCITT-FALSE remainders for each 4-bit value
+static const uint16_t CRC16_Table[16] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+uint16_t CRC16_Update(uint16_t crc, const uint8_t *data, uint32_t length)
+{
+    while (length)
+    {
+        // Process the upper nibble and then the lower nibble of each byte
+        crc = (crc << 4) ^ CRC16_Table[(crc >> 12) ^ (*data >> 4)];
+        crc = (crc << 4) ^ CRC16_Table[(crc >> 12) ^ (*data & 0x0F)];
+        data++;
+        length--;
+    }
+    return crc;
+}
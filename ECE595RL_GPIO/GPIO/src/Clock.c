@@ -44,6 +44,8 @@ policies, either expressed or implied, of the FreeBSD Project.
 #include <stdint.h>
 #include "msp.h"
 #include "../inc/Clock.h"
+#include "../inc/Flight_Recorder.h"
+#include "../inc/Profiler.h"
 
 uint32_t ClockFrequency = 3000000; // cycles/second
 //static uint32_t SubsystemFrequency = 3000000; // cycles/second
@@ -81,6 +83,7 @@ void Clock_Init48MHz(void){
     PCM->CLRIFG = 0x00000004;             // clear the transition invalid flag
     // to do: look at CPM bit field in PCMCTL0, figure out what mode you're in, and step through the chart to transition to the mode you want
     // or be lazy and do nothing; this should work out of reset at least, but it WILL NOT work if Clock_Int32kHz() or Clock_InitLowPower() has been called
+    Flight_Recorder_Log(FLIGHT_RECORDER_CLOCK_TRANSITION, 0, ClockFrequency / 1000000);   // the clock is unchanged
     return;
   }
   // wait for the CPM (Current Power Mode) bit field to reflect a change to active mode LDO VCORE1
@@ -127,6 +130,7 @@ void Clock_Init48MHz(void){
            0x00000005;                  // configure for MCLK sourced from HFXTCLK
   CS->KEY = 0;                          // lock CS module from unintended access
   ClockFrequency = 48000000;
+  Flight_Recorder_Log(FLIGHT_RECORDER_CLOCK_TRANSITION, 1, 48);
 //  SubsystemFrequency = 12000000;
 }
 
@@ -154,10 +158,12 @@ void delay(unsigned long ulCount){
 // Inputs: n, number of us to wait
 // Outputs: none
 void Clock_Delay1us(uint32_t n){
+  PROFILER_ENTER();
   n = (382*n)/100;; // 1 us, tuned at 48 MHz
   while(n){
     n--;
   }
+  PROFILER_EXIT(CLOCK_DELAY1US);
 }
 
 // ------------Clock_Delay1ms------------
@@ -165,8 +171,10 @@ void Clock_Delay1us(uint32_t n){
 // Inputs: n, number of msec to wait
 // Outputs: none
 void Clock_Delay1ms(uint32_t n){
+  PROFILER_ENTER();
   while(n){
     delay(ClockFrequency/9162);   // 1 msec, tuned at 48 MHz
     n--;
   }
+  PROFILER_EXIT(CLOCK_DELAY1MS);
 }
@@ -0,0 +1,24 @@
+/**
+ * @file Critical_Section.c
+ * @brief Source code for the Critical_Section module.
+ *
+ * This file contains the function definitions for the Critical_Section module.
+ *
+ * For more information regarding BASEPRI_MAX, refer to the MSR instruction in the Cortex-M4 Devices
+ * Generic User Guide.
+ *
+ */
+
+#include "../inc/Critical_Section.h"
+
+// The argument is passed in R0 and the previous BASEPRI is returned in R0 (AAPCS)
+__asm("    .sect \".text:Critical_Section_Raise\"\n"
+      "    .clink\n"
+      "    .thumbfunc Critical_Section_Raise\n"
+      "    .thumb\n"
+      "    .global Critical_Section_Raise\n"
+      "Critical_Section_Raise:\n"
+      "    MRS     R1, BASEPRI\n"
+      "    MSR     BASEPRI_MAX, R0\n"
+      "    MOV     R0, R1\n"
+      "    BX      LR\n");
@@ -0,0 +1,96 @@
+/**
+ * @file DMA.c
+ * @brief Source code for the DMA driver.
+ *
+ * This file contains the function definitions for the DMA driver.
+ *
+ * The control table holds a primary and an alternate structure for each channel. The controller addresses the
+ * structure of a channel with the bits of the base address below the table size, so the table is aligned to its
+ * size (16 structures of 16 bytes). The alternate structures are only used by ping-pong transfers.
+ *
+ */
+
+#include "../inc/DMA.h"
+
+typedef struct
+{
+    volatile const void *source_end;        // Address of the last byte to read
+    volatile void *destination_end;         // Address of the last byte to write
+    volatile uint32_t control;
+    uint32_t reserved;
+} DMA_Control_Structure;
+
+// Fields of the control word
+#define DMA_CONTROL_DST_INC_NONE    (3u << 30)
+#define DMA_CONTROL_DST_SIZE_8      (0u << 28)
+#define DMA_CONTROL_SRC_INC_8       (0u << 26)
+#define DMA_CONTROL_SRC_SIZE_8      (0u << 24)
+#define DMA_CONTROL_ARBITRATE_1     (0u << 14)
+#define DMA_CONTROL_N_MINUS_1(n)    (((uint32_t)(n) - 1) << 4)
+#define DMA_CONTROL_CYCLE_BASIC     (1u << 0)
+#define DMA_CONTROL_CYCLE_PING_PONG (3u << 0)
+
+#pragma DATA_ALIGN(DMA_Control_Table, 256)
+static DMA_Control_Structure DMA_Control_Table[2 * DMA_NUM_CHANNELS];
+
+void DMA_Init()
+{
+    DMA_Control->ENACLR = 0xFF;
+    DMA_Control->CFG = DMA_CFG_MASTEN;
+    DMA_Control->CTLBASE = (uint32_t)DMA_Control_Table;
+}
+
+void DMA_Start_To_Peripheral(uint8_t channel, uint8_t source, const uint8_t *buffer, volatile void *destination,
+                             uint32_t count)
+{
+    DMA_Set_To_Peripheral(channel, 0, buffer, destination, count, 0);
+    DMA_Enable(channel, source);
+}
+
+void DMA_Set_To_Peripheral(uint8_t channel, uint8_t alternate, const uint8_t *buffer, volatile void *destination,
+                           uint32_t count, uint8_t ping_pong)
+{
+    DMA_Control_Structure *structure = &DMA_Control_Table[channel + (alternate ? DMA_NUM_CHANNELS : 0)];
+
+    structure->source_end = buffer + count - 1;
+    structure->destination_end = destination;
+
+    // The control word is written last, so that the controller never reads a structure that is half written
+    structure->control = DMA_CONTROL_DST_INC_NONE | DMA_CONTROL_DST_SIZE_8
+                       | DMA_CONTROL_SRC_INC_8 | DMA_CONTROL_SRC_SIZE_8
+                       | DMA_CONTROL_ARBITRATE_1 | DMA_CONTROL_N_MINUS_1(count)
+                       | (ping_pong ? DMA_CONTROL_CYCLE_PING_PONG : DMA_CONTROL_CYCLE_BASIC);
+}
+
+void DMA_Enable(uint8_t channel, uint8_t source)
+{
+    uint32_t mask = 1u << channel;
+
+    DMA_Channel->CH_SRCCFG[channel] = source;
+
+    // Primary structure, single and burst requests, requests not masked
+    DMA_Control->ALTCLR = mask;
+    DMA_Control->USEBURSTCLR = mask;
+    DMA_Control->REQMASKCLR = mask;
+    DMA_Control->ENASET = mask;
+}
+
+void DMA_Enable_Interrupt(uint8_t channel)
+{
+    DMA_Channel->INT1_SRCCFG = DMA_INT1_SRCCFG_EN | channel;
+}
+
+void DMA_Clear_Interrupt(uint8_t channel)
+{
+    DMA_Channel->INT0_CLRFLG = 1u << channel;
+}
+
+uint8_t DMA_Is_Busy(uint8_t channel)
+{
+    return (DMA_Control->ENASET & (1u << channel)) != 0;
+}
+
+void DMA_Stop(uint8_t channel)
+{
+    DMA_Control->ENACLR = 1u << channel;
+}
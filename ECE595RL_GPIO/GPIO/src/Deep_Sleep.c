@@ -0,0 +1,196 @@
+/**
+ * @file Deep_Sleep.c
+ * @brief Source code for the Deep_Sleep driver.
+ *
+ * This file contains the function definitions for the Deep_Sleep driver.
+ *
+ * For more information regarding LPM3.5 and LPM4.5, refer to the Power Control Manager (PCM) section
+ * of the MSP432Pxx Microcontrollers Technical Reference Manual.
+ *
+ */
+
+#include "../inc/Deep_Sleep.h"
+#include "../inc/Clock.h"
+#include "../inc/Flight_Recorder.h"
+#include "../inc/GPIO.h"
+#include "../inc/IRQ_Priority.h"
+#include "../inc/ISR_Latency.h"
+#include "../inc/PC_Sampler.h"
+#include "../inc/Perf_Counter.h"
+#include "../inc/Reactor.h"
+
+// Value stored in the .persistent section when the LED state has been saved before entering LPM3.5
+#define DEEP_SLEEP_MAGIC    0x534C5050
+
+// The user buttons (P1.1 and P1.4) are the wake-up sources
+#define DEEP_SLEEP_BUTTONS  0x12
+
+typedef struct
+{
+    uint32_t magic;
+    Flash_Log_State state;
+} Deep_Sleep_Saved_State;
+
+// SRAM bank 0 is retained in LPM3.5, so the LED state can be restored without reading flash
+#pragma DATA_SECTION(Deep_Sleep_Saved, ".persistent")
+Deep_Sleep_Saved_State Deep_Sleep_Saved;
+
+static uint32_t Deep_Sleep_Timeout_ms = DEEP_SLEEP_DEFAULT_TIMEOUT;
+static uint8_t Deep_Sleep_Mode = DEEP_SLEEP_LPM35;
+static uint32_t Deep_Sleep_Idle_ms;
+static uint32_t Deep_Sleep_Idle_Cycles;
+static uint32_t Deep_Sleep_Last_Cycles;
+static uint8_t Deep_Sleep_Last_Buttons;
+static uint8_t Deep_Sleep_Last_Switches;
+static uint32_t Deep_Sleep_Wake_Latency_Cycles;
+
+static void Deep_Sleep_Wait_PCM_Idle()
+{
+    while (PCM->CTL1 & PCM_CTL1_PMR_BUSY);
+}
+
+static void Deep_Sleep_Unlock_IO()
+{
+    PCM->CTL1 = PCM_CTL1_KEY_VAL | (PCM->CTL1 & ~(PCM_CTL1_KEY_MASK | PCM_CTL1_LOCKLPM5));
+}
+
+static void Deep_Sleep_Clock_Init3MHz()
+{
+    // Run MCLK, HSMCLK and SMCLK from the 3 MHz DCO and ACLK from REFOCLK
+    CS->KEY = 0x695A;
+    CS->CTL0 = 0x00010000;                  // DCORSEL = 1 (3 MHz nominal)
+    CS->CTL1 = 0x00000233;                  // SELA = REFOCLK, SELS = DCOCLK, SELM = DCOCLK, no dividers
+    CS->CTL2 &= ~0x01000000;                // disable HFXT
+    CS->KEY = 0;
+
+    // Request active mode LDO VCORE0, which supports up to 24 MHz
+    Deep_Sleep_Wait_PCM_Idle();
+    PCM->CTL0 = PCM_CTL0_KEY_VAL | (PCM->CTL0 & ~(PCM_CTL0_KEY_MASK | PCM_CTL0_AMR_MASK));
+    Deep_Sleep_Wait_PCM_Idle();
+}
+
+uint8_t Deep_Sleep_Resume(Flash_Log_State *state)
+{
+    uint32_t pcm_reset_status = RSTCTL->PCMRESET_STAT;
+
+    if ((pcm_reset_status & (RSTCTL_PCMRESET_STAT_LPM35 | RSTCTL_PCMRESET_STAT_LPM45)) == 0)
+    {
+        return 0;
+    }
+
+    // The PCM reset flags are left set, so that Flight_Recorder_Init records the wake-up as a PCM reset and clears them
+
+    // LPM3.5 retains SRAM bank 0; otherwise use the most recent state saved in INFO flash
+    uint8_t restored_from_sram = (pcm_reset_status & RSTCTL_PCMRESET_STAT_LPM35) && (Deep_Sleep_Saved.magic == DEEP_SLEEP_MAGIC);
+    if (restored_from_sram)
+    {
+        *state = Deep_Sleep_Saved.state;
+    }
+    else if (Flash_Log_Init())
+    {
+        Flash_Log_Restore(state);
+    }
+    Deep_Sleep_Saved.magic = 0;
+
+    // The pins keep their state until the I/O lock is released, so the LEDs do not glitch
+    LED1_Init();
+    LED2_Init();
+    Buttons_Init();
+    PMOD_8LD_Init();
+    PMOD_SWT_Init();
+    LED1_Output(state->led1_value);
+    LED2_Output(state->rgb_led_value);
+    PMOD_8LD_Output(state->pmod_8ld_value);
+
+    // Disable the wake-up interrupts of the user buttons
+    P1->IE &= ~DEEP_SLEEP_BUTTONS;
+    P1->IFG &= ~DEEP_SLEEP_BUTTONS;
+
+    Deep_Sleep_Unlock_IO();
+    Deep_Sleep_Wake_Latency_Cycles = DWT->CYCCNT;
+
+    // Flash_Log_Save needs the next free location of the log, so scan the flash once the LEDs have been restored
+    if (restored_from_sram)
+    {
+        Flash_Log_Init();
+    }
+
+    return 1;
+}
+
+void Deep_Sleep_Set_Policy(uint32_t timeout_ms, uint8_t mode)
+{
+    Deep_Sleep_Timeout_ms = timeout_ms;
+    Deep_Sleep_Mode = mode;
+    Deep_Sleep_Idle_ms = 0;
+}
+
+void Deep_Sleep_Update(const Flash_Log_State *state)
+{
+    uint32_t cycles = DWT->CYCCNT;
+    uint32_t cycles_per_ms = Clock_GetFreq() / 1000;
+
+    // Accumulate the elapsed time in cycles and convert whole milliseconds
+    Deep_Sleep_Idle_Cycles += cycles - Deep_Sleep_Last_Cycles;
+    Deep_Sleep_Last_Cycles = cycles;
+    Deep_Sleep_Idle_ms += Deep_Sleep_Idle_Cycles / cycles_per_ms;
+    Deep_Sleep_Idle_Cycles %= cycles_per_ms;
+
+    if ((state->button_status != Deep_Sleep_Last_Buttons) || (state->switch_status != Deep_Sleep_Last_Switches))
+    {
+        Deep_Sleep_Last_Buttons = state->button_status;
+        Deep_Sleep_Last_Switches = state->switch_status;
+        Deep_Sleep_Idle_ms = 0;
+        return;
+    }
+
+    if ((Deep_Sleep_Timeout_ms != 0) && (Deep_Sleep_Idle_ms >= Deep_Sleep_Timeout_ms))
+    {
+        Deep_Sleep_Enter(state);
+        Deep_Sleep_Idle_ms = 0;
+    }
+}
+
+void Deep_Sleep_Enter(const Flash_Log_State *state)
+{
+    // Save the LED state in SRAM bank 0 (LPM3.5) and in INFO flash (LPM4.5)
+    Deep_Sleep_Saved.state = *state;
+    Deep_Sleep_Saved.magic = DEEP_SLEEP_MAGIC;
+    Flash_Log_Save(state);
+    Flight_Recorder_Log(FLIGHT_RECORDER_DEEP_SLEEP_ENTER, Deep_Sleep_Mode, 0);
+
+    // Wake up on a falling edge of P1.1 or P1.4 (button pressed)
+    P1->IES |= DEEP_SLEEP_BUTTONS;
+    P1->IFG &= ~DEEP_SLEEP_BUTTONS;
+    P1->IE |= DEEP_SLEEP_BUTTONS;
+
+    // A pending timer interrupt would abort the transition, and Timer_A cannot run from SMCLK in LPM3.5
+    ISR_Latency_Stop();
+    IRQ_Priority_Probe_Stop();
+    PC_Sampler_Stop();
+    Reactor_Suspend();
+    Deep_Sleep_Clock_Init3MHz();
+
+    // Request LPM3.5 or LPM4.5 and enter deep sleep
+    PCM->CLRIFG = PCM_CLRIFG_CLR_LPM_INVALID_TR_IFG | PCM_CLRIFG_CLR_LPM_INVALID_CLK_IFG;
+    PCM->CTL0 = PCM_CTL0_KEY_VAL
+              | (PCM->CTL0 & ~(PCM_CTL0_KEY_MASK | PCM_CTL0_LPMR_MASK))
+              | ((Deep_Sleep_Mode == DEEP_SLEEP_LPM45) ? PCM_CTL0_LPMR_12 : PCM_CTL0_LPMR_10);
+    SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+    __WFI();
+
+    // Execution only continues here if the transition was rejected or a wake-up event was already pending
+    SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+    PCM->CTL0 = PCM_CTL0_KEY_VAL | (PCM->CTL0 & ~(PCM_CTL0_KEY_MASK | PCM_CTL0_LPMR_MASK));
+    P1->IE &= ~DEEP_SLEEP_BUTTONS;
+    P1->IFG &= ~DEEP_SLEEP_BUTTONS;
+    Deep_Sleep_Saved.magic = 0;
+    Clock_Init48MHz();
+    Reactor_Resume();
+    Perf_Counter_Increment(PERF_COUNTER_WAKE_UPS);
+}
+
+uint32_t Deep_Sleep_Get_Wake_Latency_Cycles()
+{
+    return Deep_Sleep_Wake_Latency_Cycles;
+}
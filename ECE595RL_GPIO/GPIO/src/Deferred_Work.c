@@ -0,0 +1,186 @@
+/**
+ * @file Deferred_Work.c
+ * @brief Source code for the Deferred_Work module.
+ *
+ * This file contains the function definitions for the Deferred_Work module.
+ *
+ * Deferred_Work_Head counts the slots claimed by Deferred_Work_Post and Deferred_Work_Tail the work items run by
+ * the PendSV handler. A slot is free when its function is 0: the PendSV handler clears the function before it
+ * advances the tail, so a slot is never claimed again before it has been read.
+ *
+ */
+
+#include "../inc/Deferred_Work.h"
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/Flight_Recorder.h"
+#include "../inc/IRQ_Priority.h"
+#include "../inc/UART_Command.h"
+
+typedef struct
+{
+    volatile Deferred_Work_Function function;
+    volatile uint32_t argument;
+} Deferred_Work_Item;
+
+static Deferred_Work_Item Deferred_Work_Queue[DEFERRED_WORK_QUEUE_SIZE];
+static volatile uint32_t Deferred_Work_Head;
+static volatile uint32_t Deferred_Work_Tail;
+
+static uint32_t Deferred_Work_Budget;
+static Deferred_Work_Top_Half_Stats Deferred_Work_Top_Halves[DEFERRED_WORK_NUM_ISRS];
+static uint32_t Deferred_Work_Count;
+static uint32_t Deferred_Work_Max_Cycles;
+static volatile uint32_t Deferred_Work_Dropped;
+static volatile uint32_t Deferred_Work_Max_Depth;
+
+static const char * const Deferred_Work_ISR_Names[DEFERRED_WORK_NUM_ISRS] = {"ta1_n", "port1", "eusci_a0", "dma_int1"};
+
+// Bottom half of an overrun: argument = interrupt handler | (cycles << 8)
+static void Deferred_Work_Log_Overrun(uint32_t argument)
+{
+    uint32_t cycles = argument >> 8;
+
+    Flight_Recorder_Log(FLIGHT_RECORDER_ISR_OVERRUN, argument & 0xFF, (cycles > 0xFFFF) ? 0xFFFF : cycles);
+}
+
+void Deferred_Work_Init(uint32_t budget_cycles)
+{
+    for (int i = 0; i < DEFERRED_WORK_QUEUE_SIZE; i++)
+    {
+        Deferred_Work_Queue[i].function = 0;
+    }
+    Deferred_Work_Head = 0;
+    Deferred_Work_Tail = 0;
+    Deferred_Work_Budget = budget_cycles;
+    Deferred_Work_Reset();
+
+    UART_Command_Register('w', Deferred_Work_Dump);
+    UART_Command_Register('W', Deferred_Work_Reset);
+
+    // Lowest priority level, so that PendSV only runs when no other handler is active
+    IRQ_Priority_Apply(IRQ_PRIORITY_PENDSV);
+}
+
+uint8_t Deferred_Work_Post(Deferred_Work_Function function, uint32_t argument)
+{
+    uint32_t head;
+    uint32_t depth;
+
+    // Claim a slot; the store fails and is retried if an interrupt posted a work item in between
+    do
+    {
+        head = __ldrex((void *)&Deferred_Work_Head);
+        depth = head - Deferred_Work_Tail;
+        if (depth >= DEFERRED_WORK_QUEUE_SIZE)
+        {
+            Deferred_Work_Dropped++;
+            return 1;
+        }
+    } while (__strex(head + 1, (void *)&Deferred_Work_Head));
+
+    // The function is written last, since it marks the slot as ready for the PendSV handler
+    Deferred_Work_Item *item = &Deferred_Work_Queue[head & (DEFERRED_WORK_QUEUE_SIZE - 1)];
+    item->argument = argument;
+    item->function = function;
+
+    if (depth + 1 > Deferred_Work_Max_Depth)
+    {
+        Deferred_Work_Max_Depth = depth + 1;
+    }
+
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    return 0;
+}
+
+void Deferred_Work_Top_Half_End(Deferred_Work_ISR isr, uint32_t start)
+{
+    uint32_t cycles = DWT->CYCCNT - start;
+    Deferred_Work_Top_Half_Stats *stats = &Deferred_Work_Top_Halves[isr];
+
+    // Each interrupt handler only updates its own statistics, so they are not shared with other handlers
+    stats->count++;
+    if (cycles > stats->max_cycles)
+    {
+        stats->max_cycles = cycles;
+    }
+    if ((Deferred_Work_Budget != 0) && (cycles > Deferred_Work_Budget))
+    {
+        stats->overruns++;
+        Deferred_Work_Post(Deferred_Work_Log_Overrun, isr | (cycles << 8));
+    }
+}
+
+void Deferred_Work_Get_Top_Half_Stats(Deferred_Work_ISR isr, Deferred_Work_Top_Half_Stats *stats)
+{
+    *stats = Deferred_Work_Top_Halves[isr];
+}
+
+void Deferred_Work_Reset()
+{
+    for (int isr = 0; isr < DEFERRED_WORK_NUM_ISRS; isr++)
+    {
+        Deferred_Work_Top_Halves[isr] = (Deferred_Work_Top_Half_Stats){0};
+    }
+    Deferred_Work_Count = 0;
+    Deferred_Work_Max_Cycles = 0;
+    Deferred_Work_Dropped = 0;
+    Deferred_Work_Max_Depth = 0;
+}
+
+void Deferred_Work_Dump()
+{
+    EUSCI_A0_UART_OutString("Deferred work: ");
+    EUSCI_A0_UART_OutUDec(Deferred_Work_Count);
+    EUSCI_A0_UART_OutString(" items, ");
+    EUSCI_A0_UART_OutUDec(Deferred_Work_Dropped);
+    EUSCI_A0_UART_OutString(" dropped, max depth ");
+    EUSCI_A0_UART_OutUDec(Deferred_Work_Max_Depth);
+    EUSCI_A0_UART_OutString(", max ");
+    EUSCI_A0_UART_OutUDec(Deferred_Work_Max_Cycles);
+    EUSCI_A0_UART_OutString(" cycles\r\nTop half budget: ");
+    EUSCI_A0_UART_OutUDec(Deferred_Work_Budget);
+    EUSCI_A0_UART_OutString(" cycles\r\n");
+
+    for (int isr = 0; isr < DEFERRED_WORK_NUM_ISRS; isr++)
+    {
+        const Deferred_Work_Top_Half_Stats *stats = &Deferred_Work_Top_Halves[isr];
+
+        EUSCI_A0_UART_OutString((char *)Deferred_Work_ISR_Names[isr]);
+        EUSCI_A0_UART_OutString(": ");
+        EUSCI_A0_UART_OutUDec(stats->count);
+        EUSCI_A0_UART_OutString(" runs, max ");
+        EUSCI_A0_UART_OutUDec(stats->max_cycles);
+        EUSCI_A0_UART_OutString(" cycles, ");
+        EUSCI_A0_UART_OutUDec(stats->overruns);
+        EUSCI_A0_UART_OutString(" overruns\r\n");
+    }
+}
+
+void Deferred_Work_Run()
+{
+    while (1)
+    {
+        Deferred_Work_Item *item = &Deferred_Work_Queue[Deferred_Work_Tail & (DEFERRED_WORK_QUEUE_SIZE - 1)];
+        Deferred_Work_Function function = item->function;
+
+        // Empty queue, or the next slot has been claimed by a Deferred_Work_Post that has been interrupted
+        if (function == 0)
+        {
+            break;
+        }
+
+        uint32_t argument = item->argument;
+        item->function = 0;
+        Deferred_Work_Tail++;
+
+        uint32_t start = DWT->CYCCNT;
+        function(argument);
+        uint32_t cycles = DWT->CYCCNT - start;
+
+        Deferred_Work_Count++;
+        if (cycles > Deferred_Work_Max_Cycles)
+        {
+            Deferred_Work_Max_Cycles = cycles;
+        }
+    }
+}
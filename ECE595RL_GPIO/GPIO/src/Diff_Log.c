@@ -0,0 +1,312 @@
+/**
+ * @file Diff_Log.c
+ * @brief Source code for the Diff_Log module.
+ *
+ * This file contains the function definitions for the Diff_Log module.
+ *
+ * Diff_Log_Head and Diff_Log_Tail count the bytes written into and transmitted from the transmit buffer.
+ * A DMA transfer covers the bytes from the tail to the head or to the end of the buffer, whichever comes first;
+ * the tail is only advanced once the transfer has completed, so Diff_Log_Update never writes over bytes that the
+ * DMA controller has not read yet.
+ *
+ * The tokens of the bandwidth cap are counted in thousandths of a byte, so that a cap in bytes per second adds
+ * cap tokens per millisecond without a remainder.
+ *
+ */
+
+#include "../inc/Diff_Log.h"
+#include "../inc/Clock.h"
+#include "../inc/Critical_Section.h"
+#include "../inc/DMA.h"
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/GPIO.h"
+#include "../inc/UART_Command.h"
+
+#ifdef DIFF_LOG_ENABLE
+
+// Longest line: "diff", the time, five signals with a 32-bit count of changes, the drop count and "\r\n"
+#define DIFF_LOG_LINE_MAX       160
+
+static const char *const Diff_Log_Names[DIFF_LOG_NUM_SIGNALS] = {"led1", "rgb", "8ld", "btn", "swt"};
+
+static volatile uint8_t Diff_Log_Value[DIFF_LOG_NUM_SIGNALS];
+static volatile uint32_t Diff_Log_Changes[DIFF_LOG_NUM_SIGNALS];
+static volatile uint8_t Diff_Log_Pending;
+static volatile uint32_t Diff_Log_Window_Start;
+
+static uint8_t Diff_Log_Buffer[DIFF_LOG_BUFFER_SIZE];
+static uint32_t Diff_Log_Head;
+static uint32_t Diff_Log_Tail;
+static uint32_t Diff_Log_Sending;
+
+static uint32_t Diff_Log_Window_ms;
+static uint32_t Diff_Log_Window_Cycles;
+static uint32_t Diff_Log_Cap;
+static uint32_t Diff_Log_Tokens;
+static uint32_t Diff_Log_Cycles_Per_ms;
+static uint32_t Diff_Log_Last_Cycles;
+static uint32_t Diff_Log_Remainder_Cycles;
+static uint32_t Diff_Log_Time_ms;
+static uint32_t Diff_Log_Dropped_Since;
+static Diff_Log_Stats Diff_Log_Statistics;
+
+static uint32_t Diff_Log_Put_String(char *line, uint32_t length, const char *string)
+{
+    while (*string)
+    {
+        line[length++] = *string++;
+    }
+    return length;
+}
+
+static uint32_t Diff_Log_Put_Number(char *line, uint32_t length, uint32_t number, uint32_t base)
+{
+    char digits[10];
+    int count = 0;
+
+    do
+    {
+        digits[count++] = "0123456789abcdef"[number % base];
+        number /= base;
+    } while (number != 0);
+
+    while (count > 0)
+    {
+        line[length++] = digits[--count];
+    }
+    return length;
+}
+
+// Starts the transfer of the buffered bytes when the previous transfer has completed
+static void Diff_Log_Transmit()
+{
+    if (DMA_Is_Busy(DMA_CHANNEL_UART_TX))
+    {
+        return;
+    }
+    Diff_Log_Tail += Diff_Log_Sending;
+    Diff_Log_Sending = 0;
+
+    uint32_t count = Diff_Log_Head - Diff_Log_Tail;
+    uint32_t offset = Diff_Log_Tail % DIFF_LOG_BUFFER_SIZE;
+
+    // A character written by EUSCI_A0_UART_OutChar is still waiting in the transmit buffer of the UART
+    if ((count == 0) || !(EUSCI_A0->IFG & EUSCI_A_IFG_TXIFG))
+    {
+        return;
+    }
+    if (count > DIFF_LOG_BUFFER_SIZE - offset)
+    {
+        count = DIFF_LOG_BUFFER_SIZE - offset;
+    }
+
+    // Clear TXIFG before the channel is enabled and set it again after, so that the first request is raised
+    // whether the trigger is sensitive to the level or to the edge of the flag
+    EUSCI_A0->IFG &= ~EUSCI_A_IFG_TXIFG;
+    DMA_Start_To_Peripheral(DMA_CHANNEL_UART_TX, DMA_SOURCE_UART_TX, &Diff_Log_Buffer[offset],
+                            &EUSCI_A0->TXBUF, count);
+    EUSCI_A0->IFG |= EUSCI_A_IFG_TXIFG;
+    Diff_Log_Sending = count;
+}
+
+void Diff_Log_Init(uint32_t window_ms, uint32_t cap)
+{
+    Diff_Log_Window_ms = window_ms;
+    Diff_Log_Cycles_Per_ms = Clock_GetFreq() / 1000;
+    Diff_Log_Window_Cycles = window_ms * Diff_Log_Cycles_Per_ms;
+    Diff_Log_Cap = cap;
+    Diff_Log_Tokens = DIFF_LOG_BURST_BYTES * 1000;
+    Diff_Log_Last_Cycles = DWT->CYCCNT;
+    Diff_Log_Remainder_Cycles = 0;
+    Diff_Log_Time_ms = 0;
+    Diff_Log_Head = 0;
+    Diff_Log_Tail = 0;
+    Diff_Log_Sending = 0;
+    Diff_Log_Reset();
+
+    // The first line contains every signal
+    uint32_t state = Critical_Section_Enter(CRITICAL_SECTION_GPIO);
+    Diff_Log_Value[DIFF_LOG_LED1] = LED1_Status();
+    Diff_Log_Value[DIFF_LOG_LED2] = LED2_Status();
+    Diff_Log_Value[DIFF_LOG_PMOD_8LD] = PMOD_8LD_Status();
+    Diff_Log_Value[DIFF_LOG_BUTTONS] = Get_Buttons_Status();
+    Diff_Log_Value[DIFF_LOG_SWITCHES] = Get_PMOD_SWT_Status();
+    for (int signal = 0; signal < DIFF_LOG_NUM_SIGNALS; signal++)
+    {
+        Diff_Log_Changes[signal] = 1;
+    }
+    Diff_Log_Window_Start = DWT->CYCCNT - Diff_Log_Window_Cycles;
+    Diff_Log_Pending = 1;
+    Critical_Section_Exit(state);
+
+    UART_Command_Register('d', Diff_Log_Dump);
+    UART_Command_Register('D', Diff_Log_Reset);
+}
+
+void Diff_Log_Record(Diff_Log_Signal signal, uint8_t value)
+{
+    uint32_t state = Critical_Section_Enter(CRITICAL_SECTION_GPIO);
+
+    if (value != Diff_Log_Value[signal])
+    {
+        Diff_Log_Value[signal] = value;
+        Diff_Log_Changes[signal]++;
+        if (!Diff_Log_Pending)
+        {
+            Diff_Log_Pending = 1;
+            Diff_Log_Window_Start = DWT->CYCCNT;
+        }
+    }
+    Critical_Section_Exit(state);
+}
+
+void Diff_Log_Update()
+{
+    uint32_t now = DWT->CYCCNT;
+
+    // Advance the time and refill the token bucket by whole milliseconds
+    Diff_Log_Remainder_Cycles += now - Diff_Log_Last_Cycles;
+    Diff_Log_Last_Cycles = now;
+    uint32_t elapsed_ms = Diff_Log_Remainder_Cycles / Diff_Log_Cycles_Per_ms;
+    Diff_Log_Remainder_Cycles -= elapsed_ms * Diff_Log_Cycles_Per_ms;
+    Diff_Log_Time_ms += elapsed_ms;
+
+    uint32_t room = DIFF_LOG_BURST_BYTES * 1000 - Diff_Log_Tokens;
+    Diff_Log_Tokens += (elapsed_ms * Diff_Log_Cap < room) ? (elapsed_ms * Diff_Log_Cap) : room;
+
+    Diff_Log_Transmit();
+
+    if (!Diff_Log_Pending || ((now - Diff_Log_Window_Start) < Diff_Log_Window_Cycles))
+    {
+        return;
+    }
+
+    uint8_t values[DIFF_LOG_NUM_SIGNALS];
+    uint32_t changes[DIFF_LOG_NUM_SIGNALS];
+    uint32_t state = Critical_Section_Enter(CRITICAL_SECTION_GPIO);
+    for (int signal = 0; signal < DIFF_LOG_NUM_SIGNALS; signal++)
+    {
+        values[signal] = Diff_Log_Value[signal];
+        changes[signal] = Diff_Log_Changes[signal];
+    }
+    Critical_Section_Exit(state);
+
+    char line[DIFF_LOG_LINE_MAX];
+    uint32_t length = Diff_Log_Put_String(line, 0, "diff ");
+    uint32_t total_changes = 0;
+    uint32_t signals = 0;
+
+    length = Diff_Log_Put_Number(line, length, Diff_Log_Time_ms, 10);
+    for (int signal = 0; signal < DIFF_LOG_NUM_SIGNALS; signal++)
+    {
+        if (changes[signal] == 0)
+        {
+            continue;
+        }
+        line[length++] = ' ';
+        length = Diff_Log_Put_String(line, length, Diff_Log_Names[signal]);
+        line[length++] = '=';
+        length = Diff_Log_Put_Number(line, length, values[signal], 16);
+        if (changes[signal] > 1)
+        {
+            length = Diff_Log_Put_String(line, length, "(x");
+            length = Diff_Log_Put_Number(line, length, changes[signal], 10);
+            line[length++] = ')';
+        }
+        total_changes += changes[signal];
+        signals++;
+    }
+    if (Diff_Log_Dropped_Since != 0)
+    {
+        length = Diff_Log_Put_String(line, length, " drop=");
+        length = Diff_Log_Put_Number(line, length, Diff_Log_Dropped_Since, 10);
+    }
+    length = Diff_Log_Put_String(line, length, "\r\n");
+
+    // Drop the line and try again one window later; the changes stay pending
+    uint8_t over_cap = (length * 1000 > Diff_Log_Tokens);
+    if (over_cap || (length > DIFF_LOG_BUFFER_SIZE - (Diff_Log_Head - Diff_Log_Tail)))
+    {
+        if (over_cap)
+        {
+            Diff_Log_Statistics.dropped_cap++;
+        }
+        else
+        {
+            Diff_Log_Statistics.dropped_full++;
+        }
+        Diff_Log_Dropped_Since++;
+        Diff_Log_Window_Start = now;
+        return;
+    }
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        Diff_Log_Buffer[(Diff_Log_Head + i) % DIFF_LOG_BUFFER_SIZE] = line[i];
+    }
+    Diff_Log_Head += length;
+    Diff_Log_Tokens -= length * 1000;
+    Diff_Log_Dropped_Since = 0;
+
+    Diff_Log_Statistics.lines++;
+    Diff_Log_Statistics.bytes += length;
+    Diff_Log_Statistics.changes += total_changes;
+    Diff_Log_Statistics.coalesced += total_changes - signals;
+
+    // Remove the logged changes; the changes recorded since the snapshot open a new window
+    state = Critical_Section_Enter(CRITICAL_SECTION_GPIO);
+    uint8_t pending = 0;
+    for (int signal = 0; signal < DIFF_LOG_NUM_SIGNALS; signal++)
+    {
+        Diff_Log_Changes[signal] -= changes[signal];
+        pending |= (Diff_Log_Changes[signal] != 0);
+    }
+    Diff_Log_Pending = pending;
+    if (pending)
+    {
+        Diff_Log_Window_Start = now;
+    }
+    Critical_Section_Exit(state);
+
+    Diff_Log_Transmit();
+}
+
+uint8_t Diff_Log_Is_Busy()
+{
+    return DMA_Is_Busy(DMA_CHANNEL_UART_TX) || (Diff_Log_Head != Diff_Log_Tail + Diff_Log_Sending);
+}
+
+void Diff_Log_Get_Stats(Diff_Log_Stats *stats)
+{
+    *stats = Diff_Log_Statistics;
+}
+
+void Diff_Log_Reset()
+{
+    Diff_Log_Statistics = (Diff_Log_Stats){0};
+}
+
+void Diff_Log_Dump()
+{
+    EUSCI_A0_UART_OutString("Diff log: window ");
+    EUSCI_A0_UART_OutUDec(Diff_Log_Window_ms);
+    EUSCI_A0_UART_OutString(" ms, cap ");
+    EUSCI_A0_UART_OutUDec(Diff_Log_Cap);
+    EUSCI_A0_UART_OutString(" bytes/s, ");
+    EUSCI_A0_UART_OutUDec(Diff_Log_Statistics.lines);
+    EUSCI_A0_UART_OutString(" lines, ");
+    EUSCI_A0_UART_OutUDec(Diff_Log_Statistics.bytes);
+    EUSCI_A0_UART_OutString(" bytes, ");
+    EUSCI_A0_UART_OutUDec(Diff_Log_Statistics.changes);
+    EUSCI_A0_UART_OutString(" changes (");
+    EUSCI_A0_UART_OutUDec(Diff_Log_Statistics.coalesced);
+    EUSCI_A0_UART_OutString(" coalesced)\r\n");
+
+    EUSCI_A0_UART_OutString("Dropped lines: ");
+    EUSCI_A0_UART_OutUDec(Diff_Log_Statistics.dropped_cap);
+    EUSCI_A0_UART_OutString(" by the cap, ");
+    EUSCI_A0_UART_OutUDec(Diff_Log_Statistics.dropped_full);
+    EUSCI_A0_UART_OutString(" by a full buffer\r\n");
+}
+
+#endif /* DIFF_LOG_ENABLE */
@@ -14,9 +14,13 @@
  */
 
 #include "../inc/EUSCI_A0_UART.h"
+#include "../inc/Flight_Recorder.h"
+#include "../inc/Perf_Counter.h"
+#include "../inc/Profiler.h"
 
 void EUSCI_A0_UART_Init()
 {
+    PROFILER_ENTER();
     // Hold the EUSCI_A0 module in reset mode
     EUSCI_A0->CTLW0 |= 1;
 
@@ -45,24 +49,42 @@ void EUSCI_A0_UART_Init()
     // - Start Bit Interrupt
     // - Transmit Complete Interrupt
     EUSCI_A0->IE &= ~0xF;
+    PROFILER_EXIT(UART_INIT);
 }
 
 char EUSCI_A0_UART_InChar()
 {
+    PROFILER_ENTER();
     while((EUSCI_A0->IFG&0x01) == 0);
 
-    return((char)(EUSCI_A0->RXBUF));
+    // Read the receive errors (framing, overrun, parity) before RXBUF, since reading RXBUF clears them
+    // RXBUF is read once, so that the logged character is the one returned even if another one arrives
+    uint16_t status = EUSCI_A0->STATW;
+    char letter = (char)(EUSCI_A0->RXBUF);
+    if (status & 0x74)
+    {
+        Flight_Recorder_Log(FLIGHT_RECORDER_UART_ERROR, status, (uint8_t)letter);
+        Perf_Counter_Increment(PERF_COUNTER_UART_ERRORS);
+    }
+    Perf_Counter_Increment(PERF_COUNTER_UART_BYTES_IN);
+
+    PROFILER_EXIT(UART_INCHAR);
+    return(letter);
 }
 
 void EUSCI_A0_UART_OutChar(char letter)
 {
+    PROFILER_ENTER();
     while((EUSCI_A0->IFG&0x02) == 0);
 
     EUSCI_A0->TXBUF = letter;
+    Perf_Counter_Increment(PERF_COUNTER_UART_BYTES_OUT);
+    PROFILER_EXIT(UART_OUTCHAR);
 }
 
 void EUSCI_A0_UART_InString(char *bufPt, uint16_t max)
 {
+    PROFILER_ENTER();
     int length = 0;
     char character = EUSCI_A0_UART_InChar();
 
@@ -87,19 +109,23 @@ void EUSCI_A0_UART_InString(char *bufPt, uint16_t max)
         character = EUSCI_A0_UART_InChar();
     }
     *bufPt = 0;
+    PROFILER_EXIT(UART_INSTRING);
 }
 
 void EUSCI_A0_UART_OutString(char *pt)
 {
+    PROFILER_ENTER();
     while(*pt)
     {
         EUSCI_A0_UART_OutChar(*pt);
         pt++;
     }
+    PROFILER_EXIT(UART_OUTSTRING);
 }
 
 uint32_t EUSCI_A0_UART_InUDec()
 {
+    PROFILER_ENTER();
     uint32_t number = 0;
     uint32_t length = 0;
     char character = EUSCI_A0_UART_InChar();
@@ -126,21 +152,25 @@ uint32_t EUSCI_A0_UART_InUDec()
         }
         character = EUSCI_A0_UART_InChar();
     }
+  PROFILER_EXIT(UART_INUDEC);
   return number;
 }
 
 void EUSCI_A0_UART_OutUDec(uint32_t n)
 {
+    PROFILER_ENTER();
     if (n >= 10)
     {
         EUSCI_A0_UART_OutUDec(n/10);
         n = n%10;
     }
     EUSCI_A0_UART_OutChar(n + '0'); /* n is between 0 and 9 */
+    PROFILER_EXIT(UART_OUTUDEC);
 }
 
 void EUSCI_A0_UART_OutSDec(int32_t n)
 {
+    PROFILER_ENTER();
     if (n < 0)
     {
         EUSCI_A0_UART_OutChar('-');
@@ -150,13 +180,16 @@ void EUSCI_A0_UART_OutSDec(int32_t n)
     {
         EUSCI_A0_UART_OutUDec(n);
     }
+    PROFILER_EXIT(UART_OUTSDEC);
 }
 
 void EUSCI_A0_UART_OutUFix(uint32_t n)
 {
+    PROFILER_ENTER();
     EUSCI_A0_UART_OutUDec(n/10);
     EUSCI_A0_UART_OutChar('.');
     EUSCI_A0_UART_OutUDec(n%10);
+    PROFILER_EXIT(UART_OUTUFIX);
 }
 
 uint32_t UART0_InUHex()
@@ -204,6 +237,7 @@ uint32_t UART0_InUHex()
 
 void EUSCI_A0_UART_OutUHex(uint32_t number)
 {
+    PROFILER_ENTER();
     // Use recursion to convert the number of
     // unspecified length as an ASCII string
     if (number >= 0x10)
@@ -222,6 +256,7 @@ void EUSCI_A0_UART_OutUHex(uint32_t number)
             EUSCI_A0_UART_OutChar((number-0x0A)+'A');
         }
     }
+    PROFILER_EXIT(UART_OUTUHEX);
 }
 
 int EUSCI_A0_UART_Open(const char *path, unsigned flags, int llv_fd)
@@ -236,6 +271,7 @@ int EUSCI_A0_UART_Close(int dev_fd)
 }
 int EUSCI_A0_UART_Read(int dev_fd, char *buf, unsigned count)
 {
+    PROFILER_ENTER();
     char ch;
     // Receive char from the serial terminal
     ch = EUSCI_A0_UART_InChar();
@@ -243,11 +279,13 @@ int EUSCI_A0_UART_Read(int dev_fd, char *buf, unsigned count)
     ch = *buf;
     // Output the received char from the serial terminal
     EUSCI_A0_UART_OutChar(ch);
+    PROFILER_EXIT(UART_READ);
     return 1;
 }
 
 int EUSCI_A0_UART_Write(int dev_fd, const char *buf, unsigned count)
 {
+    PROFILER_ENTER();
     unsigned int num = count;
 
     while(num)
@@ -260,6 +298,7 @@ int EUSCI_A0_UART_Write(int dev_fd, const char *buf, unsigned count)
         buf++;
         num--;
     }
+    PROFILER_EXIT(UART_WRITE);
     return count;
 }
 
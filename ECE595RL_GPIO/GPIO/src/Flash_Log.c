@@ -0,0 +1,276 @@
+/**
+ * @file Flash_Log.c
+ * @brief Source code for the Flash_Log driver.
+ *
+ * This file contains the function definitions for the Flash_Log driver.
+ *
+ * Each record is 16 bytes long and has the following layout:
+ *  - Bytes 0 - 3:   Sequence number (incremented for every record)
+ *  - Bytes 4 - 9:   Flash_Log_State
+ *  - Bytes 10 - 11: CRC-16/CCITT-FALSE of bytes 0 - 9 and 12 - 15
+ *  - Bytes 12 - 15: Total number of sector erases
+ *
+ * A record slot is free if all of its bytes are 0xFF (erased flash).
+ *
+ */
+
+#include "../inc/Flash_Log.h"
+#include "../inc/CRC16.h"
+#include "../inc/Perf_Counter.h"
+
+// Number of records that fit in one sector
+#define FLASH_LOG_RECORDS_PER_SECTOR    (FLASH_LOG_SECTOR_SIZE / sizeof(Flash_Log_Record))
+
+// Value of an erased flash word
+#define FLASH_LOG_ERASED_WORD           0xFFFFFFFF
+
+// Value used to indicate that no sector is active
+#define FLASH_LOG_NO_SECTOR             0
+
+typedef struct
+{
+    uint32_t sequence;
+    Flash_Log_State state;
+    uint16_t crc;
+    uint32_t erase_count;
+} Flash_Log_Record;
+
+static uint32_t Flash_Log_Active_Sector = FLASH_LOG_NO_SECTOR;
+static uint32_t Flash_Log_Next_Slot;
+static uint8_t Flash_Log_Valid;
+static Flash_Log_Record Flash_Log_Last;
+static uint32_t Flash_Log_Restore_Cycles;
+static uint32_t Flash_Log_Save_Count;
+
+static uint16_t Flash_Log_Record_CRC(const Flash_Log_Record *record)
+{
+    uint16_t crc = CRC16_Update(CRC16_INIT, (const uint8_t *)record, 10);
+    return CRC16_Update(crc, (const uint8_t *)&record->erase_count, sizeof(record->erase_count));
+}
+
+static const Flash_Log_Record *Flash_Log_Slot(uint32_t sector, uint32_t slot)
+{
+    return (const Flash_Log_Record *)(sector + slot * sizeof(Flash_Log_Record));
+}
+
+static uint8_t Flash_Log_Slot_Is_Free(const Flash_Log_Record *record)
+{
+    const uint32_t *word = (const uint32_t *)record;
+
+    for (int i = 0; i < sizeof(Flash_Log_Record) / 4; i++)
+    {
+        if (word[i] != FLASH_LOG_ERASED_WORD)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static uint8_t Flash_Log_Sector_Is_Erased(uint32_t sector)
+{
+    for (int slot = 0; slot < FLASH_LOG_RECORDS_PER_SECTOR; slot++)
+    {
+        if (!Flash_Log_Slot_Is_Free(Flash_Log_Slot(sector, slot)))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static uint8_t Flash_Log_State_Equal(const Flash_Log_State *a, const Flash_Log_State *b)
+{
+    return (a->pattern == b->pattern)
+        && (a->button_status == b->button_status)
+        && (a->switch_status == b->switch_status)
+        && (a->led1_value == b->led1_value)
+        && (a->rgb_led_value == b->rgb_led_value)
+        && (a->pmod_8ld_value == b->pmod_8ld_value);
+}
+
+static void Flash_Log_Unprotect()
+{
+    FLCTL->BANK1_INFO_WEPROT &= ~(FLCTL_BANK1_INFO_WEPROT_PROT0 | FLCTL_BANK1_INFO_WEPROT_PROT1);
+}
+
+static void Flash_Log_Protect()
+{
+    FLCTL->BANK1_INFO_WEPROT |= (FLCTL_BANK1_INFO_WEPROT_PROT0 | FLCTL_BANK1_INFO_WEPROT_PROT1);
+}
+
+static uint8_t Flash_Log_Erase_Sector(uint32_t sector)
+{
+    uint8_t error;
+
+    Flash_Log_Unprotect();
+
+    // Select sector erase of INFO memory and start the erase operation
+    FLCTL->ERASE_CTLSTAT = FLCTL_ERASE_CTLSTAT_TYPE_1;
+    FLCTL->ERASE_SECTADDR = sector;
+    FLCTL->ERASE_CTLSTAT |= FLCTL_ERASE_CTLSTAT_START;
+
+    // Wait until the erase operation is complete
+    while ((FLCTL->ERASE_CTLSTAT & FLCTL_ERASE_CTLSTAT_STATUS_MASK) != FLCTL_ERASE_CTLSTAT_STATUS_2);
+
+    error = (FLCTL->ERASE_CTLSTAT & FLCTL_ERASE_CTLSTAT_ADDR_ERR) != 0;
+    FLCTL->ERASE_CTLSTAT |= FLCTL_ERASE_CTLSTAT_CLR_STAT;
+
+    Flash_Log_Protect();
+
+    return error || !Flash_Log_Sector_Is_Erased(sector);
+}
+
+static uint8_t Flash_Log_Program_Record(const Flash_Log_Record *record, uint32_t address)
+{
+    const uint32_t *src = (const uint32_t *)record;
+    volatile uint32_t *dst = (volatile uint32_t *)address;
+    uint8_t error = 0;
+
+    Flash_Log_Unprotect();
+
+    // Enable immediate word programming with pre- and post-program verify
+    FLCTL->CLRIFG = FLCTL_CLRIFG_PRG | FLCTL_CLRIFG_AVPRE | FLCTL_CLRIFG_AVPST | FLCTL_CLRIFG_PRG_ERR;
+    FLCTL->PRG_CTLSTAT = FLCTL_PRG_CTLSTAT_ENABLE | FLCTL_PRG_CTLSTAT_VER_PRE | FLCTL_PRG_CTLSTAT_VER_PST;
+
+    for (int i = 0; i < sizeof(Flash_Log_Record) / 4; i++)
+    {
+        dst[i] = src[i];
+
+        // Wait until the word has been programmed
+        while (FLCTL->PRG_CTLSTAT & FLCTL_PRG_CTLSTAT_STATUS_MASK);
+
+        if (FLCTL->IFG & (FLCTL_IFG_AVPRE | FLCTL_IFG_AVPST | FLCTL_IFG_PRG_ERR))
+        {
+            error = 1;
+            break;
+        }
+    }
+
+    FLCTL->PRG_CTLSTAT = 0;
+    Flash_Log_Protect();
+
+    // Read back the record to make sure it was programmed correctly
+    for (int i = 0; (i < sizeof(Flash_Log_Record) / 4) && !error; i++)
+    {
+        if (dst[i] != src[i])
+        {
+            error = 1;
+        }
+    }
+    return error;
+}
+
+static void Flash_Log_Scan_Sector(uint32_t sector)
+{
+    for (int slot = 0; slot < FLASH_LOG_RECORDS_PER_SECTOR; slot++)
+    {
+        const Flash_Log_Record *record = Flash_Log_Slot(sector, slot);
+
+        if (Flash_Log_Slot_Is_Free(record))
+        {
+            continue;
+        }
+
+        if ((record->crc == Flash_Log_Record_CRC(record))
+            && (!Flash_Log_Valid || (record->sequence > Flash_Log_Last.sequence)))
+        {
+            Flash_Log_Last = *record;
+            Flash_Log_Valid = 1;
+            Flash_Log_Active_Sector = sector;
+        }
+
+        // Records are only appended, so the next free slot follows the last used slot
+        if (sector == Flash_Log_Active_Sector)
+        {
+            Flash_Log_Next_Slot = slot + 1;
+        }
+    }
+}
+
+uint8_t Flash_Log_Init()
+{
+    uint32_t start_cycles = DWT->CYCCNT;
+
+    Flash_Log_Valid = 0;
+    Flash_Log_Active_Sector = FLASH_LOG_NO_SECTOR;
+    Flash_Log_Next_Slot = 0;
+
+    Flash_Log_Scan_Sector(FLASH_LOG_SECTOR_A);
+    Flash_Log_Scan_Sector(FLASH_LOG_SECTOR_B);
+
+    Flash_Log_Restore_Cycles = DWT->CYCCNT - start_cycles;
+    return Flash_Log_Valid;
+}
+
+uint8_t Flash_Log_Restore(Flash_Log_State *state)
+{
+    if (!Flash_Log_Valid)
+    {
+        return 0;
+    }
+    *state = Flash_Log_Last.state;
+    return 1;
+}
+
+uint8_t Flash_Log_Save(const Flash_Log_State *state)
+{
+    Flash_Log_Record record;
+    uint32_t erase_count = Flash_Log_Valid ? Flash_Log_Last.erase_count : 0;
+
+    if (Flash_Log_Valid && Flash_Log_State_Equal(state, &Flash_Log_Last.state))
+    {
+        return 0;
+    }
+
+    // Switch to the other sector if the active sector is full or if no sector is active yet
+    if ((Flash_Log_Active_Sector == FLASH_LOG_NO_SECTOR) || (Flash_Log_Next_Slot >= FLASH_LOG_RECORDS_PER_SECTOR))
+    {
+        uint32_t sector = (Flash_Log_Active_Sector == FLASH_LOG_SECTOR_A) ? FLASH_LOG_SECTOR_B : FLASH_LOG_SECTOR_A;
+
+        if (!Flash_Log_Sector_Is_Erased(sector))
+        {
+            erase_count++;
+            if (Flash_Log_Erase_Sector(sector))
+            {
+                return 1;
+            }
+        }
+        Flash_Log_Active_Sector = sector;
+        Flash_Log_Next_Slot = 0;
+    }
+
+    record.sequence = Flash_Log_Valid ? (Flash_Log_Last.sequence + 1) : 0;
+    record.state = *state;
+    record.erase_count = erase_count;
+    record.crc = Flash_Log_Record_CRC(&record);
+
+    if (Flash_Log_Program_Record(&record, (uint32_t)Flash_Log_Slot(Flash_Log_Active_Sector, Flash_Log_Next_Slot)))
+    {
+        // Skip the damaged slot so that the next save uses a free slot
+        Flash_Log_Next_Slot++;
+        return 1;
+    }
+
+    Flash_Log_Next_Slot++;
+    Flash_Log_Last = record;
+    Flash_Log_Valid = 1;
+    Flash_Log_Save_Count++;
+    Perf_Counter_Increment(PERF_COUNTER_FLASH_SAVES);
+    return 0;
+}
+
+uint32_t Flash_Log_Get_Restore_Cycles()
+{
+    return Flash_Log_Restore_Cycles;
+}
+
+uint32_t Flash_Log_Get_Erase_Count()
+{
+    return Flash_Log_Valid ? Flash_Log_Last.erase_count : 0;
+}
+
+uint32_t Flash_Log_Get_Save_Count()
+{
+    return Flash_Log_Save_Count;
+}
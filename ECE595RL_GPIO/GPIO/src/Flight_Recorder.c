@@ -0,0 +1,177 @@
+/**
+ * @file Flight_Recorder.c
+ * @brief Source code for the Flight_Recorder module.
+ *
+ * This file contains the function definitions for the Flight_Recorder module.
+ *
+ * For more information regarding the reset status registers, refer to the Reset Controller (RSTCTL)
+ * section of the MSP432Pxx Microcontrollers Technical Reference Manual.
+ *
+ */
+
+#include "../inc/Flight_Recorder.h"
+#include "../inc/Boot.h"
+#include "../inc/EUSCI_A0_UART.h"
+
+// Value stored in the control block once the flight recorder has been initialized
+#define FLIGHT_RECORDER_MAGIC   0x46524543
+
+#pragma DATA_SECTION(Flight_Recorder_Control, ".noinit")
+Flight_Recorder_Control_Block Flight_Recorder_Control;
+
+#pragma DATA_SECTION(Flight_Recorder_Buffer, ".noinit")
+Flight_Recorder_Record Flight_Recorder_Buffer[2][FLIGHT_RECORDER_SIZE];
+
+// Flight_Recorder_Init selects the buffer of the current session; until then, records go to buffer 0
+Flight_Recorder_Record *Flight_Recorder_Active = Flight_Recorder_Buffer[0];
+volatile uint32_t *Flight_Recorder_Count = &Flight_Recorder_Control.count[0];
+
+static uint32_t Flight_Recorder_Log_Cycles;
+
+static uint8_t Flight_Recorder_Reset_Source()
+{
+    uint8_t flags = 0;
+
+    if (RSTCTL->SOFTRESET_STAT)     flags |= FLIGHT_RECORDER_RESET_SOFT;
+    if (RSTCTL->PSSRESET_STAT)      flags |= FLIGHT_RECORDER_RESET_PSS;
+    if (RSTCTL->PCMRESET_STAT)      flags |= FLIGHT_RECORDER_RESET_PCM;
+    if (RSTCTL->PINRESET_STAT)      flags |= FLIGHT_RECORDER_RESET_PIN;
+    if (RSTCTL->REBOOTRESET_STAT)   flags |= FLIGHT_RECORDER_RESET_REBOOT;
+    if (RSTCTL->CSRESET_STAT)       flags |= FLIGHT_RECORDER_RESET_CS;
+    if (!Boot_Is_Warm_Start())      flags |= FLIGHT_RECORDER_RESET_COLD;
+
+    return flags;
+}
+
+static void Flight_Recorder_Clear_Buffer(uint32_t buffer)
+{
+    // A sequence number of 0 never matches a slot, so the records of the earlier sessions are not read
+    for (uint32_t i = 0; i < FLIGHT_RECORDER_SIZE; i++)
+    {
+        Flight_Recorder_Buffer[buffer][i].sequence = 0;
+    }
+    Flight_Recorder_Control.count[buffer] = 0;
+}
+
+static void Flight_Recorder_Clear_Reset_Source()
+{
+    RSTCTL->HARDRESET_CLR = 0xFFFF;
+    RSTCTL->SOFTRESET_CLR = 0xFFFF;
+    RSTCTL->PSSRESET_CLR = RSTCTL_PSSRESET_CLR_CLR;
+    RSTCTL->PCMRESET_CLR = RSTCTL_PCMRESET_CLR_CLR;
+    RSTCTL->PINRESET_CLR = RSTCTL_PINRESET_CLR_CLR;
+    RSTCTL->REBOOTRESET_CLR = RSTCTL_REBOOTRESET_CLR_CLR;
+    RSTCTL->CSRESET_CLR = RSTCTL_CSRESET_CLR_CLR;
+}
+
+void Flight_Recorder_Init()
+{
+    Flight_Recorder_Control_Block *control = &Flight_Recorder_Control;
+
+    if ((control->magic == FLIGHT_RECORDER_MAGIC) && (control->active == (~control->check & 0x1)))
+    {
+        // Keep the buffer of the previous session and record into the other buffer
+        control->active ^= 1;
+    }
+    else
+    {
+        control->magic = FLIGHT_RECORDER_MAGIC;
+        control->active = 0;
+        Flight_Recorder_Clear_Buffer(1);
+    }
+    control->check = ~control->active;
+    Flight_Recorder_Clear_Buffer(control->active);
+    Flight_Recorder_Active = Flight_Recorder_Buffer[control->active];
+    Flight_Recorder_Count = &control->count[control->active];
+
+    uint8_t reset_source = Flight_Recorder_Reset_Source();
+    uint16_t hard_reset_status = RSTCTL->HARDRESET_STAT;
+    uint32_t start_cycles = DWT->CYCCNT;
+    Flight_Recorder_Log(FLIGHT_RECORDER_BOOT, reset_source, hard_reset_status);
+    Flight_Recorder_Log_Cycles = DWT->CYCCNT - start_cycles;
+    Flight_Recorder_Clear_Reset_Source();
+}
+
+uint32_t Flight_Recorder_Get_Previous(Flight_Recorder_Record *records, uint32_t max)
+{
+    uint32_t previous = Flight_Recorder_Control.active ^ 1;
+    uint32_t count = Flight_Recorder_Control.count[previous];
+    uint32_t num_records = (count < FLIGHT_RECORDER_SIZE) ? count : FLIGHT_RECORDER_SIZE;
+
+    if (num_records > max)
+    {
+        num_records = max;
+    }
+
+    // Copy the most recent records in the order in which they were logged, skipping the slots that were not written
+    uint32_t num_copied = 0;
+    for (uint32_t i = 0; i < num_records; i++)
+    {
+        uint32_t sequence = count - num_records + i;
+        const Flight_Recorder_Record *record = &Flight_Recorder_Buffer[previous][sequence & (FLIGHT_RECORDER_SIZE - 1)];
+
+        if (record->sequence == sequence + 1)
+        {
+            records[num_copied++] = *record;
+        }
+    }
+    return num_copied;
+}
+
+void Flight_Recorder_Dump_Previous()
+{
+    uint32_t previous = Flight_Recorder_Control.active ^ 1;
+    uint32_t count = Flight_Recorder_Control.count[previous];
+    uint32_t num_records = (count < FLIGHT_RECORDER_SIZE) ? count : FLIGHT_RECORDER_SIZE;
+
+    EUSCI_A0_UART_OutString("Flight recorder: ");
+    EUSCI_A0_UART_OutUDec(num_records);
+    EUSCI_A0_UART_OutString(" records\r\n");
+
+    for (uint32_t i = 0; i < num_records; i++)
+    {
+        uint32_t sequence = count - num_records + i;
+        Flight_Recorder_Record record = Flight_Recorder_Buffer[previous][sequence & (FLIGHT_RECORDER_SIZE - 1)];
+
+        EUSCI_A0_UART_OutUDec(i);
+        if (record.sequence != sequence + 1)
+        {
+            // The slot was counted but the device was reset before the record was written
+            EUSCI_A0_UART_OutString(" unwritten\r\n");
+            continue;
+        }
+        EUSCI_A0_UART_OutChar(SP);
+        EUSCI_A0_UART_OutUHex(record.timestamp);
+        EUSCI_A0_UART_OutChar(SP);
+        EUSCI_A0_UART_OutUDec(record.info & 0xFF);
+        EUSCI_A0_UART_OutChar(SP);
+        EUSCI_A0_UART_OutUHex((record.info >> 8) & 0xFF);
+        EUSCI_A0_UART_OutChar(SP);
+        EUSCI_A0_UART_OutUHex(record.info >> 16);
+        EUSCI_A0_UART_OutString("\r\n");
+    }
+
+    EUSCI_A0_UART_OutString("Log cost: ");
+    EUSCI_A0_UART_OutUDec(Flight_Recorder_Log_Cycles);
+    EUSCI_A0_UART_OutString(" cycles\r\n");
+}
+
+uint32_t Flight_Recorder_Get_Log_Cycles()
+{
+    return Flight_Recorder_Log_Cycles;
+}
+
+void Flight_Recorder_Fault_Handler(void)
+{
+    uint32_t cfsr = SCB->CFSR;
+
+    Flight_Recorder_Log(FLIGHT_RECORDER_FAULT, (cfsr >> 16) & 0xFF, cfsr & 0xFFFF);
+
+    // Reset the device; the .noinit section (and therefore the log) is preserved
+    NVIC_SystemReset();
+}
+
+void HardFault_Handler(void)
+{
+    Flight_Recorder_Fault_Handler();
+}
@@ -25,6 +25,14 @@
 
 #include "../inc/GPIO.h"
 #include "../inc/Clock.h"
+#include "../inc/Critical_Section.h"
+#include "../inc/Diff_Log.h"
+#include "../inc/Flight_Recorder.h"
+#include "../inc/LED_Energy.h"
+#include "../inc/Perf_Counter.h"
+#include "../inc/Pin_Power.h"
+#include "../inc/Port_Trace.h"
+#include "../inc/Profiler.h"
 
 // Constant definitions for the built-in red LED
 const uint8_t RED_LED_OFF           =   0x00;
@@ -56,6 +64,21 @@ const uint8_t PMOD_8LD_5_ON         =   0x20;
 const uint8_t PMOD_8LD_6_ON         =   0x30;
 const uint8_t PMOD_8LD_7_ON         =   0x40;
 
+// LED pattern most recently selected by LED_Controller
+static uint8_t LED_Active_Pattern   =   1;
+
+// Position of LED_Controller_Step in the running pattern: the delay of LED_Pattern_1 to 5 that has been reached
+#define LED_STEP_IDLE               0   // No pattern is running
+#define LED_STEP_PATTERN_1_ON       1   // LED_Pattern_1, both buttons pressed, first 1 s delay
+#define LED_STEP_PATTERN_1_OFF      2   // LED_Pattern_1, both buttons pressed, second 1 s delay
+#define LED_STEP_PATTERN_2          3   // LED_Pattern_2, 100 ms delay after led_count
+#define LED_STEP_PATTERN_3          4   // LED_Pattern_3, 100 ms delay after led_count
+#define LED_STEP_PATTERN_4_ON       5   // LED_Pattern_4, first 1 s delay
+#define LED_STEP_PATTERN_4_OFF      6   // LED_Pattern_4, second 1 s delay
+#define LED_STEP_PATTERN_5          7   // LED_Pattern_5, 500 ms delay after led_count
+
+static uint8_t LED_Step_Position    =   LED_STEP_IDLE;
+static uint8_t LED_Step_Count;
 
 void LED1_Init()
 {
@@ -66,7 +89,25 @@ void LED1_Init()
 
 void LED1_Output(uint8_t led_value)
 {
-    P1->OUT = (P1->OUT & 0xFE) | led_value;
+    PROFILER_ENTER();
+    uint32_t state = Critical_Section_Enter(CRITICAL_SECTION_GPIO);
+    uint8_t output = (P1->OUT & 0xFE) | led_value;
+
+    // Skip the write if the output does not change
+    if (output != P1->OUT)
+    {
+        P1->OUT = output;
+        PORT_TRACE_LOG(1, output);
+        DIFF_LOG_RECORD(DIFF_LOG_LED1, output & 0x01);
+        LED_Energy_Output(LED_ENERGY_LED1, output);
+        Perf_Counter_Increment(PERF_COUNTER_PORT_WRITES);
+    }
+    else
+    {
+        Perf_Counter_Increment(PERF_COUNTER_PORT_WRITES_ELIDED);
+    }
+    Critical_Section_Exit(state);
+    PROFILER_EXIT(LED1_OUTPUT);
 }
 
 uint8_t LED1_Status()
@@ -79,19 +120,46 @@ void LED2_Init()
 {
     P2->SEL0 &= ~0x07;
     P2->SEL1 &= ~0x07;
-    P2->DS |= 0x07;
+
+    // High drive strength only if the RGB LED draws more than the regular drive strength supplies (see Pin_Power.h)
+    P2->DS = (P2->DS & ~0x07) | PIN_POWER_DRIVE(PIN_POWER_LOAD_LED2_UA, 0x07);
     P2->DIR |= 0x07;
     P2->OUT &= ~0x07;
+    PORT_TRACE_LOG(2, P2->OUT);
 }
 
 void LED2_Output(uint8_t led_value)
 {
-    P2->OUT = (P2->OUT & 0xF8) | led_value;
+    PROFILER_ENTER();
+    uint32_t state = Critical_Section_Enter(CRITICAL_SECTION_GPIO);
+    uint8_t output = (P2->OUT & 0xF8) | led_value;
+
+    // Skip the write if the output does not change
+    if (output != P2->OUT)
+    {
+        P2->OUT = output;
+        PORT_TRACE_LOG(2, output);
+        DIFF_LOG_RECORD(DIFF_LOG_LED2, output & 0x07);
+        LED_Energy_Output(LED_ENERGY_LED2, output);
+        Perf_Counter_Increment(PERF_COUNTER_PORT_WRITES);
+    }
+    else
+    {
+        Perf_Counter_Increment(PERF_COUNTER_PORT_WRITES_ELIDED);
+    }
+    Critical_Section_Exit(state);
+    PROFILER_EXIT(LED2_OUTPUT);
 }
 
 void LED2_Toggle(uint8_t led_value)
 {
+    uint32_t state = Critical_Section_Enter(CRITICAL_SECTION_GPIO);
     P2->OUT ^= led_value;
+    PORT_TRACE_LOG(2, P2->OUT);
+    DIFF_LOG_RECORD(DIFF_LOG_LED2, P2->OUT & 0x07);
+    LED_Energy_Output(LED_ENERGY_LED2, P2->OUT);
+    Critical_Section_Exit(state);
+    Perf_Counter_Increment(PERF_COUNTER_PORT_WRITES);
 }
 
 uint8_t LED2_Status()
@@ -107,11 +175,15 @@ void Buttons_Init()
     P1->DIR |= ~0x12;
     P1->REN |= 0x12;
     P1->OUT |= 0x12;
+    PORT_TRACE_LOG(1, P1->OUT);
 }
 
 uint8_t Get_Buttons_Status()
 {
+    PROFILER_ENTER();
     uint8_t button_status = (P1->IN & 0x12);
+    DIFF_LOG_RECORD(DIFF_LOG_BUTTONS, button_status);
+    PROFILER_EXIT(GET_BUTTONS_STATUS);
     return button_status;
 }
 
@@ -119,14 +191,38 @@ void PMOD_8LD_Init()
 {
     P9->SEL0 &= ~0xFF;
     P9->SEL1 &= ~0xFF;
-    P9->DS |= 0xFF;
+
+    // Regular drive strength: the LEDs of the PMOD 8LD are switched by transistors, and Port 9 has no high-drive pins
+    P9->DS &= ~0xFF;
     P9->DIR |= 0xFF;
     P9->OUT &= ~0xFF;
+    PORT_TRACE_LOG(9, P9->OUT);
 }
 
 uint8_t PMOD_8LD_Output(uint8_t led_value)
 {
-    P9->OUT = led_value;
+    PROFILER_ENTER();
+
+    // Skip the write if the output does not change
+    if (P9->OUT != led_value)
+    {
+        P9->OUT = led_value;
+        PORT_TRACE_LOG(9, led_value);
+        DIFF_LOG_RECORD(DIFF_LOG_PMOD_8LD, led_value);
+        LED_Energy_Output(LED_ENERGY_PMOD_8LD, led_value);
+        Perf_Counter_Increment(PERF_COUNTER_PORT_WRITES);
+    }
+    else
+    {
+        Perf_Counter_Increment(PERF_COUNTER_PORT_WRITES_ELIDED);
+    }
+    uint8_t PMOD_8LD_value = P9->OUT;
+    PROFILER_EXIT(PMOD_8LD_OUTPUT);
+    return PMOD_8LD_value;
+}
+
+uint8_t PMOD_8LD_Status()
+{
     uint8_t PMOD_8LD_value = P9->OUT;
     return PMOD_8LD_value;
 }
@@ -140,7 +236,10 @@ void PMOD_SWT_Init()
 
 uint8_t Get_PMOD_SWT_Status()
 {
+    PROFILER_ENTER();
     uint8_t switch_status = P10->IN & 0xF;
+    DIFF_LOG_RECORD(DIFF_LOG_SWITCHES, switch_status);
+    PROFILER_EXIT(GET_PMOD_SWT_STATUS);
     return switch_status;
 }
 /* Function Name: LED_Pattern_1
@@ -160,6 +259,7 @@ uint8_t Get_PMOD_SWT_Status()
  */
 void LED_Pattern_1(uint8_t button_status)
 {
+    PROFILER_ENTER();
     switch(button_status)
     {
         // Button 1 and Button 2 are pressed
@@ -204,10 +304,12 @@ void LED_Pattern_1(uint8_t button_status)
             break;
         }
     }
+    PROFILER_EXIT(LED_PATTERN_1);
 }
 
 void LED_Pattern_2()
 {
+    PROFILER_ENTER();
     LED1_Output(RED_LED_ON);
     LED2_Output(RGB_LED_RED);
 
@@ -221,6 +323,7 @@ void LED_Pattern_2()
             break;
         }
     }
+    PROFILER_EXIT(LED_PATTERN_2);
 }
 /* Function Name: LED_Pattern_3
  * case     input                   LED1    RGB LED     PMOD 8LD
@@ -229,6 +332,7 @@ void LED_Pattern_2()
  */
 void LED_Pattern_3()
 {
+    PROFILER_ENTER();
     LED1_Output(RED_LED_OFF); //Turn off Red LED
     LED2_Output(RGB_LED_BLUE); //Turn on RGB LED and set color to BLUE
     for (int led_count = 0xFF; led_count >= 0; led_count--) //for loop iteration from 0xFF down to 0
@@ -241,6 +345,7 @@ void LED_Pattern_3()
             break;
         }
     }
+    PROFILER_EXIT(LED_PATTERN_3);
 }
 /* Function Name: LED_Pattern_4
  * case     input                   LED1                RGB LED                 PMOD 8LD
@@ -249,6 +354,7 @@ void LED_Pattern_3()
  */
 void LED_Pattern_4()
 {
+    PROFILER_ENTER();
     while(1) //loop forever
     {
         PMOD_8LD_Output(PMOD_8LD_ALL_ON);//Turn on all LEDs on PMOD 8LD
@@ -265,6 +371,7 @@ void LED_Pattern_4()
                     break;
                 }
     }
+    PROFILER_EXIT(LED_PATTERN_4);
 }
 /* Function Name: LED_Pattern_5
  * case     input                   LED1    RGB LED     PMOD 8LD
@@ -273,6 +380,7 @@ void LED_Pattern_4()
  */
 void LED_Pattern_5()
 {
+        PROFILER_ENTER();
         LED1_Output(RED_LED_OFF); //Turn off Red LED
         LED2_Output(RGB_LED_OFF); //Turn off RGB LED
         for (int led_count = 0x01; led_count <= 128; led_count = led_count * 2) //for loop iteration starting at 0x01 and multiplying by 2 until 128
@@ -285,45 +393,291 @@ void LED_Pattern_5()
                 break;
             }
         }
+        PROFILER_EXIT(LED_PATTERN_5);
+}
+
+static void LED_Set_Active_Pattern(uint8_t pattern)
+{
+    if (pattern != LED_Active_Pattern)
+    {
+        Flight_Recorder_Log(FLIGHT_RECORDER_PATTERN_CHANGE, pattern, LED_Active_Pattern);
+        LED_Active_Pattern = pattern;
+        LED_Energy_Set_Pattern(pattern);
+    }
 }
 
 void LED_Controller(uint8_t button_status, uint8_t switch_status)
 {
+    Perf_Counter_Increment(PERF_COUNTER_PATTERN_FRAMES);
+
     switch(switch_status)
     {
         case 0x00:
         {
+            LED_Set_Active_Pattern(1);
             LED_Pattern_1(button_status);
         }
         break;
 
         case 0x01:
         {
+            LED_Set_Active_Pattern(2);
             LED_Pattern_2();
         }
         break;
 
         case 0x02:
         {
+            LED_Set_Active_Pattern(3);
             LED_Pattern_3();
         }
         break;
 
         case 0x04:
         {
+            LED_Set_Active_Pattern(4);
             LED_Pattern_4();
         }
         break;
 
         case 0x08:
         {
+            LED_Set_Active_Pattern(5);
             LED_Pattern_5();
         }
         break;
 
         default:
         {
+            LED_Set_Active_Pattern(1);
             LED_Pattern_1(button_status);
         }
     }
 }
+
+// Same selection and outputs as LED_Controller, up to the first delay of the selected pattern
+static uint32_t LED_Controller_Start(uint8_t button_status, uint8_t switch_status)
+{
+    Perf_Counter_Increment(PERF_COUNTER_PATTERN_FRAMES);
+
+    switch(switch_status)
+    {
+        case 0x01:
+        {
+            LED_Set_Active_Pattern(2);
+            LED1_Output(RED_LED_ON);
+            LED2_Output(RGB_LED_RED);
+            LED_Step_Count = 0x00;
+            PMOD_8LD_Output(LED_Step_Count);
+            LED_Step_Position = LED_STEP_PATTERN_2;
+            return 100;
+        }
+
+        case 0x02:
+        {
+            LED_Set_Active_Pattern(3);
+            LED1_Output(RED_LED_OFF);
+            LED2_Output(RGB_LED_BLUE);
+            LED_Step_Count = 0xFF;
+            PMOD_8LD_Output(LED_Step_Count);
+            LED_Step_Position = LED_STEP_PATTERN_3;
+            return 100;
+        }
+
+        case 0x04:
+        {
+            LED_Set_Active_Pattern(4);
+            PMOD_8LD_Output(PMOD_8LD_ALL_ON);
+            LED1_Output(RED_LED_ON);
+            LED2_Output(RGB_LED_BLUE);
+            LED_Step_Position = LED_STEP_PATTERN_4_ON;
+            return 1000;
+        }
+
+        case 0x08:
+        {
+            LED_Set_Active_Pattern(5);
+            LED1_Output(RED_LED_OFF);
+            LED2_Output(RGB_LED_OFF);
+            LED_Step_Count = 0x01;
+            PMOD_8LD_Output(LED_Step_Count);
+            LED_Step_Position = LED_STEP_PATTERN_5;
+            return 500;
+        }
+
+        default:
+        {
+            LED_Set_Active_Pattern(1);
+            if (button_status == 0x00)
+            {
+                PMOD_8LD_Output(PMOD_8LD_ALL_OFF);
+                LED1_Output(RED_LED_ON);
+                LED2_Output(RGB_LED_GREEN);
+                LED_Step_Position = LED_STEP_PATTERN_1_ON;
+                return 1000;
+            }
+
+            // The other cases of LED_Pattern_1 have no delay
+            LED_Pattern_1(button_status);
+            return 0;
+        }
+    }
+}
+
+uint32_t LED_Controller_Step(uint8_t button_status, uint8_t switch_status)
+{
+    switch(LED_Step_Position)
+    {
+        case LED_STEP_IDLE:
+        {
+            return LED_Controller_Start(button_status, switch_status);
+        }
+
+        case LED_STEP_PATTERN_1_ON:
+        {
+            LED1_Output(RED_LED_OFF);
+            LED2_Output(RGB_LED_OFF);
+            LED_Step_Position = LED_STEP_PATTERN_1_OFF;
+            return 1000;
+        }
+
+        case LED_STEP_PATTERN_2:
+        {
+            if ((Get_PMOD_SWT_Status() == 0x01) && (LED_Step_Count < 0xFF))
+            {
+                LED_Step_Count++;
+                PMOD_8LD_Output(LED_Step_Count);
+                return 100;
+            }
+        }
+        break;
+
+        case LED_STEP_PATTERN_3:
+        {
+            if ((Get_PMOD_SWT_Status() == 0x02) && (LED_Step_Count > 0x00))
+            {
+                LED_Step_Count--;
+                PMOD_8LD_Output(LED_Step_Count);
+                return 100;
+            }
+        }
+        break;
+
+        case LED_STEP_PATTERN_4_ON:
+        {
+            PMOD_8LD_Output(PMOD_8LD_ALL_OFF);
+            LED1_Output(RED_LED_OFF);
+            LED2_Output(RGB_LED_OFF);
+            LED_Step_Position = LED_STEP_PATTERN_4_OFF;
+            return 1000;
+        }
+
+        case LED_STEP_PATTERN_4_OFF:
+        {
+            if (Get_PMOD_SWT_Status() == 0x04)
+            {
+                PMOD_8LD_Output(PMOD_8LD_ALL_ON);
+                LED1_Output(RED_LED_ON);
+                LED2_Output(RGB_LED_BLUE);
+                LED_Step_Position = LED_STEP_PATTERN_4_ON;
+                return 1000;
+            }
+        }
+        break;
+
+        case LED_STEP_PATTERN_5:
+        {
+            if ((Get_PMOD_SWT_Status() == 0x08) && (LED_Step_Count < 0x80))
+            {
+                LED_Step_Count = LED_Step_Count * 2;
+                PMOD_8LD_Output(LED_Step_Count);
+                return 500;
+            }
+        }
+        break;
+
+        default:
+            break;
+    }
+
+    // The pattern run is complete (LED_STEP_PATTERN_1_OFF or the end of a loop)
+    LED_Step_Position = LED_STEP_IDLE;
+    return 0;
+}
+
+uint32_t LED_Controller_Resume(uint8_t pattern, uint8_t led1_value, uint8_t rgb_led_value, uint8_t pmod_8ld_value)
+{
+    LED_Step_Position = LED_STEP_IDLE;
+    if ((pattern < 1) || (pattern > 5))
+    {
+        return 0;
+    }
+    LED_Set_Active_Pattern(pattern);
+
+    // Find the delay of the pattern that produced the outputs, as LED_Controller_Start and LED_Controller_Step do
+    switch(pattern)
+    {
+        case 1:
+        {
+            if ((pmod_8ld_value == PMOD_8LD_ALL_OFF) && (led1_value == RED_LED_ON) && (rgb_led_value == RGB_LED_GREEN))
+            {
+                LED_Step_Position = LED_STEP_PATTERN_1_ON;
+                return 1000;
+            }
+            if ((pmod_8ld_value == PMOD_8LD_ALL_OFF) && (led1_value == RED_LED_OFF) && (rgb_led_value == RGB_LED_OFF))
+            {
+                LED_Step_Position = LED_STEP_PATTERN_1_OFF;
+                return 1000;
+            }
+        }
+        break;
+
+        case 2:
+        {
+            LED_Step_Count = pmod_8ld_value;
+            LED_Step_Position = LED_STEP_PATTERN_2;
+            return 100;
+        }
+
+        case 3:
+        {
+            LED_Step_Count = pmod_8ld_value;
+            LED_Step_Position = LED_STEP_PATTERN_3;
+            return 100;
+        }
+
+        case 4:
+        {
+            LED_Step_Position = (pmod_8ld_value == PMOD_8LD_ALL_ON) ? LED_STEP_PATTERN_4_ON : LED_STEP_PATTERN_4_OFF;
+            return 1000;
+        }
+
+        case 5:
+        {
+            // The counter of LED_Pattern_5 is a single bit
+            if ((pmod_8ld_value != 0x00) && ((pmod_8ld_value & (pmod_8ld_value - 1)) == 0))
+            {
+                LED_Step_Count = pmod_8ld_value;
+                LED_Step_Position = LED_STEP_PATTERN_5;
+                return 500;
+            }
+        }
+        break;
+
+        default:
+            break;
+    }
+
+    // The outputs are not those of a delay, so the next call of LED_Controller_Step starts a new pattern run
+    return 0;
+}
+
+uint8_t LED_Controller_Step_Is_Running()
+{
+    return LED_Step_Position != LED_STEP_IDLE;
+}
+
+uint8_t LED_Get_Active_Pattern()
+{
+    return LED_Active_Pattern;
+}
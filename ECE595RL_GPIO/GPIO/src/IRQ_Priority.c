@@ -0,0 +1,246 @@
+/**
+ * @file IRQ_Priority.c
+ * @brief Source code for the IRQ_Priority module.
+ *
+ * This file contains the function definitions for the IRQ_Priority module.
+ *
+ * Only one probe is outstanding at a time: IRQ_Priority_Probe_Target holds the source that has been pended, and
+ * the probe handler does not pend another source before IRQ_Priority_Record has cleared it. The probe handler
+ * has the highest priority, so it can interrupt IRQ_Priority_Record, but it then finds the target still set and
+ * skips that probe.
+ *
+ * For more information regarding Timer_A, refer to the Timer_A section of the
+ * MSP432Pxx Microcontrollers Technical Reference Manual.
+ *
+ */
+
+#include "../inc/IRQ_Priority.h"
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/UART_Command.h"
+
+#define IRQ_PRIORITY_NO_TARGET      IRQ_PRIORITY_NUM_SOURCES
+
+typedef struct
+{
+    IRQn_Type irq;
+    uint8_t preempt;
+    uint8_t sub;
+    uint8_t probe;                  // The handler calls IRQ_Priority_Entry and tolerates an entry without its flag
+    const char *name;
+} IRQ_Priority_Plan;
+
+static const IRQ_Priority_Plan IRQ_Priority_Table[IRQ_PRIORITY_NUM_SOURCES] =
+{
+    {TA2_0_IRQn,    IRQ_PRIORITY_LEVEL_LATENCY,     0, 0, "ta2_0 isr latency"},
+    {TA0_0_IRQn,    IRQ_PRIORITY_LEVEL_LATENCY,     0, 0, "ta0_0 latency probe"},
+    {TA3_0_IRQn,    IRQ_PRIORITY_LEVEL_SAMPLER,     0, 0, "ta3_0 pc sampler"},
+    {TA1_N_IRQn,    IRQ_PRIORITY_LEVEL_EVENTS,      0, 1, "ta1_n reactor timers"},
+    {EUSCIA0_IRQn,  IRQ_PRIORITY_LEVEL_EVENTS,      0, 1, "eusci_a0 uart rx"},
+    {PORT1_IRQn,    IRQ_PRIORITY_LEVEL_EVENTS,      0, 1, "port1 buttons"},
+    {SysTick_IRQn,  IRQ_PRIORITY_LEVEL_EVENTS,      0, 0, "systick kernel tick"},
+    {DMA_INT1_IRQn, IRQ_PRIORITY_LEVEL_EVENTS,      0, 0, "dma_int1 ws2812"},
+    {PendSV_IRQn,   IRQ_PRIORITY_LEVEL_DEFERRED,    0, 0, "pendsv"},
+};
+
+static IRQ_Priority_Latency_Stats IRQ_Priority_Latency[IRQ_PRIORITY_NUM_SOURCES];
+static volatile uint8_t IRQ_Priority_Probe_Target = IRQ_PRIORITY_NO_TARGET;
+static volatile uint32_t IRQ_Priority_Probe_Start_Cycles;
+static uint8_t IRQ_Priority_Probe_Next;
+static volatile uint32_t IRQ_Priority_Probe_Busy;
+
+// PRIGROUP value of the grouping: the preempt priority uses bits 7 to PRIGROUP + 1 of the 8-bit priority field
+static uint32_t IRQ_Priority_Group()
+{
+    return 7 - IRQ_PRIORITY_PREEMPT_BITS;
+}
+
+static uint8_t IRQ_Priority_Enabled(IRQn_Type irq)
+{
+    if (irq == SysTick_IRQn)
+    {
+        return (SysTick->CTRL & SysTick_CTRL_TICKINT_Msk) != 0;
+    }
+    if (irq < 0)
+    {
+        return 1;
+    }
+    return (NVIC->ISER[irq >> 5] & (1 << (irq & 0x1F))) != 0;
+}
+
+void IRQ_Priority_Init()
+{
+    NVIC_SetPriorityGrouping(IRQ_Priority_Group());
+    IRQ_Priority_Reset();
+
+    UART_Command_Register('i', IRQ_Priority_Dump);
+    UART_Command_Register('I', IRQ_Priority_Reset);
+}
+
+void IRQ_Priority_Apply(IRQ_Priority_Source source)
+{
+    const IRQ_Priority_Plan *plan = &IRQ_Priority_Table[source];
+
+    NVIC_SetPriority(plan->irq, NVIC_EncodePriority(IRQ_Priority_Group(), plan->preempt, plan->sub));
+}
+
+void IRQ_Priority_Probe_Start(uint32_t period)
+{
+    IRQ_Priority_Probe_Stop();
+
+    // Trace pin as a low output
+    BITBAND_PERI(IRQ_PRIORITY_TRACE_PORT->OUT, IRQ_PRIORITY_TRACE_PIN) = 0;
+    BITBAND_PERI(IRQ_PRIORITY_TRACE_PORT->SEL0, IRQ_PRIORITY_TRACE_PIN) = 0;
+    BITBAND_PERI(IRQ_PRIORITY_TRACE_PORT->SEL1, IRQ_PRIORITY_TRACE_PIN) = 0;
+    BITBAND_PERI(IRQ_PRIORITY_TRACE_PORT->DIR, IRQ_PRIORITY_TRACE_PIN) = 1;
+
+    IRQ_Priority_Probe_Target = IRQ_PRIORITY_NO_TARGET;
+    IRQ_Priority_Probe_Next = 0;
+
+    // SMCLK, no divider, up mode, clear the counter
+    TIMER_A0->CCTL[0] = TIMER_A_CCTLN_CCIE;
+    TIMER_A0->CCR[0] = period - 1;
+    TIMER_A0->EX0 = 0;
+    TIMER_A0->CTL = TIMER_A_CTL_SSEL__SMCLK | TIMER_A_CTL_MC__UP | TIMER_A_CTL_CLR;
+
+    IRQ_Priority_Apply(IRQ_PRIORITY_TA0_0);
+    NVIC_ClearPendingIRQ(TA0_0_IRQn);
+    NVIC_EnableIRQ(TA0_0_IRQn);
+}
+
+void IRQ_Priority_Probe_Stop()
+{
+    NVIC_DisableIRQ(TA0_0_IRQn);
+    TIMER_A0->CTL = 0;
+    TIMER_A0->CCTL[0] = 0;
+}
+
+void IRQ_Priority_Record(IRQ_Priority_Source source, uint32_t entry_cycles)
+{
+    if (source != IRQ_Priority_Probe_Target)
+    {
+        return;
+    }
+
+    uint32_t latency = entry_cycles - IRQ_Priority_Probe_Start_Cycles;
+    IRQ_Priority_Latency_Stats *stats = &IRQ_Priority_Latency[source];
+
+    BITBAND_PERI(IRQ_PRIORITY_TRACE_PORT->OUT, IRQ_PRIORITY_TRACE_PIN) = 0;
+
+    stats->count++;
+    stats->total_cycles += latency;
+    if (latency < stats->min_cycles)
+    {
+        stats->min_cycles = latency;
+    }
+    if (latency > stats->max_cycles)
+    {
+        stats->max_cycles = latency;
+    }
+
+    // Cleared last, since it allows the next probe
+    IRQ_Priority_Probe_Target = IRQ_PRIORITY_NO_TARGET;
+}
+
+void IRQ_Priority_Get_Latency_Stats(IRQ_Priority_Source source, IRQ_Priority_Latency_Stats *stats)
+{
+    *stats = IRQ_Priority_Latency[source];
+}
+
+void IRQ_Priority_Reset()
+{
+    for (int source = 0; source < IRQ_PRIORITY_NUM_SOURCES; source++)
+    {
+        IRQ_Priority_Latency[source] = (IRQ_Priority_Latency_Stats){0};
+        IRQ_Priority_Latency[source].min_cycles = 0xFFFFFFFF;
+    }
+    IRQ_Priority_Probe_Busy = 0;
+}
+
+void IRQ_Priority_Dump()
+{
+    uint32_t group = NVIC_GetPriorityGrouping();
+
+    EUSCI_A0_UART_OutString("IRQ priorities: ");
+    EUSCI_A0_UART_OutUDec((7 - group < __NVIC_PRIO_BITS) ? (7 - group) : __NVIC_PRIO_BITS);
+    EUSCI_A0_UART_OutString(" preempt bits, ");
+    EUSCI_A0_UART_OutUDec(IRQ_Priority_Probe_Busy);
+    EUSCI_A0_UART_OutString(" probes skipped\r\n");
+
+    for (int source = 0; source < IRQ_PRIORITY_NUM_SOURCES; source++)
+    {
+        const IRQ_Priority_Plan *plan = &IRQ_Priority_Table[source];
+        const IRQ_Priority_Latency_Stats *stats = &IRQ_Priority_Latency[source];
+        uint32_t preempt;
+        uint32_t sub;
+
+        NVIC_DecodePriority(NVIC_GetPriority(plan->irq), group, &preempt, &sub);
+
+        EUSCI_A0_UART_OutString((char *)plan->name);
+        EUSCI_A0_UART_OutString(": irq ");
+        if (plan->irq < 0)
+        {
+            EUSCI_A0_UART_OutString("-");
+            EUSCI_A0_UART_OutUDec(-plan->irq);
+        }
+        else
+        {
+            EUSCI_A0_UART_OutUDec(plan->irq);
+        }
+        EUSCI_A0_UART_OutString(", preempt ");
+        EUSCI_A0_UART_OutUDec(preempt);
+        EUSCI_A0_UART_OutString(" sub ");
+        EUSCI_A0_UART_OutUDec(sub);
+        EUSCI_A0_UART_OutString(IRQ_Priority_Enabled(plan->irq) ? ", enabled" : ", disabled");
+
+        if (plan->probe)
+        {
+            EUSCI_A0_UART_OutString(", latency ");
+            EUSCI_A0_UART_OutUDec(stats->count);
+            EUSCI_A0_UART_OutString(" entries, min ");
+            EUSCI_A0_UART_OutUDec(stats->count ? stats->min_cycles : 0);
+            EUSCI_A0_UART_OutString(" average ");
+            EUSCI_A0_UART_OutUDec(stats->count ? (uint32_t)(stats->total_cycles / stats->count) : 0);
+            EUSCI_A0_UART_OutString(" max ");
+            EUSCI_A0_UART_OutUDec(stats->max_cycles);
+            EUSCI_A0_UART_OutString(" cycles");
+        }
+        EUSCI_A0_UART_OutString("\r\n");
+    }
+}
+
+void TA0_0_IRQHandler(void)
+{
+    TIMER_A0->CCTL[0] &= ~TIMER_A_CCTLN_CCIFG;
+
+    // The previous probe has not reached its handler yet
+    uint8_t target = IRQ_Priority_Probe_Target;
+    if (target != IRQ_PRIORITY_NO_TARGET)
+    {
+        IRQ_Priority_Probe_Busy++;
+
+        // The interrupt has been disabled since the probe (for example by Reactor_Suspend), so drop the probe
+        if (!IRQ_Priority_Enabled(IRQ_Priority_Table[target].irq))
+        {
+            NVIC_ClearPendingIRQ(IRQ_Priority_Table[target].irq);
+            BITBAND_PERI(IRQ_PRIORITY_TRACE_PORT->OUT, IRQ_PRIORITY_TRACE_PIN) = 0;
+            IRQ_Priority_Probe_Target = IRQ_PRIORITY_NO_TARGET;
+        }
+        return;
+    }
+
+    // Next measured source whose interrupt is enabled, in turn
+    for (int i = 0; i < IRQ_PRIORITY_NUM_SOURCES; i++)
+    {
+        uint8_t source = IRQ_Priority_Probe_Next;
+
+        IRQ_Priority_Probe_Next = (source + 1 < IRQ_PRIORITY_NUM_SOURCES) ? (source + 1) : 0;
+        if (IRQ_Priority_Table[source].probe && IRQ_Priority_Enabled(IRQ_Priority_Table[source].irq))
+        {
+            IRQ_Priority_Probe_Target = source;
+            BITBAND_PERI(IRQ_PRIORITY_TRACE_PORT->OUT, IRQ_PRIORITY_TRACE_PIN) = 1;
+            IRQ_Priority_Probe_Start_Cycles = DWT->CYCCNT;
+            NVIC->STIR = IRQ_Priority_Table[source].irq;
+            return;
+        }
+    }
+}
@@ -0,0 +1,140 @@
+/**
+ * @file ISR_Latency.c
+ * @brief Source code for the ISR_Latency module.
+ *
+ * This file contains the function definitions for the ISR_Latency module.
+ *
+ * For more information regarding Timer_A, refer to the Timer_A section of the
+ * MSP432Pxx Microcontrollers Technical Reference Manual.
+ *
+ */
+
+#include "../inc/ISR_Latency.h"
+#include "../inc/Clock.h"
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/IRQ_Priority.h"
+#include "../inc/UART_Command.h"
+
+static uint32_t ISR_Latency_Cycles_Per_Tick = 1;
+static uint32_t ISR_Latency_Period = ISR_LATENCY_DEFAULT_PERIOD;
+static volatile uint32_t ISR_Latency_Max_Cycles;
+static volatile uint32_t ISR_Latency_Min_Cycles;
+static volatile uint32_t ISR_Latency_Count;
+static volatile uint32_t ISR_Latency_Window;
+
+static void ISR_Latency_Start_Default()
+{
+    ISR_Latency_Start(ISR_LATENCY_DEFAULT_WINDOW);
+}
+
+void ISR_Latency_Init(uint32_t period)
+{
+    // MCLK and SMCLK are derived from the same source, so one tick is 2^(DIVS - DIVM) CPU cycles
+    uint32_t divm = (CS->CTL1 & CS_CTL1_DIVM_MASK) >> CS_CTL1_DIVM_OFS;
+    uint32_t divs = (CS->CTL1 & CS_CTL1_DIVS_MASK) >> CS_CTL1_DIVS_OFS;
+    ISR_Latency_Cycles_Per_Tick = (divs > divm) ? (1 << (divs - divm)) : 1;
+    ISR_Latency_Period = period;
+
+    ISR_Latency_Stop();
+    ISR_Latency_Reset();
+
+    UART_Command_Register('a', ISR_Latency_Dump);
+    UART_Command_Register('A', ISR_Latency_Start_Default);
+}
+
+void ISR_Latency_Start(uint32_t count)
+{
+    ISR_Latency_Stop();
+    ISR_Latency_Reset();
+    ISR_Latency_Window = count;
+
+    // SMCLK, no divider, up mode, clear the counter
+    TIMER_A2->CCTL[0] = TIMER_A_CCTLN_CCIE;
+    TIMER_A2->CCR[0] = ISR_Latency_Period - 1;
+    TIMER_A2->EX0 = 0;
+    TIMER_A2->CTL = TIMER_A_CTL_SSEL__SMCLK | TIMER_A_CTL_MC__UP | TIMER_A_CTL_CLR;
+
+    IRQ_Priority_Apply(IRQ_PRIORITY_TA2_0);
+    NVIC_ClearPendingIRQ(TA2_0_IRQn);
+    NVIC_EnableIRQ(TA2_0_IRQn);
+}
+
+uint8_t ISR_Latency_Is_Running()
+{
+    return (TIMER_A2->CTL & TIMER_A_CTL_MC_MASK) != 0;
+}
+
+void ISR_Latency_Stop()
+{
+    NVIC_DisableIRQ(TA2_0_IRQn);
+    TIMER_A2->CTL = 0;
+    TIMER_A2->CCTL[0] = 0;
+}
+
+void ISR_Latency_Reset()
+{
+    ISR_Latency_Max_Cycles = 0;
+    ISR_Latency_Min_Cycles = 0xFFFFFFFF;
+    ISR_Latency_Count = 0;
+}
+
+uint32_t ISR_Latency_Get_Max_Cycles()
+{
+    return ISR_Latency_Max_Cycles;
+}
+
+uint32_t ISR_Latency_Get_Min_Cycles()
+{
+    return (ISR_Latency_Count != 0) ? ISR_Latency_Min_Cycles : 0;
+}
+
+uint32_t ISR_Latency_Get_Count()
+{
+    return ISR_Latency_Count;
+}
+
+static void ISR_Latency_Out_Cycles(char *label, uint32_t cycles)
+{
+    EUSCI_A0_UART_OutString(label);
+    EUSCI_A0_UART_OutUDec(cycles);
+    EUSCI_A0_UART_OutString(" cycles (");
+    EUSCI_A0_UART_OutUDec((uint32_t)(((uint64_t)cycles * 1000000000) / Clock_GetFreq()));
+    EUSCI_A0_UART_OutString(" ns)\r\n");
+}
+
+void ISR_Latency_Dump()
+{
+    EUSCI_A0_UART_OutString("ISR latency: ");
+    EUSCI_A0_UART_OutUDec(ISR_Latency_Get_Count());
+    EUSCI_A0_UART_OutString(" of ");
+    EUSCI_A0_UART_OutUDec(ISR_Latency_Window);
+    EUSCI_A0_UART_OutString(ISR_Latency_Is_Running() ? " interrupts (running)\r\n" : " interrupts\r\n");
+    ISR_Latency_Out_Cycles("min: ", ISR_Latency_Get_Min_Cycles());
+    ISR_Latency_Out_Cycles("max: ", ISR_Latency_Get_Max_Cycles());
+}
+
+void TA2_0_IRQHandler(void)
+{
+    uint32_t ticks = TIMER_A2->R;
+
+    TIMER_A2->CCTL[0] &= ~TIMER_A_CCTLN_CCIFG;
+
+    // The counter restarts from 0 one tick after the interrupt request
+    ticks = (ticks == TIMER_A2->CCR[0]) ? 0 : (ticks + 1);
+
+    uint32_t latency = ticks * ISR_Latency_Cycles_Per_Tick;
+    if (latency > ISR_Latency_Max_Cycles)
+    {
+        ISR_Latency_Max_Cycles = latency;
+    }
+    if (latency < ISR_Latency_Min_Cycles)
+    {
+        ISR_Latency_Min_Cycles = latency;
+    }
+
+    // End the window so that the timer no longer wakes up the CPU
+    if (++ISR_Latency_Count >= ISR_Latency_Window)
+    {
+        ISR_Latency_Stop();
+    }
+}
@@ -0,0 +1,484 @@
+/**
+ * @file Kernel.c
+ * @brief Source code for the Kernel module.
+ *
+ * This file contains the function definitions for the Kernel module.
+ *
+ * Each priority has at most one thread, so the ready threads and the threads waiting for a semaphore are
+ * bit masks indexed by priority, and the next thread is the lowest set bit of Kernel_Ready.
+ *
+ * Stack of a thread that is not running, from the saved stack pointer upwards:
+ *  - R4-R11 and EXC_RETURN, saved by PendSV_Handler
+ *  - S16-S31, saved by PendSV_Handler if bit 4 of EXC_RETURN is 0
+ *  - The exception frame stacked by the hardware: R0-R3, R12, LR, PC, xPSR (and S0-S15, FPSCR with the FPU)
+ *
+ * The PendSV handler is written in assembly, since it must save and restore the registers that the compiler
+ * does not. It also serves the Deferred_Work module, which uses PendSV for its work items.
+ *
+ */
+
+#include "../inc/Kernel.h"
+#include "../inc/Clock.h"
+#include "../inc/Critical_Section.h"
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/IRQ_Priority.h"
+#include "../inc/UART_Command.h"
+
+// Value of the unused stack words, for the high-water mark
+#define KERNEL_STACK_FILL           0xDEADBEEF
+
+// Return to thread mode on the process stack, without FPU context
+#define KERNEL_EXC_RETURN_THREAD    0xFFFFFFFD
+
+// Thumb state bit of xPSR
+#define KERNEL_XPSR_THUMB           0x01000000
+
+// Number of words of the initial stack frame: R4-R11, EXC_RETURN, R0-R3, R12, LR, PC, xPSR
+#define KERNEL_FRAME_WORDS          17
+
+// Read by PendSV_Handler
+Kernel_Thread *Kernel_Current;
+Kernel_Thread *Kernel_Next;
+volatile uint32_t Kernel_Switches;
+
+// BASEPRI value of PendSV_Handler, computed here so that the handler follows KERNEL_SYSCALL_PRIORITY
+const uint32_t Kernel_Syscall_BASEPRI = KERNEL_SYSCALL_PRIORITY << (8 - __NVIC_PRIO_BITS);
+
+static Kernel_Thread *Kernel_Threads[KERNEL_NUM_PRIORITIES];
+static volatile uint32_t Kernel_Ready;
+static volatile uint32_t Kernel_Delayed;
+static volatile uint32_t Kernel_Ticks;
+static uint8_t Kernel_Started;
+
+static Kernel_Thread Kernel_Idle_Thread;
+KERNEL_STACK(Kernel_Idle_Stack, KERNEL_IDLE_STACK_WORDS);
+static void (*Kernel_Idle_Function)(void);
+
+static const char * const Kernel_State_Names[] = {"ready", "blocked", "stopped"};
+
+void Deferred_Work_Run();
+void Kernel_Start_First();
+
+__asm("    .sect \".text:PendSV_Handler\"\n"
+      "    .clink\n"
+      "    .thumbfunc PendSV_Handler\n"
+      "    .thumb\n"
+      "    .global PendSV_Handler\n"
+      "    .global Deferred_Work_Run\n"
+      "    .global Kernel_Current\n"
+      "    .global Kernel_Next\n"
+      "    .global Kernel_Switches\n"
+      "    .global Kernel_Syscall_BASEPRI\n"
+      "PendSV_Handler:\n"
+      "    PUSH    {R4, LR}\n"
+      "    BL      Deferred_Work_Run\n"
+      "    POP     {R4, LR}\n"
+      "    LDR     R3, Kernel_Syscall_BASEPRI_Address\n"
+      "    LDR     R3, [R3]\n"
+      "    MSR     BASEPRI, R3\n"
+      "    LDR     R0, Kernel_Current_Address\n"
+      "    LDR     R1, [R0]\n"
+      "    LDR     R2, Kernel_Next_Address\n"
+      "    LDR     R2, [R2]\n"
+      "    CBZ     R2, PendSV_Return\n"         // The kernel has not been started
+      "    CMP     R1, R2\n"
+      "    BEQ     PendSV_Return\n"
+      "    LDR     R3, Kernel_Switches_Address\n"
+      "    LDR     R12, [R3]\n"
+      "    ADD     R12, R12, #1\n"
+      "    STR     R12, [R3]\n"
+      "    CBZ     R1, PendSV_Restore\n"        // First switch: there is no context to save
+      "    MRS     R3, PSP\n"
+      "    TST     LR, #0x10\n"
+      "    IT      EQ\n"
+      "    VSTMDBEQ R3!, {S16-S31}\n"
+      "    STMDB   R3!, {R4-R11, LR}\n"
+      "    STR     R3, [R1]\n"
+      "PendSV_Restore:\n"
+      "    STR     R2, [R0]\n"
+      "    LDR     R3, [R2]\n"
+      "    LDMIA   R3!, {R4-R11, LR}\n"
+      "    TST     LR, #0x10\n"
+      "    IT      EQ\n"
+      "    VLDMIAEQ R3!, {S16-S31}\n"
+      "    MSR     PSP, R3\n"
+      "PendSV_Return:\n"
+      "    MOV     R3, #0\n"
+      "    MSR     BASEPRI, R3\n"
+      "    BX      LR\n"
+      "    .align  4\n"
+      "Kernel_Current_Address:\n"
+      "    .word   Kernel_Current\n"
+      "Kernel_Next_Address:\n"
+      "    .word   Kernel_Next\n"
+      "Kernel_Switches_Address:\n"
+      "    .word   Kernel_Switches\n"
+      "Kernel_Syscall_BASEPRI_Address:\n"
+      "    .word   Kernel_Syscall_BASEPRI\n");
+
+// Resets the main stack to its initial value (entry 0 of the vector table) and waits for the first PendSV
+__asm("    .sect \".text:Kernel_Start_First\"\n"
+      "    .clink\n"
+      "    .thumbfunc Kernel_Start_First\n"
+      "    .thumb\n"
+      "    .global Kernel_Start_First\n"
+      "Kernel_Start_First:\n"
+      "    LDR     R0, Kernel_VTOR_Address\n"
+      "    LDR     R0, [R0]\n"
+      "    LDR     R0, [R0]\n"
+      "    MSR     MSP, R0\n"
+      "    DSB\n"
+      "    ISB\n"
+      "    CPSIE   I\n"
+      "Kernel_Start_Wait:\n"
+      "    B       Kernel_Start_Wait\n"
+      "    .align  4\n"
+      "Kernel_VTOR_Address:\n"
+      "    .word   0xE000ED08\n");
+
+// Selects the highest-priority ready thread; called with the kernel critical section entered
+static void Kernel_Schedule()
+{
+    uint32_t ready = Kernel_Ready;
+
+    if (!Kernel_Started)
+    {
+        return;
+    }
+
+    Kernel_Next = Kernel_Threads[31 - _norm(ready & -ready)];
+    if (Kernel_Next != Kernel_Current)
+    {
+        SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    }
+}
+
+static void Kernel_Wake(Kernel_Thread *thread, uint8_t timed_out)
+{
+    uint32_t bit = 1u << thread->priority;
+
+    if (thread->waiting)
+    {
+        thread->waiting->waiters &= ~bit;
+        thread->waiting = 0;
+    }
+    thread->timed_out = timed_out;
+    thread->state = KERNEL_STATE_READY;
+    Kernel_Delayed &= ~bit;
+    Kernel_Ready |= bit;
+}
+
+// Blocks the current thread; the switch happens when the critical section is exited (see Kernel_Wait)
+static void Kernel_Block(uint32_t timeout)
+{
+    Kernel_Thread *thread = Kernel_Current;
+    uint32_t bit = 1u << thread->priority;
+
+    thread->state = KERNEL_STATE_BLOCKED;
+    thread->timed_out = 0;
+    Kernel_Ready &= ~bit;
+    if (timeout != KERNEL_WAIT_FOREVER)
+    {
+        thread->wake_tick = Kernel_Ticks + timeout;
+        Kernel_Delayed |= bit;
+    }
+    Kernel_Schedule();
+}
+
+// Exits the critical section of a blocking call and returns once the thread runs again
+static void Kernel_Wait(uint32_t previous)
+{
+    uint32_t bit = 1u << Kernel_Current->priority;
+
+    Critical_Section_Exit(previous);
+
+    // PendSV is taken as soon as BASEPRI is lowered; the loop covers the few instructions until then
+    while ((Kernel_Ready & bit) == 0);
+}
+
+static void Kernel_Thread_Exit()
+{
+    uint32_t previous = Critical_Section_Enter(KERNEL_SYSCALL_PRIORITY);
+
+    Kernel_Current->state = KERNEL_STATE_STOPPED;
+    Kernel_Ready &= ~(1u << Kernel_Current->priority);
+    Kernel_Schedule();
+    Critical_Section_Exit(previous);
+
+    while (1);
+}
+
+static void Kernel_Idle_Entry(void *argument)
+{
+    Kernel_Idle_Function();
+
+    while (1)
+    {
+        __WFI();
+    }
+}
+
+void Kernel_Init()
+{
+    for (int priority = 0; priority < KERNEL_NUM_PRIORITIES; priority++)
+    {
+        Kernel_Threads[priority] = 0;
+    }
+    Kernel_Ready = 0;
+    Kernel_Delayed = 0;
+    Kernel_Ticks = 0;
+    Kernel_Switches = 0;
+    Kernel_Current = 0;
+    Kernel_Next = 0;
+    Kernel_Started = 0;
+
+    UART_Command_Register('k', Kernel_Dump);
+}
+
+static uint8_t Kernel_Thread_Add(Kernel_Thread *thread, const char *name, void (*entry)(void *), void *argument,
+                                 uint64_t *stack, uint32_t stack_words, uint8_t priority)
+{
+    uint32_t *words = (uint32_t *)stack;
+    uint32_t *sp = words + (stack_words & ~1u);
+
+    if ((priority >= KERNEL_NUM_PRIORITIES) || (Kernel_Threads[priority] != 0) || (stack_words < KERNEL_MIN_STACK_WORDS))
+    {
+        return 1;
+    }
+
+    for (uint32_t i = 0; i < stack_words; i++)
+    {
+        words[i] = KERNEL_STACK_FILL;
+    }
+
+    // Exception frame, as if the thread had been interrupted at the first instruction of entry
+    *(--sp) = KERNEL_XPSR_THUMB;                    // xPSR
+    *(--sp) = (uint32_t)entry & ~1u;                // PC
+    *(--sp) = (uint32_t)Kernel_Thread_Exit;         // LR
+    *(--sp) = 0;                                    // R12
+    *(--sp) = 0;                                    // R3
+    *(--sp) = 0;                                    // R2
+    *(--sp) = 0;                                    // R1
+    *(--sp) = (uint32_t)argument;                   // R0
+
+    // Context saved by PendSV_Handler
+    *(--sp) = KERNEL_EXC_RETURN_THREAD;             // EXC_RETURN
+    for (int i = 0; i < 8; i++)
+    {
+        *(--sp) = 0;                                // R11 to R4
+    }
+
+    thread->sp = sp;
+    thread->name = name;
+    thread->stack = words;
+    thread->stack_words = stack_words;
+    thread->waiting = 0;
+    thread->priority = priority;
+    thread->state = KERNEL_STATE_READY;
+    thread->timed_out = 0;
+
+    uint32_t previous = Critical_Section_Enter(KERNEL_SYSCALL_PRIORITY);
+    Kernel_Threads[priority] = thread;
+    Kernel_Ready |= 1u << priority;
+    Kernel_Schedule();
+    Critical_Section_Exit(previous);
+
+    return 0;
+}
+
+uint8_t Kernel_Thread_Create(Kernel_Thread *thread, const char *name, void (*entry)(void *), void *argument,
+                             uint64_t *stack, uint32_t stack_words, uint8_t priority)
+{
+    if (priority >= KERNEL_IDLE_PRIORITY)
+    {
+        return 1;
+    }
+    return Kernel_Thread_Add(thread, name, entry, argument, stack, stack_words, priority);
+}
+
+void Kernel_Start(void (*idle)(void))
+{
+    Kernel_Idle_Function = idle;
+    Kernel_Thread_Add(&Kernel_Idle_Thread, "idle", Kernel_Idle_Entry, 0,
+                      Kernel_Idle_Stack, KERNEL_IDLE_STACK_WORDS, KERNEL_IDLE_PRIORITY);
+
+    IRQ_Priority_Apply(IRQ_PRIORITY_PENDSV);
+    IRQ_Priority_Apply(IRQ_PRIORITY_SYSTICK);
+    SysTick->LOAD = Clock_GetFreq() / KERNEL_TICK_HZ - 1;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+
+    // The first switch happens when Kernel_Start_First enables the interrupts
+    _disable_interrupts();
+    Kernel_Started = 1;
+    Kernel_Schedule();
+    Kernel_Start_First();
+}
+
+void Kernel_Delay(uint32_t ticks)
+{
+    if (ticks == 0)
+    {
+        return;
+    }
+
+    uint32_t previous = Critical_Section_Enter(KERNEL_SYSCALL_PRIORITY);
+    Kernel_Block(ticks);
+    Kernel_Wait(previous);
+}
+
+uint32_t Kernel_Get_Ticks()
+{
+    return Kernel_Ticks;
+}
+
+void Kernel_Semaphore_Init(Kernel_Semaphore *semaphore, uint32_t initial, uint32_t max)
+{
+    semaphore->count = initial;
+    semaphore->max = max;
+    semaphore->waiters = 0;
+}
+
+uint8_t Kernel_Semaphore_Take(Kernel_Semaphore *semaphore, uint32_t timeout)
+{
+    uint32_t previous = Critical_Section_Enter(KERNEL_SYSCALL_PRIORITY);
+
+    if (semaphore->count != 0)
+    {
+        semaphore->count--;
+        Critical_Section_Exit(previous);
+        return 0;
+    }
+    if (timeout == 0)
+    {
+        Critical_Section_Exit(previous);
+        return 1;
+    }
+
+    semaphore->waiters |= 1u << Kernel_Current->priority;
+    Kernel_Current->waiting = semaphore;
+    Kernel_Block(timeout);
+    Kernel_Wait(previous);
+
+    return Kernel_Current->timed_out;
+}
+
+void Kernel_Semaphore_Give(Kernel_Semaphore *semaphore)
+{
+    uint32_t previous = Critical_Section_Enter(KERNEL_SYSCALL_PRIORITY);
+    uint32_t waiters = semaphore->waiters;
+
+    if (waiters != 0)
+    {
+        // The count stays 0: the semaphore is handed over to the highest-priority waiting thread
+        Kernel_Wake(Kernel_Threads[31 - _norm(waiters & -waiters)], 0);
+        Kernel_Schedule();
+    }
+    else if (semaphore->count < semaphore->max)
+    {
+        semaphore->count++;
+    }
+    Critical_Section_Exit(previous);
+}
+
+void Kernel_Queue_Init(Kernel_Queue *queue, uint32_t *buffer, uint32_t size)
+{
+    Kernel_Semaphore_Init(&queue->items, 0, size);
+    queue->buffer = buffer;
+    queue->size = size;
+    queue->count = 0;
+    queue->head = 0;
+    queue->tail = 0;
+}
+
+uint8_t Kernel_Queue_Send(Kernel_Queue *queue, uint32_t message)
+{
+    uint32_t previous = Critical_Section_Enter(KERNEL_SYSCALL_PRIORITY);
+
+    if (queue->count >= queue->size)
+    {
+        Critical_Section_Exit(previous);
+        return 1;
+    }
+    queue->buffer[queue->head] = message;
+    queue->head = (queue->head + 1 == queue->size) ? 0 : queue->head + 1;
+    queue->count++;
+
+    // The critical sections nest, so the message and its semaphore count are updated together
+    Kernel_Semaphore_Give(&queue->items);
+    Critical_Section_Exit(previous);
+    return 0;
+}
+
+uint8_t Kernel_Queue_Receive(Kernel_Queue *queue, uint32_t *message, uint32_t timeout)
+{
+    if (Kernel_Semaphore_Take(&queue->items, timeout))
+    {
+        return 1;
+    }
+
+    // A successful take guarantees that a message is in the buffer
+    uint32_t previous = Critical_Section_Enter(KERNEL_SYSCALL_PRIORITY);
+    *message = queue->buffer[queue->tail];
+    queue->tail = (queue->tail + 1 == queue->size) ? 0 : queue->tail + 1;
+    queue->count--;
+    Critical_Section_Exit(previous);
+    return 0;
+}
+
+void Kernel_Dump()
+{
+    EUSCI_A0_UART_OutString("Kernel: ");
+    EUSCI_A0_UART_OutUDec(Kernel_Ticks);
+    EUSCI_A0_UART_OutString(" ticks, ");
+    EUSCI_A0_UART_OutUDec(Kernel_Switches);
+    EUSCI_A0_UART_OutString(" switches\r\n");
+
+    for (int priority = 0; priority < KERNEL_NUM_PRIORITIES; priority++)
+    {
+        const Kernel_Thread *thread = Kernel_Threads[priority];
+        uint32_t unused = 0;
+
+        if (thread == 0)
+        {
+            continue;
+        }
+        while ((unused < thread->stack_words) && (thread->stack[unused] == KERNEL_STACK_FILL))
+        {
+            unused++;
+        }
+
+        EUSCI_A0_UART_OutUDec(priority);
+        EUSCI_A0_UART_OutChar(SP);
+        EUSCI_A0_UART_OutString((char *)thread->name);
+        EUSCI_A0_UART_OutString(": ");
+        EUSCI_A0_UART_OutString((char *)Kernel_State_Names[thread->state]);
+        EUSCI_A0_UART_OutString(", stack ");
+        EUSCI_A0_UART_OutUDec(thread->stack_words - unused);
+        EUSCI_A0_UART_OutString(" of ");
+        EUSCI_A0_UART_OutUDec(thread->stack_words);
+        EUSCI_A0_UART_OutString(" words\r\n");
+    }
+}
+
+void SysTick_Handler(void)
+{
+    uint32_t previous = Critical_Section_Enter(KERNEL_SYSCALL_PRIORITY);
+    uint32_t ticks = ++Kernel_Ticks;
+    uint32_t delayed = Kernel_Delayed;
+
+    while (delayed)
+    {
+        uint32_t priority = 31 - _norm(delayed & -delayed);
+        Kernel_Thread *thread = Kernel_Threads[priority];
+
+        if ((int32_t)(ticks - thread->wake_tick) >= 0)
+        {
+            Kernel_Wake(thread, 1);
+        }
+        delayed &= ~(1u << priority);
+    }
+
+    Kernel_Schedule();
+    Critical_Section_Exit(previous);
+}
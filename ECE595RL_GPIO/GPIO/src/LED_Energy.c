@@ -0,0 +1,270 @@
+/**
+ * @file LED_Energy.c
+ * @brief Source code for the LED_Energy module.
+ *
+ * This file contains the function definitions for the LED_Energy module.
+ *
+ * All statistics are integrated over the same intervals: each event (port write, sleep transition,
+ * pattern change or update) closes the interval that started at the previous event.
+ *
+ */
+
+#include "../inc/LED_Energy.h"
+#include "../inc/Clock.h"
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/UART_Command.h"
+
+// Nominal currents in microamperes (see the note in LED_Energy.h)
+#define LED_ENERGY_DEFAULT_LED_UA       3000
+#define LED_ENERGY_DEFAULT_ACTIVE_UA    4500
+#define LED_ENERGY_DEFAULT_SLEEP_UA     1000
+
+// First pin and pin mask of each LED port
+static const uint8_t LED_Energy_Port_First_Pin[LED_ENERGY_NUM_PORTS] = {LED_ENERGY_PIN_LED1, LED_ENERGY_PIN_LED2, LED_ENERGY_PIN_PMOD_8LD};
+static const uint8_t LED_Energy_Port_Mask[LED_ENERGY_NUM_PORTS] = {0x01, 0x07, 0xFF};
+
+static uint32_t LED_Energy_Pin_Current_uA[LED_ENERGY_NUM_PINS];
+static uint64_t LED_Energy_Pin_On_Cycles[LED_ENERGY_NUM_PINS];
+static uint32_t LED_Energy_On_Mask;
+static uint32_t LED_Energy_LED_Current_uA;
+static uint32_t LED_Energy_Active_uA = LED_ENERGY_DEFAULT_ACTIVE_UA;
+static uint32_t LED_Energy_Sleep_uA = LED_ENERGY_DEFAULT_SLEEP_UA;
+static uint8_t LED_Energy_Sleeping;
+static uint64_t LED_Energy_Active_Cycles;
+static uint64_t LED_Energy_Sleep_Cycles;
+static uint64_t LED_Energy_Total_Charge;
+static uint32_t LED_Energy_Last_Cycles;
+
+static uint8_t LED_Energy_Pattern;
+static uint64_t LED_Energy_Run_Cycles;
+static uint64_t LED_Energy_Run_Charge;
+static LED_Energy_Pattern_Stats LED_Energy_Patterns[LED_ENERGY_NUM_PATTERNS];
+
+static void LED_Energy_Accrue()
+{
+    uint32_t now = DWT->CYCCNT;
+    uint32_t elapsed = now - LED_Energy_Last_Cycles;
+    uint32_t mask = LED_Energy_On_Mask;
+    uint32_t cpu_uA;
+    uint64_t charge;
+
+    LED_Energy_Last_Cycles = now;
+
+    while (mask)
+    {
+        uint32_t pin = 31 - _norm(mask);
+        LED_Energy_Pin_On_Cycles[pin] += elapsed;
+        mask &= ~(1 << pin);
+    }
+
+    if (LED_Energy_Sleeping)
+    {
+        LED_Energy_Sleep_Cycles += elapsed;
+        cpu_uA = LED_Energy_Sleep_uA;
+    }
+    else
+    {
+        LED_Energy_Active_Cycles += elapsed;
+        cpu_uA = LED_Energy_Active_uA;
+    }
+
+    charge = (uint64_t)(LED_Energy_LED_Current_uA + cpu_uA) * elapsed;
+    LED_Energy_Total_Charge += charge;
+
+    if (LED_Energy_Pattern != 0)
+    {
+        LED_Energy_Pattern_Stats *stats = &LED_Energy_Patterns[LED_Energy_Pattern - 1];
+        stats->total_cycles += elapsed;
+        stats->active_cycles += LED_Energy_Sleeping ? 0 : elapsed;
+        stats->total_charge += charge;
+        LED_Energy_Run_Cycles += elapsed;
+        LED_Energy_Run_Charge += charge;
+    }
+}
+
+static void LED_Energy_Update_LED_Current()
+{
+    uint32_t mask = LED_Energy_On_Mask;
+
+    LED_Energy_LED_Current_uA = 0;
+    while (mask)
+    {
+        uint32_t pin = 31 - _norm(mask);
+        LED_Energy_LED_Current_uA += LED_Energy_Pin_Current_uA[pin];
+        mask &= ~(1 << pin);
+    }
+}
+
+static uint32_t LED_Energy_To_uAh(uint64_t charge)
+{
+    return (uint32_t)(charge / ((uint64_t)Clock_GetFreq() * 3600));
+}
+
+static uint32_t LED_Energy_To_ms(uint64_t cycles)
+{
+    return (uint32_t)(cycles / (Clock_GetFreq() / 1000));
+}
+
+void LED_Energy_Init()
+{
+    for (int pin = 0; pin < LED_ENERGY_NUM_PINS; pin++)
+    {
+        LED_Energy_Pin_Current_uA[pin] = LED_ENERGY_DEFAULT_LED_UA;
+        LED_Energy_Pin_On_Cycles[pin] = 0;
+    }
+    for (int pattern = 0; pattern < LED_ENERGY_NUM_PATTERNS; pattern++)
+    {
+        LED_Energy_Patterns[pattern] = (LED_Energy_Pattern_Stats){0};
+    }
+    LED_Energy_Active_Cycles = 0;
+    LED_Energy_Sleep_Cycles = 0;
+    LED_Energy_Total_Charge = 0;
+    LED_Energy_Sleeping = 0;
+    LED_Energy_Pattern = 0;
+    LED_Energy_Last_Cycles = DWT->CYCCNT;
+
+    LED_Energy_On_Mask = ((P1->OUT & 0x01) << LED_ENERGY_PIN_LED1)
+                       | ((P2->OUT & 0x07) << LED_ENERGY_PIN_LED2)
+                       | ((uint32_t)P9->OUT << LED_ENERGY_PIN_PMOD_8LD);
+    LED_Energy_Update_LED_Current();
+
+    UART_Command_Register('e', LED_Energy_Dump);
+}
+
+void LED_Energy_Set_Pin_Current(uint8_t pin, uint32_t current_uA)
+{
+    if (pin < LED_ENERGY_NUM_PINS)
+    {
+        LED_Energy_Accrue();
+        LED_Energy_Pin_Current_uA[pin] = current_uA;
+        LED_Energy_Update_LED_Current();
+    }
+}
+
+void LED_Energy_Set_CPU_Current(uint32_t active_uA, uint32_t sleep_uA)
+{
+    LED_Energy_Accrue();
+    LED_Energy_Active_uA = active_uA;
+    LED_Energy_Sleep_uA = sleep_uA;
+}
+
+void LED_Energy_Output(LED_Energy_Port port, uint8_t value)
+{
+    uint32_t first_pin = LED_Energy_Port_First_Pin[port];
+    uint32_t port_mask = (uint32_t)LED_Energy_Port_Mask[port] << first_pin;
+    uint32_t on_mask = ((uint32_t)value << first_pin) & port_mask;
+
+    if (on_mask == (LED_Energy_On_Mask & port_mask))
+    {
+        return;
+    }
+
+    LED_Energy_Accrue();
+    LED_Energy_On_Mask = (LED_Energy_On_Mask & ~port_mask) | on_mask;
+    LED_Energy_Update_LED_Current();
+}
+
+void LED_Energy_Sleep_Begin()
+{
+    LED_Energy_Accrue();
+    LED_Energy_Sleeping = 1;
+}
+
+void LED_Energy_Sleep_End()
+{
+    LED_Energy_Accrue();
+    LED_Energy_Sleeping = 0;
+}
+
+void LED_Energy_Set_Pattern(uint8_t pattern)
+{
+    if ((pattern == 0) || (pattern > LED_ENERGY_NUM_PATTERNS))
+    {
+        return;
+    }
+
+    LED_Energy_Accrue();
+
+    // Close the run of the previous pattern
+    if (LED_Energy_Pattern != 0)
+    {
+        LED_Energy_Patterns[LED_Energy_Pattern - 1].last_cycles = LED_Energy_Run_Cycles;
+        LED_Energy_Patterns[LED_Energy_Pattern - 1].last_charge = LED_Energy_Run_Charge;
+    }
+
+    LED_Energy_Pattern = pattern;
+    LED_Energy_Patterns[pattern - 1].runs++;
+    LED_Energy_Run_Cycles = 0;
+    LED_Energy_Run_Charge = 0;
+}
+
+void LED_Energy_Update()
+{
+    LED_Energy_Accrue();
+}
+
+uint64_t LED_Energy_Get_Pin_On_Cycles(uint8_t pin)
+{
+    return (pin < LED_ENERGY_NUM_PINS) ? LED_Energy_Pin_On_Cycles[pin] : 0;
+}
+
+uint32_t LED_Energy_Get_Total_uAh()
+{
+    LED_Energy_Accrue();
+    return LED_Energy_To_uAh(LED_Energy_Total_Charge);
+}
+
+void LED_Energy_Get_Pattern_Stats(uint8_t pattern, LED_Energy_Pattern_Stats *stats)
+{
+    if ((pattern == 0) || (pattern > LED_ENERGY_NUM_PATTERNS))
+    {
+        *stats = (LED_Energy_Pattern_Stats){0};
+        return;
+    }
+
+    LED_Energy_Accrue();
+    *stats = LED_Energy_Patterns[pattern - 1];
+}
+
+void LED_Energy_Dump()
+{
+    LED_Energy_Accrue();
+
+    EUSCI_A0_UART_OutString("Energy: ");
+    EUSCI_A0_UART_OutUDec(LED_Energy_To_uAh(LED_Energy_Total_Charge));
+    EUSCI_A0_UART_OutString(" uAh, active ");
+    EUSCI_A0_UART_OutUDec(LED_Energy_To_ms(LED_Energy_Active_Cycles));
+    EUSCI_A0_UART_OutString(" ms, sleep ");
+    EUSCI_A0_UART_OutUDec(LED_Energy_To_ms(LED_Energy_Sleep_Cycles));
+    EUSCI_A0_UART_OutString(" ms\r\n");
+
+    for (int pattern = 1; pattern <= LED_ENERGY_NUM_PATTERNS; pattern++)
+    {
+        const LED_Energy_Pattern_Stats *stats = &LED_Energy_Patterns[pattern - 1];
+
+        EUSCI_A0_UART_OutString("Pattern ");
+        EUSCI_A0_UART_OutUDec(pattern);
+        EUSCI_A0_UART_OutString(": runs ");
+        EUSCI_A0_UART_OutUDec(stats->runs);
+        EUSCI_A0_UART_OutString(", total ");
+        EUSCI_A0_UART_OutUDec(LED_Energy_To_uAh(stats->total_charge));
+        EUSCI_A0_UART_OutString(" uAh, cpu ");
+        EUSCI_A0_UART_OutUDec(stats->total_cycles ? (uint32_t)((stats->active_cycles * 1000) / stats->total_cycles) : 0);
+        EUSCI_A0_UART_OutString(" per mille, average ");
+        EUSCI_A0_UART_OutUDec(stats->total_cycles ? (uint32_t)(stats->total_charge / stats->total_cycles) : 0);
+        EUSCI_A0_UART_OutString(" uA, last run ");
+        EUSCI_A0_UART_OutUDec(LED_Energy_To_uAh(stats->last_charge));
+        EUSCI_A0_UART_OutString(" uAh in ");
+        EUSCI_A0_UART_OutUDec(LED_Energy_To_ms(stats->last_cycles));
+        EUSCI_A0_UART_OutString(" ms");
+        if (pattern == LED_Energy_Pattern)
+        {
+            EUSCI_A0_UART_OutString(", current run ");
+            EUSCI_A0_UART_OutUDec(LED_Energy_To_uAh(LED_Energy_Run_Charge));
+            EUSCI_A0_UART_OutString(" uAh in ");
+            EUSCI_A0_UART_OutUDec(LED_Energy_To_ms(LED_Energy_Run_Cycles));
+            EUSCI_A0_UART_OutString(" ms");
+        }
+        EUSCI_A0_UART_OutString("\r\n");
+    }
+}
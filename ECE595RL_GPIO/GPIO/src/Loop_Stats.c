@@ -0,0 +1,217 @@
+/**
+ * @file Loop_Stats.c
+ * @brief Source code for the Loop_Stats module.
+ *
+ * This file contains the function definitions for the Loop_Stats module.
+ *
+ * The histogram bucket of a period p is found from the position of its most significant bit (m = 31 - CLZ(p)):
+ *  - p < 8:  bucket p
+ *  - p >= 8: bucket 8 * (m - 2) + the three bits of p below the most significant bit
+ *
+ */
+
+#include "../inc/Loop_Stats.h"
+#include "../inc/Clock.h"
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/Perf_Counter.h"
+#include "../inc/UART_Command.h"
+
+// Number of sub-buckets per power of two (must be a power of 2)
+#define LOOP_STATS_SUB_BITS         3
+#define LOOP_STATS_SUB_BUCKETS      (1 << LOOP_STATS_SUB_BITS)
+#define LOOP_STATS_NUM_BUCKETS      ((32 - LOOP_STATS_SUB_BITS + 1) * LOOP_STATS_SUB_BUCKETS)
+
+static uint32_t Loop_Stats_Histogram[LOOP_STATS_NUM_BUCKETS];
+static uint64_t Loop_Stats_Phase_Cycles[LOOP_STATS_NUM_PHASES];
+static uint64_t Loop_Stats_Total_Cycles;
+static uint32_t Loop_Stats_Count;
+static uint32_t Loop_Stats_Min;
+static uint32_t Loop_Stats_Max;
+static uint32_t Loop_Stats_Budget;
+static uint32_t Loop_Stats_Overruns;
+static uint32_t Loop_Stats_Last_Begin;
+static uint32_t Loop_Stats_Last_Mark;
+static uint8_t Loop_Stats_Started;
+
+static uint32_t Loop_Stats_Bucket(uint32_t cycles)
+{
+    if (cycles < LOOP_STATS_SUB_BUCKETS)
+    {
+        return cycles;
+    }
+
+    uint32_t msb = 31 - _norm(cycles);
+    uint32_t sub = (cycles >> (msb - LOOP_STATS_SUB_BITS)) & (LOOP_STATS_SUB_BUCKETS - 1);
+    return ((msb - LOOP_STATS_SUB_BITS + 1) << LOOP_STATS_SUB_BITS) + sub;
+}
+
+// Returns the largest period that falls in the bucket
+static uint32_t Loop_Stats_Bucket_Limit(uint32_t bucket)
+{
+    if (bucket < LOOP_STATS_SUB_BUCKETS)
+    {
+        return bucket;
+    }
+
+    uint32_t msb = (bucket >> LOOP_STATS_SUB_BITS) + LOOP_STATS_SUB_BITS - 1;
+    uint32_t sub = bucket & (LOOP_STATS_SUB_BUCKETS - 1);
+    uint32_t width = 1u << (msb - LOOP_STATS_SUB_BITS);
+    return (1u << msb) + (sub + 1) * width - 1;
+}
+
+static uint32_t Loop_Stats_Percentile(uint32_t permille)
+{
+    uint32_t rank = (uint32_t)(((uint64_t)Loop_Stats_Count * permille + 999) / 1000);
+    uint32_t seen = 0;
+
+    for (uint32_t bucket = 0; bucket < LOOP_STATS_NUM_BUCKETS; bucket++)
+    {
+        seen += Loop_Stats_Histogram[bucket];
+        if ((seen >= rank) && (seen != 0))
+        {
+            // The bucket limit can be above the true maximum
+            uint32_t limit = Loop_Stats_Bucket_Limit(bucket);
+            return (limit < Loop_Stats_Max) ? limit : Loop_Stats_Max;
+        }
+    }
+    return 0;
+}
+
+void Loop_Stats_Init(uint32_t budget_cycles)
+{
+    Loop_Stats_Budget = budget_cycles;
+    Loop_Stats_Reset();
+
+    UART_Command_Register('l', Loop_Stats_Dump);
+    UART_Command_Register('L', Loop_Stats_Reset);
+}
+
+void Loop_Stats_Reset()
+{
+    for (int i = 0; i < LOOP_STATS_NUM_BUCKETS; i++)
+    {
+        Loop_Stats_Histogram[i] = 0;
+    }
+    for (int i = 0; i < LOOP_STATS_NUM_PHASES; i++)
+    {
+        Loop_Stats_Phase_Cycles[i] = 0;
+    }
+    Loop_Stats_Total_Cycles = 0;
+    Loop_Stats_Count = 0;
+    Loop_Stats_Min = 0xFFFFFFFF;
+    Loop_Stats_Max = 0;
+    Loop_Stats_Overruns = 0;
+    Loop_Stats_Started = 0;
+}
+
+void Loop_Stats_Set_Budget(uint32_t budget_cycles)
+{
+    Loop_Stats_Budget = budget_cycles;
+    Loop_Stats_Overruns = 0;
+}
+
+void Loop_Stats_Begin()
+{
+    uint32_t now = DWT->CYCCNT;
+
+    if (Loop_Stats_Started)
+    {
+        uint32_t period = now - Loop_Stats_Last_Begin;
+
+        Loop_Stats_Phase_Cycles[LOOP_STATS_OTHER] += now - Loop_Stats_Last_Mark;
+        Loop_Stats_Total_Cycles += period;
+        Loop_Stats_Histogram[Loop_Stats_Bucket(period)]++;
+        Loop_Stats_Count++;
+
+        if (period < Loop_Stats_Min)
+        {
+            Loop_Stats_Min = period;
+        }
+        if (period > Loop_Stats_Max)
+        {
+            Loop_Stats_Max = period;
+        }
+        if ((Loop_Stats_Budget != 0) && (period > Loop_Stats_Budget))
+        {
+            Loop_Stats_Overruns++;
+            Perf_Counter_Increment(PERF_COUNTER_LOOP_OVERRUNS);
+        }
+    }
+
+    Loop_Stats_Started = 1;
+    Loop_Stats_Last_Begin = now;
+    Loop_Stats_Last_Mark = now;
+}
+
+void Loop_Stats_Mark(Loop_Stats_Phase phase)
+{
+    uint32_t now = DWT->CYCCNT;
+
+    Loop_Stats_Phase_Cycles[phase] += now - Loop_Stats_Last_Mark;
+    Loop_Stats_Last_Mark = now;
+}
+
+void Loop_Stats_Get_Summary(Loop_Stats_Summary *summary)
+{
+    uint64_t phase_total = 0;
+
+    summary->count = Loop_Stats_Count;
+    summary->min_cycles = (Loop_Stats_Count != 0) ? Loop_Stats_Min : 0;
+    summary->max_cycles = Loop_Stats_Max;
+    summary->mean_cycles = (Loop_Stats_Count != 0) ? (uint32_t)(Loop_Stats_Total_Cycles / Loop_Stats_Count) : 0;
+    summary->p50_cycles = Loop_Stats_Percentile(500);
+    summary->p90_cycles = Loop_Stats_Percentile(900);
+    summary->p99_cycles = Loop_Stats_Percentile(990);
+    summary->jitter_cycles = summary->p99_cycles - summary->p50_cycles;
+    summary->budget_cycles = Loop_Stats_Budget;
+    summary->overruns = Loop_Stats_Overruns;
+
+    for (int i = 0; i < LOOP_STATS_NUM_PHASES; i++)
+    {
+        phase_total += Loop_Stats_Phase_Cycles[i];
+    }
+    for (int i = 0; i < LOOP_STATS_NUM_PHASES; i++)
+    {
+        summary->phase_permille[i] = (phase_total != 0) ? (uint16_t)((Loop_Stats_Phase_Cycles[i] * 1000) / phase_total) : 0;
+    }
+}
+
+static void Loop_Stats_Out_Microseconds(char *label, uint32_t cycles)
+{
+    uint32_t cycles_per_us = Clock_GetFreq() / 1000000;
+
+    EUSCI_A0_UART_OutString(label);
+    EUSCI_A0_UART_OutUDec(cycles / cycles_per_us);
+    EUSCI_A0_UART_OutString(" us\r\n");
+}
+
+void Loop_Stats_Dump()
+{
+    static char * const phase_names[LOOP_STATS_NUM_PHASES] = {"input", "controller", "delay", "other"};
+    Loop_Stats_Summary summary;
+
+    Loop_Stats_Get_Summary(&summary);
+
+    EUSCI_A0_UART_OutString("Loop periods: ");
+    EUSCI_A0_UART_OutUDec(summary.count);
+    EUSCI_A0_UART_OutString("\r\n");
+    Loop_Stats_Out_Microseconds("min: ", summary.min_cycles);
+    Loop_Stats_Out_Microseconds("max: ", summary.max_cycles);
+    Loop_Stats_Out_Microseconds("mean: ", summary.mean_cycles);
+    Loop_Stats_Out_Microseconds("p50: ", summary.p50_cycles);
+    Loop_Stats_Out_Microseconds("p90: ", summary.p90_cycles);
+    Loop_Stats_Out_Microseconds("p99: ", summary.p99_cycles);
+    Loop_Stats_Out_Microseconds("jitter (p99 - p50): ", summary.jitter_cycles);
+    Loop_Stats_Out_Microseconds("budget: ", summary.budget_cycles);
+    EUSCI_A0_UART_OutString("overruns: ");
+    EUSCI_A0_UART_OutUDec(summary.overruns);
+    EUSCI_A0_UART_OutString("\r\n");
+
+    for (int i = 0; i < LOOP_STATS_NUM_PHASES; i++)
+    {
+        EUSCI_A0_UART_OutString(phase_names[i]);
+        EUSCI_A0_UART_OutString(": ");
+        EUSCI_A0_UART_OutUFix(summary.phase_permille[i]);
+        EUSCI_A0_UART_OutString(" %\r\n");
+    }
+}
@@ -0,0 +1,160 @@
+/**
+ * @file PC_Sampler.c
+ * @brief Source code for the PC_Sampler module.
+ *
+ * This file contains the function definitions for the PC_Sampler module.
+ *
+ * On exception entry, the processor stacks R0-R3, R12, LR, PC and xPSR. The stacked PC is at offset 24
+ * of the stack frame. The TA3_0 handler is written in assembly so that the stack pointer still points to the
+ * stack frame when it is read. Bit 2 of EXC_RETURN (in LR) selects the stack that holds the frame (MSP or PSP).
+ *
+ */
+
+#include "../inc/PC_Sampler.h"
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/IRQ_Priority.h"
+#include "../inc/UART_Command.h"
+
+// Start and end of the .text section (see msp432p401r.cmd)
+extern uint8_t __text_run_start;
+extern uint8_t __text_run_end;
+
+#pragma DATA_SECTION(PC_Sampler_Histogram, ".noinit")
+static uint16_t PC_Sampler_Histogram[PC_SAMPLER_NUM_BUCKETS];
+
+static uint32_t PC_Sampler_Base;
+static uint32_t PC_Sampler_Size;
+static uint32_t PC_Sampler_Shift;
+static volatile uint32_t PC_Sampler_Total;
+static volatile uint32_t PC_Sampler_Other;
+
+void PC_Sampler_Record(uint32_t pc);
+
+__asm("    .sect \".text:TA3_0_IRQHandler\"\n"
+      "    .clink\n"
+      "    .thumbfunc TA3_0_IRQHandler\n"
+      "    .thumb\n"
+      "    .global TA3_0_IRQHandler\n"
+      "    .global PC_Sampler_Record\n"
+      "TA3_0_IRQHandler:\n"
+      "    TST     LR, #4\n"
+      "    ITE     EQ\n"
+      "    MRSEQ   R0, MSP\n"
+      "    MRSNE   R0, PSP\n"
+      "    LDR     R0, [R0, #24]\n"
+      "    B       PC_Sampler_Record\n");
+
+void PC_Sampler_Record(uint32_t pc)
+{
+    uint32_t offset = pc - PC_Sampler_Base;
+
+    TIMER_A3->CCTL[0] &= ~TIMER_A_CCTLN_CCIFG;
+
+    if (offset < PC_Sampler_Size)
+    {
+        uint16_t *bucket = &PC_Sampler_Histogram[offset >> PC_Sampler_Shift];
+
+        // Saturate instead of wrapping around
+        if (*bucket != 0xFFFF)
+        {
+            (*bucket)++;
+        }
+    }
+    else
+    {
+        PC_Sampler_Other++;
+    }
+    PC_Sampler_Total++;
+}
+
+void PC_Sampler_Init(uint32_t period)
+{
+    PC_Sampler_Stop();
+
+    PC_Sampler_Base = (uint32_t)&__text_run_start;
+    PC_Sampler_Size = (uint32_t)&__text_run_end - PC_Sampler_Base;
+    PC_Sampler_Shift = 1;
+    while ((PC_SAMPLER_NUM_BUCKETS << PC_Sampler_Shift) < PC_Sampler_Size)
+    {
+        PC_Sampler_Shift++;
+    }
+
+    PC_Sampler_Reset();
+
+    UART_Command_Register('s', PC_Sampler_Dump);
+    UART_Command_Register('c', PC_Sampler_Reset);
+
+    // SMCLK, no divider, up mode, clear the counter
+    TIMER_A3->CCTL[0] = TIMER_A_CCTLN_CCIE;
+    TIMER_A3->CCR[0] = period - 1;
+    TIMER_A3->EX0 = 0;
+    TIMER_A3->CTL = TIMER_A_CTL_SSEL__SMCLK | TIMER_A_CTL_MC__UP | TIMER_A_CTL_CLR;
+
+    IRQ_Priority_Apply(IRQ_PRIORITY_TA3_0);
+    NVIC_ClearPendingIRQ(TA3_0_IRQn);
+    NVIC_EnableIRQ(TA3_0_IRQn);
+}
+
+void PC_Sampler_Stop()
+{
+    NVIC_DisableIRQ(TA3_0_IRQn);
+    TIMER_A3->CTL = 0;
+    TIMER_A3->CCTL[0] = 0;
+}
+
+void PC_Sampler_Reset()
+{
+    uint32_t enabled = NVIC->ISER[TA3_0_IRQn >> 5] & (1 << (TA3_0_IRQn & 0x1F));
+
+    NVIC_DisableIRQ(TA3_0_IRQn);
+    for (int i = 0; i < PC_SAMPLER_NUM_BUCKETS; i++)
+    {
+        PC_Sampler_Histogram[i] = 0;
+    }
+    PC_Sampler_Total = 0;
+    PC_Sampler_Other = 0;
+    if (enabled)
+    {
+        NVIC_EnableIRQ(TA3_0_IRQn);
+    }
+}
+
+uint32_t PC_Sampler_Get_Total()
+{
+    return PC_Sampler_Total;
+}
+
+void PC_Sampler_Dump()
+{
+    uint32_t enabled = NVIC->ISER[TA3_0_IRQn >> 5] & (1 << (TA3_0_IRQn & 0x1F));
+
+    // Pause sampling so that the histogram is consistent and the dump itself is not sampled
+    NVIC_DisableIRQ(TA3_0_IRQn);
+
+    EUSCI_A0_UART_OutString("PC sampler: base=");
+    EUSCI_A0_UART_OutUHex(PC_Sampler_Base);
+    EUSCI_A0_UART_OutString(" shift=");
+    EUSCI_A0_UART_OutUDec(PC_Sampler_Shift);
+    EUSCI_A0_UART_OutString(" total=");
+    EUSCI_A0_UART_OutUHex(PC_Sampler_Total);
+    EUSCI_A0_UART_OutString(" other=");
+    EUSCI_A0_UART_OutUHex(PC_Sampler_Other);
+    EUSCI_A0_UART_OutString("\r\n");
+
+    for (int i = 0; i < PC_SAMPLER_NUM_BUCKETS; i++)
+    {
+        if (PC_Sampler_Histogram[i] != 0)
+        {
+            EUSCI_A0_UART_OutUHex(PC_Sampler_Base + (i << PC_Sampler_Shift));
+            EUSCI_A0_UART_OutChar(SP);
+            EUSCI_A0_UART_OutUHex(PC_Sampler_Histogram[i]);
+            EUSCI_A0_UART_OutString("\r\n");
+        }
+    }
+    EUSCI_A0_UART_OutString("PC sampler: end\r\n");
+
+    if (enabled)
+    {
+        NVIC_EnableIRQ(TA3_0_IRQn);
+    }
+}
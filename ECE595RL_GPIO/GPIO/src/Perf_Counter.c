@@ -0,0 +1,127 @@
+/**
+ * @file Perf_Counter.c
+ * @brief Source code for the Perf_Counter module.
+ *
+ * This file contains the function definitions for the Perf_Counter module.
+ *
+ */
+
+#include <string.h>
+#include "../inc/Perf_Counter.h"
+#include "../inc/Clock.h"
+#include "../inc/CRC16.h"
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/UART_Command.h"
+
+#define PERF_COUNTER_NAME(id, name)     name,
+
+static const char * const Perf_Counter_Names[PERF_COUNTER_NUM_COUNTERS] =
+{
+    PERF_COUNTERS(PERF_COUNTER_NAME)
+};
+
+#undef PERF_COUNTER_NAME
+
+#pragma DATA_SECTION(Perf_Counter_Values, ".perf_counters")
+volatile uint32_t Perf_Counter_Values[PERF_COUNTER_NUM_COUNTERS];
+
+static uint32_t Perf_Counter_Previous[PERF_COUNTER_NUM_COUNTERS];
+static uint32_t Perf_Counter_Rates[PERF_COUNTER_NUM_COUNTERS];
+static uint32_t Perf_Counter_Last_Update;
+
+void Perf_Counter_Init()
+{
+    memset((void *)Perf_Counter_Values, 0, sizeof(Perf_Counter_Values));
+    memset(Perf_Counter_Previous, 0, sizeof(Perf_Counter_Previous));
+    memset(Perf_Counter_Rates, 0, sizeof(Perf_Counter_Rates));
+    Perf_Counter_Last_Update = DWT->CYCCNT;
+
+    UART_Command_Register('n', Perf_Counter_Dump);
+    UART_Command_Register('N', Perf_Counter_Dump_Binary);
+}
+
+void Perf_Counter_Snapshot(uint32_t *values)
+{
+    memcpy(values, (const void *)Perf_Counter_Values, sizeof(Perf_Counter_Values));
+}
+
+void Perf_Counter_Update()
+{
+    uint32_t now = DWT->CYCCNT;
+    uint32_t elapsed = now - Perf_Counter_Last_Update;
+    uint32_t frequency = Clock_GetFreq();
+    uint32_t values[PERF_COUNTER_NUM_COUNTERS];
+
+    if (elapsed < frequency)
+    {
+        return;
+    }
+
+    Perf_Counter_Snapshot(values);
+    for (int i = 0; i < PERF_COUNTER_NUM_COUNTERS; i++)
+    {
+        uint32_t delta = values[i] - Perf_Counter_Previous[i];
+        Perf_Counter_Rates[i] = (uint32_t)(((uint64_t)delta * frequency) / elapsed);
+        Perf_Counter_Previous[i] = values[i];
+    }
+    Perf_Counter_Last_Update = now;
+}
+
+uint32_t Perf_Counter_Get_Rate(Perf_Counter_Id id)
+{
+    return Perf_Counter_Rates[id];
+}
+
+void Perf_Counter_Dump()
+{
+    uint32_t values[PERF_COUNTER_NUM_COUNTERS];
+
+    Perf_Counter_Snapshot(values);
+
+    for (int i = 0; i < PERF_COUNTER_NUM_COUNTERS; i++)
+    {
+        EUSCI_A0_UART_OutString((char *)Perf_Counter_Names[i]);
+        EUSCI_A0_UART_OutChar(SP);
+        EUSCI_A0_UART_OutUDec(values[i]);
+        EUSCI_A0_UART_OutChar(SP);
+        EUSCI_A0_UART_OutUDec(Perf_Counter_Rates[i]);
+        EUSCI_A0_UART_OutString("/s\r\n");
+    }
+}
+
+static uint16_t Perf_Counter_Out_Word(uint16_t crc, uint32_t word)
+{
+    uint8_t bytes[4] = {(uint8_t)word, (uint8_t)(word >> 8), (uint8_t)(word >> 16), (uint8_t)(word >> 24)};
+
+    for (int i = 0; i < 4; i++)
+    {
+        EUSCI_A0_UART_OutChar(bytes[i]);
+    }
+    return CRC16_Update(crc, bytes, 4);
+}
+
+void Perf_Counter_Dump_Binary()
+{
+    uint32_t values[PERF_COUNTER_NUM_COUNTERS];
+    uint8_t num_counters = PERF_COUNTER_NUM_COUNTERS;
+    uint16_t crc;
+
+    Perf_Counter_Snapshot(values);
+
+    EUSCI_A0_UART_OutChar(0xA5);
+    EUSCI_A0_UART_OutChar(0x5A);
+    EUSCI_A0_UART_OutChar(num_counters);
+    crc = CRC16_Update(CRC16_INIT, &num_counters, 1);
+
+    for (int i = 0; i < PERF_COUNTER_NUM_COUNTERS; i++)
+    {
+        crc = Perf_Counter_Out_Word(crc, values[i]);
+    }
+    for (int i = 0; i < PERF_COUNTER_NUM_COUNTERS; i++)
+    {
+        crc = Perf_Counter_Out_Word(crc, Perf_Counter_Rates[i]);
+    }
+
+    EUSCI_A0_UART_OutChar(crc & 0xFF);
+    EUSCI_A0_UART_OutChar(crc >> 8);
+}
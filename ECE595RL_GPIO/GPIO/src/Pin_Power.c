@@ -0,0 +1,39 @@
+/**
+ * @file Pin_Power.c
+ * @brief Source code for the Pin_Power driver.
+ *
+ * This file contains the function definitions for the Pin_Power driver.
+ *
+ * For more information regarding the unused pins, refer to the Digital I/O section of the
+ * MSP432Pxx Microcontrollers Technical Reference Manual.
+ *
+ */
+
+#include "../inc/Pin_Power.h"
+
+// Configures the pins of output_low as outputs driven low and the pins of pull_down as inputs with a pull-down
+// resistor (PxOUT selects the pull-down when PxREN is set). The other pins of the port are not changed.
+#define PIN_POWER_UNUSED(port, output_low, pull_down)                       \
+    do                                                                      \
+    {                                                                       \
+        (port)->SEL0 &= (uint8_t)~((output_low) | (pull_down));             \
+        (port)->SEL1 &= (uint8_t)~((output_low) | (pull_down));             \
+        (port)->OUT &= (uint8_t)~((output_low) | (pull_down));              \
+        (port)->REN = ((port)->REN & ~(output_low)) | (pull_down);          \
+        (port)->DIR = ((port)->DIR | (output_low)) & ~(pull_down);          \
+    } while (0)
+
+void Pin_Power_Init()
+{
+    PIN_POWER_UNUSED(P1, 0xE0, 0x00);   // P1.0 - P1.4: red LED, user buttons and UART
+    PIN_POWER_UNUSED(P2, 0xF8, 0x00);   // P2.0 - P2.2: RGB LED
+    PIN_POWER_UNUSED(P3, 0xFF, 0x00);
+    PIN_POWER_UNUSED(P4, 0xFF, 0x00);   // P4.0: IRQ_Priority trace pin
+    PIN_POWER_UNUSED(P5, 0xFF, 0x00);
+    PIN_POWER_UNUSED(P6, 0xFF, 0x00);
+    PIN_POWER_UNUSED(P7, 0xFF, 0x00);
+    PIN_POWER_UNUSED(P8, 0xFF, 0x00);
+                                        // P9.0 - P9.7: PMOD 8LD
+    PIN_POWER_UNUSED(P10, 0x00, 0x30);  // P10.0 - P10.3: PMOD SWT
+    PIN_POWER_UNUSED(PJ, 0x03, 0x00);   // PJ.2 - PJ.5: HFXT crystal and JTAG
+}
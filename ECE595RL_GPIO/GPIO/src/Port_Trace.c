@@ -0,0 +1,107 @@
+/**
+ * @file Port_Trace.c
+ * @brief Source code for the Port_Trace module.
+ *
+ * This file contains the function definitions for the Port_Trace module.
+ *
+ */
+
+#include "../inc/Port_Trace.h"
+#include "../inc/Clock.h"
+#include "../inc/Critical_Section.h"
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/UART_Command.h"
+
+#ifdef PORT_TRACE_ENABLE
+
+static Port_Trace_Entry Port_Trace_Buffer[PORT_TRACE_SIZE];
+static volatile uint32_t Port_Trace_Head;          // Number of records written
+static volatile uint32_t Port_Trace_Tail;          // Number of records read
+static volatile uint32_t Port_Trace_Lost;
+
+void Port_Trace_Init()
+{
+    Port_Trace_Reset();
+
+    UART_Command_Register('t', Port_Trace_Dump);
+    UART_Command_Register('T', Port_Trace_Reset);
+}
+
+void Port_Trace_Reset()
+{
+    uint32_t state = Critical_Section_Enter(CRITICAL_SECTION_GPIO);
+    Port_Trace_Head = 0;
+    Port_Trace_Tail = 0;
+    Port_Trace_Lost = 0;
+    Critical_Section_Exit(state);
+}
+
+void Port_Trace_Log(uint8_t port, uint8_t value)
+{
+    uint32_t timestamp = DWT->CYCCNT;
+    uint32_t state = Critical_Section_Enter(CRITICAL_SECTION_GPIO);
+
+    if ((Port_Trace_Head - Port_Trace_Tail) < PORT_TRACE_SIZE)
+    {
+        Port_Trace_Entry *entry = &Port_Trace_Buffer[Port_Trace_Head % PORT_TRACE_SIZE];
+        entry->timestamp = timestamp;
+        entry->port = port;
+        entry->value = value;
+        Port_Trace_Head++;
+    }
+    else
+    {
+        Port_Trace_Lost++;
+    }
+    Critical_Section_Exit(state);
+}
+
+uint32_t Port_Trace_Read(Port_Trace_Entry *entries, uint32_t max)
+{
+    uint32_t count = 0;
+    uint32_t state = Critical_Section_Enter(CRITICAL_SECTION_GPIO);
+
+    while ((count < max) && (Port_Trace_Tail != Port_Trace_Head))
+    {
+        entries[count++] = Port_Trace_Buffer[Port_Trace_Tail % PORT_TRACE_SIZE];
+        Port_Trace_Tail++;
+    }
+    Critical_Section_Exit(state);
+
+    return count;
+}
+
+uint32_t Port_Trace_Get_Lost()
+{
+    return Port_Trace_Lost;
+}
+
+void Port_Trace_Dump()
+{
+    Port_Trace_Entry entry;
+
+    // Only the records present now are transmitted, so the dump ends even if the ports keep changing
+    uint32_t count = Port_Trace_Head - Port_Trace_Tail;
+
+    EUSCI_A0_UART_OutString("Port trace: freq=");
+    EUSCI_A0_UART_OutUDec(Clock_GetFreq());
+    EUSCI_A0_UART_OutString(" count=");
+    EUSCI_A0_UART_OutUDec(count);
+    EUSCI_A0_UART_OutString(" lost=");
+    EUSCI_A0_UART_OutUDec(Port_Trace_Lost);
+    EUSCI_A0_UART_OutString("\r\n");
+
+    while ((count != 0) && Port_Trace_Read(&entry, 1))
+    {
+        EUSCI_A0_UART_OutUHex(entry.timestamp);
+        EUSCI_A0_UART_OutChar(SP);
+        EUSCI_A0_UART_OutUDec(entry.port);
+        EUSCI_A0_UART_OutChar(SP);
+        EUSCI_A0_UART_OutUHex(entry.value);
+        EUSCI_A0_UART_OutString("\r\n");
+        count--;
+    }
+    EUSCI_A0_UART_OutString("Port trace: end\r\n");
+}
+
+#endif /* PORT_TRACE_ENABLE */
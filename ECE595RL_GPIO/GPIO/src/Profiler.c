@@ -0,0 +1,110 @@
+/**
+ * @file Profiler.c
+ * @brief Source code for the Profiler module.
+ *
+ * This file contains the function definitions for the Profiler module.
+ *
+ */
+
+#include "../inc/Profiler.h"
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/UART_Command.h"
+
+#ifdef PROFILER_ENABLE
+
+#define PROFILER_NAME(id, name)  name,
+
+static const char * const Profiler_Names[PROFILER_NUM_FUNCTIONS] =
+{
+    PROFILER_FUNCTIONS(PROFILER_NAME)
+};
+
+#undef PROFILER_NAME
+
+Profiler_Entry Profiler_Table[PROFILER_NUM_FUNCTIONS];
+
+static uint32_t Profiler_Overhead_Cycles;
+
+void Profiler_Init()
+{
+    Profiler_Overhead_Cycles = 0;
+
+    // Measure an empty PROFILER_ENTER / PROFILER_EXIT pair, including the cycles spent after the second counter read
+    for (int i = 0; i < 16; i++)
+    {
+        uint32_t start_cycles = DWT->CYCCNT;
+        {
+            PROFILER_ENTER();
+            PROFILER_EXIT(LED1_OUTPUT);
+        }
+        uint32_t cycles = DWT->CYCCNT - start_cycles;
+
+        if (cycles > Profiler_Overhead_Cycles)
+        {
+            Profiler_Overhead_Cycles = cycles;
+        }
+    }
+
+    Profiler_Reset();
+
+    UART_Command_Register('p', Profiler_Dump);
+    UART_Command_Register('r', Profiler_Reset);
+}
+
+void Profiler_Reset()
+{
+    for (int id = 0; id < PROFILER_NUM_FUNCTIONS; id++)
+    {
+        Profiler_Table[id].count = 0;
+        for (int bucket = 0; bucket < PROFILER_NUM_BUCKETS; bucket++)
+        {
+            Profiler_Table[id].histogram[bucket] = 0;
+        }
+    }
+}
+
+const Profiler_Entry *Profiler_Get_Entry(Profiler_Function id)
+{
+    return &Profiler_Table[id];
+}
+
+uint32_t Profiler_Get_Overhead_Cycles()
+{
+    return Profiler_Overhead_Cycles;
+}
+
+void Profiler_Dump()
+{
+    EUSCI_A0_UART_OutString("Profiler overhead: ");
+    EUSCI_A0_UART_OutUDec(Profiler_Overhead_Cycles);
+    EUSCI_A0_UART_OutString(" cycles\r\n");
+
+    for (int id = 0; id < PROFILER_NUM_FUNCTIONS; id++)
+    {
+        // Copy the entry first, since the UART functions used below update the table
+        Profiler_Entry entry = Profiler_Table[id];
+
+        if (entry.count == 0)
+        {
+            continue;
+        }
+
+        EUSCI_A0_UART_OutString((char *)Profiler_Names[id]);
+        EUSCI_A0_UART_OutChar(SP);
+        EUSCI_A0_UART_OutUDec(entry.count);
+
+        for (int bucket = 0; bucket < PROFILER_NUM_BUCKETS; bucket++)
+        {
+            if (entry.histogram[bucket] != 0)
+            {
+                EUSCI_A0_UART_OutChar(SP);
+                EUSCI_A0_UART_OutUDec(bucket);
+                EUSCI_A0_UART_OutChar(':');
+                EUSCI_A0_UART_OutUDec(entry.histogram[bucket]);
+            }
+        }
+        EUSCI_A0_UART_OutString("\r\n");
+    }
+}
+
+#endif /* PROFILER_ENABLE */
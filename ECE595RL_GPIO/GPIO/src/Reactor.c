@@ -0,0 +1,460 @@
+/**
+ * @file Reactor.c
+ * @brief Source code for the Reactor module.
+ *
+ * This file contains the function definitions for the Reactor module.
+ *
+ * An event is stored as a single word: the type in bits 24 to 31 and the argument in bits 0 to 23.
+ * Reactor_Head and Reactor_Tail count the events posted and removed since Reactor_Init, and the slot of
+ * an event is its count modulo REACTOR_QUEUE_SIZE.
+ *
+ * Timer A1 counts ACLK in continuous mode. The 16-bit counter is extended to a 48-bit time by counting the
+ * overflows (TAIFG) in the TA1_N handler. ACLK is asynchronous to MCLK, so the counter is read until two
+ * consecutive reads match (see the Timer_A section of the Technical Reference Manual).
+ *
+ */
+
+#include "../inc/Reactor.h"
+#include "../inc/Clock.h"
+#include "../inc/Deferred_Work.h"
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/Flight_Recorder.h"
+#include "../inc/LED_Energy.h"
+#include "../inc/Perf_Counter.h"
+#include "../inc/UART_Command.h"
+
+#define REACTOR_TYPE_SHIFT          24
+#define REACTOR_ARGUMENT_MASK       0x00FFFFFF
+
+// ACLK frequency (REFOCLK) and timer ticks per millisecond, rounded
+#define REACTOR_ACLK_HZ             32768
+#define REACTOR_MS_TO_TICKS(ms)     (((ms) * REACTOR_ACLK_HZ + 500) / 1000)
+
+// A deadline closer than this number of ticks may already have passed when the compare register is written
+#define REACTOR_MIN_TICKS           2
+
+// The user buttons (P1.1 and P1.4)
+#define REACTOR_BUTTONS             0x12
+
+// Timer A1 interrupt vector values
+#define REACTOR_TA1_IV_TAIFG        0x0E
+
+static volatile uint32_t Reactor_Queue[REACTOR_QUEUE_SIZE];
+static volatile uint32_t Reactor_Head;
+static volatile uint32_t Reactor_Tail;
+static Reactor_Handler Reactor_Handlers[REACTOR_NUM_EVENTS];
+
+static volatile uint32_t Reactor_Overflows;
+static uint32_t Reactor_Deadline[REACTOR_NUM_TIMERS];
+static uint8_t Reactor_Buttons_Enabled;
+static uint8_t Reactor_Suspended_IRQs;
+
+static uint32_t Reactor_Events[REACTOR_NUM_EVENTS];
+static uint32_t Reactor_Max_Handler_Cycles[REACTOR_NUM_EVENTS];
+static volatile uint32_t Reactor_Dropped;
+static volatile uint32_t Reactor_Max_Depth;
+static uint32_t Reactor_Sleeps;
+static uint64_t Reactor_Start_Ticks;
+static uint64_t Reactor_Sleep_Ticks;
+static int32_t Reactor_Cycle_Debt;
+
+static const char * const Reactor_Event_Names[REACTOR_NUM_EVENTS] = {"timer", "buttons", "uart rx", "dma done"};
+
+static const IRQn_Type Reactor_IRQs[] = {TA1_N_IRQn, PORT1_IRQn, EUSCIA0_IRQn};
+
+static uint16_t Reactor_Read_Counter()
+{
+    uint16_t count = TIMER_A1->R;
+    uint16_t previous;
+
+    do
+    {
+        previous = count;
+        count = TIMER_A1->R;
+    } while (count != previous);
+
+    return count;
+}
+
+// Returns the time since Timer A1 was started in ACLK periods
+static uint64_t Reactor_Time()
+{
+    uint32_t primask = _disable_interrupts();
+    uint16_t count = Reactor_Read_Counter();
+    uint32_t overflows = Reactor_Overflows;
+
+    // The counter has wrapped around but the TA1_N handler has not run yet
+    if ((TIMER_A1->CTL & TIMER_A_CTL_IFG) && (count < 0x8000))
+    {
+        overflows++;
+    }
+    _restore_interrupts(primask);
+
+    return ((uint64_t)overflows << 16) | count;
+}
+
+static uint8_t Reactor_IRQ_Enabled(IRQn_Type irq)
+{
+    return (NVIC->ISER[irq >> 5] & (1 << (irq & 0x1F))) != 0;
+}
+
+static void Reactor_Enable_IRQ(IRQn_Type irq, IRQ_Priority_Source source)
+{
+    IRQ_Priority_Apply(source);
+    NVIC_EnableIRQ(irq);
+}
+
+// Waits for the edge opposite to the current level of each button
+static void Reactor_Arm_Buttons()
+{
+    P1->IES = (P1->IES & ~REACTOR_BUTTONS) | (P1->IN & REACTOR_BUTTONS);
+
+    // Writing IES can set the interrupt flags
+    P1->IFG &= ~REACTOR_BUTTONS;
+    P1->IE |= REACTOR_BUTTONS;
+}
+
+static void Reactor_Arm_Timer(uint8_t timer, uint32_t deadline)
+{
+    uint32_t primask = _disable_interrupts();
+    int32_t remaining = (int32_t)(deadline - (uint32_t)Reactor_Time());
+
+    Reactor_Deadline[timer] = deadline;
+    if (remaining < REACTOR_MIN_TICKS)
+    {
+        TIMER_A1->CCTL[timer + 1] = 0;
+        Reactor_Post(REACTOR_EVENT_TIMER, timer);
+    }
+    else
+    {
+        // Writing CCTL also clears a pending CCIFG of the previous deadline
+        TIMER_A1->CCR[timer + 1] = (uint16_t)deadline;
+        TIMER_A1->CCTL[timer + 1] = TIMER_A_CCTLN_CCIE;
+    }
+    _restore_interrupts(primask);
+}
+
+// Waits for an interrupt and advances the cycle counter by the time it did not count during the sleep
+static void Reactor_Sleep()
+{
+    LED_Energy_Sleep_Begin();
+
+    uint64_t start_ticks = Reactor_Time();
+    uint32_t start_cycles = DWT->CYCCNT;
+
+    __WFI();
+
+    uint32_t counted = DWT->CYCCNT - start_cycles;
+    uint32_t ticks = (uint32_t)(Reactor_Time() - start_ticks);
+    uint32_t slept = (uint32_t)(((uint64_t)ticks * Clock_GetFreq()) / REACTOR_ACLK_HZ);
+
+    // The counter must not go backwards, so a negative correction is carried over to the next sleep
+    int32_t correction = (int32_t)(slept - counted) + Reactor_Cycle_Debt;
+    if (correction > 0)
+    {
+        DWT->CYCCNT += correction;
+        Reactor_Cycle_Debt = 0;
+    }
+    else
+    {
+        Reactor_Cycle_Debt = correction;
+    }
+
+    LED_Energy_Sleep_End();
+    Reactor_Sleep_Ticks += ticks;
+    Reactor_Sleeps++;
+}
+
+void Reactor_Init()
+{
+    NVIC_DisableIRQ(TA1_N_IRQn);
+
+    Reactor_Head = 0;
+    Reactor_Tail = 0;
+    for (int type = 0; type < REACTOR_NUM_EVENTS; type++)
+    {
+        Reactor_Handlers[type] = 0;
+        Reactor_Events[type] = 0;
+        Reactor_Max_Handler_Cycles[type] = 0;
+    }
+    Reactor_Dropped = 0;
+    Reactor_Max_Depth = 0;
+    Reactor_Sleeps = 0;
+    Reactor_Sleep_Ticks = 0;
+    Reactor_Cycle_Debt = 0;
+    Reactor_Overflows = 0;
+    Reactor_Buttons_Enabled = 0;
+    Reactor_Suspended_IRQs = 0;
+
+    // ACLK, no divider, continuous mode, overflow interrupt, clear the counter
+    for (int timer = 0; timer < REACTOR_NUM_TIMERS; timer++)
+    {
+        TIMER_A1->CCTL[timer + 1] = 0;
+        Reactor_Deadline[timer] = 0;
+    }
+    TIMER_A1->EX0 = 0;
+    TIMER_A1->CTL = TIMER_A_CTL_SSEL__ACLK | TIMER_A_CTL_MC__CONTINUOUS | TIMER_A_CTL_IE | TIMER_A_CTL_CLR;
+    Reactor_Start_Ticks = Reactor_Time();
+
+    UART_Command_Register('u', Reactor_Dump);
+
+    NVIC_ClearPendingIRQ(TA1_N_IRQn);
+    Reactor_Enable_IRQ(TA1_N_IRQn, IRQ_PRIORITY_TA1_N);
+}
+
+void Reactor_Register(Reactor_Event_Type type, Reactor_Handler handler)
+{
+    if (type < REACTOR_NUM_EVENTS)
+    {
+        Reactor_Handlers[type] = handler;
+    }
+}
+
+uint8_t Reactor_Post(Reactor_Event_Type type, uint32_t argument)
+{
+    uint32_t head;
+    uint32_t depth;
+
+    // Claim a slot; the store fails and is retried if an interrupt posted an event in between
+    do
+    {
+        head = __ldrex((void *)&Reactor_Head);
+        depth = head - Reactor_Tail;
+        if (depth >= REACTOR_QUEUE_SIZE)
+        {
+            Reactor_Dropped++;
+            return 1;
+        }
+    } while (__strex(head + 1, (void *)&Reactor_Head));
+
+    // Reactor_Run cannot read the slot before this handler (or the calling event handler) has returned
+    Reactor_Queue[head & (REACTOR_QUEUE_SIZE - 1)] = ((uint32_t)type << REACTOR_TYPE_SHIFT) | (argument & REACTOR_ARGUMENT_MASK);
+
+    if (depth + 1 > Reactor_Max_Depth)
+    {
+        Reactor_Max_Depth = depth + 1;
+    }
+    return 0;
+}
+
+void Reactor_Timer_Start(uint8_t timer, uint32_t ms)
+{
+    if (timer < REACTOR_NUM_TIMERS)
+    {
+        Reactor_Arm_Timer(timer, (uint32_t)Reactor_Time() + REACTOR_MS_TO_TICKS(ms));
+    }
+}
+
+void Reactor_Timer_Continue(uint8_t timer, uint32_t ms)
+{
+    if (timer < REACTOR_NUM_TIMERS)
+    {
+        Reactor_Arm_Timer(timer, Reactor_Deadline[timer] + REACTOR_MS_TO_TICKS(ms));
+    }
+}
+
+void Reactor_Timer_Stop(uint8_t timer)
+{
+    if (timer < REACTOR_NUM_TIMERS)
+    {
+        TIMER_A1->CCTL[timer + 1] = 0;
+    }
+}
+
+void Reactor_Suspend()
+{
+    Reactor_Suspended_IRQs = 0;
+    for (int i = 0; i < sizeof(Reactor_IRQs) / sizeof(Reactor_IRQs[0]); i++)
+    {
+        if (Reactor_IRQ_Enabled(Reactor_IRQs[i]))
+        {
+            Reactor_Suspended_IRQs |= 1 << i;
+            NVIC_DisableIRQ(Reactor_IRQs[i]);
+        }
+    }
+    TIMER_A1->CTL &= ~TIMER_A_CTL_MC_MASK;
+}
+
+void Reactor_Resume()
+{
+    if (Reactor_Buttons_Enabled)
+    {
+        Reactor_Arm_Buttons();
+    }
+    if (Reactor_Suspended_IRQs & 1)
+    {
+        TIMER_A1->CTL |= TIMER_A_CTL_MC__CONTINUOUS;
+    }
+    for (int i = 0; i < sizeof(Reactor_IRQs) / sizeof(Reactor_IRQs[0]); i++)
+    {
+        if (Reactor_Suspended_IRQs & (1 << i))
+        {
+            NVIC_EnableIRQ(Reactor_IRQs[i]);
+        }
+    }
+    Reactor_Suspended_IRQs = 0;
+}
+
+void Reactor_Enable_Buttons()
+{
+    Reactor_Buttons_Enabled = 1;
+    Reactor_Arm_Buttons();
+    NVIC_ClearPendingIRQ(PORT1_IRQn);
+    Reactor_Enable_IRQ(PORT1_IRQn, IRQ_PRIORITY_PORT1);
+}
+
+void Reactor_Enable_UART_RX()
+{
+    EUSCI_A0->IE |= EUSCI_A_IE_RXIE;
+    Reactor_Enable_IRQ(EUSCIA0_IRQn, IRQ_PRIORITY_EUSCIA0);
+}
+
+void Reactor_Run()
+{
+    while(1)
+    {
+        uint32_t tail = Reactor_Tail;
+
+        if (tail != Reactor_Head)
+        {
+            uint32_t event = Reactor_Queue[tail & (REACTOR_QUEUE_SIZE - 1)];
+            uint32_t type = event >> REACTOR_TYPE_SHIFT;
+            Reactor_Handler handler = Reactor_Handlers[type];
+
+            Reactor_Tail = tail + 1;
+            Reactor_Events[type]++;
+            if (handler)
+            {
+                uint32_t start = DWT->CYCCNT;
+                handler(event & REACTOR_ARGUMENT_MASK);
+                uint32_t cycles = DWT->CYCCNT - start;
+                if (cycles > Reactor_Max_Handler_Cycles[type])
+                {
+                    Reactor_Max_Handler_Cycles[type] = cycles;
+                }
+            }
+            continue;
+        }
+
+        // An interrupt between the check and WFI would not wake the CPU, so check with interrupts disabled.
+        // WFI still wakes up on a pending interrupt, which is taken when the interrupts are enabled again.
+        uint32_t primask = _disable_interrupts();
+        if (Reactor_Tail == Reactor_Head)
+        {
+            Reactor_Sleep();
+        }
+        _restore_interrupts(primask);
+    }
+}
+
+void Reactor_Get_Stats(Reactor_Stats *stats)
+{
+    for (int type = 0; type < REACTOR_NUM_EVENTS; type++)
+    {
+        stats->events[type] = Reactor_Events[type];
+        stats->max_handler_cycles[type] = Reactor_Max_Handler_Cycles[type];
+    }
+    stats->dropped = Reactor_Dropped;
+    stats->max_depth = Reactor_Max_Depth;
+    stats->sleeps = Reactor_Sleeps;
+    stats->total_ticks = Reactor_Time() - Reactor_Start_Ticks;
+    stats->sleep_ticks = Reactor_Sleep_Ticks;
+}
+
+void Reactor_Dump()
+{
+    Reactor_Stats stats;
+
+    Reactor_Get_Stats(&stats);
+
+    uint32_t busy_permille = (stats.total_ticks != 0)
+                           ? (uint32_t)(((stats.total_ticks - stats.sleep_ticks) * 1000) / stats.total_ticks)
+                           : 0;
+
+    EUSCI_A0_UART_OutString("Reactor: cpu ");
+    EUSCI_A0_UART_OutUDec(busy_permille);
+    EUSCI_A0_UART_OutString(" per mille, ");
+    EUSCI_A0_UART_OutUDec(stats.sleeps);
+    EUSCI_A0_UART_OutString(" sleeps, ");
+    EUSCI_A0_UART_OutUDec(stats.dropped);
+    EUSCI_A0_UART_OutString(" dropped, max depth ");
+    EUSCI_A0_UART_OutUDec(stats.max_depth);
+    EUSCI_A0_UART_OutString("\r\n");
+
+    for (int type = 0; type < REACTOR_NUM_EVENTS; type++)
+    {
+        EUSCI_A0_UART_OutString((char *)Reactor_Event_Names[type]);
+        EUSCI_A0_UART_OutString(": ");
+        EUSCI_A0_UART_OutUDec(stats.events[type]);
+        EUSCI_A0_UART_OutString(" events, max ");
+        EUSCI_A0_UART_OutUDec(stats.max_handler_cycles[type]);
+        EUSCI_A0_UART_OutString(" cycles\r\n");
+    }
+}
+
+void TA1_N_IRQHandler(void)
+{
+    IRQ_Priority_Entry(IRQ_PRIORITY_TA1_N);
+    uint32_t start = Deferred_Work_Top_Half_Begin();
+    uint32_t vector;
+
+    // Reading IV clears the flag of the highest-priority pending source
+    while ((vector = TIMER_A1->IV) != 0)
+    {
+        if (vector == REACTOR_TA1_IV_TAIFG)
+        {
+            Reactor_Overflows++;
+        }
+        else
+        {
+            // IV = 2 for CCR1, 4 for CCR2, ...
+            uint8_t timer = (vector >> 1) - 1;
+            if (timer < REACTOR_NUM_TIMERS)
+            {
+                TIMER_A1->CCTL[timer + 1] &= ~TIMER_A_CCTLN_CCIE;
+                Reactor_Post(REACTOR_EVENT_TIMER, timer);
+            }
+        }
+    }
+
+    Deferred_Work_Top_Half_End(DEFERRED_WORK_ISR_TA1_N, start);
+}
+
+void PORT1_IRQHandler(void)
+{
+    IRQ_Priority_Entry(IRQ_PRIORITY_PORT1);
+    uint32_t start = Deferred_Work_Top_Half_Begin();
+    uint8_t status = P1->IN & REACTOR_BUTTONS;
+
+    // An edge between the read of P1->IN and the write of IES is missed, but the debounce delay
+    // of the event handler reads the buttons again after the last edge that has been seen
+    P1->IES = (P1->IES & ~REACTOR_BUTTONS) | status;
+    P1->IFG &= ~REACTOR_BUTTONS;
+    Reactor_Post(REACTOR_EVENT_BUTTONS, status);
+
+    Deferred_Work_Top_Half_End(DEFERRED_WORK_ISR_PORT1, start);
+}
+
+void EUSCIA0_IRQHandler(void)
+{
+    IRQ_Priority_Entry(IRQ_PRIORITY_EUSCIA0);
+    uint32_t start = Deferred_Work_Top_Half_Begin();
+
+    if (EUSCI_A0->IFG & EUSCI_A_IFG_RXIFG)
+    {
+        // Read the receive errors like EUSCI_A0_UART_InChar, before RXBUF, since reading RXBUF clears them
+        // Reading RXBUF here clears RXIFG, so a burst does not overrun RXBUF while the event waits in the queue
+        uint16_t status = EUSCI_A0->STATW;
+        uint8_t letter = (uint8_t)EUSCI_A0->RXBUF;
+        if (status & 0x74)
+        {
+            Flight_Recorder_Log(FLIGHT_RECORDER_UART_ERROR, status, letter);
+            Perf_Counter_Increment(PERF_COUNTER_UART_ERRORS);
+        }
+        Perf_Counter_Increment(PERF_COUNTER_UART_BYTES_IN);
+
+        Reactor_Post(REACTOR_EVENT_UART_RX, letter);
+    }
+
+    Deferred_Work_Top_Half_End(DEFERRED_WORK_ISR_EUSCIA0, start);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file SRAM_Power.c
+ * @brief Source code for the SRAM_Power driver.
+ *
+ * This file contains the function definitions for the SRAM_Power driver.
+ *
+ * For more information regarding the SRAM bank registers, refer to the SYSCTL Registers section
+ * of the MSP432Pxx Microcontrollers Technical Reference Manual.
+ *
+ */
+
+#include "../inc/SRAM_Power.h"
+
+// Start address of SRAM in the data address space
+#define SRAM_POWER_BASE         0x20000000
+
+// SRAM ready flag in SYS_SRAM_BANKEN and SYS_SRAM_BANKRET
+#define SRAM_POWER_RDY          0x00010000
+
+// Section boundaries generated by the linker (see msp432p401r.cmd)
+extern uint32_t __persistent_run_end;
+extern uint32_t __data_run_end;
+extern uint32_t __bss_run_end;
+extern uint32_t __sysmem_run_end;
+extern uint32_t __noinit_run_start;
+extern uint32_t __noinit_run_end;
+extern uint32_t __perf_counters_run_end;
+extern uint32_t __STACK_END;
+
+static uint32_t SRAM_Power_Max(uint32_t a, uint32_t b)
+{
+    return (a > b) ? a : b;
+}
+
+static uint8_t SRAM_Power_Used_Banks()
+{
+    uint32_t used_bytes = SRAM_Power_Get_Used_Bytes();
+    uint32_t num_banks = (used_bytes + SRAM_POWER_BANK_SIZE - 1) / SRAM_POWER_BANK_SIZE;
+
+    if (num_banks == 0)
+    {
+        num_banks = 1;
+    }
+    if (num_banks > SRAM_POWER_NUM_BANKS)
+    {
+        num_banks = SRAM_POWER_NUM_BANKS;
+    }
+    return num_banks;
+}
+
+void SRAM_Power_Init()
+{
+    uint8_t bank_mask = (1 << SRAM_Power_Used_Banks()) - 1;
+
+    // Wait until the SRAM is ready before changing the bank configuration
+    while ((SYSCTL->SRAM_BANKEN & SRAM_POWER_RDY) == 0);
+
+    // Writing 0 to BNKx_EN disables bank x and all banks above it
+    SYSCTL->SRAM_BANKEN = bank_mask;
+    while ((SYSCTL->SRAM_BANKEN & SRAM_POWER_RDY) == 0);
+
+    // Retain every enabled bank by default
+    SRAM_Power_Set_LPM_Retention(bank_mask);
+}
+
+void SRAM_Power_Set_LPM_Retention(uint8_t bank_mask)
+{
+    // Only enabled banks can be retained, and bank 0 is always retained
+    bank_mask = (bank_mask & SRAM_Power_Get_Enabled_Banks()) | 0x01;
+
+    while ((SYSCTL->SRAM_BANKRET & SRAM_POWER_RDY) == 0);
+    SYSCTL->SRAM_BANKRET = bank_mask;
+    while ((SYSCTL->SRAM_BANKRET & SRAM_POWER_RDY) == 0);
+}
+
+uint8_t SRAM_Power_Get_Scratch_Banks()
+{
+    uint32_t noinit_start = (uint32_t)&__noinit_run_start - SRAM_POWER_BASE;
+    uint32_t noinit_end = (uint32_t)&__noinit_run_end - SRAM_POWER_BASE;
+    uint8_t bank_mask = 0;
+
+    for (int bank = 1; bank < SRAM_POWER_NUM_BANKS; bank++)
+    {
+        uint32_t bank_start = bank * SRAM_POWER_BANK_SIZE;
+        uint32_t bank_end = bank_start + SRAM_POWER_BANK_SIZE;
+        if ((bank_start >= noinit_start) && (bank_end <= noinit_end))
+        {
+            bank_mask |= (1 << bank);
+        }
+    }
+    return bank_mask;
+}
+
+uint32_t SRAM_Power_Get_Used_Bytes()
+{
+    uint32_t used_end = (uint32_t)&__persistent_run_end;
+
+    used_end = SRAM_Power_Max(used_end, (uint32_t)&__data_run_end);
+    used_end = SRAM_Power_Max(used_end, (uint32_t)&__bss_run_end);
+    used_end = SRAM_Power_Max(used_end, (uint32_t)&__sysmem_run_end);
+    used_end = SRAM_Power_Max(used_end, (uint32_t)&__noinit_run_end);
+    used_end = SRAM_Power_Max(used_end, (uint32_t)&__perf_counters_run_end);
+    used_end = SRAM_Power_Max(used_end, (uint32_t)&__STACK_END);
+
+    return used_end - SRAM_POWER_BASE;
+}
+
+uint8_t SRAM_Power_Get_Enabled_Banks()
+{
+    return SYSCTL->SRAM_BANKEN & 0xFF;
+}
+
+uint8_t SRAM_Power_Get_Retained_Banks()
+{
+    return SYSCTL->SRAM_BANKRET & 0xFF;
+}
@@ -0,0 +1,204 @@
+/**
+ * @file Scheduler.c
+ * @brief Source code for the Scheduler module.
+ *
+ * This file contains the function definitions for the Scheduler module.
+ *
+ * Scheduler_Order holds the indexes of the tasks sorted by period (rate-monotonic priority), and
+ * Scheduler_Next_Release the tick of the next release of each task, so a tick only compares one number per task.
+ *
+ */
+
+#include "../inc/Scheduler.h"
+#include "../inc/Clock.h"
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/Flight_Recorder.h"
+#include "../inc/Reactor.h"
+#include "../inc/UART_Command.h"
+
+static const Scheduler_Task *Scheduler_Tasks;
+static uint8_t Scheduler_Count;
+static uint8_t Scheduler_Order[SCHEDULER_MAX_TASKS];
+static uint32_t Scheduler_Next_Release[SCHEDULER_MAX_TASKS];
+static Scheduler_Task_Stats Scheduler_Stats[SCHEDULER_MAX_TASKS];
+
+static uint8_t Scheduler_Timer;
+static uint32_t Scheduler_Tick_ms;
+static uint32_t Scheduler_Tick_Cycles;
+static uint32_t Scheduler_Cycles_Per_us;
+static uint32_t Scheduler_Ticks;
+static uint32_t Scheduler_Stats_Ticks;
+static uint32_t Scheduler_Late_Ticks;
+
+static void Scheduler_Tick(uint32_t timer)
+{
+    if (timer != Scheduler_Timer)
+    {
+        return;
+    }
+
+    // Continue from the previous expiry first, so the tick period does not include the tasks
+    Reactor_Timer_Continue(Scheduler_Timer, Scheduler_Tick_ms);
+
+    uint32_t tick = Scheduler_Ticks;
+    uint32_t tick_start = DWT->CYCCNT;
+
+    for (int i = 0; i < Scheduler_Count; i++)
+    {
+        uint8_t task = Scheduler_Order[i];
+
+        if (tick != Scheduler_Next_Release[task])
+        {
+            continue;
+        }
+        Scheduler_Next_Release[task] = tick + Scheduler_Tasks[task].period;
+
+        uint32_t start = DWT->CYCCNT;
+        Scheduler_Tasks[task].function();
+        uint32_t end = DWT->CYCCNT;
+
+        Scheduler_Task_Stats *stats = &Scheduler_Stats[task];
+        uint32_t cycles = end - start;
+        uint32_t response = end - tick_start;
+
+        stats->runs++;
+        stats->total_cycles += cycles;
+        if (cycles > stats->max_cycles)
+        {
+            stats->max_cycles = cycles;
+        }
+        if (response > stats->max_response_cycles)
+        {
+            stats->max_response_cycles = response;
+        }
+
+        // The deadline of a run is the next release of the task
+        if (response > Scheduler_Tasks[task].period * Scheduler_Tick_Cycles)
+        {
+            stats->overruns++;
+            uint32_t response_us = response / Scheduler_Cycles_Per_us;
+            Flight_Recorder_Log(FLIGHT_RECORDER_TASK_OVERRUN, task, (response_us > 0xFFFF) ? 0xFFFF : response_us);
+        }
+    }
+
+    if ((DWT->CYCCNT - tick_start) > Scheduler_Tick_Cycles)
+    {
+        Scheduler_Late_Ticks++;
+    }
+    Scheduler_Ticks = tick + 1;
+    Scheduler_Stats_Ticks++;
+}
+
+uint8_t Scheduler_Init(const Scheduler_Task *tasks, uint8_t count, uint8_t timer, uint32_t tick_ms)
+{
+    if ((count == 0) || (count > SCHEDULER_MAX_TASKS) || (timer >= REACTOR_NUM_TIMERS)
+        || (tick_ms == 0) || (tick_ms > REACTOR_TIMER_MAX_MS))
+    {
+        return 1;
+    }
+
+    for (int task = 0; task < count; task++)
+    {
+        if ((tasks[task].function == 0) || (tasks[task].period == 0) || (tasks[task].offset >= tasks[task].period))
+        {
+            return 1;
+        }
+    }
+
+    // Insertion sort by period; tasks with equal periods keep the order of the table
+    for (int i = 0; i < count; i++)
+    {
+        int j = i;
+        while ((j > 0) && (tasks[Scheduler_Order[j - 1]].period > tasks[i].period))
+        {
+            Scheduler_Order[j] = Scheduler_Order[j - 1];
+            j--;
+        }
+        Scheduler_Order[j] = i;
+    }
+
+    Scheduler_Tasks = tasks;
+    Scheduler_Count = count;
+    Scheduler_Timer = timer;
+    Scheduler_Tick_ms = tick_ms;
+    Scheduler_Tick_Cycles = (Clock_GetFreq() / 1000) * tick_ms;
+    Scheduler_Cycles_Per_us = Clock_GetFreq() / 1000000;
+    Scheduler_Ticks = 0;
+    for (int task = 0; task < count; task++)
+    {
+        Scheduler_Next_Release[task] = tasks[task].offset;
+    }
+    Scheduler_Reset();
+
+    UART_Command_Register('x', Scheduler_Dump);
+    UART_Command_Register('X', Scheduler_Reset);
+    return 0;
+}
+
+void Scheduler_Run()
+{
+    Reactor_Register(REACTOR_EVENT_TIMER, Scheduler_Tick);
+    Reactor_Timer_Start(Scheduler_Timer, Scheduler_Tick_ms);
+    Reactor_Run();
+}
+
+uint32_t Scheduler_Get_Ticks()
+{
+    return Scheduler_Ticks;
+}
+
+void Scheduler_Get_Task_Stats(uint8_t task, Scheduler_Task_Stats *stats)
+{
+    if (task < Scheduler_Count)
+    {
+        *stats = Scheduler_Stats[task];
+    }
+}
+
+void Scheduler_Reset()
+{
+    for (int task = 0; task < SCHEDULER_MAX_TASKS; task++)
+    {
+        Scheduler_Stats[task] = (Scheduler_Task_Stats){0};
+    }
+    Scheduler_Stats_Ticks = 0;
+    Scheduler_Late_Ticks = 0;
+}
+
+void Scheduler_Dump()
+{
+    uint64_t elapsed_cycles = (uint64_t)Scheduler_Stats_Ticks * Scheduler_Tick_Cycles;
+
+    EUSCI_A0_UART_OutString("Scheduler: tick ");
+    EUSCI_A0_UART_OutUDec(Scheduler_Tick_ms);
+    EUSCI_A0_UART_OutString(" ms, ");
+    EUSCI_A0_UART_OutUDec(Scheduler_Stats_Ticks);
+    EUSCI_A0_UART_OutString(" ticks, ");
+    EUSCI_A0_UART_OutUDec(Scheduler_Late_Ticks);
+    EUSCI_A0_UART_OutString(" late\r\n");
+
+    for (int i = 0; i < Scheduler_Count; i++)
+    {
+        uint8_t task = Scheduler_Order[i];
+        const Scheduler_Task_Stats *stats = &Scheduler_Stats[task];
+
+        EUSCI_A0_UART_OutString((char *)Scheduler_Tasks[task].name);
+        EUSCI_A0_UART_OutString(": period ");
+        EUSCI_A0_UART_OutUDec(Scheduler_Tasks[task].period);
+        EUSCI_A0_UART_OutString(" offset ");
+        EUSCI_A0_UART_OutUDec(Scheduler_Tasks[task].offset);
+        EUSCI_A0_UART_OutString(", ");
+        EUSCI_A0_UART_OutUDec(stats->runs);
+        EUSCI_A0_UART_OutString(" runs, average ");
+        EUSCI_A0_UART_OutUDec(stats->runs ? (uint32_t)(stats->total_cycles / stats->runs) : 0);
+        EUSCI_A0_UART_OutString(" max ");
+        EUSCI_A0_UART_OutUDec(stats->max_cycles);
+        EUSCI_A0_UART_OutString(" response ");
+        EUSCI_A0_UART_OutUDec(stats->max_response_cycles);
+        EUSCI_A0_UART_OutString(" cycles, ");
+        EUSCI_A0_UART_OutUDec(stats->overruns);
+        EUSCI_A0_UART_OutString(" overruns, cpu ");
+        EUSCI_A0_UART_OutUDec(elapsed_cycles ? (uint32_t)((stats->total_cycles * 1000) / elapsed_cycles) : 0);
+        EUSCI_A0_UART_OutString(" per mille\r\n");
+    }
+}
@@ -0,0 +1,62 @@
+/**
+ * @file UART_Command.c
+ * @brief Source code for the UART_Command module.
+ *
+ * This file contains the function definitions for the UART_Command module.
+ *
+ */
+
+#include "../inc/UART_Command.h"
+#include "../inc/EUSCI_A0_UART.h"
+
+typedef struct
+{
+    char command;
+    void (*handler)(void);
+} UART_Command_Entry;
+
+static UART_Command_Entry UART_Command_Table[UART_COMMAND_MAX];
+static uint32_t UART_Command_Count;
+
+uint8_t UART_Command_Register(char command, void (*handler)(void))
+{
+    for (uint32_t i = 0; i < UART_Command_Count; i++)
+    {
+        if (UART_Command_Table[i].command == command)
+        {
+            UART_Command_Table[i].handler = handler;
+            return 0;
+        }
+    }
+
+    if (UART_Command_Count >= UART_COMMAND_MAX)
+    {
+        return 1;
+    }
+    UART_Command_Table[UART_Command_Count].command = command;
+    UART_Command_Table[UART_Command_Count].handler = handler;
+    UART_Command_Count++;
+    return 0;
+}
+
+void UART_Command_Poll()
+{
+    if ((EUSCI_A0->IFG & 0x01) == 0)
+    {
+        return;
+    }
+
+    UART_Command_Execute(EUSCI_A0_UART_InChar());
+}
+
+void UART_Command_Execute(char command)
+{
+    for (uint32_t i = 0; i < UART_Command_Count; i++)
+    {
+        if (UART_Command_Table[i].command == command)
+        {
+            UART_Command_Table[i].handler();
+            return;
+        }
+    }
+}
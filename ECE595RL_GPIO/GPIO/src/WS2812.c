@@ -0,0 +1,329 @@
+/**
+ * @file WS2812.c
+ * @brief Source code for the WS2812 driver.
+ *
+ * This file contains the function definitions for the WS2812 driver.
+ *
+ * WS2812_Show encodes the pixels into the back frame in thread mode, and the DMA_INT1 handler only sets the
+ * structures of the channel with the chunks of the front frame, which is already encoded. The transmission state
+ * (WS2812_Front, WS2812_Next, WS2812_Armed, WS2812_Queued) is changed by the DMA_INT1 handler, and by WS2812_Show
+ * with the interrupt masked.
+ *
+ */
+
+#include "../inc/WS2812.h"
+#include "../inc/Clock.h"
+#include "../inc/Critical_Section.h"
+#include "../inc/DMA.h"
+#include "../inc/Deferred_Work.h"
+#include "../inc/EUSCI_A0_UART.h"
+#include "../inc/IRQ_Priority.h"
+#include "../inc/Reactor.h"
+#include "../inc/UART_Command.h"
+
+#ifdef WS2812_ENABLE
+
+// Strip lengths of the frame rate table of WS2812_Dump
+#define WS2812_DUMP_LENGTHS     6
+
+// SPI byte of two data bits, most significant bit first: 1000 for a 0, 1100 for a 1
+static const uint8_t WS2812_Code[4] = {0x88, 0x8C, 0xC8, 0xCC};
+
+// Pixels in GRB order, the order in which the strip receives the colors
+#pragma DATA_SECTION(WS2812_Pixels, ".noinit")
+static uint8_t WS2812_Pixels[WS2812_MAX_PIXELS * 3];
+
+// Encoded frames: the zero bytes of the low level, written once by WS2812_Init, followed by the pixels
+#pragma DATA_SECTION(WS2812_Frames, ".noinit")
+static uint8_t WS2812_Frames[2][WS2812_MAX_FRAME_BYTES];
+
+static uint16_t WS2812_Length;
+static uint32_t WS2812_Frame_Bytes;
+static uint8_t WS2812_Back;                 // Frame encoded by WS2812_Show
+static volatile uint8_t WS2812_Queued;      // The back frame waits for the end of the front frame
+
+static const uint8_t *WS2812_Front;
+static uint32_t WS2812_Next;                // Next byte of the front frame to set in a structure
+static volatile uint8_t WS2812_Armed;       // Structures set and not completed yet
+static uint8_t WS2812_Completed_Alternate;  // Structure whose completion is handled next
+
+static WS2812_Stats WS2812_Statistics;
+static volatile uint32_t WS2812_Driver_Cycles;
+static uint32_t WS2812_Update_Cycles;
+static uint32_t WS2812_Update_Frames;
+static uint32_t WS2812_Update_Driver_Cycles;
+
+// Sets a structure with the next chunk of the front frame; the chunk that ends the frame stops the channel
+static void WS2812_Arm(uint8_t alternate)
+{
+    uint32_t count = WS2812_Frame_Bytes - WS2812_Next;
+
+    if (count == 0)
+    {
+        return;
+    }
+    if (count > DMA_MAX_TRANSFER)
+    {
+        count = DMA_MAX_TRANSFER;
+    }
+
+    DMA_Set_To_Peripheral(DMA_CHANNEL_WS2812, alternate, WS2812_Front + WS2812_Next, &EUSCI_A3->TXBUF, count,
+                          (WS2812_Next + count) < WS2812_Frame_Bytes);
+    WS2812_Next += count;
+    WS2812_Armed++;
+}
+
+static void WS2812_Start_Frame()
+{
+    WS2812_Next = 0;
+    WS2812_Armed = 0;
+    WS2812_Completed_Alternate = 0;
+
+    DMA_Stop(DMA_CHANNEL_WS2812);
+
+    // Clear a completion of the stopped frame that may have been raised after the handler cleared the flag, so
+    // that it is not taken as a completion of the new frame
+    DMA_Clear_Interrupt(DMA_CHANNEL_WS2812);
+    NVIC_ClearPendingIRQ(DMA_INT1_IRQn);
+
+    WS2812_Arm(0);
+    WS2812_Arm(1);
+
+    // Clear TXIFG before the channel is enabled and set it again after, so that the first request is raised
+    // whether the trigger is sensitive to the level or to the edge of the flag
+    EUSCI_A3->IFG &= ~EUSCI_A_IFG_TXIFG;
+    DMA_Enable(DMA_CHANNEL_WS2812, DMA_SOURCE_WS2812);
+    EUSCI_A3->IFG |= EUSCI_A_IFG_TXIFG;
+}
+
+// Makes the back frame the front frame and starts it
+static void WS2812_Start_Queued()
+{
+    WS2812_Front = WS2812_Frames[WS2812_Back];
+    WS2812_Back ^= 1;
+    WS2812_Queued = 0;
+    WS2812_Start_Frame();
+}
+
+uint8_t WS2812_Init(uint16_t length)
+{
+    if ((length == 0) || (length > WS2812_MAX_PIXELS))
+    {
+        return 1;
+    }
+
+    WS2812_Length = length;
+    WS2812_Frame_Bytes = WS2812_RESET_BYTES + (uint32_t)length * WS2812_PIXEL_BYTES;
+    for (uint32_t i = 0; i < (uint32_t)length * 3; i++)
+    {
+        WS2812_Pixels[i] = 0;
+    }
+    for (uint32_t i = 0; i < WS2812_RESET_BYTES; i++)
+    {
+        WS2812_Frames[0][i] = 0;
+        WS2812_Frames[1][i] = 0;
+    }
+    WS2812_Back = 0;
+    WS2812_Queued = 0;
+    WS2812_Front = WS2812_Frames[1];
+    WS2812_Armed = 0;
+
+    // Hold EUSCI_A3 in reset, SPI master, 3-pin mode, MSB first, clocked by SMCLK
+    EUSCI_A3->CTLW0 = EUSCI_A_CTLW0_SWRST;
+    EUSCI_A3->CTLW0 = EUSCI_A_CTLW0_SWRST | EUSCI_A_CTLW0_MSB | EUSCI_A_CTLW0_MST | EUSCI_A_CTLW0_SYNC
+                    | EUSCI_A_CTLW0_SSEL__SMCLK;
+
+    // Set the bit rate
+    // N = (Clock Frequency) / (Bit Rate) = (12,000,000 / 3,000,000) = 4
+    EUSCI_A3->BRW = 12000000 / WS2812_SPI_HZ;
+
+    // P9.7 as UCA3SIMO; the clock pin is not used
+    P9->SEL0 |= 0x80;
+    P9->SEL1 &= ~0x80;
+
+    EUSCI_A3->CTLW0 &= ~EUSCI_A_CTLW0_SWRST;
+    EUSCI_A3->IE = 0;
+
+    DMA_Stop(DMA_CHANNEL_WS2812);
+    DMA_Enable_Interrupt(DMA_CHANNEL_WS2812);
+    IRQ_Priority_Apply(IRQ_PRIORITY_DMA_INT1);
+    NVIC_ClearPendingIRQ(DMA_INT1_IRQn);
+    NVIC_EnableIRQ(DMA_INT1_IRQn);
+
+    WS2812_Reset();
+
+    UART_Command_Register('g', WS2812_Dump);
+    UART_Command_Register('G', WS2812_Reset);
+    return 0;
+}
+
+void WS2812_Set_Pixel(uint16_t index, uint8_t red, uint8_t green, uint8_t blue)
+{
+    if (index >= WS2812_Length)
+    {
+        return;
+    }
+
+    uint8_t *pixel = &WS2812_Pixels[index * 3];
+    pixel[0] = green;
+    pixel[1] = red;
+    pixel[2] = blue;
+}
+
+uint8_t WS2812_Show()
+{
+    if (WS2812_Queued)
+    {
+        WS2812_Statistics.dropped++;
+        return 1;
+    }
+
+    // The back frame is not transmitted while no frame is queued, so it is encoded without masking DMA_INT1
+    uint32_t start = DWT->CYCCNT;
+    uint8_t *frame = &WS2812_Frames[WS2812_Back][WS2812_RESET_BYTES];
+
+    for (uint32_t i = 0; i < (uint32_t)WS2812_Length * 3; i++)
+    {
+        uint8_t value = WS2812_Pixels[i];
+
+        *frame++ = WS2812_Code[value >> 6];
+        *frame++ = WS2812_Code[(value >> 4) & 0x03];
+        *frame++ = WS2812_Code[(value >> 2) & 0x03];
+        *frame++ = WS2812_Code[value & 0x03];
+    }
+
+    uint32_t cycles = DWT->CYCCNT - start;
+    if (cycles > WS2812_Statistics.max_encode_cycles)
+    {
+        WS2812_Statistics.max_encode_cycles = cycles;
+    }
+
+    uint32_t state = Critical_Section_Enter(IRQ_PRIORITY_LEVEL_EVENTS);
+    WS2812_Driver_Cycles += cycles;
+    WS2812_Queued = 1;
+    if (WS2812_Armed == 0)
+    {
+        WS2812_Start_Queued();
+    }
+    Critical_Section_Exit(state);
+    return 0;
+}
+
+uint8_t WS2812_Is_Ready()
+{
+    return !WS2812_Queued;
+}
+
+uint32_t WS2812_Get_Frame_us(uint16_t length)
+{
+    uint32_t bytes = WS2812_RESET_BYTES + (uint32_t)length * WS2812_PIXEL_BYTES;
+
+    return (bytes * 8 * 1000) / (WS2812_SPI_HZ / 1000);
+}
+
+void WS2812_Update()
+{
+    uint32_t now = DWT->CYCCNT;
+    uint32_t elapsed = now - WS2812_Update_Cycles;
+    uint32_t frames = WS2812_Statistics.frames;
+    uint32_t driver_cycles = WS2812_Driver_Cycles;
+
+    if (elapsed != 0)
+    {
+        WS2812_Statistics.fps = (uint32_t)(((uint64_t)(frames - WS2812_Update_Frames) * Clock_GetFreq()) / elapsed);
+        WS2812_Statistics.cpu_per_mille = (uint32_t)(((uint64_t)(driver_cycles - WS2812_Update_Driver_Cycles) * 1000)
+                                                     / elapsed);
+    }
+    WS2812_Update_Cycles = now;
+    WS2812_Update_Frames = frames;
+    WS2812_Update_Driver_Cycles = driver_cycles;
+}
+
+void WS2812_Get_Stats(WS2812_Stats *stats)
+{
+    *stats = WS2812_Statistics;
+}
+
+void WS2812_Reset()
+{
+    WS2812_Statistics = (WS2812_Stats){0};
+    WS2812_Update_Cycles = DWT->CYCCNT;
+    WS2812_Update_Frames = 0;
+    WS2812_Update_Driver_Cycles = WS2812_Driver_Cycles;
+}
+
+void WS2812_Dump()
+{
+    static const uint16_t lengths[WS2812_DUMP_LENGTHS] = {60, 144, 300, 500, 511, 600};
+    uint32_t frame_us = WS2812_Get_Frame_us(WS2812_Length);
+
+    EUSCI_A0_UART_OutString("WS2812: ");
+    EUSCI_A0_UART_OutUDec(WS2812_Length);
+    EUSCI_A0_UART_OutString(" pixels, frame ");
+    EUSCI_A0_UART_OutUDec(frame_us);
+    EUSCI_A0_UART_OutString(" us (");
+    EUSCI_A0_UART_OutUDec(1000000 / frame_us);
+    EUSCI_A0_UART_OutString(" fps max), ");
+    EUSCI_A0_UART_OutUDec(WS2812_Statistics.frames);
+    EUSCI_A0_UART_OutString(" frames, ");
+    EUSCI_A0_UART_OutUDec(WS2812_Statistics.fps);
+    EUSCI_A0_UART_OutString(" fps achieved, CPU ");
+    EUSCI_A0_UART_OutUDec(WS2812_Statistics.cpu_per_mille);
+    EUSCI_A0_UART_OutString(" per mille (encoding max ");
+    EUSCI_A0_UART_OutUDec(WS2812_Statistics.max_encode_cycles);
+    EUSCI_A0_UART_OutString(" cycles), ");
+    EUSCI_A0_UART_OutUDec(WS2812_Statistics.underruns);
+    EUSCI_A0_UART_OutString(" underruns, ");
+    EUSCI_A0_UART_OutUDec(WS2812_Statistics.dropped);
+    EUSCI_A0_UART_OutString(" dropped\r\n");
+
+    EUSCI_A0_UART_OutString("Highest frame rate (computed):");
+    for (int i = 0; i < WS2812_DUMP_LENGTHS; i++)
+    {
+        EUSCI_A0_UART_OutString((i == 0) ? " " : ", ");
+        EUSCI_A0_UART_OutUDec(lengths[i]);
+        EUSCI_A0_UART_OutString(" pixels ");
+        EUSCI_A0_UART_OutUDec(1000000 / WS2812_Get_Frame_us(lengths[i]));
+        EUSCI_A0_UART_OutString(" fps");
+    }
+    EUSCI_A0_UART_OutString("\r\n");
+}
+
+void DMA_INT1_IRQHandler(void)
+{
+    uint32_t start = Deferred_Work_Top_Half_Begin();
+
+    DMA_Clear_Interrupt(DMA_CHANNEL_WS2812);
+    if (WS2812_Armed != 0)
+    {
+        uint8_t alternate = WS2812_Completed_Alternate;
+        WS2812_Completed_Alternate ^= 1;
+        WS2812_Armed--;
+
+        if (WS2812_Next != WS2812_Frame_Bytes)
+        {
+            WS2812_Arm(alternate);
+
+            // The other structure completed before this one was set again, so the channel has stopped
+            if (!DMA_Is_Busy(DMA_CHANNEL_WS2812))
+            {
+                WS2812_Statistics.underruns++;
+                WS2812_Start_Frame();
+            }
+        }
+        else if (WS2812_Armed == 0)
+        {
+            WS2812_Statistics.frames++;
+            Reactor_Post(REACTOR_EVENT_DMA_DONE, DMA_CHANNEL_WS2812);
+            if (WS2812_Queued)
+            {
+                WS2812_Start_Queued();
+            }
+        }
+    }
+
+    WS2812_Driver_Cycles += DWT->CYCCNT - start;
+    Deferred_Work_Top_Half_End(DEFERRED_WORK_ISR_DMA_INT1, start);
+}
+
+#endif /* WS2812_ENABLE */
@@ -0,0 +1,573 @@
+/**
+ * @file bench.cpp
+ * @brief Host microbenchmarks of the driver kernels.
+ *
+ * This program measures the hot paths of the unchanged driver sources on the simulated MSP432P401R
+ * (see inc/Sim.h) and writes the results as JSON, so that two commits can be compared with
+ * tools/bench_compare.py:
+ *
+ *   git checkout <base> && make gpio_bench && ./gpio_bench -o base.json
+ *   git checkout <head> && make gpio_bench && ./gpio_bench -o head.json
+ *   python3 ../tools/bench_compare.py base.json head.json
+ *
+ * Each benchmark reports two kinds of results:
+ *  - Host time per item: every sample runs a batch of calls calibrated to last at least the minimum batch
+ *    time (-m), after one warm-up batch. The JSON lists the minimum, median, mean, standard deviation, median
+ *    absolute deviation and the 95% confidence interval of the median (order statistics, no assumption on the
+ *    distribution), and the number of samples further than 3 scaled MADs from the median. Host time includes
+ *    the cost of the simulated registers, so it is only comparable between runs on the same machine.
+ *  - Virtual cycles and register accesses per item: counted by the Sim module over one cycle of the inputs
+ *    of the benchmark, without the cycles of the delay loops. They are deterministic and do not depend on the machine, so any change is caused by
+ *    the code.
+ *
+ * The UART kernels run with EUSCI_A0 set to the fastest baud rate (BRW = 1), so that waiting for TXIFG adds a
+ * few polls per character instead of the 4160 cycles of a character at 115200 baud. The host build defines
+ * PORT_TRACE_ENABLE, so the port writes include the cost of Port_Trace_Log.
+ *
+ * The output of each kernel is checked before it is measured; the program exits with status 1 if a check
+ * fails.
+ *
+ * Usage: gpio_bench [options]
+ *  -o <file>                 Write the JSON results to a file (default: standard output)
+ *  -n <samples>              Number of samples per benchmark (default 31)
+ *  -m <ms>                   Minimum duration of a sample (default 5 ms)
+ *  -f <text>                 Run only the benchmarks whose name contains text
+ *  -r <revision>             Revision recorded in the results (for example the output of git describe)
+ *  -l                        List the benchmarks and exit
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "inc/Fleet.h"
+#include "inc/Sim.h"
+#include "../GPIO/inc/Clock.h"
+#include "../GPIO/inc/EUSCI_A0_UART.h"
+#include "../GPIO/inc/Flight_Recorder.h"
+#include "../GPIO/inc/GPIO.h"
+#include "../GPIO/inc/LED_Energy.h"
+#include "../GPIO/inc/Perf_Counter.h"
+#include "../GPIO/inc/Port_Trace.h"
+
+#define BENCH_FLEET_BOARDS      4096
+
+typedef struct
+{
+    const char *name;
+    const char *unit;                   // What one item is
+    uint32_t items;                     // Items per call
+    uint32_t cycle;                     // Number of calls after which the inputs repeat
+    void (*setup)();                    // Called before each batch, not timed (or 0)
+    void (*run)(uint32_t call);         // One call; call selects the inputs
+    const char *(*check)();             // Returns 0 if the kernel is correct, or a description of the error
+} Benchmark;
+
+typedef struct
+{
+    double min;
+    double median;
+    double mean;
+    double stddev;
+    double mad;
+    double ci95_low;
+    double ci95_high;
+    uint32_t outliers;
+} Bench_Summary;
+
+static std::string UART_Output;
+static Fleet Bench_Fleet;
+
+static void Capture_UART(uint64_t cycles, uint8_t data)
+{
+    UART_Output.push_back((char)data);
+}
+
+static uint64_t Now_ns()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+/******************************************************************************
+* Benchmarks
+******************************************************************************/
+
+static const uint32_t UDec_Values[] = { 0, 7, 65535, 4294967295u };
+static const char * const UDec_Text = "0765535" "4294967295";
+static const uint32_t UHex_Values[] = { 0, 0xBEEF, 0xDEADBEEF, 0xFFFFFFFF };
+static const char * const UHex_Text = "0BEEFDEADBEEFFFFFFFFF";
+static const char Write_Text[] = "Pattern 3\nstep 255\n\nend";
+static const char * const Write_Expected = "Pattern 3\r\nstep 255\r\n\r\nend";
+
+// Button inputs of LED_Pattern_1 without the 2 s delays of the "both pressed" case
+static const uint8_t Pattern_1_Buttons[] = { 0x12, 0x10, 0x02 };
+
+// Every case of LED_Controller, including the default one
+static const uint8_t Dispatch_Switches[] = { 0x00, 0x01, 0x02, 0x04, 0x08, 0x03 };
+
+static void Drive_Switches(uint8_t switches)
+{
+    Sim_Schedule_Input(Sim_Get_Cycles(), 10, 0x0F, switches);
+    Sim_Advance(0);
+}
+
+static void Setup_UART()
+{
+    UART_Output.clear();
+}
+
+static void Run_OutUDec(uint32_t call)
+{
+    EUSCI_A0_UART_OutUDec(UDec_Values[call % 4]);
+}
+
+static void Run_OutUHex(uint32_t call)
+{
+    EUSCI_A0_UART_OutUHex(UHex_Values[call % 4]);
+}
+
+static void Run_Write(uint32_t call)
+{
+    EUSCI_A0_UART_Write(0, Write_Text, sizeof(Write_Text) - 1);
+}
+
+static const char *Check_UART(void (*run)(uint32_t call), uint32_t calls, const char *expected)
+{
+    static std::string error;
+
+    UART_Output.clear();
+    for (uint32_t call = 0; call < calls; call++)
+    {
+        run(call);
+    }
+    if (UART_Output != expected)
+    {
+        error = "transmitted '" + UART_Output + "'";
+        return error.c_str();
+    }
+    return 0;
+}
+
+static const char *Check_OutUDec()
+{
+    return Check_UART(Run_OutUDec, 4, UDec_Text);
+}
+
+static const char *Check_OutUHex()
+{
+    return Check_UART(Run_OutUHex, 4, UHex_Text);
+}
+
+static const char *Check_Write()
+{
+    return Check_UART(Run_Write, 1, Write_Expected);
+}
+
+static void Setup_Switches_Off()
+{
+    Drive_Switches(0x00);
+}
+
+static void Run_Pattern_1(uint32_t call)
+{
+    LED_Controller(Pattern_1_Buttons[call % 3], 0x00);
+}
+
+static const char *Check_Pattern_1()
+{
+    Setup_Switches_Off();
+    LED_Controller(0x10, 0x00);
+    if ((LED_Get_Active_Pattern() != 1) || (PMOD_8LD_Status() != 0x55))
+    {
+        return "LED_Pattern_1 did not output 0x55 on PMOD 8LD for button 1";
+    }
+    return 0;
+}
+
+// The switch pins are off, so each pattern stops after its first step
+static void Run_Dispatch(uint32_t call)
+{
+    LED_Controller(0x12, Dispatch_Switches[call % 6]);
+}
+
+static const char *Check_Dispatch()
+{
+    static const uint8_t patterns[] = { 1, 2, 3, 4, 5, 1 };
+
+    Setup_Switches_Off();
+    for (uint32_t call = 0; call < 6; call++)
+    {
+        Run_Dispatch(call);
+        if (LED_Get_Active_Pattern() != patterns[call])
+        {
+            return "LED_Controller selected the wrong pattern";
+        }
+    }
+    return 0;
+}
+
+// The switch pins select the running pattern, so the pattern runs all its steps
+static void Setup_Pattern_2()
+{
+    Drive_Switches(0x01);
+}
+
+static void Run_Pattern_2(uint32_t call)
+{
+    LED_Controller(0x12, 0x01);
+}
+
+static const char *Check_Pattern_2()
+{
+    Setup_Pattern_2();
+    Run_Pattern_2(0);
+    return (PMOD_8LD_Status() == 0xFF) ? 0 : "LED_Pattern_2 did not count up to 0xFF";
+}
+
+static void Setup_Pattern_3()
+{
+    Drive_Switches(0x02);
+}
+
+static void Run_Pattern_3(uint32_t call)
+{
+    LED_Controller(0x12, 0x02);
+}
+
+static const char *Check_Pattern_3()
+{
+    Setup_Pattern_3();
+    Run_Pattern_3(0);
+    return (PMOD_8LD_Status() == 0x00) ? 0 : "LED_Pattern_3 did not count down to 0x00";
+}
+
+static void Setup_Pattern_5()
+{
+    Drive_Switches(0x08);
+}
+
+static void Run_Pattern_5(uint32_t call)
+{
+    LED_Controller(0x12, 0x08);
+}
+
+static const char *Check_Pattern_5()
+{
+    Setup_Pattern_5();
+    Run_Pattern_5(0);
+    return (PMOD_8LD_Status() == 0x80) ? 0 : "LED_Pattern_5 did not shift up to 0x80";
+}
+
+static void Run_Fleet_Step(uint32_t call)
+{
+    Fleet_Step(&Bench_Fleet, 0, Bench_Fleet.count);
+}
+
+static const char *Check_Fleet_Step()
+{
+    Fleet reference;
+    Fleet test;
+
+    // Fleet_Step must advance every board like Fleet_Step_Reference
+    Fleet_Init(&reference, 256, 1);
+    Fleet_Randomize_Inputs(&reference, 0, reference.count, 65536);
+    Fleet_Init(&test, 256, 1);
+    Fleet_Randomize_Inputs(&test, 0, test.count, 65536);
+    for (uint64_t tick = 0; tick < 1000; tick++)
+    {
+        Fleet_Step(&test, 0, test.count);
+        for (uint32_t board = 0; board < reference.count; board++)
+        {
+            Fleet_Step_Reference(&reference, board, tick, 0, 0);
+        }
+    }
+    uint8_t same = Fleet_Hash(&test, 0, test.count) == Fleet_Hash(&reference, 0, reference.count);
+    Fleet_Free(&test);
+    Fleet_Free(&reference);
+    return same ? 0 : "Fleet_Step differs from Fleet_Step_Reference";
+}
+
+static const Benchmark Benchmarks[] =
+{
+    { "uart_out_udec",              "call",         1,  4,  Setup_UART,         Run_OutUDec,    Check_OutUDec },
+    { "uart_out_uhex",              "call",         1,  4,  Setup_UART,         Run_OutUHex,    Check_OutUHex },
+    { "uart_write_newlines",        "call",         1,  1,  Setup_UART,         Run_Write,      Check_Write },
+    { "led_controller_pattern_1",   "call",         1,  3,  Setup_Switches_Off, Run_Pattern_1,  Check_Pattern_1 },
+    { "led_controller_dispatch",    "call",         1,  6,  Setup_Switches_Off, Run_Dispatch,   Check_Dispatch },
+    { "led_pattern_2_step",         "step",         256, 1, Setup_Pattern_2,    Run_Pattern_2,  Check_Pattern_2 },
+    { "led_pattern_3_step",         "step",         256, 1, Setup_Pattern_3,    Run_Pattern_3,  Check_Pattern_3 },
+    { "led_pattern_5_step",         "step",         8,  1,  Setup_Pattern_5,    Run_Pattern_5,  Check_Pattern_5 },
+    { "fleet_step",                 "board-tick",   BENCH_FLEET_BOARDS, 1, 0,   Run_Fleet_Step, Check_Fleet_Step },
+};
+
+#define BENCH_NUM_BENCHMARKS    (sizeof(Benchmarks) / sizeof(Benchmarks[0]))
+
+/******************************************************************************
+* Measurement
+******************************************************************************/
+
+static uint64_t Run_Batch(const Benchmark *benchmark, uint64_t calls)
+{
+    if (benchmark->setup)
+    {
+        benchmark->setup();
+    }
+    // Keep the port trace from filling up, which would make the later samples cheaper
+    Port_Trace_Reset();
+
+    uint64_t start = Now_ns();
+    for (uint64_t call = 0; call < calls; call++)
+    {
+        benchmark->run((uint32_t)call);
+    }
+    return Now_ns() - start;
+}
+
+static double Median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    size_t n = values.size();
+    return (n % 2) ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+static Bench_Summary Summarize(std::vector<double> samples)
+{
+    Bench_Summary summary;
+    size_t n = samples.size();
+    double sum = 0;
+    double squares = 0;
+
+    std::sort(samples.begin(), samples.end());
+    summary.min = samples[0];
+    summary.median = Median(samples);
+    for (size_t i = 0; i < n; i++)
+    {
+        sum += samples[i];
+    }
+    summary.mean = sum / n;
+    for (size_t i = 0; i < n; i++)
+    {
+        squares += (samples[i] - summary.mean) * (samples[i] - summary.mean);
+    }
+    summary.stddev = (n > 1) ? sqrt(squares / (n - 1)) : 0;
+
+    std::vector<double> deviations(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        deviations[i] = fabs(samples[i] - summary.median);
+    }
+    summary.mad = Median(deviations);
+
+    // The ranks n/2 -/+ 1.96 sqrt(n)/2 bound the median with a confidence of 95%
+    double half_width = 0.98 * sqrt((double)n);
+    long low = (long)floor(n / 2.0 - half_width);
+    long high = (long)ceil(n / 2.0 + half_width);
+    summary.ci95_low = samples[std::max(low, 0L)];
+    summary.ci95_high = samples[std::min(high, (long)n - 1)];
+
+    summary.outliers = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (deviations[i] > 3 * 1.4826 * summary.mad)
+        {
+            summary.outliers++;
+        }
+    }
+    return summary;
+}
+
+static void Print_Summary(FILE *file, const char *name, const Bench_Summary *summary)
+{
+    fprintf(file, "      \"%s\": {\"min\": %.3f, \"median\": %.3f, \"mean\": %.3f, \"stddev\": %.3f, \"mad\": %.3f, "
+                  "\"ci95_low\": %.3f, \"ci95_high\": %.3f, \"outliers\": %u},\n",
+            name, summary->min, summary->median, summary->mean, summary->stddev, summary->mad,
+            summary->ci95_low, summary->ci95_high, summary->outliers);
+}
+
+static void Print_String(FILE *file, const char *text)
+{
+    fputc('"', file);
+    for (; *text; text++)
+    {
+        if ((*text == '"') || (*text == '\\'))
+        {
+            fputc('\\', file);
+        }
+        fputc(((uint8_t)*text < 0x20) ? ' ' : *text, file);
+    }
+    fputc('"', file);
+}
+
+static void Init_Drivers()
+{
+    Sim_Reset();
+    Flight_Recorder_Init();
+    Perf_Counter_Init();
+    Clock_Init48MHz();
+    Port_Trace_Init();
+
+    LED1_Init();
+    LED2_Init();
+    Buttons_Init();
+    PMOD_8LD_Init();
+    PMOD_SWT_Init();
+
+    EUSCI_A0_UART_Init();
+    LED_Energy_Init();
+
+    // Fastest baud rate, see the file comment
+    EUSCI_A0->CTLW0 |= 1;
+    EUSCI_A0->BRW = 1;
+    EUSCI_A0->CTLW0 &= ~1;
+
+    Sim_Set_UART_Observer(Capture_UART);
+
+    Fleet_Init(&Bench_Fleet, BENCH_FLEET_BOARDS, 1);
+    Fleet_Randomize_Inputs(&Bench_Fleet, 0, Bench_Fleet.count, 65536);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *output_path = 0;
+    const char *filter = "";
+    const char *revision = "unknown";
+    uint32_t samples = 31;
+    double min_batch_ms = 5;
+    uint8_t failed = 0;
+    int option;
+
+    while ((option = getopt(argc, argv, "o:n:m:f:r:l")) != -1)
+    {
+        switch (option)
+        {
+            case 'o':
+                output_path = optarg;
+                break;
+            case 'n':
+                samples = strtoul(optarg, 0, 10);
+                break;
+            case 'm':
+                min_batch_ms = strtod(optarg, 0);
+                break;
+            case 'f':
+                filter = optarg;
+                break;
+            case 'r':
+                revision = optarg;
+                break;
+            case 'l':
+                for (size_t i = 0; i < BENCH_NUM_BENCHMARKS; i++)
+                {
+                    printf("%s\n", Benchmarks[i].name);
+                }
+                return 0;
+            default:
+                fprintf(stderr, "usage: %s [-o file] [-n samples] [-m ms] [-f text] [-r revision] [-l]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (samples < 3)
+    {
+        fprintf(stderr, "at least 3 samples are needed\n");
+        return 2;
+    }
+
+    FILE *file = output_path ? fopen(output_path, "w") : stdout;
+    if (file == 0)
+    {
+        perror(output_path);
+        return 1;
+    }
+
+    Init_Drivers();
+
+    fprintf(file, "{\n  \"schema\": 1,\n  \"revision\": ");
+    Print_String(file, revision);
+    fprintf(file, ",\n  \"compiler\": ");
+    Print_String(file, __VERSION__);
+    fprintf(file, ",\n  \"samples\": %u,\n  \"min_batch_ms\": %g,\n  \"benchmarks\": [", samples, min_batch_ms);
+
+    uint8_t first = 1;
+    for (size_t i = 0; i < BENCH_NUM_BENCHMARKS; i++)
+    {
+        const Benchmark *benchmark = &Benchmarks[i];
+
+        if (strstr(benchmark->name, filter) == 0)
+        {
+            continue;
+        }
+
+        const char *error = benchmark->check();
+        if (error)
+        {
+            fprintf(stderr, "%s: %s\n", benchmark->name, error);
+            failed = 1;
+        }
+
+        // Deterministic cost over one cycle of the inputs
+        Sim_Stats before;
+        Sim_Stats after;
+        if (benchmark->setup)
+        {
+            benchmark->setup();
+        }
+        Sim_Get_Stats(&before);
+        for (uint32_t call = 0; call < benchmark->cycle; call++)
+        {
+            benchmark->run(call);
+        }
+        Sim_Get_Stats(&after);
+        uint64_t accesses = 0;
+        for (int peripheral = 0; peripheral < SIM_NUM_PERIPHERALS; peripheral++)
+        {
+            accesses += (after.reads[peripheral] - before.reads[peripheral])
+                        + (after.writes[peripheral] - before.writes[peripheral]);
+        }
+        double items = (double)benchmark->cycle * benchmark->items;
+
+        // Calibrate the batch, whole cycles of the inputs, then discard one warm-up batch
+        uint64_t calls = benchmark->cycle;
+        while (Run_Batch(benchmark, calls) < min_batch_ms * 1e6)
+        {
+            calls *= 2;
+        }
+        Run_Batch(benchmark, calls);
+
+        std::vector<double> times;
+        for (uint32_t sample = 0; sample < samples; sample++)
+        {
+            times.push_back((double)Run_Batch(benchmark, calls) / ((double)calls * benchmark->items));
+        }
+        Bench_Summary summary = Summarize(times);
+
+        fprintf(file, "%s\n    {\n      \"name\": \"%s\",\n      \"unit\": \"%s\",\n      \"ok\": %s,\n",
+                first ? "" : ",", benchmark->name, benchmark->unit, error ? "false" : "true");
+        fprintf(file, "      \"items_per_sample\": %llu,\n", (unsigned long long)(calls * benchmark->items));
+        Print_Summary(file, "ns_per_item", &summary);
+        fprintf(file, "      \"virtual_cycles_per_item\": %.3f,\n      \"register_accesses_per_item\": %.3f\n    }",
+                (double)((after.cycles - after.delay_cycles - after.sleep_cycles)
+                         - (before.cycles - before.delay_cycles - before.sleep_cycles)) / items,
+                (double)accesses / items);
+        first = 0;
+
+        fprintf(stderr, "%-28s %10.1f ns/%s (CI95 %.1f to %.1f)\n", benchmark->name, summary.median, benchmark->unit,
+                summary.ci95_low, summary.ci95_high);
+    }
+    fprintf(file, "\n  ]\n}\n");
+
+    if (output_path)
+    {
+        fclose(file);
+    }
+    Fleet_Free(&Bench_Fleet);
+    return failed;
+}
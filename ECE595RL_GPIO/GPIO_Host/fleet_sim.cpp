@@ -0,0 +1,304 @@
+/**
+ * @file fleet_sim.cpp
+ * @brief Load test of the LED pattern engine on many simulated boards.
+ *
+ * This program advances a fleet of boards (see inc/Fleet.h) in ticks of 100 ms. The boards are split into
+ * one contiguous range per thread; each thread advances its range for an epoch of ticks, then all threads
+ * meet at a barrier where the fleet statistics are collected. The result is reported in simulated
+ * board-seconds per wall-clock second.
+ *
+ * Usage: fleet_sim [options]
+ *  -n <boards>               Number of boards (default 65536)
+ *  -t <ms>                   Simulated time (default 60000 ms)
+ *  -j <threads>              Number of threads (default: number of CPUs)
+ *  -e <ticks>                Ticks per epoch between two barriers (default 10)
+ *  -r <probability>          Probability that the inputs of a board change at each tick (default 0.01)
+ *  -b <ms>:<buttons>         Drive the buttons of every board to a hex value at a given time
+ *  -s <ms>:<switches>        Drive the switches of every board to a hex value at a given time
+ *  -x <seed>                 Seed of the random inputs (default 1)
+ *  -S                        Measure the scaling: run with 1, 2, 4, ... threads up to -j
+ *  -c <boards>               Check the vectorized step against the reference step on a separate fleet
+ *  -w <file>                 Write the port writes of one board in the Port_Trace format (see tools/trace_compare.py)
+ *  -B <board>                Board written by -w (default 0)
+ *  -v                        Print the number of boards per active pattern at each epoch
+ *
+ * Example: fleet_sim -n 1000000 -t 10000 -S
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "inc/Fleet.h"
+
+// Time base of the traces (CPU cycles at 48 MHz)
+#define TRACE_FREQ          48000000
+
+// P1 value written by Buttons_Init (pull-ups of P1.1 and P1.4)
+#define BUTTONS_RELEASED    0x12
+
+typedef struct
+{
+    uint64_t tick;
+    uint8_t mask;
+    uint8_t buttons;
+    uint8_t switches;
+} Input_Event;
+
+static std::vector<Input_Event> Input_Events;
+static uint32_t Random_Threshold = 655;
+static uint8_t Verbose;
+
+static void Parse_Input(const char *arg, uint8_t mask)
+{
+    char *end;
+    uint64_t ms = strtoull(arg, &end, 10);
+
+    if (*end != ':')
+    {
+        fprintf(stderr, "expected <ms>:<value>, got '%s'\n", arg);
+        exit(2);
+    }
+    uint8_t value = strtoul(end + 1, 0, 16);
+    Input_Event event = { ms / FLEET_TICK_MS, mask, value, value };
+    Input_Events.push_back(event);
+}
+
+// Applies the scripted and random inputs of one tick to a range of boards
+static void Apply_Inputs(Fleet *fleet, uint32_t begin, uint32_t end, uint64_t tick, size_t *next_event)
+{
+    while ((*next_event < Input_Events.size()) && (Input_Events[*next_event].tick <= tick))
+    {
+        const Input_Event &event = Input_Events[*next_event];
+        Fleet_Set_Inputs(fleet, begin, end, event.mask, event.buttons, event.switches);
+        (*next_event)++;
+    }
+    if (Random_Threshold != 0)
+    {
+        Fleet_Randomize_Inputs(fleet, begin, end, Random_Threshold);
+    }
+}
+
+static double Run(Fleet *fleet, uint64_t ticks, uint32_t threads, uint32_t epoch)
+{
+    uint32_t chunk = ((fleet->count / threads) + FLEET_BOARD_ALIGN - 1) & ~(FLEET_BOARD_ALIGN - 1);
+    std::vector<uint32_t> histograms(threads * 8);
+    uint64_t epoch_start = 0;
+
+    auto collect = [&]() noexcept
+    {
+        if (Verbose)
+        {
+            uint32_t total[8] = { 0 };
+            for (uint32_t t = 0; t < threads; t++)
+            {
+                for (int p = 0; p < 8; p++)
+                {
+                    total[p] += histograms[t * 8 + p];
+                }
+            }
+            printf("%8.1f s  pattern 1: %u  2: %u  3: %u  4: %u  5: %u\n",
+                   (double)std::min(epoch_start + epoch, ticks) * FLEET_TICK_MS / 1000,
+                   total[1], total[2], total[3], total[4], total[5]);
+        }
+        epoch_start += epoch;
+    };
+    std::barrier<decltype(collect)> barrier(threads, collect);
+
+    auto worker = [&](uint32_t index)
+    {
+        uint32_t begin = std::min(index * chunk, fleet->count);
+        uint32_t end = std::min(begin + chunk, fleet->count);
+        size_t next_event = 0;
+
+        for (uint64_t start = 0; start < ticks; start += epoch)
+        {
+            for (uint64_t tick = start; (tick < start + epoch) && (tick < ticks); tick++)
+            {
+                Apply_Inputs(fleet, begin, end, tick, &next_event);
+                Fleet_Step(fleet, begin, end);
+            }
+            if (Verbose)
+            {
+                uint32_t *histogram = &histograms[index * 8];
+                memset(histogram, 0, 8 * sizeof(uint32_t));
+                for (uint32_t i = begin; i < end; i++)
+                {
+                    histogram[fleet->pattern[i] & 0x7]++;
+                }
+            }
+            barrier.arrive_and_wait();
+        }
+    };
+
+    auto wall_start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (uint32_t t = 1; t < threads; t++)
+    {
+        workers.push_back(std::thread(worker, t));
+    }
+    worker(0);
+    for (size_t t = 0; t < workers.size(); t++)
+    {
+        workers[t].join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+}
+
+static int Check(uint32_t boards, uint64_t ticks, uint32_t seed)
+{
+    Fleet vectorized, reference;
+    size_t next_vectorized = 0, next_reference = 0;
+
+    Fleet_Init(&vectorized, boards, seed);
+    Fleet_Init(&reference, boards, seed);
+    for (uint64_t tick = 0; tick < ticks; tick++)
+    {
+        Apply_Inputs(&vectorized, 0, vectorized.count, tick, &next_vectorized);
+        Fleet_Step(&vectorized, 0, vectorized.count);
+
+        Apply_Inputs(&reference, 0, reference.count, tick, &next_reference);
+        for (uint32_t i = 0; i < reference.count; i++)
+        {
+            Fleet_Step_Reference(&reference, i, tick, 0, 0);
+        }
+
+        for (uint32_t i = 0; i < reference.count; i++)
+        {
+            if (Fleet_Hash(&vectorized, i, i + 1) != Fleet_Hash(&reference, i, i + 1))
+            {
+                printf("check: board %u differs at tick %llu (phase %u/%u, P9 0x%02X/0x%02X)\n", i,
+                       (unsigned long long)tick, vectorized.phase[i], reference.phase[i], vectorized.pmod[i], reference.pmod[i]);
+                return 1;
+            }
+        }
+    }
+    printf("check: %u boards identical to the reference after %llu ticks\n", reference.count, (unsigned long long)ticks);
+    Fleet_Free(&vectorized);
+    Fleet_Free(&reference);
+    return 0;
+}
+
+typedef struct
+{
+    uint32_t timestamp;
+    uint8_t port;
+    uint8_t value;
+} Trace_Entry;
+
+static void Trace_Write(void *context, uint64_t tick, uint8_t port, uint8_t value)
+{
+    Trace_Entry entry = { (uint32_t)(tick * FLEET_TICK_MS * (TRACE_FREQ / 1000)), port, value };
+    ((std::vector<Trace_Entry> *)context)->push_back(entry);
+}
+
+static void Write_Trace(const char *path, uint32_t board, uint64_t ticks, uint32_t seed)
+{
+    std::vector<Trace_Entry> trace;
+    Fleet fleet;
+    size_t next_event = 0;
+
+    Fleet_Init(&fleet, board + 1, seed);
+
+    // LED2_Init, Buttons_Init and PMOD_8LD_Init
+    Trace_Write(&trace, 0, 2, 0x00);
+    Trace_Write(&trace, 0, 1, BUTTONS_RELEASED);
+    Trace_Write(&trace, 0, 9, 0x00);
+
+    for (uint64_t tick = 0; tick < ticks; tick++)
+    {
+        Apply_Inputs(&fleet, 0, fleet.count, tick, &next_event);
+        Fleet_Step_Reference(&fleet, board, tick, Trace_Write, &trace);
+    }
+    Fleet_Free(&fleet);
+
+    FILE *file = fopen(path, "w");
+    if (file == 0)
+    {
+        perror(path);
+        exit(1);
+    }
+    fprintf(file, "Port trace: freq=%u count=%u lost=0\n", TRACE_FREQ, (uint32_t)trace.size());
+    for (size_t i = 0; i < trace.size(); i++)
+    {
+        fprintf(file, "%X %u %X\n", trace[i].timestamp, trace[i].port, trace[i].value);
+    }
+    fprintf(file, "Port trace: end\n");
+    fclose(file);
+}
+
+static void Report(const Fleet *fleet, uint32_t threads, uint64_t ticks, double wall)
+{
+    double board_seconds = (double)fleet->count * ticks * FLEET_TICK_MS / 1000;
+    printf("%10u boards %3u threads %8.3f s wall %14.0f board-s/s %7.3f ns/board-tick  hash %016llX\n",
+           fleet->count, threads, wall, board_seconds / wall, wall * 1e9 / ((double)fleet->count * ticks),
+           (unsigned long long)Fleet_Hash(fleet, 0, fleet->count));
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t boards = 65536;
+    uint64_t time_ms = 60000;
+    uint32_t threads = std::max(1u, std::thread::hardware_concurrency());
+    uint32_t epoch = 10;
+    uint32_t seed = 1;
+    uint32_t check_boards = 0;
+    uint32_t trace_board = 0;
+    const char *trace_path = 0;
+    uint8_t scaling = 0;
+    int option;
+
+    while ((option = getopt(argc, argv, "n:t:j:e:r:b:s:x:Sc:w:B:v")) != -1)
+    {
+        switch (option)
+        {
+            case 'n': boards = strtoul(optarg, 0, 10); break;
+            case 't': time_ms = strtoull(optarg, 0, 10); break;
+            case 'j': threads = std::max(1ul, strtoul(optarg, 0, 10)); break;
+            case 'e': epoch = std::max(1ul, strtoul(optarg, 0, 10)); break;
+            case 'r': Random_Threshold = (uint32_t)(strtod(optarg, 0) * 65536); break;
+            case 'b': Parse_Input(optarg, 1); break;
+            case 's': Parse_Input(optarg, 2); break;
+            case 'x': seed = strtoul(optarg, 0, 0); break;
+            case 'S': scaling = 1; break;
+            case 'c': check_boards = strtoul(optarg, 0, 10); break;
+            case 'w': trace_path = optarg; break;
+            case 'B': trace_board = strtoul(optarg, 0, 10); break;
+            case 'v': Verbose = 1; break;
+            default:
+                fprintf(stderr, "usage: %s [-n boards] [-t ms] [-j threads] [-e ticks] [-r probability] [-b ms:buttons]"
+                                " [-s ms:switches] [-x seed] [-S] [-c boards] [-w file] [-B board] [-v]\n", argv[0]);
+                return 2;
+        }
+    }
+    std::stable_sort(Input_Events.begin(), Input_Events.end(),
+                     [](const Input_Event &a, const Input_Event &b) { return a.tick < b.tick; });
+
+    uint64_t ticks = time_ms / FLEET_TICK_MS;
+
+    if (check_boards != 0)
+    {
+        return Check(check_boards, ticks, seed);
+    }
+    if (trace_path != 0)
+    {
+        Write_Trace(trace_path, trace_board, ticks, seed);
+        return 0;
+    }
+
+    for (uint32_t t = scaling ? 1 : threads; t <= threads; t = (t * 2 > threads && t < threads) ? threads : t * 2)
+    {
+        Fleet fleet;
+        Fleet_Init(&fleet, boards, seed);
+        double wall = Run(&fleet, ticks, t, epoch);
+        Report(&fleet, t, ticks, wall);
+        Fleet_Free(&fleet);
+    }
+    return 0;
+}
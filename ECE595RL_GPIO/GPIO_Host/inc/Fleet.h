@@ -0,0 +1,162 @@
+/**
+ * @file Fleet.h
+ * @brief Header file for the Fleet module.
+ *
+ * This file contains the function definitions for the Fleet module.
+ *
+ * The Fleet module simulates many boards running the main loop of GPIO/main.c and the LED patterns of
+ * GPIO.c (LED_Controller and LED_Pattern_1 to LED_Pattern_5). The drivers themselves cannot run once per
+ * board, since they block in Clock_Delay1ms and use the global registers of the Sim module, so the same
+ * behaviour is expressed as a state machine that advances every board by one tick of FLEET_TICK_MS:
+ *  - Every delay of the patterns and of the main loop is a multiple of 100 ms, and the inputs are only read
+ *    between two delays, so a board executes at most one segment of code (the writes between two delays)
+ *    per tick and then waits a number of ticks.
+ *  - The time spent outside the delays (a few microseconds per iteration) is ignored.
+ *  - A write that does not change a port is elided, as in GPIO.c.
+ *
+ * The state of the boards is stored as a structure of arrays, one byte per board and field, so that
+ * Fleet_Step processes one board per byte lane of the vector registers. Fleet_Step is written without
+ * branches so that the compiler vectorizes it; Fleet_Step_Reference is a direct translation of GPIO.c used
+ * to check Fleet_Step and to record the port writes of a single board.
+ *
+ */
+
+#ifndef INC_FLEET_H_
+#define INC_FLEET_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Duration of one tick of the simulation in milliseconds
+ */
+#define FLEET_TICK_MS           100
+
+/**
+ * @brief The number of boards is rounded up to a multiple of FLEET_BOARD_ALIGN (one cache line per field)
+ */
+#define FLEET_BOARD_ALIGN       64
+
+/**
+ * @brief Code position of a board: the segment executed when its wait counter reaches 0
+ */
+typedef enum
+{
+    FLEET_PHASE_TOP,                // Main loop: read the inputs and start the selected pattern
+    FLEET_PHASE_PATTERN_1_ON,       // LED_Pattern_1 (both buttons pressed) after the first 1 s delay
+    FLEET_PHASE_PATTERN_2,          // LED_Pattern_2 after a 100 ms step
+    FLEET_PHASE_PATTERN_3,          // LED_Pattern_3 after a 100 ms step
+    FLEET_PHASE_PATTERN_4_ON,       // LED_Pattern_4 after the first 1 s delay
+    FLEET_PHASE_PATTERN_4_OFF,      // LED_Pattern_4 after the second 1 s delay
+    FLEET_PHASE_PATTERN_5           // LED_Pattern_5 after a 500 ms step
+} Fleet_Phase;
+
+/**
+ * @brief State of the boards (one element per board in each array)
+ */
+typedef struct
+{
+    uint32_t count;                 // Number of boards (multiple of FLEET_BOARD_ALIGN)
+    uint8_t *phase;                 // Fleet_Phase
+    uint8_t *wait;                  // Ticks before the next segment
+    uint8_t *counter;               // Loop variable of LED_Pattern_2, 3 and 5
+    uint8_t *pattern;               // Active pattern (LED_Get_Active_Pattern)
+    uint8_t *led1;                  // LED1 output (P1.0)
+    uint8_t *rgb;                   // RGB LED output (P2.0 to P2.2)
+    uint8_t *pmod;                  // PMOD 8LD output (P9)
+    uint8_t *buttons;               // User buttons input (P1.1 and P1.4, active low)
+    uint8_t *switches;              // PMOD SWT input (P10.0 to P10.3)
+    uint32_t *random;               // State of the per-board random input generator
+    uint32_t *writes;               // Number of port writes (elided writes are not counted)
+} Fleet;
+
+/**
+ * @brief Callback called by Fleet_Step_Reference for each port write
+ */
+typedef void (*Fleet_Write_Callback)(void *context, uint64_t tick, uint8_t port, uint8_t value);
+
+/**
+ * @brief The Fleet_Init function allocates the boards and resets them.
+ *
+ * Each board starts at the top of the main loop with its LEDs off, the buttons released and the switches off.
+ *
+ * @param fleet Pointer to the fleet.
+ * @param count The number of boards (rounded up to a multiple of FLEET_BOARD_ALIGN).
+ * @param seed The seed of the random input generators. Board i uses the same sequence for a given seed.
+ *
+ * @return None
+ */
+void Fleet_Init(Fleet *fleet, uint32_t count, uint32_t seed);
+
+/**
+ * @brief The Fleet_Free function releases the memory of the boards.
+ *
+ * @param fleet Pointer to the fleet.
+ *
+ * @return None
+ */
+void Fleet_Free(Fleet *fleet);
+
+/**
+ * @brief The Fleet_Set_Inputs function drives the inputs of a range of boards.
+ *
+ * @param fleet Pointer to the fleet.
+ * @param begin The first board.
+ * @param end The board after the last board.
+ * @param mask The inputs to change: 1 for the buttons, 2 for the switches.
+ * @param buttons The value of the buttons (0x00 to 0x12).
+ * @param switches The value of the switches (0x0 to 0xF).
+ *
+ * @return None
+ */
+void Fleet_Set_Inputs(Fleet *fleet, uint32_t begin, uint32_t end, uint8_t mask, uint8_t buttons, uint8_t switches);
+
+/**
+ * @brief The Fleet_Randomize_Inputs function changes the inputs of each board of a range with a given probability.
+ *
+ * The new switch value selects one of the five patterns, and each button is pressed with a probability of 1/2.
+ *
+ * @param fleet Pointer to the fleet.
+ * @param begin The first board.
+ * @param end The board after the last board.
+ * @param threshold The probability of a change is threshold / 65536.
+ *
+ * @return None
+ */
+void Fleet_Randomize_Inputs(Fleet *fleet, uint32_t begin, uint32_t end, uint32_t threshold);
+
+/**
+ * @brief The Fleet_Step function advances a range of boards by one tick.
+ *
+ * @param fleet Pointer to the fleet.
+ * @param begin The first board (multiple of FLEET_BOARD_ALIGN).
+ * @param end The board after the last board (multiple of FLEET_BOARD_ALIGN).
+ *
+ * @return None
+ */
+void Fleet_Step(Fleet *fleet, uint32_t begin, uint32_t end);
+
+/**
+ * @brief The Fleet_Step_Reference function advances one board by one tick, following the code of GPIO.c.
+ *
+ * @param fleet Pointer to the fleet.
+ * @param board The board.
+ * @param tick The current tick, passed to the callback.
+ * @param callback The function called for each port write in program order, or 0.
+ * @param context The first argument of the callback.
+ *
+ * @return None
+ */
+void Fleet_Step_Reference(Fleet *fleet, uint32_t board, uint64_t tick, Fleet_Write_Callback callback, void *context);
+
+/**
+ * @brief The Fleet_Hash function returns a hash of the state of a range of boards.
+ *
+ * @param fleet Pointer to the fleet.
+ * @param begin The first board.
+ * @param end The board after the last board.
+ *
+ * @return The FNV-1a hash of every field of the boards.
+ */
+uint64_t Fleet_Hash(const Fleet *fleet, uint32_t begin, uint32_t end);
+
+#endif /* INC_FLEET_H_ */
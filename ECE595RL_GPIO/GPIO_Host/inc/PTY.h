@@ -0,0 +1,104 @@
+/**
+ * @file PTY.h
+ * @brief Header file for the PTY module.
+ *
+ * This file contains the function definitions for the PTY module.
+ *
+ * The PTY module connects the simulated EUSCI_A0 to a Linux pseudo-terminal, so that a terminal program
+ * (screen, minicom, picocom) or a host tool using pyserial can talk to the drivers running in gpio_sim:
+ *  - The characters transmitted by EUSCI_A0 are written to the pseudo-terminal (PTY_Transmit).
+ *  - The characters written to the pseudo-terminal are received by EUSCI_A0 one character time apart at
+ *    the configured baud rate (Sim_Push_UART_RX), so a host tool that sends faster than the drivers read
+ *    RXBUF loses characters with an overrun error, as on the LaunchPad.
+ *
+ * Pacing:
+ *  - Without pacing, the virtual time runs as fast as the host allows and the 115200 baud line transfers
+ *    much more than 11520 characters per wall-clock second.
+ *  - With pacing, the virtual time is held back to a multiple of the wall-clock time. At a speed of 1,
+ *    the delays, the main loop period and the UART throughput seen by the host tools match the hardware.
+ *
+ * The pseudo-terminal is left in raw mode, without echo or line editing, like the USB serial port of the
+ * LaunchPad.
+ *
+ */
+
+#ifndef INC_PTY_H_
+#define INC_PTY_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Period of the PTY_Poll calls in nanoseconds of virtual time
+ */
+#define PTY_POLL_PERIOD_NS      1000000
+
+/**
+ * @brief The PTY_Open function creates the pseudo-terminal and installs PTY_Poll as the Sim poll callback.
+ *
+ * @param link Path of a symbolic link to the pseudo-terminal (for example /tmp/gpio_sim), or 0.
+ *
+ * @return 0 on success, -1 on failure (the reason is printed on stderr).
+ */
+int PTY_Open(const char *link);
+
+/**
+ * @brief The PTY_Close function closes the pseudo-terminal and removes its symbolic link.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void PTY_Close();
+
+/**
+ * @brief The PTY_Get_Name function returns the path of the pseudo-terminal.
+ *
+ * @param None
+ *
+ * @return The path of the terminal device (for example /dev/pts/3), or 0 if the pseudo-terminal is not open.
+ */
+const char *PTY_Get_Name();
+
+/**
+ * @brief The PTY_Set_Speed function paces the virtual time to the wall-clock time.
+ *
+ * The pacing does not need an open pseudo-terminal.
+ *
+ * @param speed The ratio of virtual time to wall-clock time (1 for real time), or 0 to run without pacing.
+ *
+ * @return None
+ */
+void PTY_Set_Speed(double speed);
+
+/**
+ * @brief The PTY_Transmit function writes a character transmitted by EUSCI_A0 to the pseudo-terminal.
+ *
+ * The character is dropped if the pseudo-terminal buffer is full.
+ *
+ * @param data The character.
+ *
+ * @return None
+ */
+void PTY_Transmit(uint8_t data);
+
+/**
+ * @brief The PTY_Poll function forwards the characters written to the pseudo-terminal and applies the pacing.
+ *
+ * It is called by the Sim module every PTY_POLL_PERIOD_NS of virtual time.
+ *
+ * @param cycles The virtual time.
+ *
+ * @return None
+ */
+void PTY_Poll(uint64_t cycles);
+
+/**
+ * @brief The PTY_Get_Dropped function returns the number of transmitted characters dropped by PTY_Transmit.
+ *
+ * @param None
+ *
+ * @return The number of dropped characters.
+ */
+uint32_t PTY_Get_Dropped();
+
+#endif /* INC_PTY_H_ */
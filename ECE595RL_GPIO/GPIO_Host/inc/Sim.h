@@ -0,0 +1,314 @@
+/**
+ * @file Sim.h
+ * @brief Header file for the Sim module.
+ *
+ * This file contains the function definitions for the Sim module.
+ *
+ * The Sim module simulates the MSP432P401R peripherals used by the drivers, so that the unchanged
+ * driver sources can be run, tested and benchmarked on a Linux host (see GPIO_Host/Makefile).
+ *
+ * Virtual time:
+ *  - The virtual time is counted in CPU (MCLK) cycles and is returned by DWT->CYCCNT.
+ *  - Each register access costs SIM_REGISTER_ACCESS_CYCLES, so polling loops advance the time.
+ *  - The delay loop of Clock_Delay1ms costs SIM_DELAY_LOOP_CYCLES_X1000 / 1000 cycles per iteration,
+ *    which is the value the loop was tuned to at 48 MHz.
+ *  - Code that does not access a register is free. In particular, Clock_Delay1us does not advance the time.
+ *
+ * Behavioural models:
+ *  - Ports: Px->IN returns the output of the pins configured as outputs, the level driven on the other pins
+ *    by Sim_Schedule_Input, or the level of the pull resistor (REN set) of undriven pins. Undriven pins
+ *    without a pull resistor read 0.
+ *  - EUSCI_A0: the transmitter takes 10 bit times per character and sets TXIFG when TXBUF is free.
+ *    The bytes scheduled with Sim_Schedule_UART_RX or Sim_Push_UART_RX set RXIFG when they arrive. A byte
+ *    that arrives before the previous one was read from RXBUF overwrites it and sets STATW.OE.
+ *  - PCM: active mode requests need the PCM key, keep PMR_BUSY set for SIM_PCM_TRANSITION_CYCLES and
+ *    then update CPM. Unsupported requests set AM_INVALID_TR_IFG.
+ *  - CS: the registers are write-protected by CSKEY, and HFXTIFG stays set for SIM_HFXT_STARTUP_CYCLES
+ *    after HFXT is enabled. MCLK and SMCLK are derived from CTL0, CTL1 and the HFXT state.
+ *  - FLCTL: selecting a 48 MHz MCLK with less than 2 flash wait states is reported as a violation.
+ *
+ * Register accesses that real hardware would ignore or mishandle (locked writes, TXBUF overruns, ...) are
+ * reported as violations (see Sim_Get_Stats).
+ *
+ * The cycle costs are approximations chosen for relative comparisons; they have not been calibrated
+ * against the LaunchPad.
+ *
+ */
+
+#ifndef INC_SIM_H_
+#define INC_SIM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "msp.h"
+
+/**
+ * @brief Cost model
+ */
+#define SIM_REGISTER_ACCESS_CYCLES      2           // Peripheral register load or store
+#define SIM_DELAY_LOOP_CYCLES_X1000     9162        // One iteration of the delay loop in Clock.c
+#define SIM_PCM_TRANSITION_CYCLES       3000        // Active mode transition (PMR_BUSY set)
+#define SIM_HFXT_STARTUP_CYCLES         30000       // HFXT start-up (HFXTIFG set)
+#define SIM_UART_RX_CHAR_CYCLES         4160        // Default spacing of received characters (115200 baud at 48 MHz)
+
+/**
+ * @brief Port numbers used by the Sim functions (P1 to P10 use their own number)
+ */
+#define SIM_PORT_J                      11
+#define SIM_NUM_PORTS                   12
+
+/**
+ * @brief Peripherals counted by the register access statistics
+ */
+typedef enum
+{
+    SIM_PERIPHERAL_PORT,
+    SIM_PERIPHERAL_CS,
+    SIM_PERIPHERAL_PCM,
+    SIM_PERIPHERAL_FLCTL,
+    SIM_PERIPHERAL_EUSCI_A0,
+    SIM_PERIPHERAL_RSTCTL,
+    SIM_PERIPHERAL_CORE,
+    SIM_NUM_PERIPHERALS
+} Sim_Peripheral;
+
+/**
+ * @brief Statistics of the simulation
+ */
+typedef struct
+{
+    uint64_t cycles;                                // Virtual time
+    uint64_t register_cycles;                       // Cycles charged for register accesses
+    uint64_t delay_cycles;                          // Cycles charged for delay loops
+    uint64_t sleep_cycles;                          // Cycles skipped by __WFI
+    uint32_t reads[SIM_NUM_PERIPHERALS];            // Register reads per peripheral
+    uint32_t writes[SIM_NUM_PERIPHERALS];           // Register writes per peripheral
+    uint32_t violations;                            // Accesses that real hardware would reject
+    uint32_t uart_overruns;                         // Received bytes lost because RXBUF was not read in time
+} Sim_Stats;
+
+/**
+ * @brief Reasons for leaving the simulation (thrown as Sim_Stop)
+ */
+typedef enum
+{
+    SIM_STOP_TIME_LIMIT,                            // The virtual time reached the limit set with Sim_Set_Time_Limit
+    SIM_STOP_SYSTEM_RESET,                          // The drivers called NVIC_SystemReset
+    SIM_STOP_SLEEP_FOREVER                          // __WFI was called with no scheduled event
+} Sim_Stop;
+
+/**
+ * @brief Callback called when a port output register changes or a character is transmitted
+ */
+typedef void (*Sim_Output_Observer)(uint64_t cycles, uint8_t port, uint8_t value);
+typedef void (*Sim_UART_Observer)(uint64_t cycles, uint8_t data);
+
+/**
+ * @brief Callback called periodically in virtual time (see Sim_Set_Poll_Callback)
+ */
+typedef void (*Sim_Poll_Callback)(uint64_t cycles);
+
+/**
+ * @brief The Sim_Reset function applies a power-on reset to every simulated peripheral.
+ *
+ * The virtual time, the statistics, the scheduled events and the observers are cleared.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Sim_Reset();
+
+/**
+ * @brief The Sim_Advance function advances the virtual time and applies the events that are due.
+ *
+ * @param cycles The number of cycles to add to the virtual time.
+ *
+ * @throw Sim_Stop SIM_STOP_TIME_LIMIT if the time limit is reached.
+ *
+ * @return None
+ */
+void Sim_Advance(uint64_t cycles);
+
+/**
+ * @brief The Sim_Get_Cycles function returns the virtual time in CPU cycles.
+ *
+ * @param None
+ *
+ * @return The number of cycles since Sim_Reset.
+ */
+uint64_t Sim_Get_Cycles();
+
+/**
+ * @brief The Sim_Get_Time_ns function returns the virtual time in nanoseconds.
+ *
+ * Each cycle is converted with the MCLK frequency at the time it elapsed.
+ *
+ * @param None
+ *
+ * @return The number of nanoseconds since Sim_Reset.
+ */
+uint64_t Sim_Get_Time_ns();
+
+/**
+ * @brief The Sim_Get_MCLK_Hz function returns the current MCLK frequency.
+ *
+ * @param None
+ *
+ * @return The MCLK frequency in Hz.
+ */
+uint32_t Sim_Get_MCLK_Hz();
+
+/**
+ * @brief The Sim_Get_SMCLK_Hz function returns the current SMCLK frequency.
+ *
+ * @param None
+ *
+ * @return The SMCLK frequency in Hz.
+ */
+uint32_t Sim_Get_SMCLK_Hz();
+
+/**
+ * @brief The Sim_Set_Time_Limit function stops the simulation when the virtual time reaches a limit.
+ *
+ * @param cycles The limit in CPU cycles, or 0 for no limit.
+ *
+ * @return None
+ */
+void Sim_Set_Time_Limit(uint64_t cycles);
+
+/**
+ * @brief The Sim_Schedule_Input function drives input pins of a port at a given time.
+ *
+ * The pins in mask are driven to the corresponding bits of value. The other pins keep their state.
+ * A pin is released (left undriven) by scheduling it with Sim_Release_Input.
+ *
+ * @param cycles The virtual time of the change.
+ * @param port The port number (1 to 10, or SIM_PORT_J).
+ * @param mask The pins to drive.
+ * @param value The levels of the driven pins.
+ *
+ * @return None
+ */
+void Sim_Schedule_Input(uint64_t cycles, uint8_t port, uint8_t mask, uint8_t value);
+
+/**
+ * @brief The Sim_Release_Input function stops driving input pins of a port at a given time.
+ *
+ * @param cycles The virtual time of the change.
+ * @param port The port number (1 to 10, or SIM_PORT_J).
+ * @param mask The pins to release.
+ *
+ * @return None
+ */
+void Sim_Release_Input(uint64_t cycles, uint8_t port, uint8_t mask);
+
+/**
+ * @brief The Sim_Schedule_UART_RX function schedules characters received by EUSCI_A0.
+ *
+ * The first character arrives at the given time and the next ones every SIM_UART_RX_CHAR_CYCLES.
+ *
+ * @param cycles The virtual time of the first character.
+ * @param data Pointer to the characters.
+ * @param length The number of characters.
+ * @param statw The EUSCI_A0 STATW error bits reported with each character (0 for no error).
+ *
+ * @return None
+ */
+void Sim_Schedule_UART_RX(uint64_t cycles, const uint8_t *data, size_t length, uint16_t statw);
+
+/**
+ * @brief The Sim_Push_UART_RX function sends characters to EUSCI_A0 over the simulated serial line.
+ *
+ * The characters follow the characters already queued, one character time apart at the baud rate
+ * configured in EUSCI_A0, and the first one arrives no earlier than the current virtual time.
+ *
+ * @param data Pointer to the characters.
+ * @param length The number of characters.
+ *
+ * @return None
+ */
+void Sim_Push_UART_RX(const uint8_t *data, size_t length);
+
+/**
+ * @brief The Sim_Get_Pins function returns the level of the pins of a port.
+ *
+ * @param port The port number (1 to 10, or SIM_PORT_J).
+ *
+ * @return The value that the port IN register would return.
+ */
+uint8_t Sim_Get_Pins(uint8_t port);
+
+/**
+ * @brief The Sim_Get_Port function returns the registers of a port.
+ *
+ * @param port The port number (1 to 10, or SIM_PORT_J).
+ *
+ * @return Pointer to the port registers. Accesses through this pointer are charged like driver accesses,
+ * so observers should read the value field of the registers instead.
+ */
+DIO_PORT_Type *Sim_Get_Port(uint8_t port);
+
+/**
+ * @brief The Sim_Set_Output_Observer function sets the callback called when a port OUT or DIR register changes.
+ *
+ * The callback receives the pins driven by the port (OUT & DIR).
+ *
+ * @param observer The callback, or 0 to remove it.
+ *
+ * @return None
+ */
+void Sim_Set_Output_Observer(Sim_Output_Observer observer);
+
+/**
+ * @brief The Sim_Set_UART_Observer function sets the callback called when EUSCI_A0 starts transmitting a character.
+ *
+ * @param observer The callback, or 0 to remove it.
+ *
+ * @return None
+ */
+void Sim_Set_UART_Observer(Sim_UART_Observer observer);
+
+/**
+ * @brief The Sim_Set_Poll_Callback function sets a callback called each time the virtual time advances by a period.
+ *
+ * The callback connects the simulation to the outside world (see PTY.h). It may schedule events but must
+ * not access the simulated registers.
+ *
+ * @param callback The callback, or 0 to remove it.
+ * @param period_ns The period in nanoseconds of virtual time.
+ *
+ * @return None
+ */
+void Sim_Set_Poll_Callback(Sim_Poll_Callback callback, uint64_t period_ns);
+
+/**
+ * @brief The Sim_Get_Stats function returns the statistics of the simulation.
+ *
+ * @param stats Pointer to the structure that receives the statistics.
+ *
+ * @return None
+ */
+void Sim_Get_Stats(Sim_Stats *stats);
+
+/**
+ * @brief The Sim_Get_Last_Violation function describes the most recent violation.
+ *
+ * @param None
+ *
+ * @return A description of the violation, or an empty string if there was none.
+ */
+const char *Sim_Get_Last_Violation();
+
+/**
+ * @brief The Sim_Delay_Loops function charges the cost of the delay loop in Clock.c.
+ *
+ * The Makefile replaces the inline assembly loop of Clock.c with a call to this function.
+ *
+ * @param loops The number of iterations of the loop.
+ *
+ * @return None
+ */
+void Sim_Delay_Loops(uint32_t loops);
+
+#endif /* INC_SIM_H_ */
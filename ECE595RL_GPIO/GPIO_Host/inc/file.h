@@ -0,0 +1,30 @@
+/**
+ * @file file.h
+ * @brief Host replacement of the TI run-time support header for device drivers.
+ *
+ * EUSCI_A0_UART_Init_Printf registers the UART as a stdio device with add_device. The host C library
+ * has no equivalent, so add_device always fails and stdout is left unchanged.
+ *
+ */
+
+#ifndef HOST_FILE_H_
+#define HOST_FILE_H_
+
+#include <sys/types.h>
+
+#define _SSA    0
+#define _MSA    1
+
+static inline int add_device(const char *name, unsigned flags,
+                             int (*dopen)(const char *path, unsigned flags, int llv_fd),
+                             int (*dclose)(int dev_fd),
+                             int (*dread)(int dev_fd, char *buf, unsigned count),
+                             int (*dwrite)(int dev_fd, const char *buf, unsigned count),
+                             off_t (*dlseek)(int dev_fd, off_t offset, int origin),
+                             int (*dunlink)(const char *path),
+                             int (*drename)(const char *old_name, const char *new_name))
+{
+    return -1;
+}
+
+#endif /* HOST_FILE_H_ */
@@ -0,0 +1,346 @@
+/**
+ * @file msp.h
+ * @brief Host replacement of the MSP432P401R device header.
+ *
+ * This file is included instead of the TI device header when the drivers are built for the host
+ * (see GPIO_Host/Makefile). It provides the peripheral pointers, register names, compiler intrinsics
+ * and CMSIS functions used by the drivers, so that the driver sources compile without changes.
+ *
+ * Each register is a Sim_Register object instead of a volatile integer. Reading or writing a register
+ * charges its cost to the virtual time and calls the behavioural model of the peripheral, if any
+ * (see Sim.h). The drivers are compiled as C++ so that these accesses can be intercepted.
+ *
+ * Only the peripherals and register names used by the host build are defined.
+ *
+ */
+
+#ifndef HOST_MSP_H_
+#define HOST_MSP_H_
+
+#include <stdint.h>
+
+#ifndef __cplusplus
+#error "The host drivers must be compiled as C++ (see GPIO_Host/Makefile)"
+#endif
+
+/**
+ * @brief Hooks of a modelled register
+ *
+ * The read hook returns the value seen by the driver, and the write hook stores the value written
+ * by the driver. Both receive the address of the Sim_Register object.
+ */
+typedef uint32_t (*Sim_Read_Hook)(const void *reg, uint32_t stored);
+typedef void (*Sim_Write_Hook)(void *reg, uint32_t value);
+
+void Sim_Register_Access(const void *reg, int write);
+
+/**
+ * @brief Simulated memory-mapped register
+ *
+ * Registers without hooks behave like plain memory.
+ */
+template <typename T>
+class Sim_Register
+{
+public:
+    T value;
+    Sim_Read_Hook read_hook;
+    Sim_Write_Hook write_hook;
+
+    T Read() const
+    {
+        Sim_Register_Access(this, 0);
+        return read_hook ? (T)read_hook(this, value) : value;
+    }
+
+    // The value is truncated to the width of the register, as the bus does on the target
+    void Write(uint32_t new_value)
+    {
+        Sim_Register_Access(this, 1);
+        if (write_hook)
+        {
+            write_hook(this, (T)new_value);
+        }
+        else
+        {
+            value = (T)new_value;
+        }
+    }
+
+    operator T() const { return Read(); }
+
+    Sim_Register &operator=(T new_value) { Write(new_value); return *this; }
+    Sim_Register &operator=(const Sim_Register &other) { Write(other.Read()); return *this; }
+    // The operands are taken as uint32_t, like the integer promotion of the target, so that ~0xFF is not narrowed
+    Sim_Register &operator|=(uint32_t bits) { Write(Read() | bits); return *this; }
+    Sim_Register &operator&=(uint32_t bits) { Write(Read() & bits); return *this; }
+    Sim_Register &operator^=(uint32_t bits) { Write(Read() ^ bits); return *this; }
+    Sim_Register &operator+=(T n) { Write(Read() + n); return *this; }
+    Sim_Register &operator-=(T n) { Write(Read() - n); return *this; }
+};
+
+typedef Sim_Register<uint8_t> Sim_Reg8;
+typedef Sim_Register<uint16_t> Sim_Reg16;
+typedef Sim_Register<uint32_t> Sim_Reg32;
+
+/******************************************************************************
+* Peripheral register layouts
+******************************************************************************/
+
+typedef struct
+{
+    Sim_Reg8 IN;
+    Sim_Reg8 OUT;
+    Sim_Reg8 DIR;
+    Sim_Reg8 REN;
+    Sim_Reg8 DS;
+    Sim_Reg8 SEL0;
+    Sim_Reg8 SEL1;
+    Sim_Reg8 SELC;
+    Sim_Reg8 IES;
+    Sim_Reg8 IE;
+    Sim_Reg8 IFG;
+    Sim_Reg16 IV;
+} DIO_PORT_Type;
+
+typedef struct
+{
+    Sim_Reg32 KEY;
+    Sim_Reg32 CTL0;
+    Sim_Reg32 CTL1;
+    Sim_Reg32 CTL2;
+    Sim_Reg32 CTL3;
+    Sim_Reg32 CLKEN;
+    Sim_Reg32 STAT;
+    Sim_Reg32 IE;
+    Sim_Reg32 IFG;
+    Sim_Reg32 CLRIFG;
+    Sim_Reg32 SETIFG;
+} CS_Type;
+
+typedef struct
+{
+    Sim_Reg32 CTL0;
+    Sim_Reg32 CTL1;
+    Sim_Reg32 IE;
+    Sim_Reg32 IFG;
+    Sim_Reg32 CLRIFG;
+} PCM_Type;
+
+typedef struct
+{
+    Sim_Reg32 POWER_STAT;
+    Sim_Reg32 BANK0_RDCTL;
+    Sim_Reg32 BANK1_RDCTL;
+} FLCTL_Type;
+
+typedef struct
+{
+    Sim_Reg16 CTLW0;
+    Sim_Reg16 CTLW1;
+    Sim_Reg16 BRW;
+    Sim_Reg16 MCTLW;
+    Sim_Reg16 STATW;
+    Sim_Reg16 RXBUF;
+    Sim_Reg16 TXBUF;
+    Sim_Reg16 ABCTL;
+    Sim_Reg16 IRCTL;
+    Sim_Reg16 IE;
+    Sim_Reg16 IFG;
+    Sim_Reg16 IV;
+} EUSCI_A_Type;
+
+typedef struct
+{
+    Sim_Reg32 RESET_REQ;
+    Sim_Reg32 HARDRESET_STAT;
+    Sim_Reg32 HARDRESET_CLR;
+    Sim_Reg32 HARDRESET_SET;
+    Sim_Reg32 SOFTRESET_STAT;
+    Sim_Reg32 SOFTRESET_CLR;
+    Sim_Reg32 SOFTRESET_SET;
+    Sim_Reg32 PSSRESET_STAT;
+    Sim_Reg32 PSSRESET_CLR;
+    Sim_Reg32 PCMRESET_STAT;
+    Sim_Reg32 PCMRESET_CLR;
+    Sim_Reg32 PINRESET_STAT;
+    Sim_Reg32 PINRESET_CLR;
+    Sim_Reg32 REBOOTRESET_STAT;
+    Sim_Reg32 REBOOTRESET_CLR;
+    Sim_Reg32 CSRESET_STAT;
+    Sim_Reg32 CSRESET_CLR;
+} RSTCTL_Type;
+
+typedef struct
+{
+    Sim_Reg32 CTRL;
+    Sim_Reg32 CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    Sim_Reg32 DEMCR;
+} CoreDebug_Type;
+
+typedef struct
+{
+    Sim_Reg32 VTOR;
+    Sim_Reg32 AIRCR;
+    Sim_Reg32 SCR;
+    Sim_Reg32 CCR;
+    Sim_Reg32 CFSR;
+    Sim_Reg32 HFSR;
+    Sim_Reg32 MMFAR;
+    Sim_Reg32 BFAR;
+    Sim_Reg32 CPACR;
+} SCB_Type;
+
+/******************************************************************************
+* Peripheral instances (defined in Sim.cpp)
+******************************************************************************/
+
+extern DIO_PORT_Type Sim_P1, Sim_P2, Sim_P3, Sim_P4, Sim_P5, Sim_P6, Sim_P7, Sim_P8, Sim_P9, Sim_P10, Sim_PJ;
+extern CS_Type Sim_CS;
+extern PCM_Type Sim_PCM;
+extern FLCTL_Type Sim_FLCTL;
+extern EUSCI_A_Type Sim_EUSCI_A0;
+extern RSTCTL_Type Sim_RSTCTL;
+extern DWT_Type Sim_DWT;
+extern CoreDebug_Type Sim_CoreDebug;
+extern SCB_Type Sim_SCB;
+
+#define P1              (&Sim_P1)
+#define P2              (&Sim_P2)
+#define P3              (&Sim_P3)
+#define P4              (&Sim_P4)
+#define P5              (&Sim_P5)
+#define P6              (&Sim_P6)
+#define P7              (&Sim_P7)
+#define P8              (&Sim_P8)
+#define P9              (&Sim_P9)
+#define P10             (&Sim_P10)
+#define PJ              (&Sim_PJ)
+#define CS              (&Sim_CS)
+#define PCM             (&Sim_PCM)
+#define FLCTL           (&Sim_FLCTL)
+#define EUSCI_A0        (&Sim_EUSCI_A0)
+#define RSTCTL          (&Sim_RSTCTL)
+#define DWT             (&Sim_DWT)
+#define CoreDebug       (&Sim_CoreDebug)
+#define SCB             (&Sim_SCB)
+
+/******************************************************************************
+* Register bit definitions
+******************************************************************************/
+
+#define __NVIC_PRIO_BITS                    3
+
+#define CS_KEY_VAL                          0x0000695A
+#define CS_CTL1_SELM_MASK                   0x00000007
+#define CS_CTL1_SELM_OFS                    0
+#define CS_CTL1_DIVM_MASK                   0x00070000
+#define CS_CTL1_DIVM_OFS                    16
+#define CS_CTL1_DIVS_MASK                   0x70000000
+#define CS_CTL1_DIVS_OFS                    28
+#define CS_CTL2_HFXT_EN                     0x01000000
+#define CS_IFG_HFXTIFG                      0x00000002
+
+#define PCM_CTL0_KEY_VAL                    0x695A0000
+#define PCM_CTL0_KEY_MASK                   0xFFFF0000
+#define PCM_CTL0_AMR_MASK                   0x0000000F
+#define PCM_CTL0_LPMR_MASK                  0x000000F0
+#define PCM_CTL0_CPM_MASK                   0x00003F00
+#define PCM_CTL0_CPM_OFS                    8
+#define PCM_CTL1_KEY_VAL                    0x695A0000
+#define PCM_CTL1_KEY_MASK                   0xFFFF0000
+#define PCM_CTL1_LOCKLPM5                   0x00000001
+#define PCM_CTL1_PMR_BUSY                   0x00000100
+#define PCM_IFG_AM_INVALID_TR_IFG           0x00000004
+
+#define FLCTL_BANK0_RDCTL_WAIT_MASK         0x0000F000
+#define FLCTL_BANK0_RDCTL_WAIT_OFS          12
+#define FLCTL_BANK0_RDCTL_WAIT_2            0x00002000
+#define FLCTL_BANK1_RDCTL_WAIT_MASK         0x0000F000
+#define FLCTL_BANK1_RDCTL_WAIT_OFS          12
+#define FLCTL_BANK1_RDCTL_WAIT_2            0x00002000
+
+#define EUSCI_A_CTLW0_SWRST                 0x0001
+#define EUSCI_A_IFG_RXIFG                   0x0001
+#define EUSCI_A_IFG_TXIFG                   0x0002
+#define EUSCI_A_STATW_OE                    0x0020
+
+#define RSTCTL_PSSRESET_CLR_CLR             0x00000001
+#define RSTCTL_PCMRESET_CLR_CLR             0x00000001
+#define RSTCTL_PINRESET_CLR_CLR             0x00000001
+#define RSTCTL_REBOOTRESET_CLR_CLR          0x00000001
+#define RSTCTL_CSRESET_CLR_CLR              0x00000001
+
+#define DWT_CTRL_CYCCNTENA_Msk              0x00000001
+#define CoreDebug_DEMCR_TRCENA_Msk          0x01000000
+#define SCB_SCR_SLEEPDEEP_Msk               0x00000004
+
+/******************************************************************************
+* Compiler intrinsics and CMSIS functions
+******************************************************************************/
+
+uint32_t Sim_Get_PRIMASK();
+void Sim_Set_PRIMASK(uint32_t primask);
+uint32_t Sim_Get_BASEPRI();
+void Sim_Set_BASEPRI(uint32_t basepri);
+void Sim_Wait_For_Interrupt();
+void Sim_System_Reset();
+
+static inline uint32_t _disable_interrupts()
+{
+    uint32_t primask = Sim_Get_PRIMASK();
+    Sim_Set_PRIMASK(1);
+    return primask;
+}
+
+static inline uint32_t _enable_interrupts()
+{
+    uint32_t primask = Sim_Get_PRIMASK();
+    Sim_Set_PRIMASK(0);
+    return primask;
+}
+
+static inline void _restore_interrupts(uint32_t primask)
+{
+    Sim_Set_PRIMASK(primask);
+}
+
+static inline uint32_t _set_interrupt_priority(uint32_t basepri)
+{
+    uint32_t previous = Sim_Get_BASEPRI();
+    Sim_Set_BASEPRI(basepri & 0xFF);
+    return previous;
+}
+
+static inline uint32_t _norm(uint32_t value)
+{
+    return (value != 0) ? (uint32_t)__builtin_clz(value) : 32;
+}
+
+// The host runs the drivers on a single thread, so an exclusive store never fails
+static inline uint32_t __ldrex(void *address)
+{
+    return *(volatile uint32_t *)address;
+}
+
+static inline uint32_t __strex(uint32_t value, void *address)
+{
+    *(volatile uint32_t *)address = value;
+    return 0;
+}
+
+static inline void __WFI()
+{
+    Sim_Wait_For_Interrupt();
+}
+
+static inline void NVIC_SystemReset()
+{
+    Sim_System_Reset();
+}
+
+#endif /* HOST_MSP_H_ */
@@ -0,0 +1,301 @@
+/**
+ * @file main.cpp
+ * @brief Host runner of the GPIO drivers on the simulated MSP432P401R.
+ *
+ * This program runs the main loop of GPIO/main.c on the host with the unchanged driver sources and the
+ * peripheral models of the Sim module (see inc/Sim.h). It prints the changes of the LED outputs and the
+ * characters transmitted by EUSCI_A0 with their virtual time, followed by the cost accounting of the run.
+ *
+ * The flash log, deep sleep, SRAM power, ISR latency and sampling modules are target-only and are not part
+ * of the host build, so the loop does not save the LED state and never enters deep sleep.
+ *
+ * Usage: gpio_sim [options]
+ *  -t <ms>                   Virtual time to simulate, counted in 48 MHz cycles (default 5000 ms, 0 for no limit)
+ *  -b <ms>:<buttons>         Drive the user buttons (P1.1 and P1.4, active low) to a hex value at a given time
+ *  -s <ms>:<switches>        Drive the PMOD SWT switches (P10.0 to P10.3) to a hex value at a given time
+ *  -u <ms>:<text>            Send text to EUSCI_A0 at a given time (for example -u 1000:n to dump the counters).
+ *                            As on the board, characters that the main loop does not read in time are overrun
+ *  -w <file>                 Write the port trace (see Port_Trace.h) to a file for tools/trace_compare.py
+ *  -q                        Do not print the output trace
+ *  -p                        Connect EUSCI_A0 to a pseudo-terminal (see inc/PTY.h) and print its path on stderr
+ *  -l <path>                 Same as -p, and create a symbolic link to the pseudo-terminal
+ *  -r <speed>                Pace the virtual time to speed times the wall-clock time (default 0: no pacing)
+ *  -e                        Run the patterns with LED_Controller_Step and Clock_Delay1ms, as the event-driven main
+ *                            loop of the board does with its timer (see Reactor.h), instead of LED_Controller
+ *
+ * Example: gpio_sim -t 3000 -s 0:0x1 -s 1500:0x2
+ *          gpio_sim -t 0 -q -l /tmp/gpio_sim -r 1     (then: picocom /tmp/gpio_sim)
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+#include "inc/PTY.h"
+#include "inc/Sim.h"
+#include "../GPIO/inc/Clock.h"
+#include "../GPIO/inc/EUSCI_A0_UART.h"
+#include "../GPIO/inc/Flight_Recorder.h"
+#include "../GPIO/inc/GPIO.h"
+#include "../GPIO/inc/LED_Energy.h"
+#include "../GPIO/inc/Loop_Stats.h"
+#include "../GPIO/inc/Perf_Counter.h"
+#include "../GPIO/inc/Port_Trace.h"
+#include "../GPIO/inc/UART_Command.h"
+
+static uint8_t Quiet;
+static uint8_t Step_Patterns;
+static uint8_t UART_Line_Start = 1;
+static std::vector<Port_Trace_Entry> Trace;
+
+static void Print_Time()
+{
+    printf("%12.3f ms  ", (double)Sim_Get_Time_ns() / 1e6);
+}
+
+static void Trace_Output(uint64_t cycles, uint8_t port, uint8_t value)
+{
+    if (Quiet || ((port != 1) && (port != 2) && (port != 9)))
+    {
+        return;
+    }
+    Print_Time();
+    printf("P%u->OUT = 0x%02X\n", port, value);
+}
+
+static void Trace_UART(uint64_t cycles, uint8_t data)
+{
+    if (PTY_Get_Name() != 0)
+    {
+        PTY_Transmit(data);
+    }
+    if (Quiet || (data == '\r'))
+    {
+        return;
+    }
+    if (UART_Line_Start)
+    {
+        Print_Time();
+        printf("UART: ");
+        UART_Line_Start = 0;
+    }
+    putchar(data);
+    if (data == '\n')
+    {
+        UART_Line_Start = 1;
+    }
+}
+
+static uint64_t Parse_Time(const char *arg, const char **rest)
+{
+    char *end;
+    uint64_t ms = strtoull(arg, &end, 10);
+
+    if (*end != ':')
+    {
+        fprintf(stderr, "expected <ms>:<value>, got '%s'\n", arg);
+        exit(2);
+    }
+    *rest = end + 1;
+
+    // The clock runs at 48 MHz after Clock_Init48MHz
+    return ms * 48000;
+}
+
+static void Drain_Trace()
+{
+    Port_Trace_Entry entries[64];
+    uint32_t count;
+
+    while ((count = Port_Trace_Read(entries, 64)) != 0)
+    {
+        Trace.insert(Trace.end(), entries, entries + count);
+    }
+}
+
+// Same format as Port_Trace_Dump
+static void Write_Trace(const char *path)
+{
+    FILE *file = fopen(path, "w");
+
+    if (file == 0)
+    {
+        perror(path);
+        exit(1);
+    }
+    Drain_Trace();
+    fprintf(file, "Port trace: freq=%u count=%zu lost=%u\n", Clock_GetFreq(), Trace.size(), Port_Trace_Get_Lost());
+    for (size_t i = 0; i < Trace.size(); i++)
+    {
+        fprintf(file, "%X %u %X\n", Trace[i].timestamp, Trace[i].port, Trace[i].value);
+    }
+    fprintf(file, "Port trace: end\n");
+    fclose(file);
+}
+
+static void Print_Stats()
+{
+    static const char * const names[SIM_NUM_PERIPHERALS] = { "ports", "CS", "PCM", "FLCTL", "EUSCI_A0", "RSTCTL", "core" };
+    Sim_Stats stats;
+
+    Sim_Get_Stats(&stats);
+    printf("\nvirtual time      %llu cycles (%.3f ms)\n", (unsigned long long)stats.cycles, (double)Sim_Get_Time_ns() / 1e6);
+    printf("register accesses %llu cycles\n", (unsigned long long)stats.register_cycles);
+    printf("delay loops       %llu cycles\n", (unsigned long long)stats.delay_cycles);
+    printf("sleep             %llu cycles\n", (unsigned long long)stats.sleep_cycles);
+    for (int i = 0; i < SIM_NUM_PERIPHERALS; i++)
+    {
+        printf("%-17s %u reads, %u writes\n", names[i], stats.reads[i], stats.writes[i]);
+    }
+    printf("violations        %u%s%s\n", stats.violations, stats.violations ? ", last: " : "", Sim_Get_Last_Violation());
+    printf("UART overruns     %u\n", stats.uart_overruns);
+    if (PTY_Get_Name() != 0)
+    {
+        printf("PTY dropped       %u\n", PTY_Get_Dropped());
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    uint64_t limit_ms = 5000;
+    const char *trace_path = 0;
+    const char *pty_link = 0;
+    uint8_t pty = 0;
+    double speed = 0;
+    int option;
+
+    Sim_Reset();
+
+    while ((option = getopt(argc, argv, "t:b:s:u:w:qpl:r:e")) != -1)
+    {
+        const char *value;
+        uint64_t cycles;
+
+        switch (option)
+        {
+            case 't':
+                limit_ms = strtoull(optarg, 0, 10);
+                break;
+            case 'b':
+                cycles = Parse_Time(optarg, &value);
+                Sim_Schedule_Input(cycles, 1, 0x12, strtoul(value, 0, 16));
+                break;
+            case 's':
+                cycles = Parse_Time(optarg, &value);
+                Sim_Schedule_Input(cycles, 10, 0x0F, strtoul(value, 0, 16));
+                break;
+            case 'u':
+                cycles = Parse_Time(optarg, &value);
+                Sim_Schedule_UART_RX(cycles, (const uint8_t *)value, strlen(value), 0);
+                break;
+            case 'w':
+                trace_path = optarg;
+                break;
+            case 'q':
+                Quiet = 1;
+                break;
+            case 'l':
+                pty_link = optarg;
+                pty = 1;
+                break;
+            case 'p':
+                pty = 1;
+                break;
+            case 'r':
+                speed = strtod(optarg, 0);
+                break;
+            case 'e':
+                Step_Patterns = 1;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-t ms] [-b ms:buttons] [-s ms:switches] [-u ms:text] [-w file] [-q]"
+                                " [-p] [-l path] [-r speed] [-e]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    Sim_Set_Output_Observer(Trace_Output);
+    Sim_Set_UART_Observer(Trace_UART);
+    Sim_Set_Time_Limit(limit_ms * 48000);
+
+    if (pty)
+    {
+        if (PTY_Open(pty_link) != 0)
+        {
+            return 1;
+        }
+        fprintf(stderr, "EUSCI_A0 connected to %s\n", PTY_Get_Name());
+    }
+    PTY_Set_Speed(speed);
+
+    try
+    {
+        Flight_Recorder_Init();
+        Perf_Counter_Init();
+        Clock_Init48MHz();
+        Port_Trace_Init();
+
+        LED1_Init();
+        LED2_Init();
+        Buttons_Init();
+        PMOD_8LD_Init();
+        PMOD_SWT_Init();
+
+        EUSCI_A0_UART_Init();
+        UART_Command_Register('f', Flight_Recorder_Dump_Previous);
+        LED_Energy_Init();
+        LED_Energy_Set_Pattern(LED_Get_Active_Pattern());
+        Loop_Stats_Init((Clock_GetFreq() / 1000) * 110);
+
+        while (1)
+        {
+            Loop_Stats_Begin();
+
+            uint8_t button_status = Get_Buttons_Status();
+            uint8_t switch_status = Get_PMOD_SWT_Status();
+            Loop_Stats_Mark(LOOP_STATS_INPUT);
+
+            if (Step_Patterns)
+            {
+                uint32_t delay = LED_Controller_Step(button_status, switch_status);
+                while (delay != 0)
+                {
+                    Clock_Delay1ms(delay);
+                    delay = LED_Controller_Step(button_status, switch_status);
+                }
+            }
+            else
+            {
+                LED_Controller(button_status, switch_status);
+            }
+            Loop_Stats_Mark(LOOP_STATS_CONTROLLER);
+
+            Clock_Delay1ms(100);
+            Loop_Stats_Mark(LOOP_STATS_DELAY);
+
+            UART_Command_Poll();
+            Perf_Counter_Update();
+            LED_Energy_Update();
+            Drain_Trace();
+        }
+    }
+    catch (Sim_Stop reason)
+    {
+        static const char * const reasons[] = { "time limit", "system reset", "sleep without wake-up event" };
+        if (!UART_Line_Start)
+        {
+            putchar('\n');
+        }
+        printf("\nstopped: %s\n", reasons[reason]);
+    }
+
+    Print_Stats();
+    if (trace_path)
+    {
+        Write_Trace(trace_path);
+    }
+    PTY_Close();
+    return 0;
+}
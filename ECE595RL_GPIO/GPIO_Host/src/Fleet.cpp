@@ -0,0 +1,434 @@
+/**
+ * @file Fleet.cpp
+ * @brief Source code for the Fleet module.
+ *
+ * This file contains the function definitions for the Fleet module.
+ *
+ * The wait counts are the delays of GPIO.c in ticks. A segment that returns to the main loop adds the
+ * 100 ms delay of the main loop (one tick) to its wait count.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../inc/Fleet.h"
+
+// Values written by LED_Pattern_1 to LED_Pattern_5 (see GPIO.c)
+#define RED_LED_ON          0x01
+#define RGB_LED_RED         0x01
+#define RGB_LED_GREEN       0x02
+#define RGB_LED_BLUE        0x04
+#define RGB_LED_PINK        0x05
+#define BUTTONS_RELEASED    0x12
+
+static uint8_t *Fleet_Alloc8(uint32_t count)
+{
+    uint8_t *array = (uint8_t *)aligned_alloc(FLEET_BOARD_ALIGN, count);
+    memset(array, 0, count);
+    return array;
+}
+
+static uint32_t *Fleet_Alloc32(uint32_t count)
+{
+    uint32_t *array = (uint32_t *)aligned_alloc(FLEET_BOARD_ALIGN, count * sizeof(uint32_t));
+    memset(array, 0, count * sizeof(uint32_t));
+    return array;
+}
+
+void Fleet_Init(Fleet *fleet, uint32_t count, uint32_t seed)
+{
+    count = (count + FLEET_BOARD_ALIGN - 1) & ~(FLEET_BOARD_ALIGN - 1);
+
+    fleet->count = count;
+    fleet->phase = Fleet_Alloc8(count);
+    fleet->wait = Fleet_Alloc8(count);
+    fleet->counter = Fleet_Alloc8(count);
+    fleet->pattern = Fleet_Alloc8(count);
+    fleet->led1 = Fleet_Alloc8(count);
+    fleet->rgb = Fleet_Alloc8(count);
+    fleet->pmod = Fleet_Alloc8(count);
+    fleet->buttons = Fleet_Alloc8(count);
+    fleet->switches = Fleet_Alloc8(count);
+    fleet->random = Fleet_Alloc32(count);
+    fleet->writes = Fleet_Alloc32(count);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        fleet->pattern[i] = 1;
+        fleet->buttons[i] = BUTTONS_RELEASED;
+
+        // Xorshift generators must not start at 0
+        uint32_t state = seed ^ (i * 0x9E3779B9u);
+        fleet->random[i] = (state != 0) ? state : 1;
+    }
+}
+
+void Fleet_Free(Fleet *fleet)
+{
+    free(fleet->phase);
+    free(fleet->wait);
+    free(fleet->counter);
+    free(fleet->pattern);
+    free(fleet->led1);
+    free(fleet->rgb);
+    free(fleet->pmod);
+    free(fleet->buttons);
+    free(fleet->switches);
+    free(fleet->random);
+    free(fleet->writes);
+    memset(fleet, 0, sizeof(*fleet));
+}
+
+void Fleet_Set_Inputs(Fleet *fleet, uint32_t begin, uint32_t end, uint8_t mask, uint8_t buttons, uint8_t switches)
+{
+    if (mask & 1)
+    {
+        memset(fleet->buttons + begin, buttons, end - begin);
+    }
+    if (mask & 2)
+    {
+        memset(fleet->switches + begin, switches, end - begin);
+    }
+}
+
+// GCC only relies on restrict for function parameters, so the loops of Fleet_Randomize_Inputs and Fleet_Step
+// take the arrays as parameters
+static void Fleet_Randomize_Kernel(size_t count, uint32_t threshold, uint32_t * __restrict random,
+                                   uint8_t * __restrict buttons, uint8_t * __restrict switches)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t x = random[i];
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        random[i] = x;
+
+        uint32_t select = (x >> 16) & 0x7;
+        uint8_t new_switches = ((select - 1) < 4) ? (uint8_t)(1u << (select - 1)) : 0x0;
+        uint8_t new_buttons = (((x >> 20) & 1) ? 0x10 : 0) | (((x >> 21) & 1) ? 0x02 : 0);
+        uint8_t change = (x & 0xFFFF) < threshold;
+
+        switches[i] = change ? new_switches : switches[i];
+        buttons[i] = change ? new_buttons : buttons[i];
+    }
+}
+
+void Fleet_Randomize_Inputs(Fleet *fleet, uint32_t begin, uint32_t end, uint32_t threshold)
+{
+    Fleet_Randomize_Kernel(end - begin, threshold, fleet->random + begin, fleet->buttons + begin, fleet->switches + begin);
+}
+
+// Returns a if condition is 1 and b if it is 0. GCC does not if-convert long chains of the ?: operator (a
+// PHI node with more than 4 arguments), so Fleet_Step selects its values with masks.
+static inline uint8_t Fleet_Select(uint8_t condition, uint8_t a, uint8_t b)
+{
+    return b ^ ((a ^ b) & (uint8_t)-condition);
+}
+
+static void Fleet_Step_Kernel(size_t count, uint8_t * __restrict phase, uint8_t * __restrict wait,
+                              uint8_t * __restrict counter, uint8_t * __restrict pattern, uint8_t * __restrict led1,
+                              uint8_t * __restrict rgb, uint8_t * __restrict pmod, const uint8_t * __restrict buttons,
+                              const uint8_t * __restrict switches, uint32_t * __restrict writes)
+{
+    // Every candidate state is computed and the matching one is selected, so the loop has no branch
+    for (size_t i = 0; i < count; i++)
+    {
+        uint8_t ph = phase[i];
+        uint8_t cnt = counter[i];
+        uint8_t l1 = led1[i];
+        uint8_t rg = rgb[i];
+        uint8_t p9 = pmod[i];
+        uint8_t sw = switches[i];
+        uint8_t bt = buttons[i];
+
+        // FLEET_PHASE_TOP: LED_Controller
+        uint8_t p2 = (sw == 0x1);
+        uint8_t p3 = (sw == 0x2);
+        uint8_t p4 = (sw == 0x4);
+        uint8_t p5 = (sw == 0x8);
+        uint8_t p1 = !(p2 | p3 | p4 | p5);
+        uint8_t pat = Fleet_Select(p2, 2, Fleet_Select(p3, 3, Fleet_Select(p4, 4, Fleet_Select(p5, 5, 1))));
+        uint8_t both = p1 & (bt == 0x00);
+        uint8_t b1 = p1 & (bt == 0x10);
+        uint8_t b2 = p1 & (bt == 0x02);
+        uint8_t none = p1 & (bt == BUTTONS_RELEASED);
+
+        uint8_t top_l1 = Fleet_Select(both | b1 | p2 | p4, RED_LED_ON, Fleet_Select(b2 | none | p3 | p5, 0, l1));
+        uint8_t top_rg = Fleet_Select(both, RGB_LED_GREEN, Fleet_Select(b2, RGB_LED_PINK, Fleet_Select(p2, RGB_LED_RED,
+                         Fleet_Select(p3 | p4, RGB_LED_BLUE, Fleet_Select(b1 | none | p5, 0, rg)))));
+        uint8_t top_p9 = Fleet_Select(both | p2, 0x00, Fleet_Select(b1, 0x55, Fleet_Select(b2, 0xAA,
+                         Fleet_Select(none | p3 | p4, 0xFF, Fleet_Select(p5, 0x01, p9)))));
+        uint8_t top_cnt = Fleet_Select(p2, 0, Fleet_Select(p3, 0xFF, Fleet_Select(p5, 1, cnt)));
+        uint8_t top_w = Fleet_Select(both | p4, 10, Fleet_Select(p5, 5, 1));
+        uint8_t top_ph = Fleet_Select(both, FLEET_PHASE_PATTERN_1_ON, Fleet_Select(p2, FLEET_PHASE_PATTERN_2,
+                         Fleet_Select(p3, FLEET_PHASE_PATTERN_3, Fleet_Select(p4, FLEET_PHASE_PATTERN_4_ON,
+                         Fleet_Select(p5, FLEET_PHASE_PATTERN_5, FLEET_PHASE_TOP)))));
+
+        // Loops of LED_Pattern_2, 3, 4 and 5
+        uint8_t is_top = (ph == FLEET_PHASE_TOP);
+        uint8_t is_p1 = (ph == FLEET_PHASE_PATTERN_1_ON);
+        uint8_t is_p4_on = (ph == FLEET_PHASE_PATTERN_4_ON);
+        uint8_t up = (ph == FLEET_PHASE_PATTERN_2) & p2 & (cnt != 0xFF);
+        uint8_t down = (ph == FLEET_PHASE_PATTERN_3) & p3 & (cnt != 0x00);
+        uint8_t again = (ph == FLEET_PHASE_PATTERN_4_OFF) & p4;
+        uint8_t shift = (ph == FLEET_PHASE_PATTERN_5) & p5 & (cnt != 0x80);
+
+        uint8_t n_cnt = Fleet_Select(is_top, top_cnt, Fleet_Select(up, cnt + 1, Fleet_Select(down, cnt - 1,
+                        Fleet_Select(shift, cnt << 1, cnt))));
+        uint8_t n_l1 = Fleet_Select(is_top, top_l1, Fleet_Select(is_p1 | is_p4_on, 0, Fleet_Select(again, RED_LED_ON, l1)));
+        uint8_t n_rg = Fleet_Select(is_top, top_rg, Fleet_Select(is_p1 | is_p4_on, 0, Fleet_Select(again, RGB_LED_BLUE, rg)));
+        uint8_t n_p9 = Fleet_Select(is_top, top_p9, Fleet_Select(up | down | shift, n_cnt,
+                       Fleet_Select(is_p4_on, 0x00, Fleet_Select(again, 0xFF, p9))));
+        uint8_t n_w = Fleet_Select(is_top, top_w, Fleet_Select(is_p1, 11, Fleet_Select(is_p4_on | again, 10,
+                      Fleet_Select(shift, 5, 1))));
+        uint8_t n_ph = Fleet_Select(is_top, top_ph, Fleet_Select(up, FLEET_PHASE_PATTERN_2, Fleet_Select(down, FLEET_PHASE_PATTERN_3,
+                       Fleet_Select(is_p4_on, FLEET_PHASE_PATTERN_4_OFF, Fleet_Select(again, FLEET_PHASE_PATTERN_4_ON,
+                       Fleet_Select(shift, FLEET_PHASE_PATTERN_5, FLEET_PHASE_TOP))))));
+
+        // Only the boards whose wait counter has expired execute a segment
+        uint8_t run = (wait[i] == 0);
+        writes[i] += run * ((n_l1 != l1) + (n_rg != rg) + (n_p9 != p9));
+        phase[i] = Fleet_Select(run, n_ph, ph);
+        counter[i] = Fleet_Select(run, n_cnt, cnt);
+        pattern[i] = Fleet_Select(run & is_top, pat, pattern[i]);
+        led1[i] = Fleet_Select(run, n_l1, l1);
+        rgb[i] = Fleet_Select(run, n_rg, rg);
+        pmod[i] = Fleet_Select(run, n_p9, p9);
+        wait[i] = Fleet_Select(run, n_w, wait[i]) - 1;
+    }
+}
+
+void Fleet_Step(Fleet *fleet, uint32_t begin, uint32_t end)
+{
+    Fleet_Step_Kernel(end - begin, fleet->phase + begin, fleet->wait + begin, fleet->counter + begin,
+                      fleet->pattern + begin, fleet->led1 + begin, fleet->rgb + begin, fleet->pmod + begin,
+                      fleet->buttons + begin, fleet->switches + begin, fleet->writes + begin);
+}
+
+typedef struct
+{
+    Fleet *fleet;
+    uint32_t board;
+    uint64_t tick;
+    Fleet_Write_Callback callback;
+    void *context;
+} Fleet_Reference_Board;
+
+static void Fleet_LED1_Output(Fleet_Reference_Board *b, uint8_t value)
+{
+    if (b->fleet->led1[b->board] != value)
+    {
+        b->fleet->led1[b->board] = value;
+        b->fleet->writes[b->board]++;
+        if (b->callback)
+        {
+            b->callback(b->context, b->tick, 1, BUTTONS_RELEASED | value);
+        }
+    }
+}
+
+static void Fleet_LED2_Output(Fleet_Reference_Board *b, uint8_t value)
+{
+    if (b->fleet->rgb[b->board] != value)
+    {
+        b->fleet->rgb[b->board] = value;
+        b->fleet->writes[b->board]++;
+        if (b->callback)
+        {
+            b->callback(b->context, b->tick, 2, value);
+        }
+    }
+}
+
+static void Fleet_PMOD_8LD_Output(Fleet_Reference_Board *b, uint8_t value)
+{
+    if (b->fleet->pmod[b->board] != value)
+    {
+        b->fleet->pmod[b->board] = value;
+        b->fleet->writes[b->board]++;
+        if (b->callback)
+        {
+            b->callback(b->context, b->tick, 9, value);
+        }
+    }
+}
+
+void Fleet_Step_Reference(Fleet *fleet, uint32_t board, uint64_t tick, Fleet_Write_Callback callback, void *context)
+{
+    Fleet_Reference_Board b = { fleet, board, tick, callback, context };
+    uint8_t switches = fleet->switches[board];
+    uint8_t *counter = &fleet->counter[board];
+    uint8_t *phase = &fleet->phase[board];
+    uint8_t *wait = &fleet->wait[board];
+
+    if (*wait != 0)
+    {
+        (*wait)--;
+        return;
+    }
+
+    // Each case ends at the next delay of GPIO.c; the main loop delay counts as one tick
+    switch (*phase)
+    {
+        case FLEET_PHASE_TOP:
+        {
+            uint8_t buttons = fleet->buttons[board];
+            *wait = 1;
+
+            switch (switches)
+            {
+                case 0x1:
+                    fleet->pattern[board] = 2;
+                    Fleet_LED1_Output(&b, RED_LED_ON);
+                    Fleet_LED2_Output(&b, RGB_LED_RED);
+                    *counter = 0;
+                    Fleet_PMOD_8LD_Output(&b, *counter);
+                    *phase = FLEET_PHASE_PATTERN_2;
+                    break;
+
+                case 0x2:
+                    fleet->pattern[board] = 3;
+                    Fleet_LED1_Output(&b, 0);
+                    Fleet_LED2_Output(&b, RGB_LED_BLUE);
+                    *counter = 0xFF;
+                    Fleet_PMOD_8LD_Output(&b, *counter);
+                    *phase = FLEET_PHASE_PATTERN_3;
+                    break;
+
+                case 0x4:
+                    fleet->pattern[board] = 4;
+                    Fleet_PMOD_8LD_Output(&b, 0xFF);
+                    Fleet_LED1_Output(&b, RED_LED_ON);
+                    Fleet_LED2_Output(&b, RGB_LED_BLUE);
+                    *wait = 10;
+                    *phase = FLEET_PHASE_PATTERN_4_ON;
+                    break;
+
+                case 0x8:
+                    fleet->pattern[board] = 5;
+                    Fleet_LED1_Output(&b, 0);
+                    Fleet_LED2_Output(&b, 0);
+                    *counter = 0x01;
+                    Fleet_PMOD_8LD_Output(&b, *counter);
+                    *wait = 5;
+                    *phase = FLEET_PHASE_PATTERN_5;
+                    break;
+
+                default:
+                    fleet->pattern[board] = 1;
+                    if (buttons == 0x00)
+                    {
+                        Fleet_PMOD_8LD_Output(&b, 0x00);
+                        Fleet_LED1_Output(&b, RED_LED_ON);
+                        Fleet_LED2_Output(&b, RGB_LED_GREEN);
+                        *wait = 10;
+                        *phase = FLEET_PHASE_PATTERN_1_ON;
+                    }
+                    else if (buttons == 0x10)
+                    {
+                        Fleet_LED1_Output(&b, RED_LED_ON);
+                        Fleet_LED2_Output(&b, 0);
+                        Fleet_PMOD_8LD_Output(&b, 0x55);
+                    }
+                    else if (buttons == 0x02)
+                    {
+                        Fleet_LED1_Output(&b, 0);
+                        Fleet_LED2_Output(&b, RGB_LED_PINK);
+                        Fleet_PMOD_8LD_Output(&b, 0xAA);
+                    }
+                    else if (buttons == BUTTONS_RELEASED)
+                    {
+                        Fleet_LED1_Output(&b, 0);
+                        Fleet_LED2_Output(&b, 0);
+                        Fleet_PMOD_8LD_Output(&b, 0xFF);
+                    }
+                    break;
+            }
+            break;
+        }
+
+        case FLEET_PHASE_PATTERN_1_ON:
+            Fleet_LED1_Output(&b, 0);
+            Fleet_LED2_Output(&b, 0);
+            *wait = 11;
+            *phase = FLEET_PHASE_TOP;
+            break;
+
+        case FLEET_PHASE_PATTERN_2:
+            *wait = 1;
+            *phase = FLEET_PHASE_TOP;
+            if ((switches == 0x1) && (*counter != 0xFF))
+            {
+                (*counter)++;
+                Fleet_PMOD_8LD_Output(&b, *counter);
+                *phase = FLEET_PHASE_PATTERN_2;
+            }
+            break;
+
+        case FLEET_PHASE_PATTERN_3:
+            *wait = 1;
+            *phase = FLEET_PHASE_TOP;
+            if ((switches == 0x2) && (*counter != 0x00))
+            {
+                (*counter)--;
+                Fleet_PMOD_8LD_Output(&b, *counter);
+                *phase = FLEET_PHASE_PATTERN_3;
+            }
+            break;
+
+        case FLEET_PHASE_PATTERN_4_ON:
+            Fleet_PMOD_8LD_Output(&b, 0x00);
+            Fleet_LED1_Output(&b, 0);
+            Fleet_LED2_Output(&b, 0);
+            *wait = 10;
+            *phase = FLEET_PHASE_PATTERN_4_OFF;
+            break;
+
+        case FLEET_PHASE_PATTERN_4_OFF:
+            *wait = 1;
+            *phase = FLEET_PHASE_TOP;
+            if (switches == 0x4)
+            {
+                Fleet_PMOD_8LD_Output(&b, 0xFF);
+                Fleet_LED1_Output(&b, RED_LED_ON);
+                Fleet_LED2_Output(&b, RGB_LED_BLUE);
+                *wait = 10;
+                *phase = FLEET_PHASE_PATTERN_4_ON;
+            }
+            break;
+
+        case FLEET_PHASE_PATTERN_5:
+            *wait = 1;
+            *phase = FLEET_PHASE_TOP;
+            if ((switches == 0x8) && (*counter != 0x80))
+            {
+                *counter <<= 1;
+                Fleet_PMOD_8LD_Output(&b, *counter);
+                *wait = 5;
+                *phase = FLEET_PHASE_PATTERN_5;
+            }
+            break;
+    }
+    (*wait)--;
+}
+
+uint64_t Fleet_Hash(const Fleet *fleet, uint32_t begin, uint32_t end)
+{
+    const uint8_t * const fields[] =
+    {
+        fleet->phase, fleet->wait, fleet->counter, fleet->pattern, fleet->led1, fleet->rgb, fleet->pmod,
+        fleet->buttons, fleet->switches, (const uint8_t *)fleet->random, (const uint8_t *)fleet->writes
+    };
+    const uint32_t sizes[] = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 4, 4 };
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    for (uint32_t f = 0; f < sizeof(sizes) / sizeof(sizes[0]); f++)
+    {
+        for (uint32_t i = begin * sizes[f]; i < end * sizes[f]; i++)
+        {
+            hash = (hash ^ fields[f][i]) * 0x100000001B3ull;
+        }
+    }
+    return hash;
+}
@@ -0,0 +1,188 @@
+/**
+ * @file PTY.cpp
+ * @brief Source code for the PTY module.
+ *
+ * This file contains the function definitions for the PTY module.
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "../inc/PTY.h"
+#include "../inc/Sim.h"
+
+static int PTY_Master = -1;
+static int PTY_Slave = -1;
+static char PTY_Name[64];
+static char PTY_Link[256];
+static double PTY_Speed;
+static uint32_t PTY_Dropped;
+
+// Wall-clock and virtual time when the pacing started
+static uint8_t PTY_Paced;
+static uint64_t PTY_Wall_Start_ns;
+static uint64_t PTY_Virtual_Start_ns;
+
+static uint64_t PTY_Wall_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+// Removes the symbolic link when gpio_sim is stopped with Ctrl-C
+static void PTY_Signal(int signal_number)
+{
+    if (PTY_Link[0] != '\0')
+    {
+        unlink(PTY_Link);
+    }
+    signal(signal_number, SIG_DFL);
+    raise(signal_number);
+}
+
+int PTY_Open(const char *link)
+{
+    struct termios settings;
+
+    PTY_Master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if ((PTY_Master < 0) || (grantpt(PTY_Master) != 0) || (unlockpt(PTY_Master) != 0))
+    {
+        perror("posix_openpt");
+        PTY_Close();
+        return -1;
+    }
+    strncpy(PTY_Name, ptsname(PTY_Master), sizeof(PTY_Name) - 1);
+
+    // Keep the slave side open, so that the master does not report a hang-up between two host tools
+    PTY_Slave = open(PTY_Name, O_RDWR | O_NOCTTY);
+    if ((PTY_Slave < 0) || (tcgetattr(PTY_Slave, &settings) != 0))
+    {
+        perror(PTY_Name);
+        PTY_Close();
+        return -1;
+    }
+    cfmakeraw(&settings);
+    cfsetispeed(&settings, B115200);
+    cfsetospeed(&settings, B115200);
+    tcsetattr(PTY_Slave, TCSANOW, &settings);
+
+    if (link != 0)
+    {
+        unlink(link);
+        if (symlink(PTY_Name, link) != 0)
+        {
+            perror(link);
+            PTY_Close();
+            return -1;
+        }
+        strncpy(PTY_Link, link, sizeof(PTY_Link) - 1);
+        signal(SIGINT, PTY_Signal);
+        signal(SIGTERM, PTY_Signal);
+    }
+
+    PTY_Dropped = 0;
+    PTY_Paced = 0;
+    Sim_Set_Poll_Callback(PTY_Poll, PTY_POLL_PERIOD_NS);
+    return 0;
+}
+
+void PTY_Close()
+{
+    Sim_Set_Poll_Callback(0, 0);
+    if (PTY_Link[0] != '\0')
+    {
+        unlink(PTY_Link);
+        PTY_Link[0] = '\0';
+    }
+    if (PTY_Slave >= 0)
+    {
+        close(PTY_Slave);
+        PTY_Slave = -1;
+    }
+    if (PTY_Master >= 0)
+    {
+        close(PTY_Master);
+        PTY_Master = -1;
+    }
+    PTY_Name[0] = '\0';
+}
+
+const char *PTY_Get_Name()
+{
+    return (PTY_Master >= 0) ? PTY_Name : 0;
+}
+
+void PTY_Set_Speed(double speed)
+{
+    PTY_Speed = speed;
+    PTY_Paced = 0;
+
+    // The pacing also applies to runs without a pseudo-terminal
+    if ((speed > 0) || (PTY_Master >= 0))
+    {
+        Sim_Set_Poll_Callback(PTY_Poll, PTY_POLL_PERIOD_NS);
+    }
+}
+
+void PTY_Transmit(uint8_t data)
+{
+    if ((PTY_Master < 0) || (write(PTY_Master, &data, 1) != 1))
+    {
+        PTY_Dropped++;
+    }
+}
+
+void PTY_Poll(uint64_t cycles)
+{
+    uint8_t buffer[256];
+    ssize_t count;
+
+    if (PTY_Speed > 0)
+    {
+        uint64_t virtual_ns = Sim_Get_Time_ns();
+
+        if (!PTY_Paced)
+        {
+            PTY_Wall_Start_ns = PTY_Wall_ns();
+            PTY_Virtual_Start_ns = virtual_ns;
+            PTY_Paced = 1;
+        }
+
+        // Wait until the wall-clock time catches up, or until the host sends a character
+        uint64_t target_ns = PTY_Wall_Start_ns + (uint64_t)((virtual_ns - PTY_Virtual_Start_ns) / PTY_Speed);
+        uint64_t now_ns = PTY_Wall_ns();
+        if (target_ns > now_ns)
+        {
+            struct pollfd input = { PTY_Master, POLLIN, 0 };          // Ignored if PTY_Master is -1
+            struct timespec timeout = { (time_t)((target_ns - now_ns) / 1000000000ull), (long)((target_ns - now_ns) % 1000000000ull) };
+            ppoll(&input, 1, &timeout, 0);
+        }
+    }
+
+    if (PTY_Master < 0)
+    {
+        return;
+    }
+    while ((count = read(PTY_Master, buffer, sizeof(buffer))) > 0)
+    {
+        Sim_Push_UART_RX(buffer, (size_t)count);
+    }
+    if ((count < 0) && (errno != EAGAIN) && (errno != EIO))
+    {
+        perror(PTY_Name);
+    }
+}
+
+uint32_t PTY_Get_Dropped()
+{
+    return PTY_Dropped;
+}
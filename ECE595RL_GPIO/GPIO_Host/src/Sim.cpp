@@ -0,0 +1,800 @@
+/**
+ * @file Sim.cpp
+ * @brief Source code for the Sim module.
+ *
+ * This file contains the function definitions for the Sim module.
+ *
+ * The register reset values and behaviours follow the MSP432Pxx Microcontrollers Technical Reference Manual
+ * for the bits that the drivers use.
+ *
+ */
+
+#include <map>
+#include <deque>
+#include <string.h>
+#include "../inc/Sim.h"
+#include "../../GPIO/inc/Boot.h"
+#include "../../GPIO/inc/Critical_Section.h"
+
+DIO_PORT_Type Sim_P1, Sim_P2, Sim_P3, Sim_P4, Sim_P5, Sim_P6, Sim_P7, Sim_P8, Sim_P9, Sim_P10, Sim_PJ;
+CS_Type Sim_CS;
+PCM_Type Sim_PCM;
+FLCTL_Type Sim_FLCTL;
+EUSCI_A_Type Sim_EUSCI_A0;
+RSTCTL_Type Sim_RSTCTL;
+DWT_Type Sim_DWT;
+CoreDebug_Type Sim_CoreDebug;
+SCB_Type Sim_SCB;
+
+typedef struct
+{
+    uint8_t port;
+    uint8_t mask;
+    uint8_t value;
+    uint8_t release;
+} Sim_Input_Event;
+
+typedef struct
+{
+    uint64_t arrival;
+    uint8_t data;
+    uint16_t statw;
+} Sim_UART_Char;
+
+typedef struct
+{
+    const void *base;
+    size_t size;
+    Sim_Peripheral peripheral;
+} Sim_Address_Range;
+
+static DIO_PORT_Type * const Sim_Ports[SIM_NUM_PORTS] =
+{
+    0, &Sim_P1, &Sim_P2, &Sim_P3, &Sim_P4, &Sim_P5, &Sim_P6, &Sim_P7, &Sim_P8, &Sim_P9, &Sim_P10, &Sim_PJ
+};
+
+static const Sim_Address_Range Sim_Ranges[] =
+{
+    { &Sim_CS,          sizeof(CS_Type),                SIM_PERIPHERAL_CS },
+    { &Sim_PCM,         sizeof(PCM_Type),               SIM_PERIPHERAL_PCM },
+    { &Sim_FLCTL,       sizeof(FLCTL_Type),             SIM_PERIPHERAL_FLCTL },
+    { &Sim_EUSCI_A0,    sizeof(EUSCI_A_Type),           SIM_PERIPHERAL_EUSCI_A0 },
+    { &Sim_RSTCTL,      sizeof(RSTCTL_Type),            SIM_PERIPHERAL_RSTCTL },
+};
+
+static uint64_t Sim_Cycles;
+static uint64_t Sim_Time_Limit;
+static double Sim_Time_ns;
+static Sim_Stats Sim_Statistics;
+static char Sim_Last_Violation[128];
+
+static std::multimap<uint64_t, Sim_Input_Event> Sim_Input_Events;
+static uint8_t Sim_Drive_Mask[SIM_NUM_PORTS];
+static uint8_t Sim_Drive_Value[SIM_NUM_PORTS];
+static uint8_t Sim_Observed_Output[SIM_NUM_PORTS];
+static Sim_Output_Observer Sim_Port_Observer;
+
+static uint32_t Sim_PRIMASK;
+static uint32_t Sim_BASEPRI;
+static uint32_t Sim_CYCCNT_Offset;
+
+static uint8_t Sim_CS_Unlocked;
+static uint64_t Sim_HFXT_Ready_Cycles;
+
+static uint8_t Sim_PCM_Mode;
+static uint8_t Sim_PCM_Target_Mode;
+static uint64_t Sim_PCM_Busy_Until;
+
+static uint64_t Sim_UART_TXBUF_Free_At;
+static uint64_t Sim_UART_Shift_End;
+static std::deque<Sim_UART_Char> Sim_UART_RX_Queue;
+static Sim_UART_Observer Sim_UART_TX_Observer;
+
+static Sim_Poll_Callback Sim_Poller;
+static double Sim_Poll_Period_ns;
+static double Sim_Next_Poll_ns;
+
+static void Sim_Violation(const char *description)
+{
+    Sim_Statistics.violations++;
+    strncpy(Sim_Last_Violation, description, sizeof(Sim_Last_Violation) - 1);
+}
+
+static uint8_t Sim_Port_Number(const void *reg);
+
+template <typename T>
+static void Sim_Clear(Sim_Register<T> *reg, size_t count, T reset_value)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        reg[i].value = reset_value;
+        reg[i].read_hook = 0;
+        reg[i].write_hook = 0;
+    }
+}
+
+/******************************************************************************
+* Virtual time
+******************************************************************************/
+
+void Sim_Advance(uint64_t cycles)
+{
+    uint32_t mclk = Sim_Get_MCLK_Hz();
+
+    Sim_Cycles += cycles;
+    Sim_Time_ns += (double)cycles * 1e9 / mclk;
+
+    while (!Sim_Input_Events.empty() && (Sim_Input_Events.begin()->first <= Sim_Cycles))
+    {
+        const Sim_Input_Event &event = Sim_Input_Events.begin()->second;
+        if (event.release)
+        {
+            Sim_Drive_Mask[event.port] &= ~event.mask;
+        }
+        else
+        {
+            Sim_Drive_Mask[event.port] |= event.mask;
+            Sim_Drive_Value[event.port] = (Sim_Drive_Value[event.port] & ~event.mask) | (event.value & event.mask);
+        }
+        Sim_Input_Events.erase(Sim_Input_Events.begin());
+    }
+
+    if (Sim_Poller && (Sim_Time_ns >= Sim_Next_Poll_ns))
+    {
+        Sim_Next_Poll_ns = Sim_Time_ns + Sim_Poll_Period_ns;
+        Sim_Poller(Sim_Cycles);
+    }
+
+    if ((Sim_Time_Limit != 0) && (Sim_Cycles >= Sim_Time_Limit))
+    {
+        throw SIM_STOP_TIME_LIMIT;
+    }
+}
+
+uint64_t Sim_Get_Cycles()
+{
+    return Sim_Cycles;
+}
+
+uint64_t Sim_Get_Time_ns()
+{
+    return (uint64_t)Sim_Time_ns;
+}
+
+void Sim_Set_Time_Limit(uint64_t cycles)
+{
+    Sim_Time_Limit = cycles;
+}
+
+void Sim_Set_Poll_Callback(Sim_Poll_Callback callback, uint64_t period_ns)
+{
+    Sim_Poller = callback;
+    Sim_Poll_Period_ns = (double)period_ns;
+    Sim_Next_Poll_ns = Sim_Time_ns;
+}
+
+void Sim_Register_Access(const void *reg, int write)
+{
+    const uint8_t *address = (const uint8_t *)reg;
+    Sim_Peripheral peripheral = (Sim_Port_Number(reg) != 0) ? SIM_PERIPHERAL_PORT : SIM_PERIPHERAL_CORE;
+
+    for (size_t i = 0; (peripheral == SIM_PERIPHERAL_CORE) && (i < sizeof(Sim_Ranges) / sizeof(Sim_Ranges[0])); i++)
+    {
+        const uint8_t *base = (const uint8_t *)Sim_Ranges[i].base;
+        if ((address >= base) && (address < base + Sim_Ranges[i].size))
+        {
+            peripheral = Sim_Ranges[i].peripheral;
+            break;
+        }
+    }
+
+    if (write)
+    {
+        Sim_Statistics.writes[peripheral]++;
+    }
+    else
+    {
+        Sim_Statistics.reads[peripheral]++;
+    }
+    Sim_Statistics.register_cycles += SIM_REGISTER_ACCESS_CYCLES;
+    Sim_Advance(SIM_REGISTER_ACCESS_CYCLES);
+}
+
+void Sim_Delay_Loops(uint32_t loops)
+{
+    uint64_t cycles = ((uint64_t)loops * SIM_DELAY_LOOP_CYCLES_X1000) / 1000;
+
+    Sim_Statistics.delay_cycles += cycles;
+    Sim_Advance(cycles);
+}
+
+/******************************************************************************
+* Core
+******************************************************************************/
+
+uint32_t Sim_Get_PRIMASK()
+{
+    return Sim_PRIMASK;
+}
+
+void Sim_Set_PRIMASK(uint32_t primask)
+{
+    Sim_PRIMASK = primask & 1;
+}
+
+uint32_t Sim_Get_BASEPRI()
+{
+    return Sim_BASEPRI;
+}
+
+void Sim_Set_BASEPRI(uint32_t basepri)
+{
+    Sim_BASEPRI = basepri;
+}
+
+// MRS BASEPRI followed by MSR BASEPRI_MAX (Critical_Section.c)
+uint32_t Critical_Section_Raise(uint32_t basepri)
+{
+    uint32_t previous = Sim_BASEPRI;
+
+    basepri &= 0xFF;
+    if ((basepri != 0) && ((previous == 0) || (basepri < previous)))
+    {
+        Sim_BASEPRI = basepri;
+    }
+    return previous;
+}
+
+void Sim_Wait_For_Interrupt()
+{
+    uint64_t wake_up = 0;
+
+    if (!Sim_Input_Events.empty())
+    {
+        wake_up = Sim_Input_Events.begin()->first;
+    }
+    if (!Sim_UART_RX_Queue.empty() && ((wake_up == 0) || (Sim_UART_RX_Queue.front().arrival < wake_up)))
+    {
+        wake_up = Sim_UART_RX_Queue.front().arrival;
+    }
+    if (wake_up == 0)
+    {
+        throw SIM_STOP_SLEEP_FOREVER;
+    }
+    if (wake_up > Sim_Cycles)
+    {
+        Sim_Statistics.sleep_cycles += wake_up - Sim_Cycles;
+        Sim_Advance(wake_up - Sim_Cycles);
+    }
+}
+
+void Sim_System_Reset()
+{
+    throw SIM_STOP_SYSTEM_RESET;
+}
+
+static uint32_t Sim_CYCCNT_Read(const void *reg, uint32_t stored)
+{
+    return (uint32_t)Sim_Cycles + Sim_CYCCNT_Offset;
+}
+
+static void Sim_CYCCNT_Write(void *reg, uint32_t value)
+{
+    Sim_CYCCNT_Offset = value - (uint32_t)Sim_Cycles;
+}
+
+/******************************************************************************
+* Ports
+******************************************************************************/
+
+static uint8_t Sim_Port_Number(const void *reg)
+{
+    for (uint8_t port = 1; port < SIM_NUM_PORTS; port++)
+    {
+        if ((reg >= (const void *)Sim_Ports[port]) && (reg < (const void *)(Sim_Ports[port] + 1)))
+        {
+            return port;
+        }
+    }
+    return 0;
+}
+
+uint8_t Sim_Get_Pins(uint8_t port)
+{
+    DIO_PORT_Type *p = Sim_Ports[port];
+    uint8_t inputs = ~p->DIR.value;
+    uint8_t driven = inputs & Sim_Drive_Mask[port];
+    uint8_t pulled = inputs & ~Sim_Drive_Mask[port] & p->REN.value;
+
+    return (p->OUT.value & p->DIR.value) | (driven & Sim_Drive_Value[port]) | (pulled & p->OUT.value);
+}
+
+DIO_PORT_Type *Sim_Get_Port(uint8_t port)
+{
+    return Sim_Ports[port];
+}
+
+static uint32_t Sim_Port_IN_Read(const void *reg, uint32_t stored)
+{
+    return Sim_Get_Pins(Sim_Port_Number(reg));
+}
+
+static void Sim_Port_IN_Write(void *reg, uint32_t value)
+{
+    Sim_Violation("write to a read-only Px->IN register");
+}
+
+static void Sim_Port_Output_Write(void *reg, uint32_t value)
+{
+    uint8_t port = Sim_Port_Number(reg);
+    DIO_PORT_Type *p = Sim_Ports[port];
+
+    ((Sim_Reg8 *)reg)->value = value;
+
+    uint8_t output = p->OUT.value & p->DIR.value;
+    if (output != Sim_Observed_Output[port])
+    {
+        Sim_Observed_Output[port] = output;
+        if (Sim_Port_Observer)
+        {
+            Sim_Port_Observer(Sim_Cycles, port, output);
+        }
+    }
+}
+
+void Sim_Schedule_Input(uint64_t cycles, uint8_t port, uint8_t mask, uint8_t value)
+{
+    Sim_Input_Event event = { port, mask, value, 0 };
+    Sim_Input_Events.insert(std::make_pair(cycles, event));
+    if (cycles <= Sim_Cycles)
+    {
+        Sim_Advance(0);
+    }
+}
+
+void Sim_Release_Input(uint64_t cycles, uint8_t port, uint8_t mask)
+{
+    Sim_Input_Event event = { port, mask, 0, 1 };
+    Sim_Input_Events.insert(std::make_pair(cycles, event));
+    if (cycles <= Sim_Cycles)
+    {
+        Sim_Advance(0);
+    }
+}
+
+void Sim_Set_Output_Observer(Sim_Output_Observer observer)
+{
+    Sim_Port_Observer = observer;
+}
+
+/******************************************************************************
+* Clock System
+******************************************************************************/
+
+static uint32_t Sim_CS_Source_Hz(uint32_t select)
+{
+    switch (select)
+    {
+        case 0:
+        case 2:
+            return 32768;                                   // LFXTCLK, REFOCLK
+        case 1:
+            return 9400;                                    // VLOCLK
+        case 3:
+            return 1500000 << ((Sim_CS.CTL0.value >> 16) & 0x7);    // DCOCLK (DCORSEL)
+        case 4:
+            return 24000000;                                // MODCLK
+        case 5:
+            return 48000000;                                // HFXTCLK
+        default:
+            return 32768;
+    }
+}
+
+uint32_t Sim_Get_MCLK_Hz()
+{
+    uint32_t ctl1 = Sim_CS.CTL1.value;
+    return Sim_CS_Source_Hz(ctl1 & CS_CTL1_SELM_MASK) >> ((ctl1 & CS_CTL1_DIVM_MASK) >> CS_CTL1_DIVM_OFS);
+}
+
+uint32_t Sim_Get_SMCLK_Hz()
+{
+    uint32_t ctl1 = Sim_CS.CTL1.value;
+    return Sim_CS_Source_Hz((ctl1 >> 4) & 0x7) >> ((ctl1 & CS_CTL1_DIVS_MASK) >> CS_CTL1_DIVS_OFS);
+}
+
+static uint8_t Sim_HFXT_Stable()
+{
+    return (Sim_CS.CTL2.value & CS_CTL2_HFXT_EN) && (Sim_Cycles >= Sim_HFXT_Ready_Cycles);
+}
+
+static uint32_t Sim_CS_KEY_Read(const void *reg, uint32_t stored)
+{
+    return 0xA596;
+}
+
+static void Sim_CS_KEY_Write(void *reg, uint32_t value)
+{
+    Sim_CS_Unlocked = ((value & 0xFFFF) == CS_KEY_VAL);
+}
+
+static void Sim_CS_Check_MCLK()
+{
+    uint32_t mclk = Sim_Get_MCLK_Hz();
+    uint32_t wait_states = (mclk > 32000000) ? 2 : ((mclk > 16000000) ? 1 : 0);
+
+    if (((Sim_CS.CTL1.value & CS_CTL1_SELM_MASK) == 5) && !Sim_HFXT_Stable())
+    {
+        Sim_Violation("MCLK sourced from HFXT before HFXT is stable");
+    }
+    if ((((Sim_FLCTL.BANK0_RDCTL.value & FLCTL_BANK0_RDCTL_WAIT_MASK) >> FLCTL_BANK0_RDCTL_WAIT_OFS) < wait_states)
+        || (((Sim_FLCTL.BANK1_RDCTL.value & FLCTL_BANK1_RDCTL_WAIT_MASK) >> FLCTL_BANK1_RDCTL_WAIT_OFS) < wait_states))
+    {
+        Sim_Violation("not enough flash wait states for MCLK");
+    }
+    if ((mclk > 24000000) && ((Sim_PCM_Mode & 0x1) == 0))
+    {
+        Sim_Violation("MCLK above 24 MHz in a VCORE0 power mode");
+    }
+}
+
+static void Sim_CS_Locked_Write(void *reg, uint32_t value)
+{
+    if (!Sim_CS_Unlocked)
+    {
+        Sim_Violation("write to a CS register while CSKEY is locked");
+        return;
+    }
+
+    if ((reg == &Sim_CS.CTL2) && (value & CS_CTL2_HFXT_EN) && !(Sim_CS.CTL2.value & CS_CTL2_HFXT_EN))
+    {
+        Sim_HFXT_Ready_Cycles = Sim_Cycles + SIM_HFXT_STARTUP_CYCLES;
+    }
+    ((Sim_Reg32 *)reg)->value = value;
+
+    if (reg == &Sim_CS.CTL1)
+    {
+        Sim_CS_Check_MCLK();
+    }
+}
+
+static uint32_t Sim_CS_IFG_Read(const void *reg, uint32_t stored)
+{
+    // The fault flag is set again as long as the oscillator is not stable
+    if ((Sim_CS.CTL2.value & CS_CTL2_HFXT_EN) && !Sim_HFXT_Stable())
+    {
+        Sim_CS.IFG.value |= CS_IFG_HFXTIFG;
+    }
+    return Sim_CS.IFG.value;
+}
+
+static void Sim_CS_CLRIFG_Write(void *reg, uint32_t value)
+{
+    Sim_CS.IFG.value &= ~value;
+}
+
+/******************************************************************************
+* Power Control Manager
+******************************************************************************/
+
+static void Sim_PCM_Update()
+{
+    if (Sim_Cycles >= Sim_PCM_Busy_Until)
+    {
+        Sim_PCM_Mode = Sim_PCM_Target_Mode;
+    }
+}
+
+static uint32_t Sim_PCM_CTL0_Read(const void *reg, uint32_t stored)
+{
+    Sim_PCM_Update();
+    return 0xA5960000 | ((uint32_t)Sim_PCM_Mode << PCM_CTL0_CPM_OFS) | (stored & 0xFF);
+}
+
+static void Sim_PCM_CTL0_Write(void *reg, uint32_t value)
+{
+    uint8_t mode = value & PCM_CTL0_AMR_MASK;
+
+    if ((value & PCM_CTL0_KEY_MASK) != PCM_CTL0_KEY_VAL)
+    {
+        Sim_Violation("write to PCM->CTL0 without the PCM key");
+        return;
+    }
+    if (Sim_Cycles < Sim_PCM_Busy_Until)
+    {
+        Sim_Violation("write to PCM->CTL0 while PMR_BUSY is set");
+        return;
+    }
+
+    Sim_PCM.CTL0.value = value & 0xFF;
+    if ((mode != 0) && (mode != 1) && (mode != 4) && (mode != 5) && (mode != 8) && (mode != 9))
+    {
+        Sim_PCM.IFG.value |= PCM_IFG_AM_INVALID_TR_IFG;
+    }
+    else if (mode != Sim_PCM_Mode)
+    {
+        Sim_PCM_Target_Mode = mode;
+        Sim_PCM_Busy_Until = Sim_Cycles + SIM_PCM_TRANSITION_CYCLES;
+    }
+}
+
+static uint32_t Sim_PCM_CTL1_Read(const void *reg, uint32_t stored)
+{
+    Sim_PCM_Update();
+    return 0xA5960000 | (stored & 0xFF) | ((Sim_Cycles < Sim_PCM_Busy_Until) ? PCM_CTL1_PMR_BUSY : 0);
+}
+
+static void Sim_PCM_CTL1_Write(void *reg, uint32_t value)
+{
+    if ((value & PCM_CTL1_KEY_MASK) != PCM_CTL1_KEY_VAL)
+    {
+        Sim_Violation("write to PCM->CTL1 without the PCM key");
+        return;
+    }
+    Sim_PCM.CTL1.value = value & 0xFF;
+}
+
+static void Sim_PCM_CLRIFG_Write(void *reg, uint32_t value)
+{
+    Sim_PCM.IFG.value &= ~value;
+}
+
+/******************************************************************************
+* EUSCI_A0
+******************************************************************************/
+
+static uint64_t Sim_UART_Char_Cycles()
+{
+    uint32_t brw = Sim_EUSCI_A0.BRW.value ? Sim_EUSCI_A0.BRW.value : 1;
+    uint32_t smclk = Sim_Get_SMCLK_Hz();
+
+    // Start bit, 8 data bits and stop bit, each lasting BRW SMCLK periods
+    return ((uint64_t)10 * brw * Sim_Get_MCLK_Hz() + smclk - 1) / smclk;
+}
+
+static uint8_t Sim_UART_RX_Ready()
+{
+    // A character received while RXBUF is still full replaces it
+    while ((Sim_UART_RX_Queue.size() >= 2) && (Sim_UART_RX_Queue[1].arrival <= Sim_Cycles)
+           && !(Sim_EUSCI_A0.CTLW0.value & EUSCI_A_CTLW0_SWRST))
+    {
+        Sim_UART_RX_Queue.pop_front();
+        Sim_UART_RX_Queue.front().statw |= EUSCI_A_STATW_OE;
+        Sim_Statistics.uart_overruns++;
+    }
+
+    return !Sim_UART_RX_Queue.empty() && (Sim_UART_RX_Queue.front().arrival <= Sim_Cycles)
+           && !(Sim_EUSCI_A0.CTLW0.value & EUSCI_A_CTLW0_SWRST);
+}
+
+static uint32_t Sim_UART_IFG_Read(const void *reg, uint32_t stored)
+{
+    uint32_t ifg = stored & ~(EUSCI_A_IFG_RXIFG | EUSCI_A_IFG_TXIFG);
+
+    if (Sim_UART_RX_Ready())
+    {
+        ifg |= EUSCI_A_IFG_RXIFG;
+    }
+    if (Sim_Cycles >= Sim_UART_TXBUF_Free_At)
+    {
+        ifg |= EUSCI_A_IFG_TXIFG;
+    }
+    return ifg;
+}
+
+static uint32_t Sim_UART_STATW_Read(const void *reg, uint32_t stored)
+{
+    uint32_t busy = (Sim_Cycles < Sim_UART_Shift_End) ? 0x01 : 0;
+    return busy | (Sim_UART_RX_Ready() ? Sim_UART_RX_Queue.front().statw : 0);
+}
+
+static uint32_t Sim_UART_RXBUF_Read(const void *reg, uint32_t stored)
+{
+    if (Sim_UART_RX_Ready())
+    {
+        Sim_EUSCI_A0.RXBUF.value = Sim_UART_RX_Queue.front().data;
+        Sim_UART_RX_Queue.pop_front();
+    }
+    return Sim_EUSCI_A0.RXBUF.value;
+}
+
+static void Sim_UART_TXBUF_Write(void *reg, uint32_t value)
+{
+    uint64_t char_cycles = Sim_UART_Char_Cycles();
+
+    if (Sim_EUSCI_A0.CTLW0.value & EUSCI_A_CTLW0_SWRST)
+    {
+        Sim_Violation("write to EUSCI_A0->TXBUF while the module is in reset");
+        return;
+    }
+    if (Sim_Cycles < Sim_UART_TXBUF_Free_At)
+    {
+        Sim_Violation("EUSCI_A0->TXBUF overwritten before TXIFG was set");
+    }
+
+    Sim_EUSCI_A0.TXBUF.value = value & 0xFF;
+    if (Sim_Cycles >= Sim_UART_Shift_End)
+    {
+        // The character moves to the shift register immediately
+        Sim_UART_TXBUF_Free_At = Sim_Cycles;
+        Sim_UART_Shift_End = Sim_Cycles + char_cycles;
+    }
+    else
+    {
+        Sim_UART_TXBUF_Free_At = Sim_UART_Shift_End;
+        Sim_UART_Shift_End += char_cycles;
+    }
+
+    if (Sim_UART_TX_Observer)
+    {
+        Sim_UART_TX_Observer(Sim_UART_TXBUF_Free_At, value & 0xFF);
+    }
+}
+
+void Sim_Schedule_UART_RX(uint64_t cycles, const uint8_t *data, size_t length, uint16_t statw)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        Sim_UART_Char c = { cycles + i * SIM_UART_RX_CHAR_CYCLES, data[i], statw };
+
+        std::deque<Sim_UART_Char>::iterator position = Sim_UART_RX_Queue.end();
+        while ((position != Sim_UART_RX_Queue.begin()) && ((position - 1)->arrival > c.arrival))
+        {
+            position--;
+        }
+        Sim_UART_RX_Queue.insert(position, c);
+    }
+}
+
+void Sim_Push_UART_RX(const uint8_t *data, size_t length)
+{
+    uint64_t char_cycles = Sim_UART_Char_Cycles();
+    uint64_t arrival = Sim_Cycles;
+
+    if (!Sim_UART_RX_Queue.empty() && (Sim_UART_RX_Queue.back().arrival + char_cycles > arrival))
+    {
+        arrival = Sim_UART_RX_Queue.back().arrival + char_cycles;
+    }
+    for (size_t i = 0; i < length; i++)
+    {
+        Sim_UART_Char c = { arrival + i * char_cycles, data[i], 0 };
+        Sim_UART_RX_Queue.push_back(c);
+    }
+}
+
+void Sim_Set_UART_Observer(Sim_UART_Observer observer)
+{
+    Sim_UART_TX_Observer = observer;
+}
+
+/******************************************************************************
+* Reset Controller
+******************************************************************************/
+
+static void Sim_RSTCTL_CLR_Write(void *reg, uint32_t value)
+{
+    // Each CLR register follows the STAT register it clears
+    Sim_Reg32 *stat = (Sim_Reg32 *)reg - 1;
+
+    if ((reg == &Sim_RSTCTL.HARDRESET_CLR) || (reg == &Sim_RSTCTL.SOFTRESET_CLR))
+    {
+        stat->value &= ~value;
+    }
+    else if (value & 1)
+    {
+        stat->value = 0;
+    }
+}
+
+/******************************************************************************
+* Reset and statistics
+******************************************************************************/
+
+void Sim_Reset()
+{
+    Sim_Cycles = 0;
+    Sim_Time_Limit = 0;
+    Sim_Time_ns = 0;
+    memset(&Sim_Statistics, 0, sizeof(Sim_Statistics));
+    Sim_Last_Violation[0] = '\0';
+
+    Sim_Input_Events.clear();
+    Sim_UART_RX_Queue.clear();
+    memset(Sim_Drive_Mask, 0, sizeof(Sim_Drive_Mask));
+    memset(Sim_Drive_Value, 0, sizeof(Sim_Drive_Value));
+    memset(Sim_Observed_Output, 0, sizeof(Sim_Observed_Output));
+    Sim_Port_Observer = 0;
+    Sim_UART_TX_Observer = 0;
+    Sim_Poller = 0;
+
+    Sim_PRIMASK = 0;
+    Sim_BASEPRI = 0;
+    Sim_CYCCNT_Offset = 0;
+    Sim_CS_Unlocked = 0;
+    Sim_HFXT_Ready_Cycles = 0;
+    Sim_PCM_Mode = 0;
+    Sim_PCM_Target_Mode = 0;
+    Sim_PCM_Busy_Until = 0;
+    Sim_UART_TXBUF_Free_At = 0;
+    Sim_UART_Shift_End = 0;
+
+    for (uint8_t port = 1; port < SIM_NUM_PORTS; port++)
+    {
+        DIO_PORT_Type *p = Sim_Ports[port];
+        Sim_Clear(&p->IN, 11, (uint8_t)0);
+        Sim_Clear(&p->IV, 1, (uint16_t)0);
+        p->IN.read_hook = Sim_Port_IN_Read;
+        p->IN.write_hook = Sim_Port_IN_Write;
+        p->OUT.write_hook = Sim_Port_Output_Write;
+        p->DIR.write_hook = Sim_Port_Output_Write;
+    }
+
+    Sim_Clear(&Sim_CS.KEY, sizeof(CS_Type) / sizeof(Sim_Reg32), (uint32_t)0);
+    Sim_CS.CTL0.value = 0x00010000;                 // DCORSEL = 1 (3 MHz)
+    Sim_CS.CTL1.value = 0x00000033;                 // SELM = SELS = DCOCLK
+    Sim_CS.CTL2.value = 0x00010003;
+    Sim_CS.KEY.read_hook = Sim_CS_KEY_Read;
+    Sim_CS.KEY.write_hook = Sim_CS_KEY_Write;
+    Sim_CS.CTL0.write_hook = Sim_CS_Locked_Write;
+    Sim_CS.CTL1.write_hook = Sim_CS_Locked_Write;
+    Sim_CS.CTL2.write_hook = Sim_CS_Locked_Write;
+    Sim_CS.CTL3.write_hook = Sim_CS_Locked_Write;
+    Sim_CS.CLKEN.write_hook = Sim_CS_Locked_Write;
+    Sim_CS.IFG.read_hook = Sim_CS_IFG_Read;
+    Sim_CS.CLRIFG.write_hook = Sim_CS_CLRIFG_Write;
+
+    Sim_Clear(&Sim_PCM.CTL0, sizeof(PCM_Type) / sizeof(Sim_Reg32), (uint32_t)0);
+    Sim_PCM.CTL0.read_hook = Sim_PCM_CTL0_Read;
+    Sim_PCM.CTL0.write_hook = Sim_PCM_CTL0_Write;
+    Sim_PCM.CTL1.read_hook = Sim_PCM_CTL1_Read;
+    Sim_PCM.CTL1.write_hook = Sim_PCM_CTL1_Write;
+    Sim_PCM.CLRIFG.write_hook = Sim_PCM_CLRIFG_Write;
+
+    Sim_Clear(&Sim_FLCTL.POWER_STAT, sizeof(FLCTL_Type) / sizeof(Sim_Reg32), (uint32_t)0);
+
+    Sim_Clear(&Sim_EUSCI_A0.CTLW0, sizeof(EUSCI_A_Type) / sizeof(Sim_Reg16), (uint16_t)0);
+    Sim_EUSCI_A0.CTLW0.value = EUSCI_A_CTLW0_SWRST;
+    Sim_EUSCI_A0.IFG.value = EUSCI_A_IFG_TXIFG;
+    Sim_EUSCI_A0.IFG.read_hook = Sim_UART_IFG_Read;
+    Sim_EUSCI_A0.STATW.read_hook = Sim_UART_STATW_Read;
+    Sim_EUSCI_A0.RXBUF.read_hook = Sim_UART_RXBUF_Read;
+    Sim_EUSCI_A0.TXBUF.write_hook = Sim_UART_TXBUF_Write;
+
+    Sim_Clear(&Sim_RSTCTL.RESET_REQ, sizeof(RSTCTL_Type) / sizeof(Sim_Reg32), (uint32_t)0);
+    Sim_RSTCTL.HARDRESET_CLR.write_hook = Sim_RSTCTL_CLR_Write;
+    Sim_RSTCTL.SOFTRESET_CLR.write_hook = Sim_RSTCTL_CLR_Write;
+    Sim_RSTCTL.PSSRESET_CLR.write_hook = Sim_RSTCTL_CLR_Write;
+    Sim_RSTCTL.PCMRESET_CLR.write_hook = Sim_RSTCTL_CLR_Write;
+    Sim_RSTCTL.PINRESET_CLR.write_hook = Sim_RSTCTL_CLR_Write;
+    Sim_RSTCTL.REBOOTRESET_CLR.write_hook = Sim_RSTCTL_CLR_Write;
+    Sim_RSTCTL.CSRESET_CLR.write_hook = Sim_RSTCTL_CLR_Write;
+
+    // _system_pre_init enables the cycle counter on the target
+    Sim_Clear(&Sim_DWT.CTRL, sizeof(DWT_Type) / sizeof(Sim_Reg32), (uint32_t)0);
+    Sim_DWT.CTRL.value = DWT_CTRL_CYCCNTENA_Msk;
+    Sim_DWT.CYCCNT.read_hook = Sim_CYCCNT_Read;
+    Sim_DWT.CYCCNT.write_hook = Sim_CYCCNT_Write;
+    Sim_Clear(&Sim_CoreDebug.DEMCR, 1, (uint32_t)CoreDebug_DEMCR_TRCENA_Msk);
+    Sim_Clear(&Sim_SCB.VTOR, sizeof(SCB_Type) / sizeof(Sim_Reg32), (uint32_t)0);
+}
+
+void Sim_Get_Stats(Sim_Stats *stats)
+{
+    *stats = Sim_Statistics;
+    stats->cycles = Sim_Cycles;
+}
+
+const char *Sim_Get_Last_Violation()
+{
+    return Sim_Last_Violation;
+}
+
+/******************************************************************************
+* Boot
+******************************************************************************/
+
+// The host build has no .noinit section, so every run is a cold start
+uint8_t Boot_Is_Warm_Start()
+{
+    return 0;
+}
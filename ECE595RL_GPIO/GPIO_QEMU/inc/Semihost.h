@@ -0,0 +1,54 @@
+/**
+ * @file Semihost.h
+ * @brief Header file for the Semihost module.
+ *
+ * This file contains the function definitions for the Semihost module.
+ *
+ * The Semihost module sends requests to the debugger, or to QEMU with -semihosting, through the
+ * BKPT 0xAB instruction (Arm semihosting specification). It only implements the requests needed by the
+ * kernel harness: writing a string to the host console and exiting.
+ *
+ */
+
+#ifndef INC_SEMIHOST_H_
+#define INC_SEMIHOST_H_
+
+#include <stdint.h>
+
+/**
+ * @brief The Semihost_Write function writes a string to the host console.
+ *
+ * @param text The null-terminated string.
+ *
+ * @return None
+ */
+void Semihost_Write(const char *text);
+
+/**
+ * @brief The Semihost_Write_UDec function writes an unsigned decimal number to the host console.
+ *
+ * @param number The number.
+ *
+ * @return None
+ */
+void Semihost_Write_UDec(uint32_t number);
+
+/**
+ * @brief The Semihost_Write_UHex function writes an unsigned number in hexadecimal to the host console.
+ *
+ * @param number The number.
+ *
+ * @return None
+ */
+void Semihost_Write_UHex(uint32_t number);
+
+/**
+ * @brief The Semihost_Exit function stops the program. QEMU exits with status 0 or 1.
+ *
+ * @param failed 0 for a normal exit, 1 for an error.
+ *
+ * @return None (does not return)
+ */
+void Semihost_Exit(uint8_t failed) __attribute__((noreturn));
+
+#endif /* INC_SEMIHOST_H_ */
@@ -0,0 +1,46 @@
+/**
+ * @file UART_Capture.h
+ * @brief Header file for the UART_Capture module.
+ *
+ * This file contains the function definitions for the UART_Capture module.
+ *
+ * The UART_Capture module collects the characters that the unchanged EUSCI_A0_UART.c writes to the
+ * EUSCI_A0 registers, which are plain memory on the QEMU board (see msp.h). Each EUSCI_A0 access goes
+ * through UART_Capture_Access, which stores the character left in TXBUF by the previous access and marks
+ * TXBUF as empty. The last character of a call is stored by UART_Capture_Get.
+ *
+ * The access function adds a few instructions per EUSCI_A0 register access to the instruction counts of
+ * the formatting kernels.
+ *
+ */
+
+#ifndef INC_UART_CAPTURE_H_
+#define INC_UART_CAPTURE_H_
+
+#include <stdint.h>
+#include "msp.h"
+
+/**
+ * @brief Size of the capture buffer. The characters that do not fit are dropped.
+ */
+#define UART_CAPTURE_SIZE       64
+
+/**
+ * @brief The UART_Capture_Reset function clears the captured characters.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void UART_Capture_Reset();
+
+/**
+ * @brief The UART_Capture_Get function returns the characters captured since UART_Capture_Reset.
+ *
+ * @param None
+ *
+ * @return The null-terminated characters, or the first UART_CAPTURE_SIZE - 1 of them.
+ */
+const char *UART_Capture_Get();
+
+#endif /* INC_UART_CAPTURE_H_ */
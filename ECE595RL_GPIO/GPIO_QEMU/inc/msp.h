@@ -0,0 +1,90 @@
+/**
+ * @file msp.h
+ * @brief QEMU replacement of the MSP432P401R device header.
+ *
+ * This file is included instead of the TI device header when the compute kernels are built for the
+ * QEMU mps2-an386 board (see GPIO_QEMU/Makefile). The board has a Cortex-M4 core like the MSP432P401R
+ * but none of its peripherals, so the registers used by the kernels are plain variables in SRAM:
+ *  - EUSCI_A0: IFG always reports TXIFG, and the characters written to TXBUF are collected by the
+ *    UART_Capture module (see UART_Capture.h). Every EUSCI_A0 access calls UART_Capture_Access.
+ *  - P1 and DWT: plain memory. QEMU does not implement the DWT cycle counter, so CYCCNT reads 0.
+ *
+ * Only the peripherals and register names used by the QEMU build are defined.
+ *
+ */
+
+#ifndef QEMU_MSP_H_
+#define QEMU_MSP_H_
+
+#include <stdint.h>
+
+/******************************************************************************
+* Peripheral register blocks
+******************************************************************************/
+
+typedef struct
+{
+    volatile uint16_t CTLW0;
+    volatile uint16_t CTLW1;
+    uint16_t RESERVED0;
+    volatile uint16_t BRW;
+    volatile uint16_t MCTLW;
+    volatile uint16_t STATW;
+    volatile uint16_t RXBUF;
+    volatile uint16_t TXBUF;
+    volatile uint16_t ABCTL;
+    volatile uint16_t IRCTL;
+    uint16_t RESERVED1[3];
+    volatile uint16_t IE;
+    volatile uint16_t IFG;
+    volatile uint16_t IV;
+} EUSCI_A_Type;
+
+typedef struct
+{
+    volatile uint8_t SEL0;
+    volatile uint8_t SEL1;
+} DIO_PORT_Type;
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+extern DIO_PORT_Type QEMU_P1;
+extern DWT_Type QEMU_DWT;
+
+EUSCI_A_Type *UART_Capture_Access(void);
+
+#define P1              (&QEMU_P1)
+#define EUSCI_A0        (UART_Capture_Access())
+#define DWT             (&QEMU_DWT)
+
+#define EUSCI_A_IFG_RXIFG                   0x0001
+#define EUSCI_A_IFG_TXIFG                   0x0002
+
+/******************************************************************************
+* TI compiler intrinsics
+******************************************************************************/
+
+static inline uint32_t _norm(uint32_t value)
+{
+    return (value != 0) ? (uint32_t)__builtin_clz(value) : 32;
+}
+
+static inline uint32_t __ldrex(void *address)
+{
+    uint32_t value;
+    __asm volatile ("ldrex %0, [%1]" : "=r" (value) : "r" (address) : "memory");
+    return value;
+}
+
+static inline uint32_t __strex(uint32_t value, void *address)
+{
+    uint32_t failed;
+    __asm volatile ("strex %0, %2, [%1]" : "=&r" (failed) : "r" (address), "r" (value) : "memory");
+    return failed;
+}
+
+#endif /* QEMU_MSP_H_ */
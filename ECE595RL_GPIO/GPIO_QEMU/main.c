@@ -0,0 +1,201 @@
+/**
+ * @file main.c
+ * @brief Kernel harness for the QEMU mps2-an386 board.
+ *
+ * This program runs the compute kernels of the GPIO drivers on the Cortex-M4 emulated by QEMU, checks
+ * their results and prints the number of instructions per call on the host console (semihosting).
+ * The kernel sources in ../GPIO/src are compiled unchanged (see GPIO_QEMU/Makefile).
+ *
+ * The instructions are counted with SysTick. QEMU runs with -icount, so the virtual time advances by
+ * 2^QEMU_ICOUNT_SHIFT ns per instruction, and SysTick counts the 25 MHz system clock of the board (40 ns).
+ * Each kernel is called many times and the cost of the empty measurement loop is subtracted, so the
+ * resolution is better than one instruction per call. The counts are for the code generated by
+ * arm-none-eabi-gcc, which is not the TI compiler used for the LaunchPad, so they are meant for comparing
+ * two versions of a kernel rather than for predicting its cycle count on the MSP432P401R.
+ *
+ * Output: one line per kernel, "<kernel> <instructions per call> <PASS|FAIL>". The program exits with
+ * status 1 if a kernel returns a wrong result.
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "inc/Semihost.h"
+#include "inc/UART_Capture.h"
+#include "../GPIO/inc/CRC16.h"
+#include "../GPIO/inc/EUSCI_A0_UART.h"
+#include "../GPIO/inc/Flight_Recorder.h"
+#include "../GPIO/inc/Perf_Counter.h"
+
+#ifndef QEMU_ICOUNT_SHIFT
+#define QEMU_ICOUNT_SHIFT       0
+#endif
+
+// SysTick counts the 25 MHz system clock of the mps2-an386 board
+#define SYSTICK_NS              40
+#define SYSTICK_CTRL            (*(volatile uint32_t *)0xE000E010)
+#define SYSTICK_LOAD            (*(volatile uint32_t *)0xE000E014)
+#define SYSTICK_VAL             (*(volatile uint32_t *)0xE000E018)
+#define SYSTICK_MAX             0x00FFFFFF
+
+// Variables of the device header and of the modules that are not part of the QEMU build
+DIO_PORT_Type QEMU_P1;
+DWT_Type QEMU_DWT;
+volatile uint32_t Perf_Counter_Values[PERF_COUNTER_NUM_COUNTERS];
+static Flight_Recorder_Record QEMU_Flight_Recorder_Buffer[FLIGHT_RECORDER_SIZE];
+static volatile uint32_t QEMU_Flight_Recorder_Count;
+Flight_Recorder_Record *Flight_Recorder_Active = QEMU_Flight_Recorder_Buffer;
+volatile uint32_t *Flight_Recorder_Count = &QEMU_Flight_Recorder_Count;
+
+typedef struct
+{
+    const char *name;
+    uint32_t iterations;
+    void (*run)(void);              // One call of the kernel
+    const char *expected;           // Characters transmitted by one call, or 0
+    uint8_t (*check)(void);         // Returns 1 if the result of the last call is correct, or 0
+} Kernel;
+
+static uint8_t CRC16_Data[1024];
+static volatile uint16_t CRC16_Result;
+static char Write_Text[] = "line 1\nline 2\n";
+
+// Bit-by-bit CRC-16/CCITT-FALSE, used to check the table-driven CRC16_Update
+static uint16_t CRC16_Reference(const uint8_t *data, uint32_t length)
+{
+    uint16_t crc = CRC16_INIT;
+
+    while (length--)
+    {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void Run_Empty(void)
+{
+}
+
+static void Run_CRC16_Check(void)
+{
+    CRC16_Result = CRC16_Update(CRC16_INIT, (const uint8_t *)"123456789", 9);
+}
+
+static uint8_t Check_CRC16_Check(void)
+{
+    // Check value of the CRC-16/CCITT-FALSE catalogue entry
+    return CRC16_Result == 0x29B1;
+}
+
+static void Run_CRC16_1K(void)
+{
+    CRC16_Result = CRC16_Update(CRC16_INIT, CRC16_Data, sizeof(CRC16_Data));
+}
+
+static uint8_t Check_CRC16_1K(void)
+{
+    return CRC16_Result == CRC16_Reference(CRC16_Data, sizeof(CRC16_Data));
+}
+
+static void Run_OutUDec_Small(void)
+{
+    EUSCI_A0_UART_OutUDec(7);
+}
+
+static void Run_OutUDec_Max(void)
+{
+    EUSCI_A0_UART_OutUDec(4294967295u);
+}
+
+static void Run_OutSDec(void)
+{
+    EUSCI_A0_UART_OutSDec(-2147483647);
+}
+
+static void Run_OutUHex(void)
+{
+    EUSCI_A0_UART_OutUHex(0xDEADBEEF);
+}
+
+static void Run_OutUFix(void)
+{
+    EUSCI_A0_UART_OutUFix(1234);
+}
+
+static void Run_Write(void)
+{
+    EUSCI_A0_UART_Write(0, Write_Text, sizeof(Write_Text) - 1);
+}
+
+static const Kernel Kernels[] =
+{
+    { "crc16_check",        1000,   Run_CRC16_Check,    0,                      Check_CRC16_Check },
+    { "crc16_1k",           100,    Run_CRC16_1K,       0,                      Check_CRC16_1K },
+    { "uart_out_udec_7",    1000,   Run_OutUDec_Small,  "7",                    0 },
+    { "uart_out_udec_max",  1000,   Run_OutUDec_Max,    "4294967295",           0 },
+    { "uart_out_sdec",      1000,   Run_OutSDec,        "-2147483647",          0 },
+    { "uart_out_uhex",      1000,   Run_OutUHex,        "DEADBEEF",             0 },
+    { "uart_out_ufix",      1000,   Run_OutUFix,        "123.4",                0 },
+    { "uart_write",         1000,   Run_Write,          "line 1\r\nline 2\r\n", 0 },
+};
+
+// Returns the number of instructions executed by the given number of calls
+static uint64_t Count_Instructions(void (*run)(void), uint32_t iterations)
+{
+    uint32_t start = SYSTICK_VAL;
+
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        run();
+    }
+
+    uint32_t ticks = (start - SYSTICK_VAL) & SYSTICK_MAX;
+    return ((uint64_t)ticks * SYSTICK_NS) >> QEMU_ICOUNT_SHIFT;
+}
+
+int main(void)
+{
+    uint8_t failed = 0;
+
+    SYSTICK_LOAD = SYSTICK_MAX;
+    SYSTICK_VAL = 0;
+    SYSTICK_CTRL = 0x5;             // Enabled, processor clock, no interrupt
+
+    for (uint32_t i = 0; i < sizeof(CRC16_Data); i++)
+    {
+        CRC16_Data[i] = (uint8_t)(i * 7 + 3);
+    }
+
+    // Cost of the measurement loop with an empty kernel, per 1000 calls
+    uint64_t overhead = Count_Instructions(Run_Empty, 1000);
+
+    Semihost_Write("# kernel instructions/call result (QEMU mps2-an386, icount shift ");
+    Semihost_Write_UDec(QEMU_ICOUNT_SHIFT);
+    Semihost_Write(")\n");
+
+    for (uint32_t k = 0; k < sizeof(Kernels) / sizeof(Kernels[0]); k++)
+    {
+        const Kernel *kernel = &Kernels[k];
+
+        UART_Capture_Reset();
+        kernel->run();
+        uint8_t pass = ((kernel->expected == 0) || (strcmp(UART_Capture_Get(), kernel->expected) == 0))
+                       && ((kernel->check == 0) || kernel->check());
+        failed |= !pass;
+
+        uint64_t total = Count_Instructions(kernel->run, kernel->iterations);
+        uint64_t loop = (overhead * kernel->iterations) / 1000;
+        uint32_t per_call = (uint32_t)(((total > loop) ? (total - loop) : 0) / kernel->iterations);
+
+        Semihost_Write(kernel->name);
+        Semihost_Write(" ");
+        Semihost_Write_UDec(per_call);
+        Semihost_Write(pass ? " PASS\n" : " FAIL\n");
+    }
+
+    return failed;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file Semihost.c
+ * @brief Source code for the Semihost module.
+ *
+ * This file contains the function definitions for the Semihost module.
+ *
+ */
+
+#include "../inc/Semihost.h"
+
+// Semihosting operations and exit reasons
+#define SYS_WRITE0                          0x04
+#define SYS_EXIT                            0x18
+#define ADP_STOPPED_APPLICATION_EXIT        0x20026
+#define ADP_STOPPED_RUN_TIME_ERROR          0x20023
+
+static uint32_t Semihost_Call(uint32_t operation, const void *argument)
+{
+    register uint32_t r0 __asm("r0") = operation;
+    register const void *r1 __asm("r1") = argument;
+
+    __asm volatile ("bkpt 0xAB" : "+r" (r0) : "r" (r1) : "memory");
+    return r0;
+}
+
+void Semihost_Write(const char *text)
+{
+    Semihost_Call(SYS_WRITE0, text);
+}
+
+void Semihost_Write_UDec(uint32_t number)
+{
+    char text[11];
+    char *pt = &text[10];
+
+    *pt = '\0';
+    do
+    {
+        *--pt = '0' + (number % 10);
+        number /= 10;
+    } while (number != 0);
+    Semihost_Write(pt);
+}
+
+void Semihost_Write_UHex(uint32_t number)
+{
+    char text[9];
+
+    for (int i = 0; i < 8; i++)
+    {
+        uint32_t digit = (number >> (28 - 4 * i)) & 0xF;
+        text[i] = (digit < 10) ? ('0' + digit) : ('A' + digit - 10);
+    }
+    text[8] = '\0';
+    Semihost_Write(text);
+}
+
+void Semihost_Exit(uint8_t failed)
+{
+    // On AArch32, SYS_EXIT takes the reason in r1 instead of a parameter block
+    Semihost_Call(SYS_EXIT, (const void *)(uintptr_t)(failed ? ADP_STOPPED_RUN_TIME_ERROR : ADP_STOPPED_APPLICATION_EXIT));
+    while (1);
+}
@@ -0,0 +1,62 @@
+/**
+ * @file Startup.c
+ * @brief Start-up code of the QEMU mps2-an386 board.
+ *
+ * This file contains the vector table and the reset handler of the kernel harness. QEMU loads the
+ * initial stack pointer and the reset vector from address 0, which is the start of the code SRAM.
+ *
+ */
+
+#include <stdint.h>
+#include "../inc/Semihost.h"
+
+extern uint32_t __data_load, __data_start, __data_end, __bss_start, __bss_end, __stack_top;
+
+int main(void);
+void Reset_Handler(void);
+
+// Any exception other than the reset is an error of the harness or of a kernel
+static void Default_Handler(void)
+{
+    Semihost_Write("# unexpected exception\n");
+    Semihost_Exit(1);
+}
+
+__attribute__((section(".vectors"), used))
+static void (* const Vector_Table[16])(void) =
+{
+    (void (*)(void))&__stack_top,
+    Reset_Handler,
+    Default_Handler,        // NMI
+    Default_Handler,        // HardFault
+    Default_Handler,        // MemManage
+    Default_Handler,        // BusFault
+    Default_Handler,        // UsageFault
+    0, 0, 0, 0,
+    Default_Handler,        // SVCall
+    Default_Handler,        // DebugMonitor
+    0,
+    Default_Handler,        // PendSV
+    Default_Handler         // SysTick
+};
+
+void Reset_Handler(void)
+{
+    uint32_t *source = &__data_load;
+    uint32_t *destination = &__data_start;
+
+    while (destination < &__data_end)
+    {
+        *destination++ = *source++;
+    }
+    for (destination = &__bss_start; destination < &__bss_end; destination++)
+    {
+        *destination = 0;
+    }
+
+    // Enable full access to the FPU (CP10 and CP11), as the TI start-up code does
+    *(volatile uint32_t *)0xE000ED88 |= (0xF << 20);
+    __asm volatile ("dsb\n isb" ::: "memory");
+
+    Semihost_Exit(main() != 0);
+}
@@ -0,0 +1,41 @@
+/**
+ * @file UART_Capture.c
+ * @brief Source code for the UART_Capture module.
+ *
+ * This file contains the function definitions for the UART_Capture module.
+ *
+ */
+
+#include "../inc/UART_Capture.h"
+
+#define UART_CAPTURE_EMPTY      0xFFFF
+
+static EUSCI_A_Type UART_Capture_EUSCI_A0 = { .IFG = EUSCI_A_IFG_TXIFG, .TXBUF = UART_CAPTURE_EMPTY };
+static char UART_Capture_Buffer[UART_CAPTURE_SIZE];
+static uint32_t UART_Capture_Count;
+
+EUSCI_A_Type *UART_Capture_Access(void)
+{
+    if (UART_Capture_EUSCI_A0.TXBUF != UART_CAPTURE_EMPTY)
+    {
+        if (UART_Capture_Count < UART_CAPTURE_SIZE - 1)
+        {
+            UART_Capture_Buffer[UART_Capture_Count++] = (char)UART_Capture_EUSCI_A0.TXBUF;
+        }
+        UART_Capture_EUSCI_A0.TXBUF = UART_CAPTURE_EMPTY;
+    }
+    return &UART_Capture_EUSCI_A0;
+}
+
+void UART_Capture_Reset()
+{
+    UART_Capture_EUSCI_A0.TXBUF = UART_CAPTURE_EMPTY;
+    UART_Capture_Count = 0;
+}
+
+const char *UART_Capture_Get()
+{
+    UART_Capture_Access();
+    UART_Capture_Buffer[UART_Capture_Count] = '\0';
+    return UART_Capture_Buffer;
+}
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""Compare two result files of the host microbenchmarks (GPIO_Host/gpio_bench -o <file>).
+
+For each benchmark present in both files, the comparison reports:
+
+  - the change of the median host time per item. A slowdown is a regression when it is above the
+    threshold and the 95% confidence intervals of the two medians do not overlap, so that the noise
+    of a single run is not reported. Host times are only comparable between runs on the same, otherwise
+    idle machine; the drift between two runs (frequency scaling, other processes) is not part of the
+    confidence intervals, which only describe the samples of one run.
+  - the change of the virtual cycles and register accesses per item. They are deterministic, so any
+    increase is a regression.
+
+A benchmark whose check failed (ok: false) is also a regression. The exit status is 1 if there is a
+regression, so that the script can gate a review.
+
+Usage:
+    python3 bench_compare.py <base.json> <head.json> [--threshold PERCENT]
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as results:
+        data = json.load(results)
+    if data.get("schema") != 1:
+        sys.exit("%s: unsupported schema %r" % (path, data.get("schema")))
+    return data
+
+
+def change(base, head):
+    return 100.0 * (head - base) / base if base else 0.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("base")
+    parser.add_argument("head")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="slowdown of the median host time reported as a regression, in percent (default 10)")
+    args = parser.parse_args()
+
+    base = load(args.base)
+    head = load(args.head)
+    base_benchmarks = {b["name"]: b for b in base["benchmarks"]}
+    head_benchmarks = {b["name"]: b for b in head["benchmarks"]}
+    regressions = 0
+
+    print("base %s (%s), head %s (%s)" % (base["revision"], base["compiler"], head["revision"], head["compiler"]))
+    print("%-28s %12s %12s %8s %10s %10s  %s" % ("benchmark", "base ns", "head ns", "change",
+                                                   "cycles", "accesses", "result"))
+    for name, new in head_benchmarks.items():
+        old = base_benchmarks.get(name)
+        if old is None:
+            print("%-28s %12s %12.2f %8s %10s %10s  new" % (name, "", new["ns_per_item"]["median"], "", "", ""))
+            continue
+
+        notes = []
+        old_ns = old["ns_per_item"]
+        new_ns = new["ns_per_item"]
+        time_change = change(old_ns["median"], new_ns["median"])
+        separated = (new_ns["ci95_low"] > old_ns["ci95_high"]) or (new_ns["ci95_high"] < old_ns["ci95_low"])
+        if separated and time_change > args.threshold:
+            notes.append("slower")
+        elif separated and time_change < -args.threshold:
+            notes.append("faster")
+
+        cycles = new["virtual_cycles_per_item"] - old["virtual_cycles_per_item"]
+        accesses = new["register_accesses_per_item"] - old["register_accesses_per_item"]
+        if cycles > 0 or accesses > 0:
+            notes.append("more cycles or accesses")
+        if not new["ok"]:
+            notes.append("check failed")
+        if new["unit"] != old["unit"]:
+            notes.append("unit changed from %s" % old["unit"])
+
+        regression = any(note in ("slower", "more cycles or accesses", "check failed") for note in notes)
+        regressions += regression
+        print("%-28s %12.2f %12.2f %+7.1f%% %+10.3f %+10.3f  %s" % (
+            name, old_ns["median"], new_ns["median"], time_change, cycles, accesses,
+            ("REGRESSION: " if regression else "") + ", ".join(notes)))
+
+    for name in base_benchmarks:
+        if name not in head_benchmarks:
+            print("%-28s missing in %s" % (name, args.head))
+
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
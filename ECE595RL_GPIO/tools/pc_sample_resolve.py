@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""Resolve a PC_Sampler histogram to function names.
+
+The histogram is the text transmitted by PC_Sampler_Dump (see GPIO/inc/PC_Sampler.h),
+captured from the serial terminal into a file. The function address ranges are read from
+the map file generated by the TI linker (${ProjName}.map, for example GPIO/Debug/GPIO.map).
+
+Each function is placed in its own .text:<name> subsection by the compiler, so the section
+allocation map gives the start address and size of every function, including static functions.
+Input sections without a function name (for example, assembly files of the run-time library)
+are reported with the name of their object file.
+
+A bucket that spans more than one function is split between them in proportion to the number
+of bytes of the bucket that each function covers.
+
+Usage:
+    python3 pc_sample_resolve.py <capture.txt> <GPIO.map> [--top N]
+"""
+
+import argparse
+import re
+import sys
+
+HEADER_RE = re.compile(r"PC sampler: base=([0-9A-Fa-f]+) shift=(\d+) total=([0-9A-Fa-f]+) other=([0-9A-Fa-f]+)")
+BUCKET_RE = re.compile(r"^([0-9A-Fa-f]+) ([0-9A-Fa-f]+)$")
+END_RE = re.compile(r"PC sampler: end")
+
+# Example: "                  00000e10    000000c8     GPIO.obj (.text:LED_Pattern_1)"
+SECTION_RE = re.compile(r"^\s+([0-9A-Fa-f]{8})\s+([0-9A-Fa-f]{8})\s+(.*?)\s*\((\.text(?::[^)]*)?)\)\s*$")
+
+
+def parse_capture(path):
+    """Return (shift, total, other, {bucket_address: samples}) of the last dump in the capture."""
+    dump = None
+    current = None
+    with open(path, errors="replace") as capture:
+        for line in capture:
+            line = line.strip()
+            header = HEADER_RE.search(line)
+            if header:
+                current = {
+                    "shift": int(header.group(2)),
+                    "total": int(header.group(3), 16),
+                    "other": int(header.group(4), 16),
+                    "buckets": {},
+                }
+                continue
+            if current is None:
+                continue
+            if END_RE.search(line):
+                dump = current
+                current = None
+                continue
+            bucket = BUCKET_RE.match(line)
+            if bucket:
+                current["buckets"][int(bucket.group(1), 16)] = int(bucket.group(2), 16)
+    if dump is None:
+        sys.exit("error: no complete PC sampler dump found in %s" % path)
+    return dump
+
+
+def parse_map(path):
+    """Return a sorted list of (start, end, name) for the .text input sections of the map file."""
+    functions = []
+    with open(path, errors="replace") as map_file:
+        for line in map_file:
+            section = SECTION_RE.match(line)
+            if not section:
+                continue
+            start = int(section.group(1), 16)
+            size = int(section.group(2), 16)
+            if size == 0:
+                continue
+            name = section.group(4)
+            if name.startswith(".text:"):
+                name = name[len(".text:"):]
+            else:
+                name = section.group(3).split(":")[-1].strip() or name
+            functions.append((start, start + size, name))
+    if not functions:
+        sys.exit("error: no .text sections found in %s" % path)
+    functions.sort()
+    return functions
+
+
+def resolve(dump, functions):
+    """Return {name: samples} with the samples of each bucket split over the functions it covers."""
+    bucket_size = 1 << dump["shift"]
+    samples = {}
+    for address, count in dump["buckets"].items():
+        end = address + bucket_size
+        covered = []
+        for start, stop, name in functions:
+            overlap = min(end, stop) - max(address, start)
+            if overlap > 0:
+                covered.append((overlap, name))
+        if not covered:
+            samples["(unknown)"] = samples.get("(unknown)", 0) + count
+            continue
+        total_overlap = sum(overlap for overlap, _ in covered)
+        for overlap, name in covered:
+            samples[name] = samples.get(name, 0) + count * overlap / total_overlap
+    if dump["other"]:
+        samples["(outside .text)"] = dump["other"]
+    return samples
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Resolve a PC_Sampler histogram to function names.")
+    parser.add_argument("capture", help="serial capture that contains the output of PC_Sampler_Dump")
+    parser.add_argument("map", help="map file generated by the linker")
+    parser.add_argument("--top", type=int, default=0, help="only print the N functions with the most samples")
+    args = parser.parse_args()
+
+    dump = parse_capture(args.capture)
+    samples = resolve(dump, parse_map(args.map))
+    total = dump["total"]
+    if total == 0:
+        sys.exit("error: the dump does not contain any sample")
+
+    rows = sorted(samples.items(), key=lambda item: item[1], reverse=True)
+    if args.top > 0:
+        rows = rows[:args.top]
+
+    print("%d samples, bucket size %d bytes" % (total, 1 << dump["shift"]))
+    print("%-40s %10s %8s" % ("function", "samples", "share"))
+    for name, count in rows:
+        print("%-40s %10.1f %7.2f%%" % (name, count, 100.0 * count / total))
+
+
+if __name__ == "__main__":
+    main()
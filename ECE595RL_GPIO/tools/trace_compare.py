@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+"""Compare a port trace against a golden waveform.
+
+The trace is the text transmitted by Port_Trace_Dump (see GPIO/inc/Port_Trace.h), captured from
+the serial terminal into a file, or the file written by the host simulation (GPIO_Host/gpio_sim -w).
+A capture may contain several dumps; since each dump removes the transmitted records, they are
+concatenated in order.
+
+A golden waveform lists the expected port writes with their time in milliseconds relative to the
+first write, and the tolerance of the interval between two consecutive writes:
+
+    # Pattern 3: binary down counter, 100 ms per step
+    # gpio_sim: -t 3000 -s 0:0x2
+    tolerance 2 1           # absolute tolerance in ms, relative tolerance in percent
+    drift 20                # optional: maximum accumulated error in ms
+    ports 1 2 9             # writes to the other ports are ignored
+    end 2900                # optional: end of the compared window in ms (default: last write)
+    0 2 0x00
+    ...
+
+Only the trace writes up to the end of the window (plus the absolute tolerance) are compared,
+so the trace may be longer than the golden waveform. The comparison fails on a missing or extra
+write, a different port or value, an interval outside its tolerance, or an accumulated error
+above the drift limit.
+
+Usage:
+    python3 trace_compare.py <trace.txt> <golden.txt> [--verbose]
+    python3 trace_compare.py <trace.txt> --make-golden <golden.txt> [--round MS] [--ports 1 2 9]
+                             [--tolerance ABS REL] [--drift MS] [--comment TEXT]
+"""
+
+import argparse
+import re
+import sys
+
+HEADER_RE = re.compile(r"Port trace: freq=(\d+) count=(\d+) lost=(\d+)")
+RECORD_RE = re.compile(r"^([0-9A-Fa-f]+) (\d+) ([0-9A-Fa-f]+)$")
+END_RE = re.compile(r"Port trace: end")
+
+
+def parse_trace(path):
+    """Return a list of (time_ms, port, value) of every complete dump in the capture."""
+    events = []
+    current = None
+    freq = None
+    last_timestamp = None
+    high = 0
+    with open(path, errors="replace") as capture:
+        for line in capture:
+            line = line.strip()
+            header = HEADER_RE.search(line)
+            if header:
+                freq = int(header.group(1))
+                if int(header.group(3)) != 0:
+                    print("warning: %s records were lost; the trace is incomplete" % header.group(3), file=sys.stderr)
+                current = []
+                continue
+            if current is None:
+                continue
+            if END_RE.search(line):
+                events.extend(current)
+                current = None
+                continue
+            record = RECORD_RE.match(line)
+            if record:
+                timestamp = int(record.group(1), 16)
+                # DWT->CYCCNT wraps every 2^32 cycles
+                if (last_timestamp is not None) and (timestamp < last_timestamp):
+                    high += 1 << 32
+                last_timestamp = timestamp
+                current.append(((high + timestamp) * 1000.0 / freq, int(record.group(2)), int(record.group(3), 16)))
+    if not events:
+        sys.exit("error: no complete port trace found in %s" % path)
+    return events
+
+
+def parse_golden(path):
+    """Return the settings and the list of (time_ms, port, value) of a golden waveform."""
+    golden = {"tolerance": (1.0, 1.0), "drift": None, "ports": None, "end": None, "events": []}
+    with open(path) as source:
+        for number, line in enumerate(source, 1):
+            fields = line.split("#", 1)[0].split()
+            if not fields:
+                continue
+            try:
+                if fields[0] == "tolerance":
+                    golden["tolerance"] = (float(fields[1]), float(fields[2]))
+                elif fields[0] == "drift":
+                    golden["drift"] = float(fields[1])
+                elif fields[0] == "ports":
+                    golden["ports"] = set(int(port) for port in fields[1:])
+                elif fields[0] == "end":
+                    golden["end"] = float(fields[1])
+                else:
+                    golden["events"].append((float(fields[0]), int(fields[1]), int(fields[2], 0)))
+            except (IndexError, ValueError):
+                sys.exit("error: %s:%d: invalid line" % (path, number))
+    if not golden["events"]:
+        sys.exit("error: %s contains no write" % path)
+    return golden
+
+
+def compare(events, golden, verbose):
+    """Print the differences and return the number of errors."""
+    tolerance_abs, tolerance_rel = golden["tolerance"]
+    expected = golden["events"]
+    ports = golden["ports"]
+    if ports is not None:
+        events = [event for event in events if event[1] in ports]
+    if not events:
+        print("FAIL: the trace contains no write to the compared ports")
+        return 1
+
+    golden_start = expected[0][0]
+    trace_start = events[0][0]
+    end = (golden["end"] if golden["end"] is not None else expected[-1][0]) - golden_start
+    actual = [(time - trace_start, port, value) for time, port, value in events
+              if time - trace_start <= end + tolerance_abs]
+    expected = [(time - golden_start, port, value) for time, port, value in expected]
+
+    errors = []
+    mismatch = False
+    max_interval_error = 0.0
+    max_drift = 0.0
+    for i in range(min(len(actual), len(expected))):
+        time, port, value = actual[i]
+        golden_time, golden_port, golden_value = expected[i]
+        if (port, value) != (golden_port, golden_value):
+            errors.append("write %d at %.3f ms: expected P%d = 0x%02X, got P%d = 0x%02X"
+                          % (i, time, golden_port, golden_value, port, value))
+            # The remaining writes are shifted, so the other differences are not meaningful
+            mismatch = True
+            break
+        drift = time - golden_time
+        max_drift = max(max_drift, abs(drift))
+        if (golden["drift"] is not None) and (abs(drift) > golden["drift"]):
+            errors.append("write %d at %.3f ms: accumulated error %.3f ms exceeds %.3f ms"
+                          % (i, time, drift, golden["drift"]))
+        if i > 0:
+            interval = time - actual[i - 1][0]
+            golden_interval = golden_time - expected[i - 1][0]
+            allowed = tolerance_abs + golden_interval * tolerance_rel / 100.0
+            interval_error = interval - golden_interval
+            max_interval_error = max(max_interval_error, abs(interval_error))
+            if abs(interval_error) > allowed:
+                errors.append("write %d at %.3f ms: interval %.3f ms, expected %.3f +/- %.3f ms"
+                              % (i, time, interval, golden_interval, allowed))
+        if verbose:
+            print("%4d %10.3f ms %+8.3f ms  P%d = 0x%02X" % (i, time, drift, port, value))
+
+    if not mismatch:
+        if len(actual) < len(expected):
+            time, port, value = expected[len(actual)]
+            errors.append("missing write %d at %.3f ms: P%d = 0x%02X (%d missing)"
+                          % (len(actual), time, port, value, len(expected) - len(actual)))
+        elif len(actual) > len(expected):
+            time, port, value = actual[len(expected)]
+            errors.append("extra write %d at %.3f ms: P%d = 0x%02X (%d extra)"
+                          % (len(expected), time, port, value, len(actual) - len(expected)))
+
+    for error in errors[:20]:
+        print(error)
+    if len(errors) > 20:
+        print("... %d more errors" % (len(errors) - 20))
+    print("%s: %d of %d writes compared, max interval error %.3f ms, max accumulated error %.3f ms"
+          % ("FAIL" if errors else "PASS", min(len(actual), len(expected)), len(expected),
+             max_interval_error, max_drift))
+    return len(errors)
+
+
+def make_golden(events, args):
+    """Write the trace as a golden waveform, with the times rounded to a multiple of args.round ms."""
+    ports = set(args.ports) if args.ports else None
+    if ports is not None:
+        events = [event for event in events if event[1] in ports]
+    start = events[0][0]
+    with open(args.make_golden, "w") as golden:
+        for comment in args.comment:
+            golden.write("# %s\n" % comment)
+        golden.write("tolerance %g %g\n" % tuple(args.tolerance))
+        if args.drift is not None:
+            golden.write("drift %g\n" % args.drift)
+        if ports is not None:
+            golden.write("ports %s\n" % " ".join(str(port) for port in sorted(ports)))
+        for time, port, value in events:
+            time = round((time - start) / args.round) * args.round
+            golden.write("%g %d 0x%02X\n" % (time, port, value))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare a port trace against a golden waveform.")
+    parser.add_argument("trace", help="trace captured from Port_Trace_Dump or written by gpio_sim -w")
+    parser.add_argument("golden", nargs="?", help="golden waveform")
+    parser.add_argument("--verbose", action="store_true", help="print every compared write")
+    parser.add_argument("--make-golden", metavar="FILE", help="write the trace as a golden waveform")
+    parser.add_argument("--round", type=float, default=1.0, metavar="MS", help="time grid of --make-golden (default 1 ms)")
+    parser.add_argument("--ports", type=int, nargs="+", help="ports kept by --make-golden (default all)")
+    parser.add_argument("--tolerance", type=float, nargs=2, default=[1.0, 1.0], metavar=("ABS", "REL"),
+                        help="interval tolerance of --make-golden in ms and percent (default 1 1)")
+    parser.add_argument("--drift", type=float, metavar="MS", help="accumulated error limit of --make-golden")
+    parser.add_argument("--comment", action="append", default=[], help="comment line of --make-golden")
+    args = parser.parse_args()
+
+    events = parse_trace(args.trace)
+    if args.make_golden:
+        make_golden(events, args)
+        return 0
+    if args.golden is None:
+        parser.error("a golden waveform or --make-golden is required")
+    return 1 if compare(events, parse_golden(args.golden), args.verbose) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())